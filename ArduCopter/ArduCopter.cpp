@@ -225,8 +225,17 @@ void Copter::fast_loop()
     // update INS immediately to get current gyro data populated
     ins.update();
 
-    // run low level rate controllers that only require IMU data
-    attitude_control->rate_controller_run();
+    if (!fast_rate_thread_running) {
+        // run low level rate controllers that only require IMU data
+        attitude_control->rate_controller_run();
+    }
+#if FRAME_CONFIG != HELI_FRAME
+    else {
+        // the rate PIDs run in fast_rate_thread(), which also mixes and
+        // writes the motors once they are spooled up
+        attitude_control->rate_controller_slow_update(ahrs.get_gyro_drift());
+    }
+#endif
 
     // send outputs to the motors library immediately
     motors_output();
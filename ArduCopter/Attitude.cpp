@@ -263,3 +263,81 @@ uint16_t Copter::get_pilot_speed_dn()
         return abs(g2.pilot_speed_dn);
     }
 }
+
+// start the rate controller thread if FSTRATE_ENABLE is set
+void Copter::fast_rate_thread_init()
+{
+#if FRAME_CONFIG != HELI_FRAME
+    if (g2.fast_rate_enable == 0) {
+        return;
+    }
+    if (!motors->has_rate_only_output()) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "Fast rate loop: frame not supported");
+        return;
+    }
+    if (!ins.enable_rate_loop_gyro()) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "Fast rate loop: no gyro queue");
+        return;
+    }
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&Copter::fast_rate_thread, void),
+                                      "FSTRATE", 2048, AP_HAL::Scheduler::PRIORITY_BOOST, 0)) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "Fast rate loop: thread failed");
+        return;
+    }
+    // the thread writes the motors while they are spooled up, and
+    // motors->output() leaves them alone
+    motors->set_rate_only_output(true);
+    fast_rate_thread_running = true;
+#endif
+}
+
+/*
+  run the rate PIDs on each new sample from the primary gyro, and
+  re-run the motor mixer with their outputs. This runs alongside the
+  main loop, sharing only the rate target, which the main loop passes
+  over once per loop, and the motors, which it holds the motors output
+  lock over. Samples that arrive while it runs are taken as one on the
+  next run, using the latest gyro and the total time since the last
+  run.
+
+  Only the rate PIDs and the mixer run here, each scaled by the time
+  between samples. The spool logic, throttle and battery filters,
+  servo channels and logging stay in motors_output() on the main loop
+ */
+void Copter::fast_rate_thread()
+{
+#if FRAME_CONFIG != HELI_FRAME
+    // motors output starts with the main loop
+    while (!ap.initialised) {
+        hal.scheduler->delay(1);
+    }
+
+    while (true) {
+        // the timeout only matters if the gyro stops
+        if (!ins.wait_rate_loop_gyro(scheduler.get_loop_period_us())) {
+            continue;
+        }
+
+        Vector3f gyro;
+        float dt = 0;
+        Vector3f sample;
+        float sample_dt;
+        while (ins.get_next_rate_loop_gyro(sample, sample_dt)) {
+            gyro = sample;
+            dt += sample_dt;
+        }
+        if (!is_positive(dt)) {
+            continue;
+        }
+
+        // a gap longer than a main loop period is treated as one
+        // main loop period so the integrators don't jump
+        dt = MIN(dt, scheduler.get_loop_period_s());
+
+        WITH_SEMAPHORE(motors->get_output_semaphore());
+
+        attitude_control->rate_controller_run_gyro(gyro, dt);
+        motors->output_rate_only();
+    }
+#endif
+}
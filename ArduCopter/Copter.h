@@ -469,6 +469,10 @@ private:
     // arm_time_ms - Records when vehicle was armed. Will be Zero if we are disarmed.
     uint32_t arm_time_ms;
 
+    // true when the rate controller is run by fast_rate_thread()
+    // rather than the main loop
+    bool fast_rate_thread_running;
+
     // Used to exit the roll and pitch auto trim function
     uint8_t auto_trim_counter;
 
@@ -657,6 +661,8 @@ private:
     void set_accel_throttle_I_from_pilot_throttle();
     void rotate_body_frame_to_NE(float &x, float &y);
     uint16_t get_pilot_speed_dn();
+    void fast_rate_thread_init();
+    void fast_rate_thread();
 
 #if ADSB_ENABLED == ENABLED
     // avoidance_adsb.cpp
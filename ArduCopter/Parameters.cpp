@@ -948,6 +948,16 @@ const AP_Param::GroupInfo ParametersG2::var_info[] = {
     AP_SUBGROUPINFO(user_parameters, "USR", 28, ParametersG2, UserParameters),
 #endif
 
+#if FRAME_CONFIG != HELI_FRAME
+    // @Param: FSTRATE_ENABLE
+    // @DisplayName: Fast rate loop enable
+    // @Description: Run the rate controller and motor mixer in their own thread for each sample from the primary gyro, rather than once per main loop. The thread runs while the main loop waits for its next sample. The attitude and position controllers, motor spool logic and other servo outputs stay in the main loop. This reduces the delay from gyro to motors, at the cost of more CPU. Only multicopter frames with a motor matrix are supported
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("FSTRATE_ENABLE", 29, ParametersG2, fast_rate_enable, 0),
+#endif
+
     AP_GROUPEND
 };
 
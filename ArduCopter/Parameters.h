@@ -567,6 +567,9 @@ public:
     // Land alt final stage
     AP_Int16 land_alt_low;
 
+    // run the rate controller at the gyro sample rate
+    AP_Int8 fast_rate_enable;
+
 #if TOY_MODE_ENABLED == ENABLED
     ToyMode toy_mode;
 #endif
@@ -315,6 +315,12 @@ void Copter::motors_output()
         ap.in_arming_delay = false;
     }
 
+#if FRAME_CONFIG != HELI_FRAME
+    // keep fast_rate_thread() from writing the motors in between the
+    // channel outputs below
+    WITH_SEMAPHORE(motors->get_output_semaphore());
+#endif
+
     // output any servo channels
     SRV_Channels::calc_pwm();
 
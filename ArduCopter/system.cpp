@@ -247,6 +247,9 @@ void Copter::init_ardupilot()
 
     startup_INS_ground();
 
+    // start the fast rate loop once the gyros are calibrated
+    fast_rate_thread_init();
+
     // set landed flags
     set_land_complete(true);
     set_land_complete_maybe(true);
@@ -61,6 +61,7 @@ COMMON_VEHICLE_DEPENDENT_LIBRARIES = [
     'AP_ICEngine',
     'AP_Frsky_Telem',
     'AP_FlashStorage',
+    'AP_FileStorage',
     'AP_Relay',
     'AP_ServoRelayEvents',
     'AP_Volz_Protocol',
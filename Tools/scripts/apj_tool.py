@@ -129,13 +129,18 @@ class embedded_defaults(object):
     def set_file(self, filename):
         '''set defaults to contents of a file'''
         print("Setting defaults from %s" % filename)
-        f = open(filename, 'r')
+        f = open(filename, 'rb')
         contents = f.read()
         f.close()
-        # remove carriage returns from the file
-        contents = contents.replace('\r','')
+        if not self.is_binary_defaults(contents):
+            # remove carriage returns from the file
+            contents = contents.replace('\r','')
         self.set_contents(contents)
 
+    def is_binary_defaults(self, contents):
+        '''check for defaults from libraries/AP_Param/tools/param_defaults_compile.py'''
+        return contents[:4] == 'APDF'
+
     def split_multi(self, str, separators):
         '''split a string, handling multiple separators'''
         for sep in separators:
@@ -152,6 +157,9 @@ class embedded_defaults(object):
         param_value = v[1]
         
         contents = self.contents()
+        if self.is_binary_defaults(contents):
+            print("Error: can't set a parameter in binary defaults")
+            sys.exit(1)
         lines = contents.strip().split('\n')
         changed = False
         for i in range(len(lines)):
@@ -0,0 +1,113 @@
+#!/usr/bin/env python
+'''
+time the download of a log from a vehicle over MAVLink, for example SITL
+
+Requests the whole log in one LOG_REQUEST_DATA and lets the vehicle
+stream it. Received LOG_DATA can be dropped to model a lossy link, and
+gaps are requested again while the stream carries on, the way MAVProxy
+fills them.
+'''
+
+import optparse
+import random
+import time
+
+from pymavlink import mavutil
+
+parser = optparse.OptionParser("log_download_time.py [options]")
+parser.add_option("--master", default="tcp:127.0.0.1:5760", help="MAVLink connection to the vehicle")
+parser.add_option("--log", type='int', default=0, help="log number to download, default is the latest")
+parser.add_option("--loss", type='float', default=0.0, help="percentage of LOG_DATA to drop")
+parser.add_option("--gap-interval", type='float', default=0.5, help="seconds between requests for gaps")
+parser.add_option("--max-gaps", type='int', default=8, help="most gaps to request at once")
+parser.add_option("--timeout", type='float', default=600.0, help="seconds to wait for the download to complete")
+parser.add_option("--seed", type='int', default=1, help="random seed for dropped LOG_DATA")
+
+opts, args = parser.parse_args()
+
+random.seed(opts.seed)
+
+mav = mavutil.mavlink_connection(opts.master)
+mav.wait_heartbeat()
+print("Heartbeat from system %u component %u" % (mav.target_system, mav.target_component))
+
+# find the log and its size
+mav.mav.log_request_list_send(mav.target_system, mav.target_component, 0, 0xFFFF)
+entries = {}
+while True:
+    m = mav.recv_match(type='LOG_ENTRY', blocking=True, timeout=5)
+    if m is None:
+        break
+    entries[m.id] = m.size
+    if m.id == m.last_log_num:
+        break
+if not entries or max(entries.keys()) == 0:
+    print("No logs")
+    exit(1)
+lognum = opts.log if opts.log != 0 else max(entries.keys())
+size = entries[lognum]
+print("Downloading log %u of %u bytes" % (lognum, size))
+
+
+def find_gaps(received, size, limit):
+    '''ranges of the log not yet received, as (ofs, count)'''
+    gaps = []
+    ofs = 0
+    for start in sorted(received.keys()):
+        if start > ofs:
+            gaps.append((ofs, start - ofs))
+            if len(gaps) >= limit:
+                return gaps
+        ofs = max(ofs, start + received[start])
+    return gaps
+
+
+received = {}
+total = 0
+packets = 0
+dropped = 0
+repeats = 0
+gap_requests = 0
+stream_end = 0
+
+start = time.time()
+last_gap_request = start
+mav.mav.log_request_data_send(mav.target_system, mav.target_component, lognum, 0, 0xFFFFFFFF)
+
+while total < size:
+    now = time.time()
+    if now - start > opts.timeout:
+        print("Timed out after %.1fs with %u of %u bytes" % (now - start, total, size))
+        break
+
+    if now - last_gap_request > opts.gap_interval:
+        # ask again for anything missing behind the stream, or for
+        # the end of the log if the stream has stalled
+        last_gap_request = now
+        for (ofs, count) in find_gaps(received, stream_end, opts.max_gaps):
+            mav.mav.log_request_data_send(mav.target_system, mav.target_component, lognum, ofs, count)
+            gap_requests += 1
+        if stream_end < size and not find_gaps(received, stream_end, 1):
+            mav.mav.log_request_data_send(mav.target_system, mav.target_component,
+                                          lognum, stream_end, 0xFFFFFFFF)
+            gap_requests += 1
+
+    m = mav.recv_match(type='LOG_DATA', blocking=True, timeout=0.1)
+    if m is None or m.id != lognum:
+        continue
+    packets += 1
+    if random.uniform(0, 100) < opts.loss:
+        dropped += 1
+        continue
+    if m.count == 0:
+        continue
+    stream_end = max(stream_end, m.ofs + m.count)
+    if m.ofs in received:
+        repeats += 1
+        continue
+    received[m.ofs] = m.count
+    total += m.count
+
+elapsed = time.time() - start
+print("Downloaded %u bytes in %.2fs (%.3f MB/s)" % (total, elapsed, total / (elapsed * 1.0e6)))
+print("%u LOG_DATA, %u dropped, %u repeated, %u gap requests" % (packets, dropped, repeats, gap_requests))
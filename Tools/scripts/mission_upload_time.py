@@ -0,0 +1,97 @@
+#!/usr/bin/env python
+'''
+time the upload of a large survey mission to a vehicle, for example SITL
+
+Acts as a ground station answering the vehicle's MISSION_REQUEST and
+MISSION_REQUEST_INT messages. Replies can be delayed and dropped to
+model a telemetry radio, and several requests may be outstanding at
+once if the vehicle requests items ahead of the one it is storing.
+'''
+
+import heapq
+import optparse
+import random
+import time
+
+from pymavlink import mavutil
+
+parser = optparse.OptionParser("mission_upload_time.py [options]")
+parser.add_option("--master", default="tcp:127.0.0.1:5760", help="MAVLink connection to the vehicle")
+parser.add_option("--count", type='int', default=1000, help="number of mission items to upload")
+parser.add_option("--latency", type='float', default=0.0, help="seconds to delay each reply by")
+parser.add_option("--loss", type='float', default=0.0, help="percentage of replies to drop")
+parser.add_option("--timeout", type='float', default=600.0, help="seconds to wait for the upload to complete")
+parser.add_option("--seed", type='int', default=1, help="random seed for dropped replies")
+
+opts, args = parser.parse_args()
+
+random.seed(opts.seed)
+
+
+def survey_item(mav, seq, lat, lng):
+    '''waypoint seq of a lawnmower survey with 20 waypoints per lane'''
+    lane = seq // 20
+    along = seq % 20
+    if lane % 2:
+        along = 19 - along
+    return mav.mav.mission_item_int_encode(
+        mav.target_system,
+        mav.target_component,
+        seq,
+        mavutil.mavlink.MAV_FRAME_GLOBAL_RELATIVE_ALT,
+        mavutil.mavlink.MAV_CMD_NAV_WAYPOINT,
+        0, 1, 0, 0, 0, 0,
+        int((lat + lane * 0.0002) * 1.0e7),
+        int((lng + along * 0.0002) * 1.0e7),
+        50.0,
+        mavutil.mavlink.MAV_MISSION_TYPE_MISSION)
+
+
+mav = mavutil.mavlink_connection(opts.master)
+mav.wait_heartbeat()
+print("Heartbeat from system %u component %u" % (mav.target_system, mav.target_component))
+
+lat = -35.3632
+lng = 149.1652
+pending = []
+requests = 0
+repeats = 0
+requested = set()
+
+start = time.time()
+mav.mav.mission_count_send(mav.target_system, mav.target_component, opts.count,
+                           mavutil.mavlink.MAV_MISSION_TYPE_MISSION)
+
+while True:
+    now = time.time()
+    if now - start > opts.timeout:
+        print("Timed out after %.1fs" % (now - start))
+        break
+
+    # send any replies which are due
+    while pending and pending[0][0] <= now:
+        due, seq = heapq.heappop(pending)
+        mav.mav.send(survey_item(mav, seq, lat, lng))
+
+    wait = 0.01
+    if pending:
+        wait = min(wait, max(0, pending[0][0] - now))
+    m = mav.recv_match(type=['MISSION_REQUEST', 'MISSION_REQUEST_INT', 'MISSION_ACK'], blocking=True, timeout=wait)
+    if m is None:
+        continue
+    if m.get_type() == 'MISSION_ACK':
+        if m.mission_type != mavutil.mavlink.MAV_MISSION_TYPE_MISSION:
+            continue
+        elapsed = time.time() - start
+        print("Upload of %u items finished with result %u in %.2fs (%.1f items/s)" %
+              (opts.count, m.type, elapsed, opts.count / elapsed))
+        break
+    requests += 1
+    if m.seq in requested:
+        repeats += 1
+    requested.add(m.seq)
+    if random.uniform(0, 100) < opts.loss:
+        continue
+    heapq.heappush(pending, (now + opts.latency, m.seq))
+
+print("%u requests, %u repeated" % (requests, repeats))
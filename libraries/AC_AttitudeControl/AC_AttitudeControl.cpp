@@ -186,6 +186,8 @@ void AC_AttitudeControl::relax_attitude_controllers()
 
 void AC_AttitudeControl::reset_rate_controller_I_terms()
 {
+    WITH_SEMAPHORE(_rate_sem);
+
     get_rate_roll_pid().reset_I();
     get_rate_pitch_pid().reset_I();
     get_rate_yaw_pid().reset_I();
@@ -11,6 +11,7 @@
 #include <AP_Motors/AP_Motors.h>
 #include <AC_PID/AC_PID.h>
 #include <AC_PID/AC_P.h>
+#include <AP_Common/Semaphore.h>
 
 #define AC_ATTITUDE_CONTROL_ANGLE_P                     4.5f             // default angle P gain for roll, pitch and yaw
 
@@ -377,6 +378,10 @@ protected:
     // velocity controller.
     Vector3f            _rate_target_ang_vel;
 
+    // held while the rate PIDs run or their I terms are reset, so a rate
+    // loop run in its own thread never races the main loop
+    HAL_Semaphore       _rate_sem;
+
     // This represents a quaternion attitude error in the body frame, used for inertial frame reset handling.
     Quaternion          _attitude_ang_error;
 
@@ -1,5 +1,6 @@
 #include "AC_AttitudeControl_Heli.h"
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Scheduler/LatencyInfo.h>
 
 // table of user settable parameters
 const AP_Param::GroupInfo AC_AttitudeControl_Heli::var_info[] = {
@@ -263,6 +264,8 @@ void AC_AttitudeControl_Heli::rate_controller_run()
     } else {
         _motors.set_yaw(rate_target_to_motor_yaw(gyro_latest.z, _rate_target_ang_vel.z));
     }
+
+    AP::latency().record(AP::LatencyInfo::STAGE_RATE);
 }
 
 // Update Alt_Hold angle maximum
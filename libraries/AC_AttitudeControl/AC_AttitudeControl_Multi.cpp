@@ -1,6 +1,7 @@
 #include "AC_AttitudeControl_Multi.h"
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
+#include <AP_Scheduler/LatencyInfo.h>
 
 // table of user settable parameters
 const AP_Param::GroupInfo AC_AttitudeControl_Multi::var_info[] = {
@@ -260,6 +261,39 @@ void AC_AttitudeControl_Multi::rate_controller_run()
     _motors.set_pitch(rate_target_to_motor_pitch(gyro_latest.y, _rate_target_ang_vel.y));
     _motors.set_yaw(rate_target_to_motor_yaw(gyro_latest.z, _rate_target_ang_vel.z));
 
+    AP::latency().record(AP::LatencyInfo::STAGE_RATE);
+
+    control_monitor_update();
+}
+
+void AC_AttitudeControl_Multi::rate_controller_run_gyro(const Vector3f &gyro, float dt)
+{
+    WITH_SEMAPHORE(_rate_sem);
+
+    get_rate_roll_pid().set_dt(dt);
+    get_rate_pitch_pid().set_dt(dt);
+    get_rate_yaw_pid().set_dt(dt);
+
+    // correct the gyro as the AHRS does in get_gyro_latest()
+    const Vector3f gyro_corrected = gyro + _rate_gyro_drift;
+    _motors.set_roll(rate_target_to_motor_roll(gyro_corrected.x, _rate_gyro_target.x));
+    _motors.set_pitch(rate_target_to_motor_pitch(gyro_corrected.y, _rate_gyro_target.y));
+    _motors.set_yaw(rate_target_to_motor_yaw(gyro_corrected.z, _rate_gyro_target.z));
+
+    AP::latency().record(AP::LatencyInfo::STAGE_RATE);
+}
+
+void AC_AttitudeControl_Multi::rate_controller_slow_update(const Vector3f &gyro_drift)
+{
+    // these filter over the main loop period
+    update_throttle_rpy_mix();
+
+    {
+        WITH_SEMAPHORE(_rate_sem);
+        _rate_gyro_target = _rate_target_ang_vel;
+        _rate_gyro_drift = gyro_drift;
+    }
+
     control_monitor_update();
 }
 
@@ -75,6 +75,21 @@ public:
     // run lowest level body-frame rate controller and send outputs to the motors
     void rate_controller_run() override;
 
+    // run lowest level body-frame rate controller on one uncorrected
+    // gyro sample taken dt seconds after the last one, and set the
+    // motors roll, pitch and yaw. This is for a rate loop run at the
+    // gyro sample rate in its own thread, with rate_controller_slow_update()
+    // called from the main loop in place of rate_controller_run(). It
+    // uses the rate target and gyro drift from the last
+    // rate_controller_slow_update(). The caller must hold the motors
+    // output lock while it sets the motors
+    void rate_controller_run_gyro(const Vector3f &gyro, float dt);
+
+    // update the parts of the rate controller that run at the main
+    // loop rate when rate_controller_run_gyro() is used, and pass the
+    // latest rate target and gyro drift to it
+    void rate_controller_slow_update(const Vector3f &gyro_drift);
+
     // sanity check parameters.  should be called once before take-off
     void parameter_sanity_check() override;
 
@@ -97,4 +112,8 @@ protected:
     AP_Float              _thr_mix_man;     // throttle vs attitude control prioritisation used when using manual throttle (higher values mean we prioritise attitude control over throttle)
     AP_Float              _thr_mix_min;     // throttle vs attitude control prioritisation used when landing (higher values mean we prioritise attitude control over throttle)
     AP_Float              _thr_mix_max;     // throttle vs attitude control prioritisation used during active flight (higher values mean we prioritise attitude control over throttle)
+
+    // rate target and gyro drift passed to rate_controller_run_gyro(), protected by _rate_sem
+    Vector3f              _rate_gyro_target;
+    Vector3f              _rate_gyro_drift;
 };
@@ -1,6 +1,7 @@
 #include "AC_AttitudeControl_Sub.h"
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
+#include <AP_Scheduler/LatencyInfo.h>
 
 // table of user settable parameters
 const AP_Param::GroupInfo AC_AttitudeControl_Sub::var_info[] = {
@@ -267,6 +268,8 @@ void AC_AttitudeControl_Sub::rate_controller_run()
     _motors.set_pitch(rate_target_to_motor_pitch(gyro_latest.y, _rate_target_ang_vel.y));
     _motors.set_yaw(rate_target_to_motor_yaw(gyro_latest.z, _rate_target_ang_vel.z));
 
+    AP::latency().record(AP::LatencyInfo::STAGE_RATE);
+
     control_monitor_update();
 }
 
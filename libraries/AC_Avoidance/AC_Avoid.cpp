@@ -340,13 +340,17 @@ void AC_Avoid::adjust_velocity_polygon_fence(float kP, float accel_cmss, Vector2
         return;
     }
 
-    // get polygon boundary
-    // Note: first point in list is the return-point (which copter does not use)
-    uint16_t num_points;
-    const Vector2f* boundary = _fence.get_polygon_points(num_points);
-
-    // adjust velocity using polygon
-    adjust_velocity_polygon(kP, accel_cmss, desired_vel_cms, boundary, num_points, true, _fence.get_margin(), dt);
+    // adjust velocity using each polygon zone.  Circular zones are only
+    // enforced by the fence breach check
+    for (uint8_t i=0; i<_fence.get_zone_count(); i++) {
+        uint16_t num_points;
+        bool inclusion;
+        const AP_PolygonIndex* index;
+        const Vector2f* boundary = _fence.get_zone_points(i, num_points, inclusion, index);
+        if (boundary != nullptr) {
+            adjust_velocity_polygon(kP, accel_cmss, desired_vel_cms, boundary, num_points, true, _fence.get_margin(), dt, index, inclusion);
+        }
+    }
 }
 
 /*
@@ -399,14 +403,15 @@ void AC_Avoid::adjust_velocity_proximity(float kP, float accel_cmss, Vector2f &d
 /*
  * Adjusts the desired velocity for the polygon fence.
  */
-void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, const Vector2f* boundary, uint16_t num_points, bool earth_frame, float margin, float dt)
+void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, const Vector2f* boundary, uint16_t num_points, bool earth_frame, float margin, float dt,
+                                       const AP_PolygonIndex *index, bool inclusion)
 {
     // exit if there are no points
     if (boundary == nullptr || num_points == 0) {
         return;
     }
 
-    // do not adjust velocity if vehicle is outside the polygon fence
+    // do not adjust velocity if vehicle has breached the polygon fence
     Vector2f position_xy;
     if (earth_frame) {
         if (!_ahrs.get_relative_position_NE_origin(position_xy)) {
@@ -417,7 +422,8 @@ void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &des
         position_xy = position_xy * 100.0f;  // m to cm
     }
 
-    if (_fence.boundary_breached(position_xy, num_points, boundary)) {
+    const bool outside = (index != nullptr) ? index->outside(position_xy) : _fence.boundary_breached(position_xy, num_points, boundary);
+    if (outside == inclusion) {
         return;
     }
 
@@ -439,11 +445,24 @@ void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &des
     const float speed = safe_vel.length();
     const Vector2f stopping_point_plus_margin = position_xy + safe_vel*((2.0f + margin_cm + get_stopping_distance(kP, accel_cmss, speed))/speed);
 
-    uint16_t i, j;
-    for (i = 0, j = num_points-1; i < num_points; j = i++) {
+    // edges further away than the stopping point plus margin can not
+    // limit the velocity, so with an index only the nearby edges are checked
+    uint16_t near_edges[AC_AVOID_POLYGON_NEAR_EDGES_MAX];
+    uint16_t num_edges = num_points;
+    bool use_near_edges = false;
+    if (index != nullptr) {
+        const float check_radius = (stopping_point_plus_margin - position_xy).length();
+        use_near_edges = index->edges_near(position_xy, check_radius, near_edges, ARRAY_SIZE(near_edges), num_edges);
+        if (!use_near_edges) {
+            num_edges = num_points;
+        }
+    }
+
+    for (uint16_t i = 0; i < num_edges; i++) {
         // end points of current edge
-        Vector2f start = boundary[j];
-        Vector2f end = boundary[i];
+        const uint16_t edge = use_near_edges ? near_edges[i] : i;
+        Vector2f start = boundary[edge];
+        Vector2f end = boundary[(edge + 1) % num_points];
         if ((AC_Avoid::BehaviourType)_behavior.get() == BEHAVIOR_SLIDE) {
             // vector from current position to closest point on current edge
             Vector2f limit_direction = Vector2f::closest_point(position_xy, start, end) - position_xy;
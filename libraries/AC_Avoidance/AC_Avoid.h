@@ -21,6 +21,7 @@
 // definitions for non-GPS avoidance
 #define AC_AVOID_NONGPS_DIST_MAX_DEFAULT    5.0f    // objects over 5m away are ignored (default value for DIST_MAX parameter)
 #define AC_AVOID_ANGLE_MAX_PERCENT          0.75f   // object avoidance max lean angle as a percentage (expressed in 0 ~ 1 range) of total vehicle max lean angle
+#define AC_AVOID_POLYGON_NEAR_EDGES_MAX     32      // maximum number of nearby fence edges checked using the fence's spatial index
 
 /*
  * This class prevents the vehicle from leaving a polygon fence in
@@ -113,8 +114,11 @@ private:
      * Adjusts the desired velocity given an array of boundary points
      *   earth_frame should be true if boundary is in earth-frame, false for body-frame
      *   margin is the distance (in meters) that the vehicle should stop short of the polygon
+     *   index is an optional spatial index of the boundary, used to check only the edges within stopping distance
+     *   inclusion should be false if the vehicle must stay outside of the polygon
      */
-    void adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, const Vector2f* boundary, uint16_t num_points, bool earth_frame, float margin, float dt);
+    void adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, const Vector2f* boundary, uint16_t num_points, bool earth_frame, float margin, float dt,
+                                 const AP_PolygonIndex *index = nullptr, bool inclusion = true);
 
     /*
      * Computes distance required to stop, given current speed.
@@ -255,7 +255,7 @@ bool AC_Fence::check_fence_polygon()
     }
 
     position = position * 100.0f;  // m to cm
-    if (_poly_loader.boundary_breached(position, _boundary_num_points, _boundary, true)) {
+    if (zones_breached(position)) {
         // check if this is a new breach
         if (_breached_fences & AC_FENCE_TYPE_POLYGON) {
             // not a new breach
@@ -379,11 +379,11 @@ bool AC_Fence::check_destination_within_fence(const Location_Class& loc)
     }
 
     // polygon fence check
-    if ((get_enabled_fences() & AC_FENCE_TYPE_POLYGON) && _boundary_num_points > 0) {
+    if ((get_enabled_fences() & AC_FENCE_TYPE_POLYGON) && _boundary_valid) {
         // check ekf has a good location
         Vector2f posNE;
         if (loc.get_vector_xy_from_origin_NE(posNE)) {
-            if (_poly_loader.boundary_breached(posNE, _boundary_num_points, _boundary, true)) {
+            if (zones_breached(posNE)) {
                 return false;
             }
         }
@@ -460,9 +460,26 @@ Vector2f* AC_Fence::get_polygon_points(uint16_t& num_points) const
     if ((_boundary == nullptr) || (num_points == 0)) {
         return nullptr;
     }
+    // only the first zone if it is an inclusion polygon
+    if (_boundary_valid && _zones[0].inclusion && !_zones[0].circle) {
+        num_points = _zones[0].num_points;
+    }
     return &_boundary[1];
 }
 
+/// get_zone_points - returns pointer to the points of a polygon zone, or nullptr for a circle zone
+const Vector2f* AC_Fence::get_zone_points(uint8_t zone, uint16_t& num_points, bool& inclusion, const AP_PolygonIndex*& index) const
+{
+    num_points = 0;
+    if (zone >= get_zone_count() || _zones[zone].circle) {
+        return nullptr;
+    }
+    num_points = _zones[zone].num_points;
+    inclusion = _zones[zone].inclusion;
+    index = _zone_index[zone].valid() ? &_zone_index[zone] : nullptr;
+    return &_boundary[_zones[zone].first];
+}
+
 /// returns true if we've breached the polygon boundary.  simple passthrough to underlying _poly_loader object
 bool AC_Fence::boundary_breached(const Vector2f& location, uint16_t num_points, const Vector2f* points) const
 {
@@ -478,7 +495,8 @@ void AC_Fence::handle_msg(GCS_MAVLINK &link, mavlink_message_t* msg)
     }
 
     switch (msg->msgid) {
-        // receive a fence point from GCS and store in EEPROM
+        // receive a fence point from GCS and store in EEPROM.  See the
+        // comment on AC_Fence::Zone for how zones are encoded in the points
         case MAVLINK_MSG_ID_FENCE_POINT: {
             mavlink_fence_point_t packet;
             mavlink_msg_fence_point_decode(msg, &packet);
@@ -562,11 +580,90 @@ bool AC_Fence::load_polygon_from_eeprom(bool force_reload)
     _boundary_loaded = true;
 
     // update validity of polygon
-    _boundary_valid = _poly_loader.boundary_valid(_boundary_num_points, _boundary, true);
+    _boundary_valid = load_zones();
 
     return true;
 }
 
+/// load_zones - split the boundary array into zones and index them
+bool AC_Fence::load_zones()
+{
+    _num_zones = 0;
+    for (uint8_t i=0; i<AC_FENCE_ZONES_MAX; i++) {
+        _zone_index[i].clear();
+    }
+
+    // point 0 is the return point
+    uint16_t first = 1;
+    while (first < _boundary_num_points) {
+        if (_num_zones >= AC_FENCE_ZONES_MAX) {
+            return false;
+        }
+
+        // find the point closing this zone
+        uint16_t last = first + 2;
+        while (last < _boundary_num_points && _boundary[last] != _boundary[first]) {
+            last++;
+        }
+        if (last >= _boundary_num_points) {
+            // zone is not closed
+            return false;
+        }
+
+        Zone &zone = _zones[_num_zones];
+        zone.first = first;
+        zone.num_points = last - first + 1;
+        // a second copy of the closing point marks an exclusion zone
+        zone.inclusion = (last + 1 >= _boundary_num_points) || (_boundary[last + 1] != _boundary[first]);
+        zone.circle = (zone.num_points == 3);
+        if (zone.circle) {
+            zone.radius = (_boundary[first+1] - _boundary[first]).length();
+        } else {
+            // if the index can't be built the zone is checked with Polygon_outside
+            _zone_index[_num_zones].init(&_boundary[first], zone.num_points);
+        }
+        _num_zones++;
+        first = zone.inclusion ? last + 1 : last + 2;
+    }
+
+    if (_num_zones == 0) {
+        return false;
+    }
+
+    // check return point is within the fence
+    return !zones_breached(_boundary[0]);
+}
+
+/// zone_outside - returns true if position is outside the given zone
+bool AC_Fence::zone_outside(uint8_t zone, const Vector2f& position) const
+{
+    const Zone &z = _zones[zone];
+    if (z.circle) {
+        return (position - _boundary[z.first]).length() > z.radius;
+    }
+    if (_zone_index[zone].valid()) {
+        return _zone_index[zone].outside(position);
+    }
+    return Polygon_outside(position, &_boundary[z.first], z.num_points);
+}
+
+/// zones_breached - returns true if position is outside every inclusion zone or inside an exclusion zone
+bool AC_Fence::zones_breached(const Vector2f& position) const
+{
+    bool have_inclusion = false;
+    bool inside_inclusion = false;
+    for (uint8_t i=0; i<_num_zones; i++) {
+        const bool outside = zone_outside(i, position);
+        if (_zones[i].inclusion) {
+            have_inclusion = true;
+            inside_inclusion |= !outside;
+        } else if (!outside) {
+            return true;
+        }
+    }
+    return have_inclusion && !inside_inclusion;
+}
+
 // methods for mavlink SYS_STATUS message (send_sys_status)
 bool AC_Fence::sys_status_present() const
 {
@@ -7,6 +7,7 @@
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_AHRS/AP_AHRS.h>
 #include <AC_Fence/AC_PolyFence_loader.h>
+#include <AP_Math/AP_PolygonIndex.h>
 #include <AP_Common/Location.h>
 
 // bit masks for enabled fence types.  Used for TYPE parameter
@@ -25,6 +26,7 @@
 #define AC_FENCE_ALT_MAX_BACKUP_DISTANCE            20.0f   // after fence is broken we recreate the fence 20m further up
 #define AC_FENCE_CIRCLE_RADIUS_BACKUP_DISTANCE      20.0f   // after fence is broken we recreate the fence 20m further out
 #define AC_FENCE_MARGIN_DEFAULT                     2.0f    // default distance in meters that autopilot's should maintain from the fence to avoid a breach
+#define AC_FENCE_ZONES_MAX                          8       // maximum number of polygon and circle zones in the fence point list
 
 // give up distance
 #define AC_FENCE_GIVE_UP_DISTANCE                   100.0f  // distance outside the fence at which we should give up and just land.  Note: this is not used by library directly but is intended to be used by the main code
@@ -100,6 +102,13 @@ public:
     /// returns pointer to array of polygon points and num_points is filled in with the total number
     Vector2f* get_polygon_points(uint16_t& num_points) const;
 
+    /// get_zone_count - returns the number of inclusion and exclusion zones in the polygon fence
+    uint8_t get_zone_count() const { return _boundary_valid ? _num_zones : 0; }
+
+    /// get_zone_points - returns pointer to the points of a polygon zone, or nullptr for a circle zone.
+    ///     inclusion is set true if the vehicle must remain inside the zone.  index is the zone's spatial index, or nullptr if it could not be built
+    const Vector2f* get_zone_points(uint8_t zone, uint16_t& num_points, bool& inclusion, const AP_PolygonIndex*& index) const;
+
     /// returns true if we've breached the polygon boundary.  simple passthrough to underlying _poly_loader object
     bool boundary_breached(const Vector2f& location, uint16_t num_points, const Vector2f* points) const;
 
@@ -138,6 +147,15 @@ private:
     /// load polygon points stored in eeprom into boundary array and perform validation.  returns true if load successfully completed
     bool load_polygon_from_eeprom(bool force_reload = false);
 
+    /// load_zones - split the boundary array into zones and index them.  returns true if the zones are valid
+    bool load_zones();
+
+    /// zone_outside - returns true if position (in cm from the EKF origin) is outside the given zone
+    bool zone_outside(uint8_t zone, const Vector2f& position) const;
+
+    /// zones_breached - returns true if position (in cm from the EKF origin) is outside every inclusion zone or inside an exclusion zone
+    bool zones_breached(const Vector2f& position) const;
+
     // pointers to other objects we depend upon
     const AP_AHRS_NavEKF& _ahrs;
 
@@ -178,4 +196,28 @@ private:
     bool            _boundary_create_attempted = false; // true if we have attempted to create the boundary array
     bool            _boundary_loaded = false;       // true if boundary array has been loaded from eeprom
     bool            _boundary_valid = false;        // true if boundary forms a closed polygon
+
+    // The boundary array holds the return point followed by one or
+    // more zones, as uploaded with FENCE_POINT:
+    //  - each zone is closed by repeating its first point
+    //  - a zone whose closing point is repeated a second time is an
+    //    exclusion zone, otherwise it is an inclusion zone
+    //  - a zone of a centre and one point on its edge is a circle
+    // so "R A B C A D E F G D D P Q P" is the return point R, an
+    // inclusion triangle ABC, an exclusion quadrilateral DEFG and an
+    // inclusion circle around P through Q.  A zone can't start at the
+    // closing point of the zone before it.  The vehicle must be inside
+    // at least one inclusion zone, if there are any, and outside all
+    // exclusion zones.  A single closed polygon is an inclusion fence
+    // as before
+    struct Zone {
+        uint16_t    first;                          // index of the zone's first point in the boundary array
+        uint16_t    num_points;                     // number of points including the closing point
+        bool        inclusion;                      // true if the vehicle must stay inside the zone
+        bool        circle;                         // true if the zone is a circle around its first point
+        float       radius;                         // circle radius in cm
+    };
+    Zone            _zones[AC_FENCE_ZONES_MAX];
+    AP_PolygonIndex _zone_index[AC_FENCE_ZONES_MAX]; // spatial index of each polygon zone
+    uint8_t         _num_zones = 0;
 };
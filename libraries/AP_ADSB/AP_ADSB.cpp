@@ -30,7 +30,7 @@
 
 #define VEHICLE_TIMEOUT_MS              5000   // if no updates in this time, drop it from the list
 #define ADSB_VEHICLE_LIST_SIZE_DEFAULT  25
-#define ADSB_VEHICLE_LIST_SIZE_MAX      100
+#define ADSB_VEHICLE_LIST_SIZE_MAX      500
 #define ADSB_CHAN_TIMEOUT_MS            15000
 #define ADSB_SQUAWK_OCTAL_DEFAULT       1200
 
@@ -59,7 +59,7 @@ const AP_Param::GroupInfo AP_ADSB::var_info[] = {
     // @Param: LIST_MAX
     // @DisplayName: ADSB vehicle list size
     // @Description: ADSB list size of nearest vehicles. Longer lists take longer to refresh with lower SRx_ADSB values.
-    // @Range: 1 100
+    // @Range: 1 500
     // @User: Advanced
     AP_GROUPINFO("LIST_MAX",   2, AP_ADSB, in_state.list_size_param, ADSB_VEHICLE_LIST_SIZE_DEFAULT),
 
@@ -139,7 +139,6 @@ const AP_Param::GroupInfo AP_ADSB::var_info[] = {
 void AP_ADSB::init(void)
 {
     // in_state
-    in_state.vehicle_count = 0;
     if (in_state.vehicle_list == nullptr) {
         if (in_state.list_size_param != constrain_int16(in_state.list_size_param, 1, ADSB_VEHICLE_LIST_SIZE_MAX)) {
             in_state.list_size_param.set_and_notify(ADSB_VEHICLE_LIST_SIZE_DEFAULT);
@@ -148,15 +147,17 @@ void AP_ADSB::init(void)
         in_state.list_size = in_state.list_size_param;
         in_state.vehicle_list = new adsb_vehicle_t[in_state.list_size];
 
+        if (in_state.vehicle_list != nullptr && !in_state.index.init(in_state.list_size)) {
+            delete [] in_state.vehicle_list;
+            in_state.vehicle_list = nullptr;
+        }
         if (in_state.vehicle_list == nullptr) {
             // dynamic RAM allocation of _vehicle_list[] failed, disable gracefully
             hal.console->printf("Unable to initialize ADS-B vehicle list\n");
             _enabled.set_and_notify(0);
         }
     }
-
-    furthest_vehicle_distance = 0;
-    furthest_vehicle_index = 0;
+    in_state.index.clear();
 
     // out_state
     set_callsign("PING1234", false);
@@ -167,7 +168,7 @@ void AP_ADSB::init(void)
  */
 void AP_ADSB::deinit(void)
 {
-    in_state.vehicle_count = 0;
+    in_state.index.deinit();
     if (in_state.vehicle_list != nullptr) {
         delete [] in_state.vehicle_list;
         in_state.vehicle_list = nullptr;
@@ -202,7 +203,7 @@ void AP_ADSB::update(void)
 
     // check current list for vehicles that time out
     uint16_t index = 0;
-    while (index < in_state.vehicle_count) {
+    while (index < in_state.index.count()) {
         // check list and drop stale vehicles. When disabled, the list will get flushed
         if (now - in_state.vehicle_list[index].last_update_ms > VEHICLE_TIMEOUT_MS) {
             // don't increment index, we want to check this same index again because the contents changed
@@ -276,27 +277,6 @@ void AP_ADSB::update(void)
     } // chan_last_ms
 }
 
-/*
- * determine index and distance of furthest vehicle. This is
- * used to bump it off when a new closer aircraft is detected
- */
-void AP_ADSB::determine_furthest_aircraft(void)
-{
-    float max_distance = 0;
-    uint16_t max_distance_index = 0;
-
-    for (uint16_t index = 0; index < in_state.vehicle_count; index++) {
-        float distance = _my_loc.get_distance(get_location(in_state.vehicle_list[index]));
-        if (max_distance < distance || index == 0) {
-            max_distance = distance;
-            max_distance_index = index;
-        }
-    } // for index
-
-    furthest_vehicle_index = max_distance_index;
-    furthest_vehicle_distance = max_distance;
-}
-
 /*
  * Convert/Extract a Location from a vehicle
  */
@@ -317,37 +297,16 @@ Location_Class AP_ADSB::get_location(const adsb_vehicle_t &vehicle) const
  */
 void AP_ADSB::delete_vehicle(const uint16_t index)
 {
-    if (index < in_state.vehicle_count) {
-        // if the vehicle is the furthest, invalidate it. It has been bumped
-        if (index == furthest_vehicle_index && furthest_vehicle_distance > 0) {
-            furthest_vehicle_distance = 0;
-            furthest_vehicle_index = 0;
-        }
-        if (index != (in_state.vehicle_count-1)) {
-            in_state.vehicle_list[index] = in_state.vehicle_list[in_state.vehicle_count-1];
+    if (index < in_state.index.count()) {
+        const uint16_t last = in_state.index.remove(index);
+        if (index != last) {
+            in_state.vehicle_list[index] = in_state.vehicle_list[last];
         }
         // TODO: is memset needed? When we decrement the index we essentially forget about it
-        memset(&in_state.vehicle_list[in_state.vehicle_count-1], 0, sizeof(adsb_vehicle_t));
-        in_state.vehicle_count--;
+        memset(&in_state.vehicle_list[last], 0, sizeof(adsb_vehicle_t));
     }
 }
 
-/*
- * Search _vehicle_list for the given vehicle. A match
- * depends on ICAO_address. Returns true if match found
- * and index is populated. otherwise, return false.
- */
-bool AP_ADSB::find_index(const adsb_vehicle_t &vehicle, uint16_t *index) const
-{
-    for (uint16_t i = 0; i < in_state.vehicle_count; i++) {
-        if (in_state.vehicle_list[i].info.ICAO_address == vehicle.info.ICAO_address) {
-            *index = i;
-            return true;
-        }
-    }
-    return false;
-}
-
 /*
  * Update the vehicle list. If the vehicle is already in the
  * list then it will update it, otherwise it will be added.
@@ -366,7 +325,7 @@ void AP_ADSB::handle_vehicle(const mavlink_message_t* packet)
     bool my_loc_is_zero = _my_loc.is_zero();
     float my_loc_distance_to_vehicle = _my_loc.get_distance(vehicle_loc);
     bool out_of_range = in_state.list_radius > 0 && !my_loc_is_zero && my_loc_distance_to_vehicle > in_state.list_radius;
-    bool is_tracked_in_list = find_index(vehicle, &index);
+    bool is_tracked_in_list = in_state.index.find(vehicle.info.ICAO_address, index);
     uint32_t now = AP_HAL::millis();
 
     // note the last time the receiver got a packet from the aircraft
@@ -387,41 +346,28 @@ void AP_ADSB::handle_vehicle(const mavlink_message_t* packet)
             delete_vehicle(index);
         }
         return;
+    }
 
-    } else if (is_tracked_in_list) {
+    // distances are only kept in order while we know where we are
+    const float distance = my_loc_is_zero ? 0.0f : my_loc_distance_to_vehicle;
+
+    if (is_tracked_in_list) {
 
         // found, update it
         set_vehicle(index, vehicle);
+        in_state.index.set_distance(index, distance);
 
-    } else if (in_state.vehicle_count < in_state.list_size) {
+    } else if (!in_state.index.full()) {
 
         // not found and there's room, add it to the end of the list
-        set_vehicle(in_state.vehicle_count, vehicle);
-        in_state.vehicle_count++;
+        set_vehicle(in_state.index.add(vehicle.info.ICAO_address, distance), vehicle);
 
-    } else {
+    } else if (!my_loc_is_zero) {
         // buffer is full. if new vehicle is closer than furthest, replace furthest with new
-
-        if (my_loc_is_zero) {
-            // nothing else to do
-            furthest_vehicle_distance = 0;
-            furthest_vehicle_index = 0;
-
-        } else {
-            if (furthest_vehicle_distance <= 0) {
-                // ensure this is populated
-                determine_furthest_aircraft();
-            }
-
-            if (my_loc_distance_to_vehicle < furthest_vehicle_distance) { // is closer than the furthest
-                // replace with the furthest vehicle
-                set_vehicle(furthest_vehicle_index, vehicle);
-
-                // furthest_vehicle_index is now invalid because the vehicle was overwritten, need
-                // to run determine_furthest_aircraft() to determine a new one next time
-                furthest_vehicle_distance = 0;
-                furthest_vehicle_index = 0;
-            }
+        const uint16_t furthest = in_state.index.furthest();
+        if (distance < in_state.index.distance(furthest)) {
+            delete_vehicle(furthest);
+            set_vehicle(in_state.index.add(vehicle.info.ICAO_address, distance), vehicle);
         }
     } // if buffer full
 
@@ -448,13 +394,13 @@ void AP_ADSB::set_vehicle(const uint16_t index, const adsb_vehicle_t &vehicle)
 
 void AP_ADSB::send_adsb_vehicle(const mavlink_channel_t chan)
 {
-    if (in_state.vehicle_list == nullptr || in_state.vehicle_count == 0) {
+    if (in_state.vehicle_list == nullptr || in_state.index.count() == 0) {
         return;
     }
 
     uint32_t now = AP_HAL::millis();
 
-    if (in_state.send_index[chan] >= in_state.vehicle_count) {
+    if (in_state.send_index[chan] >= in_state.index.count()) {
         // we've finished a list
         if (now - in_state.send_start_ms[chan] < 1000) {
             // too soon to start a new one
@@ -466,8 +412,10 @@ void AP_ADSB::send_adsb_vehicle(const mavlink_channel_t chan)
         }
     }
 
-    if (in_state.send_index[chan] < in_state.vehicle_count) {
-        mavlink_adsb_vehicle_t vehicle = in_state.vehicle_list[in_state.send_index[chan]].info;
+    if (in_state.send_index[chan] < in_state.index.count()) {
+        // send the nearest aircraft first
+        const uint16_t slot = in_state.index.slot_by_distance(in_state.send_index[chan]);
+        mavlink_adsb_vehicle_t vehicle = in_state.vehicle_list[slot].info;
         in_state.send_index[chan]++;
 
         mavlink_msg_adsb_vehicle_send(chan,
@@ -29,6 +29,8 @@
 
 #include <AP_Buffer/AP_Buffer.h>
 
+#include "AP_ADSB_Index.h"
+
 class AP_ADSB {
 public:
     AP_ADSB()
@@ -51,7 +53,7 @@ public:
     // periodic task that maintains vehicle_list
     void update(void);
 
-    uint16_t get_vehicle_count() { return in_state.vehicle_count; }
+    uint16_t get_vehicle_count() { return in_state.index.count(); }
 
     // send ADSB_VEHICLE mavlink message, usually as a StreamRate
     void send_adsb_vehicle(mavlink_channel_t chan);
@@ -87,12 +89,6 @@ private:
     // free _vehicle_list
     void deinit();
 
-    // compares current vector against vehicle_list to detect threats
-    void determine_furthest_aircraft(void);
-
-    // return index of given vehicle if ICAO_ADDRESS matches. return -1 if no match
-    bool find_index(const adsb_vehicle_t &vehicle, uint16_t *index) const;
-
     // remove a vehicle from the list
     void delete_vehicle(const uint16_t index);
 
@@ -131,7 +127,7 @@ private:
         AP_Int16    list_size_param;
         uint16_t    list_size = 1; // start with tiny list, then change to param-defined size. This ensures it doesn't fail on start
         adsb_vehicle_t *vehicle_list = nullptr;
-        uint16_t    vehicle_count;
+        AP_ADSB_Index index; // ICAO lookup and distance order of vehicle_list
         AP_Int32    list_radius;
 
         // streamrate stuff
@@ -172,10 +168,6 @@ private:
     } out_state;
 
 
-    // index of and distance to furthest vehicle in list
-    uint16_t    furthest_vehicle_index;
-    float       furthest_vehicle_distance;
-
     static const uint8_t max_samples = 30;
     AP_Buffer<adsb_vehicle_t, max_samples> samples;
 
@@ -0,0 +1,188 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "AP_ADSB_Index.h"
+
+bool AP_ADSB_Index::init(uint16_t max_slots)
+{
+    deinit();
+
+    if (max_slots == 0 || max_slots > UINT16_MAX / 4) {
+        return false;
+    }
+
+    // keep the hash table at most half full so probe sequences stay short
+    uint16_t num_buckets = 8;
+    _bucket_shift = 32 - 3;
+    while (num_buckets < 2 * max_slots) {
+        num_buckets <<= 1;
+        _bucket_shift--;
+    }
+    _bucket_mask = num_buckets - 1;
+
+    _icao = (uint32_t *)calloc(max_slots, sizeof(uint32_t));
+    _distance = (float *)calloc(max_slots, sizeof(float));
+    _rank = (uint16_t *)calloc(max_slots, sizeof(uint16_t));
+    _order = (uint16_t *)calloc(max_slots, sizeof(uint16_t));
+    _buckets = (uint16_t *)malloc(num_buckets * sizeof(uint16_t));
+    if (_icao == nullptr || _distance == nullptr || _rank == nullptr ||
+        _order == nullptr || _buckets == nullptr) {
+        deinit();
+        return false;
+    }
+
+    _max_slots = max_slots;
+    clear();
+    return true;
+}
+
+void AP_ADSB_Index::deinit()
+{
+    free(_icao);
+    free(_distance);
+    free(_rank);
+    free(_order);
+    free(_buckets);
+    _icao = nullptr;
+    _distance = nullptr;
+    _rank = nullptr;
+    _order = nullptr;
+    _buckets = nullptr;
+    _max_slots = 0;
+    _count = 0;
+}
+
+void AP_ADSB_Index::clear()
+{
+    _count = 0;
+    if (_buckets != nullptr) {
+        memset(_buckets, 0xFF, (_bucket_mask + 1) * sizeof(uint16_t));
+    }
+}
+
+// multiplicative hash; ICAO addresses are often allocated in blocks
+// so the low bits alone are a poor hash
+uint16_t AP_ADSB_Index::bucket(uint32_t icao) const
+{
+    return (uint16_t)((icao * 2654435761U) >> _bucket_shift) & _bucket_mask;
+}
+
+bool AP_ADSB_Index::find(uint32_t icao, uint16_t &slot) const
+{
+    if (_buckets == nullptr) {
+        return false;
+    }
+    for (uint16_t b = bucket(icao); _buckets[b] != EMPTY; b = (b + 1) & _bucket_mask) {
+        if (_icao[_buckets[b]] == icao) {
+            slot = _buckets[b];
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t AP_ADSB_Index::add(uint32_t icao, float distance)
+{
+    const uint16_t slot = _count++;
+    _icao[slot] = icao;
+    _distance[slot] = distance;
+
+    uint16_t b = bucket(icao);
+    while (_buckets[b] != EMPTY) {
+        b = (b + 1) & _bucket_mask;
+    }
+    _buckets[b] = slot;
+
+    _order[slot] = slot;
+    _rank[slot] = slot;
+    sort_rank(slot);
+
+    return slot;
+}
+
+void AP_ADSB_Index::set_distance(uint16_t slot, float distance)
+{
+    _distance[slot] = distance;
+    sort_rank(_rank[slot]);
+}
+
+uint16_t AP_ADSB_Index::remove(uint16_t slot)
+{
+    // remove from the hash table, shifting back any following entries
+    // that would no longer be reachable across the gap
+    uint16_t b = bucket(_icao[slot]);
+    while (_buckets[b] != slot) {
+        b = (b + 1) & _bucket_mask;
+    }
+    uint16_t gap = b;
+    for (uint16_t next = (gap + 1) & _bucket_mask; _buckets[next] != EMPTY; next = (next + 1) & _bucket_mask) {
+        const uint16_t home = bucket(_icao[_buckets[next]]);
+        // the entry can fill the gap if its home bucket is not
+        // cyclically between the gap and its current position
+        if (((next - home) & _bucket_mask) >= ((next - gap) & _bucket_mask)) {
+            _buckets[gap] = _buckets[next];
+            gap = next;
+        }
+    }
+    _buckets[gap] = EMPTY;
+
+    // remove from the distance order
+    const uint16_t rank = _rank[slot];
+    for (uint16_t r = rank; r + 1 < _count; r++) {
+        _order[r] = _order[r + 1];
+        _rank[_order[r]] = r;
+    }
+
+    // move the last slot into the freed one
+    const uint16_t last = --_count;
+    if (last != slot) {
+        _icao[slot] = _icao[last];
+        _distance[slot] = _distance[last];
+        _rank[slot] = _rank[last];
+        _order[_rank[slot]] = slot;
+        b = bucket(_icao[slot]);
+        while (_buckets[b] != last) {
+            b = (b + 1) & _bucket_mask;
+        }
+        _buckets[b] = slot;
+    }
+    return last;
+}
+
+void AP_ADSB_Index::swap_ranks(uint16_t a, uint16_t b)
+{
+    const uint16_t slot_a = _order[a];
+    _order[a] = _order[b];
+    _order[b] = slot_a;
+    _rank[_order[a]] = a;
+    _rank[_order[b]] = b;
+}
+
+// move the slot at rank towards the nearer or further end until it
+// is in order
+void AP_ADSB_Index::sort_rank(uint16_t rank)
+{
+    while (rank > 0 && _distance[_order[rank - 1]] > _distance[_order[rank]]) {
+        swap_ranks(rank - 1, rank);
+        rank--;
+    }
+    while (rank + 1 < _count && _distance[_order[rank + 1]] < _distance[_order[rank]]) {
+        swap_ranks(rank, rank + 1);
+        rank++;
+    }
+}
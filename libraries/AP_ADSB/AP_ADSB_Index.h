@@ -0,0 +1,111 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  index over the slots of the ADS-B vehicle list.
+
+  Slots 0 to count()-1 are in use. Each slot is found from its ICAO
+  address through an open addressed hash table, and the slots are
+  also kept sorted by distance from our own position so the nearest
+  and furthest aircraft are available without scanning the list.
+
+  Distances change slowly between reports, so re-sorting a slot after
+  its distance is updated usually only moves it a place or two.
+
+  The index does not hold the vehicles themselves: when a slot is
+  removed the last slot is moved into its place and the caller must
+  move the vehicle data to match.
+ */
+
+#include <AP_Common/AP_Common.h>
+
+class AP_ADSB_Index
+{
+public:
+    AP_ADSB_Index() {}
+    ~AP_ADSB_Index() { deinit(); }
+
+    /* Do not allow copies */
+    AP_ADSB_Index(const AP_ADSB_Index &other) = delete;
+    AP_ADSB_Index &operator=(const AP_ADSB_Index&) = delete;
+
+    // allocate the index for up to max_slots vehicles. Returns false
+    // if the memory could not be allocated
+    bool init(uint16_t max_slots);
+
+    // free the index
+    void deinit();
+
+    // forget all slots
+    void clear();
+
+    uint16_t count() const { return _count; }
+    uint16_t max_slots() const { return _max_slots; }
+    bool full() const { return _count >= _max_slots; }
+
+    // find the slot holding an ICAO address
+    bool find(uint32_t icao, uint16_t &slot) const;
+
+    // add a vehicle in the next free slot and return the slot. Must
+    // not be called when full() or if icao is already present
+    uint16_t add(uint32_t icao, float distance);
+
+    // record a new distance for a slot
+    void set_distance(uint16_t slot, float distance);
+
+    // remove a slot. The last slot is moved into its place and its
+    // old number returned, so the caller should then move its vehicle
+    // from the returned slot to slot (they are equal if the removed
+    // slot was the last)
+    uint16_t remove(uint16_t slot);
+
+    // slot of the vehicle at rank in order of distance, 0 is the
+    // nearest. rank must be less than count()
+    uint16_t slot_by_distance(uint16_t rank) const { return _order[rank]; }
+
+    // slot and distance of the furthest vehicle. count() must be non-zero
+    uint16_t furthest() const { return _order[_count - 1]; }
+    float distance(uint16_t slot) const { return _distance[slot]; }
+
+private:
+
+    static const uint16_t EMPTY = UINT16_MAX;
+
+    // first hash table bucket to try for an address
+    uint16_t bucket(uint32_t icao) const;
+
+    // restore the distance order around one rank
+    void sort_rank(uint16_t rank);
+
+    // swap two adjacent ranks
+    void swap_ranks(uint16_t a, uint16_t b);
+
+    uint16_t _max_slots;
+    uint16_t _count;
+
+    // per slot
+    uint32_t *_icao = nullptr;
+    float *_distance = nullptr;
+    uint16_t *_rank = nullptr;      // position of the slot in _order
+
+    // slots ordered nearest first
+    uint16_t *_order = nullptr;
+
+    // linear probing hash table of slots, a power of two at least twice max_slots
+    uint16_t *_buckets = nullptr;
+    uint16_t _bucket_mask;
+    uint8_t _bucket_shift;
+};
@@ -0,0 +1,143 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_ADSB/AP_ADSB_Index.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+/*
+  traffic modelled on SIM_ADSB: aircraft spread normally over a 10km
+  radius, each reporting once a second. More aircraft are heard than
+  the list can hold, so the list is always full and new aircraft
+  compete with the furthest one for a slot
+ */
+#define TRAFFIC_COUNT   800
+#define LIST_SIZE       500
+#define TRAFFIC_RADIUS  10000.0f
+
+struct traffic_t {
+    uint32_t icao;
+    Vector2f position;
+    Vector2f velocity;
+};
+
+static traffic_t traffic[TRAFFIC_COUNT];
+
+static float rand_float()
+{
+    return ((rand() % 20001) - 10000) * 1.0e-4f;
+}
+
+static void setup_traffic()
+{
+    static bool done;
+    if (done) {
+        return;
+    }
+    srand(1);
+    for (uint16_t i = 0; i < TRAFFIC_COUNT; i++) {
+        traffic[i].icao = (uint32_t)(rand() % 0x1000000);
+        traffic[i].position = Vector2f(rand_float(), rand_float()) * TRAFFIC_RADIUS;
+        traffic[i].velocity = Vector2f(rand_float(), rand_float()) * 60.0f;
+    }
+    done = true;
+}
+
+// advance one aircraft by a one second reporting interval and return
+// its distance from the origin
+static float next_report(uint16_t i)
+{
+    traffic_t &t = traffic[i];
+    t.position += t.velocity;
+    if (t.position.length() > TRAFFIC_RADIUS) {
+        t.velocity = -t.velocity;
+    }
+    return t.position.length();
+}
+
+// the flat list search that AP_ADSB used before the index
+static void BM_ADSBLinearList(benchmark::State& state)
+{
+    setup_traffic();
+    static uint32_t icao[LIST_SIZE];
+    static float distance[LIST_SIZE];
+    uint16_t count = 0;
+    uint16_t i = 0;
+
+    while (state.KeepRunning()) {
+        const float d = next_report(i);
+        int16_t slot = -1;
+        for (uint16_t j = 0; j < count; j++) {
+            if (icao[j] == traffic[i].icao) {
+                slot = j;
+                break;
+            }
+        }
+        if (slot < 0 && count < LIST_SIZE) {
+            slot = count++;
+        } else if (slot < 0) {
+            uint16_t furthest = 0;
+            for (uint16_t j = 1; j < count; j++) {
+                if (distance[j] > distance[furthest]) {
+                    furthest = j;
+                }
+            }
+            if (d < distance[furthest]) {
+                slot = furthest;
+            }
+        }
+        if (slot >= 0) {
+            icao[slot] = traffic[i].icao;
+            distance[slot] = d;
+        }
+        gbenchmark_clobber();
+        i = (i + 1) % TRAFFIC_COUNT;
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+
+static void BM_ADSBIndex(benchmark::State& state)
+{
+    setup_traffic();
+    static AP_ADSB_Index index;
+    index.init(LIST_SIZE);
+    uint16_t i = 0;
+
+    while (state.KeepRunning()) {
+        const float d = next_report(i);
+        uint16_t slot;
+        if (index.find(traffic[i].icao, slot)) {
+            index.set_distance(slot, d);
+        } else if (!index.full()) {
+            index.add(traffic[i].icao, d);
+        } else if (d < index.distance(index.furthest())) {
+            index.remove(index.furthest());
+            index.add(traffic[i].icao, d);
+        }
+        gbenchmark_clobber();
+        i = (i + 1) % TRAFFIC_COUNT;
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+
+static void BM_ADSBIndexNearest(benchmark::State& state)
+{
+    setup_traffic();
+    static AP_ADSB_Index index;
+    index.init(LIST_SIZE);
+    for (uint16_t i = 0; i < LIST_SIZE; i++) {
+        index.add(traffic[i].icao, traffic[i].position.length());
+    }
+
+    while (state.KeepRunning()) {
+        uint16_t slot = index.slot_by_distance(0);
+        gbenchmark_escape(&slot);
+    }
+}
+
+BENCHMARK(BM_ADSBLinearList);
+BENCHMARK(BM_ADSBIndex);
+BENCHMARK(BM_ADSBIndexNearest);
+
+BENCHMARK_MAIN()
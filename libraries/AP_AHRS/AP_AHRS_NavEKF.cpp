@@ -19,11 +19,13 @@
  *
  */
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/Trace.h>
 #include "AP_AHRS.h"
 #include "AP_AHRS_View.h"
 #include <AP_Vehicle/AP_Vehicle.h>
 #include <GCS_MAVLink/GCS.h>
 #include <AP_Module/AP_Module.h>
+#include <AP_Scheduler/LatencyInfo.h>
 
 #if AP_AHRS_NAVEKF_AVAILABLE
 
@@ -127,6 +129,8 @@ void AP_AHRS_NavEKF::update(bool skip_ins_update)
         // update optional alternative attitude view
         _view->update(skip_ins_update);
     }
+
+    AP::latency().record(AP::LatencyInfo::STAGE_EKF, AP::ins().get_update_sample_us());
 }
 
 void AP_AHRS_NavEKF::update_DCM(bool skip_ins_update)
@@ -147,6 +151,8 @@ void AP_AHRS_NavEKF::update_DCM(bool skip_ins_update)
 
 void AP_AHRS_NavEKF::update_EKF2(void)
 {
+    TRACE_SPAN("EKF2");
+
     if (!_ekf2_started) {
         // wait 1 second for DCM to output a valid tilt error estimate
         if (start_time_ms == 0) {
@@ -220,6 +226,8 @@ void AP_AHRS_NavEKF::update_EKF2(void)
 
 void AP_AHRS_NavEKF::update_EKF3(void)
 {
+    TRACE_SPAN("EKF3");
+
     if (!_ekf3_started) {
         // wait 1 second for DCM to output a valid tilt error estimate
         if (start_time_ms == 0) {
@@ -4,6 +4,7 @@ extern const AP_HAL::HAL& hal;
 
 #include <limits>
 #include <GCS_MAVLink/GCS.h>
+#include <AP_Mission/AP_Mission.h>
 
 #define AVOIDANCE_DEBUGGING 0
 
@@ -75,14 +76,14 @@ const AP_Param::GroupInfo AP_Avoidance::var_info[] = {
 
     // @Param: W_TIME
     // @DisplayName: Time Horizon Warn
-    // @Description: Aircraft velocity vectors are multiplied by this time to determine closest approach.  If this results in an approach closer than W_DIST_XY or W_DIST_Z then W_ACTION is undertaken (assuming F_ACTION is not undertaken)
+    // @Description: Our planned path and the velocity vectors of other aircraft are projected forward by this time to determine closest approach.  If this results in an approach closer than W_DIST_XY or W_DIST_Z then W_ACTION is undertaken (assuming F_ACTION is not undertaken)
     // @Units: s
     // @User: Advanced
     AP_GROUPINFO("W_TIME",      6, AP_Avoidance, _warn_time_horizon, AP_AVOIDANCE_WARN_TIME_DEFAULT),
 
     // @Param: F_TIME
     // @DisplayName: Time Horizon Fail
-    // @Description: Aircraft velocity vectors are multiplied by this time to determine closest approach.  If this results in an approach closer than F_DIST_XY or F_DIST_Z then F_ACTION is undertaken
+    // @Description: Our planned path and the velocity vectors of other aircraft are projected forward by this time to determine closest approach.  If this results in an approach closer than F_DIST_XY or F_DIST_Z then F_ACTION is undertaken
     // @Units: s
     // @User: Advanced
     AP_GROUPINFO("F_TIME",      7, AP_Avoidance, _fail_time_horizon, AP_AVOIDANCE_FAIL_TIME_DEFAULT),
@@ -149,12 +150,22 @@ void AP_Avoidance::init(void)
             return;
         }
         _obstacles_allocated = _obstacles_max;
+        if (!_cpa.init(_obstacles_allocated)) {
+            hal.console->printf("Unable to initialize Avoidance obstacle list\n");
+            delete [] _obstacles;
+            _obstacles = nullptr;
+            _obstacles_allocated = 0;
+            _enabled.set(0);
+            return;
+        }
     }
     _obstacle_count = 0;
     _last_state_change_ms = 0;
     _threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
     _gcs_cleared_messages_first_sent = std::numeric_limits<uint32_t>::max();
     _current_most_serious_threat = -1;
+    _path_nav_index = AP_MISSION_CMD_INDEX_NONE;
+    _path_next_valid = false;
 }
 
 /*
@@ -166,6 +177,7 @@ void AP_Avoidance::deinit(void)
         delete [] _obstacles;
         _obstacles = nullptr;
         _obstacles_allocated = 0;
+        _cpa.deinit();
         handle_recovery(AP_AVOIDANCE_RECOVERY_RTL);
     }
     _obstacle_count = 0;
@@ -234,6 +246,8 @@ void AP_Avoidance::add_obstacle(const uint32_t obstacle_timestamp_ms,
     _obstacles[index]._location = loc;
     _obstacles[index]._velocity = vel_ned;
     _obstacles[index].timestamp_ms = obstacle_timestamp_ms;
+
+    _cpa.set_obstacle(index, loc, vel_ned, obstacle_timestamp_ms);
 }
 
 void AP_Avoidance::add_obstacle(const uint32_t obstacle_timestamp_ms,
@@ -274,88 +288,109 @@ void AP_Avoidance::get_adsb_samples()
     }
 }
 
-float closest_approach_xy(const Location &my_loc,
-                          const Vector3f &my_vel,
-                          const Location &obstacle_loc,
-                          const Vector3f &obstacle_vel,
-                          const uint8_t time_horizon)
+/*
+  work out the path we expect to fly over the time horizons. When a
+  mission is running and we are heading for its waypoint this follows
+  the current leg and then the next leg at our current ground speed,
+  otherwise we assume our current velocity is held
+ */
+void AP_Avoidance::update_planned_path(const Location &my_loc, const Vector3f &my_vel)
 {
+    Vector3f velocity[AP_AVOIDANCE_CPA_LEGS_MAX];
+    float duration[AP_AVOIDANCE_CPA_LEGS_MAX];
+    uint8_t num_legs = 0;
+
+    AP_Mission *mission = AP::mission();
+    const float speed = norm(my_vel.x, my_vel.y);
+    if (mission != nullptr &&
+        mission->state() == AP_Mission::MISSION_RUNNING &&
+        speed > _low_velocity_threshold) {
+        const AP_Mission::Mission_Command &cmd = mission->get_current_nav_cmd();
+        const Location &dest = cmd.content.location;
+        if (dest.lat != 0 || dest.lng != 0) {
+            if (cmd.index != _path_nav_index) {
+                // reading the following command may touch storage, so
+                // only do it when the current command changes
+                AP_Mission::Mission_Command next_cmd;
+                _path_nav_index = cmd.index;
+                _path_next_valid = mission->get_next_nav_cmd(cmd.index + 1, next_cmd) &&
+                    (next_cmd.content.location.lat != 0 || next_cmd.content.location.lng != 0);
+                _path_next_loc = next_cmd.content.location;
+            }
+            // only trust the mission if we are actually heading for
+            // the waypoint, within 60 degrees
+            if (planned_leg(my_loc, dest, speed, velocity[0], duration[0]) &&
+                velocity[0].x * my_vel.x + velocity[0].y * my_vel.y > 0.5f * speed * speed) {
+                num_legs++;
+                if (_path_next_valid &&
+                    planned_leg(dest, _path_next_loc, speed, velocity[1], duration[1])) {
+                    num_legs++;
+                }
+            }
+        }
+    }
 
-    Vector2f delta_vel_ne = Vector2f(obstacle_vel[0] - my_vel[0], obstacle_vel[1] - my_vel[1]);
-    Vector2f delta_pos_ne = location_diff(obstacle_loc, my_loc);
-
-    Vector2f line_segment_ne = delta_vel_ne * time_horizon;
-
-    float ret = Vector2<float>::closest_distance_between_radial_and_point
-        (line_segment_ne,
-         delta_pos_ne);
-
-    debug("   time_horizon: (%d)", time_horizon);
-    debug("   delta pos: (y=%f,x=%f)", delta_pos_ne[0], delta_pos_ne[1]);
-    debug("   delta vel: (y=%f,x=%f)", delta_vel_ne[0], delta_vel_ne[1]);
-    debug("   line segment: (y=%f,x=%f)", line_segment_ne[0], line_segment_ne[1]);
-    debug("   closest: (%f)", ret);
+    if (num_legs == 0) {
+        velocity[0] = my_vel;
+        duration[0] = 0.0f;
+        num_legs = 1;
+    }
 
-    return ret;
+    // obstacles may be added from another thread while the path moves
+    WITH_SEMAPHORE(_rsem);
+    if (_cpa.set_path(my_loc, AP_HAL::millis(), velocity, duration, num_legs)) {
+        // obstacles are held relative to the start of the path
+        for (uint8_t i=0; i<_obstacle_count; i++) {
+            const AP_Avoidance::Obstacle &obstacle = _obstacles[i];
+            _cpa.set_obstacle(i, obstacle._location, obstacle._velocity, obstacle.timestamp_ms);
+        }
+    }
 }
 
-// returns the closest these objects will get in the body z axis (in metres)
-float closest_approach_z(const Location &my_loc,
-                         const Vector3f &my_vel,
-                         const Location &obstacle_loc,
-                         const Vector3f &obstacle_vel,
-                         const uint8_t time_horizon)
+bool AP_Avoidance::planned_leg(const Location &from, const Location &to, const float speed, Vector3f &velocity, float &duration)
 {
-
-    float delta_vel_d = obstacle_vel[2] - my_vel[2];
-    float delta_pos_d = obstacle_loc.alt - my_loc.alt;
-
-    float ret;
-    if (delta_pos_d >= 0 && delta_vel_d >= 0) {
-        ret = delta_pos_d;
-    } else if (delta_pos_d <= 0 && delta_vel_d <= 0) {
-        ret = fabsf(delta_pos_d);
-    } else {
-        ret = fabsf(delta_pos_d - delta_vel_d * time_horizon);
+    const Vector2f ne = location_diff(from, to);
+    const float distance = ne.length();
+    if (distance < 1.0f || !is_positive(speed)) {
+        return false;
     }
+    duration = distance / speed;
 
-    debug("   time_horizon: (%d)", time_horizon);
-    debug("   delta pos: (%f) metres", delta_pos_d/100.0f);
-    debug("   delta vel: (%f) m/s", delta_vel_d);
-    debug("   closest: (%f) metres", ret/100.0f);
-
-    return ret/100.0f;
+    // hold our altitude if either end is in a frame we can't convert
+    float vel_d = 0.0f;
+    int32_t from_alt_cm, to_alt_cm;
+    if (Location_Class(from).get_alt_cm(Location_Class::ALT_FRAME_ABSOLUTE, from_alt_cm) &&
+        Location_Class(to).get_alt_cm(Location_Class::ALT_FRAME_ABSOLUTE, to_alt_cm)) {
+        vel_d = (from_alt_cm - to_alt_cm) * 0.01f / duration;
+    }
+    velocity = Vector3f(ne.x / duration, ne.y / duration, vel_d);
+    return true;
 }
 
-void AP_Avoidance::update_threat_level(const Location &my_loc,
-                                       const Vector3f &my_vel,
-                                       AP_Avoidance::Obstacle &obstacle)
+void AP_Avoidance::update_threat_level(const uint8_t i, const uint32_t now)
 {
-
-    Location &obstacle_loc = obstacle._location;
-    Vector3f &obstacle_vel = obstacle._velocity;
+    AP_Avoidance::Obstacle &obstacle = _obstacles[i];
+    const AP_Avoidance_CPA::Approach &fail = _cpa.fail(i);
+    const AP_Avoidance_CPA::Approach &warn = _cpa.warn(i);
 
     obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
 
-    const uint32_t obstacle_age = AP_HAL::millis() - obstacle.timestamp_ms;
-    float closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _fail_time_horizon + obstacle_age/1000);
-    if (closest_xy < _fail_distance_xy) {
+    const AP_Avoidance_CPA::Approach *closest_xy = &warn;
+    if (fail.closest_xy < _fail_distance_xy) {
         obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_HIGH;
-    } else {
-        closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _warn_time_horizon + obstacle_age/1000);
-        if (closest_xy < _warn_distance_xy) {
-            obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
-        }
+        closest_xy = &fail;
+    } else if (warn.closest_xy < _warn_distance_xy) {
+        obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
     }
 
     // check for vertical separation; our threat level is the minimum
     // of vertical and horizontal threat levels
-    float closest_z = closest_approach_z(my_loc, my_vel, obstacle_loc, obstacle_vel, _warn_time_horizon + obstacle_age/1000);
+    float closest_z = warn.closest_z;
     if (obstacle.threat_level != MAV_COLLISION_THREAT_LEVEL_NONE) {
         if (closest_z > _warn_distance_z) {
             obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
         } else {
-            closest_z = closest_approach_z(my_loc, my_vel, obstacle_loc, obstacle_vel, _fail_time_horizon + obstacle_age/1000);
+            closest_z = fail.closest_z;
             if (closest_z > _fail_distance_z) {
                 obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
             }
@@ -363,22 +398,15 @@ void AP_Avoidance::update_threat_level(const Location &my_loc,
     }
 
     // If we haven't heard from a vehicle then assume it is no threat
+    const uint32_t obstacle_age = now - obstacle.timestamp_ms;
     if (obstacle_age > MAX_OBSTACLE_AGE_MS) {
         obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
     }
 
-    // could optimise this to not calculate a lot of this if threat
-    // level is none - but only *once the GCS has been informed*!
-    obstacle.closest_approach_xy = closest_xy;
+    obstacle.closest_approach_xy = closest_xy->closest_xy;
     obstacle.closest_approach_z = closest_z;
-    float current_distance = get_distance(my_loc, obstacle_loc);
-    obstacle.distance_to_closest_approach = current_distance - closest_xy;
-    Vector2f net_velocity_ne = Vector2f(my_vel[0] - obstacle_vel[0], my_vel[1] - obstacle_vel[1]);
-    obstacle.time_to_closest_approach = 0.0f;
-    if (!is_zero(obstacle.distance_to_closest_approach) &&
-        ! is_zero(net_velocity_ne.length())) {
-        obstacle.time_to_closest_approach = obstacle.distance_to_closest_approach / net_velocity_ne.length();
-    }
+    obstacle.distance_to_closest_approach = MAX(_cpa.distance(i) - closest_xy->closest_xy, 0.0f);
+    obstacle.time_to_closest_approach = MAX((int32_t)(closest_xy->closest_ms - now), 0) * 0.001f;
 }
 
 MAV_COLLISION_THREAT_LEVEL AP_Avoidance::current_threat_level() const {
@@ -450,17 +478,24 @@ void AP_Avoidance::check_for_threats()
         return;
     }
 
-    // we always check all obstacles to see if they are threats since it
-    // is most likely our own position and/or velocity have changed
+    // only obstacles which have moved since they were last evaluated
+    // against our planned path are recalculated, unless we have
+    // strayed from the path
+    update_planned_path(my_loc, my_vel);
+
+    WITH_SEMAPHORE(_rsem);
+    const uint32_t now = AP_HAL::millis();
+    _cpa.update(_obstacle_count, now, _fail_time_horizon, _warn_time_horizon);
+
     // determine the current most-serious-threat
     _current_most_serious_threat = -1;
     for (uint8_t i=0; i<_obstacle_count; i++) {
 
         AP_Avoidance::Obstacle &obstacle = _obstacles[i];
-        const uint32_t obstacle_age = AP_HAL::millis() - obstacle.timestamp_ms;
+        const uint32_t obstacle_age = now - obstacle.timestamp_ms;
         debug("i=%d src_id=%d timestamp=%u age=%d", i, obstacle.src_id, obstacle.timestamp_ms, obstacle_age);
 
-        update_threat_level(my_loc, my_vel, obstacle);
+        update_threat_level(i, now);
         debug("   threat-level=%d", obstacle.threat_level);
 
         // ignore any really old data:
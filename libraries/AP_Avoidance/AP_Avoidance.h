@@ -28,6 +28,7 @@
 #include <AP_AHRS/AP_AHRS.h>
 #include <AP_ADSB/AP_ADSB.h>
 #include <AP_Common/Semaphore.h>
+#include "AP_Avoidance_CPA.h"
 
 // F_RCVRY possible parameter values
 #define AP_AVOIDANCE_RECOVERY_REMAIN_IN_AVOID_ADSB                  0
@@ -160,9 +161,14 @@ private:
     uint32_t src_id_for_adsb_vehicle(AP_ADSB::adsb_vehicle_t vehicle) const;
 
     void check_for_threats();
-    void update_threat_level(const Location &my_loc,
-                             const Vector3f &my_vel,
-                             AP_Avoidance::Obstacle &obstacle);
+    void update_threat_level(uint8_t i, uint32_t now);
+
+    // work out the path we expect to fly, along the current mission
+    // leg if a mission is running, and pass it to the CPA engine
+    void update_planned_path(const Location &my_loc, const Vector3f &my_vel);
+
+    // velocity and duration of a leg flown at speed between two locations
+    static bool planned_leg(const Location &from, const Location &to, float speed, Vector3f &velocity, float &duration);
 
     // calls into the AP_ADSB library to retrieve vehicle data
     void get_adsb_samples();
@@ -176,6 +182,14 @@ private:
     uint8_t _obstacles_allocated;
     uint8_t _obstacle_count;
     int8_t _current_most_serious_threat;
+
+    // closest approach of each obstacle to our planned path
+    AP_Avoidance_CPA _cpa;
+
+    // the mission waypoint after the current one
+    uint16_t _path_nav_index;
+    bool _path_next_valid;
+    Location _path_next_loc;
     MAV_COLLISION_ACTION _latest_action = MAV_COLLISION_ACTION_NONE;
 
     // external references
@@ -203,14 +217,3 @@ private:
 
 float closest_distance_between_radial_and_point(const Vector2f &w,
                                                 const Vector2f &p);
-float closest_approach_xy(const Location &my_loc,
-                          const Vector3f &my_vel,
-                          const Location &obstacle_loc,
-                          const Vector3f &obstacle_vel,
-                          uint8_t time_horizon);
-
-float closest_approach_z(const Location &my_loc,
-                         const Vector3f &my_vel,
-                         const Location &obstacle_loc,
-                         const Vector3f &obstacle_vel,
-                         uint8_t time_horizon);
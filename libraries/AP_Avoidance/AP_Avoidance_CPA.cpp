@@ -0,0 +1,258 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include "AP_Avoidance_CPA.h"
+
+bool AP_Avoidance_CPA::init(uint8_t max_obstacles)
+{
+    deinit();
+
+    if (max_obstacles == 0) {
+        return false;
+    }
+
+    _state = (float *)calloc(6 * max_obstacles, sizeof(float));
+    _fail = (Approach *)calloc(max_obstacles, sizeof(Approach));
+    _warn = (Approach *)calloc(max_obstacles, sizeof(Approach));
+    _distance = (float *)calloc(max_obstacles, sizeof(float));
+    _eval_ms = (uint32_t *)calloc(max_obstacles, sizeof(uint32_t));
+    _moved = (bool *)calloc(max_obstacles, sizeof(bool));
+    _batch = (uint8_t *)calloc(max_obstacles, sizeof(uint8_t));
+    if (_state == nullptr || _fail == nullptr || _warn == nullptr || _distance == nullptr ||
+        _eval_ms == nullptr || _moved == nullptr || _batch == nullptr) {
+        deinit();
+        return false;
+    }
+
+    _pos_n = &_state[0 * max_obstacles];
+    _pos_e = &_state[1 * max_obstacles];
+    _pos_d = &_state[2 * max_obstacles];
+    _vel_n = &_state[3 * max_obstacles];
+    _vel_e = &_state[4 * max_obstacles];
+    _vel_d = &_state[5 * max_obstacles];
+
+    _max_obstacles = max_obstacles;
+    _have_path = false;
+    return true;
+}
+
+void AP_Avoidance_CPA::deinit()
+{
+    free(_state);
+    free(_fail);
+    free(_warn);
+    free(_distance);
+    free(_eval_ms);
+    free(_moved);
+    free(_batch);
+    _state = nullptr;
+    _fail = nullptr;
+    _warn = nullptr;
+    _distance = nullptr;
+    _eval_ms = nullptr;
+    _moved = nullptr;
+    _batch = nullptr;
+    _max_obstacles = 0;
+    _have_path = false;
+}
+
+uint8_t AP_Avoidance_CPA::path_leg(float t) const
+{
+    uint8_t leg = 0;
+    while (leg + 1 < _num_legs && t >= _leg_duration[leg]) {
+        t -= _leg_duration[leg];
+        leg++;
+    }
+    return leg;
+}
+
+Vector3f AP_Avoidance_CPA::path_position(float t) const
+{
+    Vector3f pos;
+    uint8_t leg = 0;
+    while (leg + 1 < _num_legs && t >= _leg_duration[leg]) {
+        pos += _leg_velocity[leg] * _leg_duration[leg];
+        t -= _leg_duration[leg];
+        leg++;
+    }
+    return pos + _leg_velocity[leg] * t;
+}
+
+bool AP_Avoidance_CPA::set_path(const Location &loc, uint32_t now_ms, const Vector3f *velocity, const float *duration, uint8_t num_legs)
+{
+    if (_state == nullptr || num_legs == 0) {
+        return false;
+    }
+    num_legs = MIN(num_legs, AP_AVOIDANCE_CPA_LEGS_MAX);
+
+    bool replan = !_have_path || (now_ms - _origin_ms) > AP_AVOIDANCE_CPA_PATH_MAX_AGE_MS;
+    if (!replan) {
+        // we must be where the current path says we should be
+        const float t = (now_ms - _origin_ms) * 0.001f;
+        const Vector2f ne = location_diff(_origin, loc);
+        const Vector3f pos(ne.x, ne.y, (_origin.alt - loc.alt) * 0.01f);
+        replan = (path_position(t) - pos).length() > AP_AVOIDANCE_CPA_POSITION_TOLERANCE;
+
+        // and the legs still ahead of us must be flown the same way
+        const uint8_t leg = path_leg(t);
+        if (leg + num_legs != _num_legs) {
+            replan = true;
+        }
+        for (uint8_t i = 0; i < num_legs && !replan; i++) {
+            replan = (velocity[i] - _leg_velocity[leg + i]).length() > AP_AVOIDANCE_CPA_VELOCITY_TOLERANCE;
+        }
+    }
+    if (!replan) {
+        return false;
+    }
+
+    _origin = loc;
+    _origin_ms = now_ms;
+    _num_legs = num_legs;
+    for (uint8_t i = 0; i < num_legs; i++) {
+        _leg_velocity[i] = velocity[i];
+        _leg_duration[i] = duration[i];
+    }
+    _have_path = true;
+
+    // every obstacle is now relative to a new origin
+    for (uint8_t i = 0; i < _max_obstacles; i++) {
+        _moved[i] = true;
+    }
+    return true;
+}
+
+void AP_Avoidance_CPA::set_obstacle(uint8_t i, const Location &loc, const Vector3f &vel_ned, uint32_t timestamp_ms)
+{
+    if (i >= _max_obstacles) {
+        return;
+    }
+    _moved[i] = true;
+    if (!_have_path) {
+        // filled in when the first path is set
+        return;
+    }
+
+    // move the obstacle forward (or back) to where it is expected to
+    // be at the start of our path
+    const float dt = (int32_t)(_origin_ms - timestamp_ms) * 0.001f;
+    const Vector2f ne = location_diff(_origin, loc);
+    _pos_n[i] = ne.x + vel_ned.x * dt;
+    _pos_e[i] = ne.y + vel_ned.y * dt;
+    _pos_d[i] = (_origin.alt - loc.alt) * 0.01f + vel_ned.z * dt;
+    _vel_n[i] = vel_ned.x;
+    _vel_e[i] = vel_ned.y;
+    _vel_d[i] = vel_ned.z;
+}
+
+/*
+  on each leg the obstacle position relative to us is r + v*t for
+  t from 0 to the length of the part of the leg inside the horizon,
+  so the closest horizontal approach is at t = -(r.v)/(v.v) clamped
+  to that range, and the closest vertical approach is zero if the
+  relative altitude changes sign or else at one end
+ */
+void AP_Avoidance_CPA::evaluate(uint8_t num, float t_start, float t_end, Approach *result) const
+{
+    // closest_xy holds the squared distance until the end
+    for (uint8_t k = 0; k < num; k++) {
+        Approach &r = result[_batch[k]];
+        r.closest_xy = FLT_MAX;
+        r.closest_z = FLT_MAX;
+    }
+
+    Vector3f leg_pos;
+    float leg_start = 0.0f;
+    for (uint8_t leg = 0; leg < _num_legs && leg_start < t_end; leg++) {
+        const bool last = (leg + 1 == _num_legs);
+        const float leg_end = last ? t_end : leg_start + _leg_duration[leg];
+        const float s0 = MAX(t_start, leg_start);
+        const float s1 = MIN(t_end, leg_end);
+        if (s1 > s0) {
+            const Vector3f &own_vel = _leg_velocity[leg];
+            const Vector3f own_pos = leg_pos + own_vel * (s0 - leg_start);
+            const float span = s1 - s0;
+            for (uint8_t k = 0; k < num; k++) {
+                const uint8_t i = _batch[k];
+                const float rn = _pos_n[i] + _vel_n[i] * s0 - own_pos.x;
+                const float re = _pos_e[i] + _vel_e[i] * s0 - own_pos.y;
+                const float rd = _pos_d[i] + _vel_d[i] * s0 - own_pos.z;
+                const float vn = _vel_n[i] - own_vel.x;
+                const float ve = _vel_e[i] - own_vel.y;
+                const float vd = _vel_d[i] - own_vel.z;
+
+                const float v_sq = vn * vn + ve * ve;
+                float t = 0.0f;
+                if (v_sq > 0.0f) {
+                    t = constrain_float(-(rn * vn + re * ve) / v_sq, 0.0f, span);
+                }
+                const float cn = rn + vn * t;
+                const float ce = re + ve * t;
+                const float xy_sq = cn * cn + ce * ce;
+                if (xy_sq < result[i].closest_xy) {
+                    result[i].closest_xy = xy_sq;
+                    result[i].closest_ms = _origin_ms + (uint32_t)((s0 + t) * 1000.0f);
+                }
+
+                const float rd_end = rd + vd * span;
+                const float z = (rd * rd_end <= 0.0f) ? 0.0f : MIN(fabsf(rd), fabsf(rd_end));
+                result[i].closest_z = MIN(result[i].closest_z, z);
+            }
+        }
+        if (!last) {
+            leg_pos += _leg_velocity[leg] * _leg_duration[leg];
+            leg_start = leg_end;
+        }
+    }
+
+    for (uint8_t k = 0; k < num; k++) {
+        Approach &r = result[_batch[k]];
+        r.closest_xy = sqrtf(r.closest_xy);
+    }
+}
+
+uint8_t AP_Avoidance_CPA::update(uint8_t count, uint32_t now_ms, float fail_horizon, float warn_horizon)
+{
+    if (!_have_path) {
+        return 0;
+    }
+    count = MIN(count, _max_obstacles);
+
+    uint8_t num = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (_moved[i] || (now_ms - _eval_ms[i]) >= AP_AVOIDANCE_CPA_RESULT_MAX_AGE_MS) {
+            _batch[num++] = i;
+        }
+    }
+    if (num == 0) {
+        return 0;
+    }
+
+    const float t_now = (now_ms - _origin_ms) * 0.001f;
+    evaluate(num, t_now, t_now + fail_horizon, _fail);
+    evaluate(num, t_now, t_now + warn_horizon, _warn);
+
+    const Vector3f own_pos = path_position(t_now);
+    for (uint8_t k = 0; k < num; k++) {
+        const uint8_t i = _batch[k];
+        _distance[i] = norm(_pos_n[i] + _vel_n[i] * t_now - own_pos.x,
+                            _pos_e[i] + _vel_e[i] * t_now - own_pos.y);
+        _eval_ms[i] = now_ms;
+        _moved[i] = false;
+    }
+    return num;
+}
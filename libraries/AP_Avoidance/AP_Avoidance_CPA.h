@@ -0,0 +1,126 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  closest point of approach between our own planned path and a set of
+  obstacles.
+
+  Our path is a series of legs, each flown at a constant NED velocity
+  for a duration, with the last leg held indefinitely. Obstacles move
+  in straight lines from their last reported position. Both are held
+  in metres relative to the position we were at when the path was
+  planned, so on each leg the separation from every obstacle changes
+  linearly and its closest approach is found analytically.
+
+  Obstacle state is held as separate arrays so a batch of obstacles is
+  evaluated leg by leg in one tight loop. Results are cached: an
+  obstacle is only re-evaluated when it reports a new position, its
+  result becomes stale, or we stray from the planned path.
+ */
+
+#include <AP_Common/AP_Common.h>
+#include <AP_Math/AP_Math.h>
+
+#define AP_AVOIDANCE_CPA_LEGS_MAX               2       // legs of our own path considered
+#define AP_AVOIDANCE_CPA_POSITION_TOLERANCE     5.0f    // metres from the planned path before it is replanned
+#define AP_AVOIDANCE_CPA_VELOCITY_TOLERANCE     1.0f    // m/s difference from the planned path before it is replanned
+#define AP_AVOIDANCE_CPA_PATH_MAX_AGE_MS        5000    // path is replanned at least this often
+#define AP_AVOIDANCE_CPA_RESULT_MAX_AGE_MS      1000    // obstacles are re-evaluated at least this often
+
+class AP_Avoidance_CPA
+{
+public:
+    AP_Avoidance_CPA() {}
+    ~AP_Avoidance_CPA() { deinit(); }
+
+    /* Do not allow copies */
+    AP_Avoidance_CPA(const AP_Avoidance_CPA &other) = delete;
+    AP_Avoidance_CPA &operator=(const AP_Avoidance_CPA&) = delete;
+
+    // closest approach to an obstacle within a time horizon
+    struct Approach {
+        float closest_xy;       // metres
+        float closest_z;        // metres
+        uint32_t closest_ms;    // system time of the closest horizontal approach
+    };
+
+    // allocate space for up to max_obstacles. Returns false if the
+    // memory could not be allocated
+    bool init(uint8_t max_obstacles);
+
+    // free all memory
+    void deinit();
+
+    // offer our current planned path starting from loc at now_ms. The
+    // path is only replaced if it differs from the one obstacles were
+    // last evaluated against. Returns true if it was replaced, in which
+    // case every obstacle must be given again with set_obstacle()
+    bool set_path(const Location &loc, uint32_t now_ms, const Vector3f *velocity, const float *duration, uint8_t num_legs);
+
+    // record the latest report of an obstacle
+    void set_obstacle(uint8_t i, const Location &loc, const Vector3f &vel_ned, uint32_t timestamp_ms);
+
+    // evaluate obstacles 0 to count-1 which need it against both time
+    // horizons. Returns the number evaluated
+    uint8_t update(uint8_t count, uint32_t now_ms, float fail_horizon, float warn_horizon);
+
+    // results of the last evaluation of an obstacle
+    const Approach &fail(uint8_t i) const { return _fail[i]; }
+    const Approach &warn(uint8_t i) const { return _warn[i]; }
+
+    // horizontal distance to an obstacle when it was last evaluated
+    float distance(uint8_t i) const { return _distance[i]; }
+
+private:
+
+    // our planned position at time t seconds after the start of the
+    // path, and the leg we are on at that time
+    Vector3f path_position(float t) const;
+    uint8_t path_leg(float t) const;
+
+    // find the closest approach of a batch of obstacles between path
+    // times t_start and t_end
+    void evaluate(uint8_t num, float t_start, float t_end, Approach *result) const;
+
+    uint8_t _max_obstacles;
+
+    // obstacle position at the start of the path and velocity, NED metres
+    float *_state = nullptr;
+    float *_pos_n;
+    float *_pos_e;
+    float *_pos_d;
+    float *_vel_n;
+    float *_vel_e;
+    float *_vel_d;
+
+    // cached results
+    Approach *_fail = nullptr;
+    Approach *_warn = nullptr;
+    float *_distance = nullptr;
+    uint32_t *_eval_ms = nullptr;
+    bool *_moved = nullptr;
+
+    // obstacles being evaluated
+    uint8_t *_batch = nullptr;
+
+    // our planned path
+    bool _have_path;
+    Location _origin;
+    uint32_t _origin_ms;
+    uint8_t _num_legs;
+    Vector3f _leg_velocity[AP_AVOIDANCE_CPA_LEGS_MAX];
+    float _leg_duration[AP_AVOIDANCE_CPA_LEGS_MAX];
+};
@@ -142,6 +142,10 @@ void CompassCalibrator::update_completion_mask(const Vector3f& v)
 void CompassCalibrator::update_completion_mask()
 {
     memset(_completion_mask, 0, sizeof(_completion_mask));
+    _completion_mask_dirty = false;
+    if (_sample_buffer == nullptr) {
+        return;
+    }
     for (int i = 0; i < _samples_collected; i++) {
         update_completion_mask(_sample_buffer[i].get());
     }
@@ -149,6 +153,9 @@ void CompassCalibrator::update_completion_mask()
 
 CompassCalibrator::completion_mask_t& CompassCalibrator::get_completion_mask()
 {
+    if (_completion_mask_dirty) {
+        update_completion_mask();
+    }
     return _completion_mask;
 }
 
@@ -170,7 +177,12 @@ void CompassCalibrator::new_sample(const Vector3f& sample) {
     }
 
     if(running() && _samples_collected < COMPASS_CAL_NUM_SAMPLES && accept_sample(sample)) {
-        update_completion_mask(sample);
+        if (!_completion_mask_dirty) {
+            update_completion_mask(sample);
+        }
+        if (_status == COMPASS_CAL_RUNNING_STEP_ONE) {
+            accumulate_sphere_sums(sample);
+        }
         _sample_buffer[_samples_collected].set(sample);
         _sample_buffer[_samples_collected].att.set_from_ahrs();
         _samples_collected++;
@@ -249,6 +261,9 @@ void CompassCalibrator::reset_state() {
     _params.offdiag.zero();
 
     memset(_completion_mask, 0, sizeof(_completion_mask));
+    _completion_mask_dirty = false;
+    memset(_sphere_ATA, 0, sizeof(_sphere_ATA));
+    memset(_sphere_ATb, 0, sizeof(_sphere_ATb));
     initialize_fit();
 }
 
@@ -390,7 +405,7 @@ void CompassCalibrator::thin_samples() {
         }
     }
 
-    update_completion_mask();
+    invalidate_completion_mask();
 }
 
 /*
@@ -419,11 +434,12 @@ bool CompassCalibrator::accept_sample(const Vector3f& sample)
         return false;
     }
 
-    float min_distance = _params.radius * 2*sinf(theta/2);
+    // compare squared distances to keep the per-sample scan free of square roots
+    const float min_distance_sq = sq(_params.radius * 2*sinf(theta/2));
 
     for (uint16_t i = 0; i<_samples_collected; i++){
-        float distance = (sample - _sample_buffer[i].get()).length();
-        if(distance < min_distance) {
+        float distance_sq = (sample - _sample_buffer[i].get()).length_squared();
+        if(distance_sq < min_distance_sq) {
             return false;
         }
     }
@@ -463,20 +479,42 @@ float CompassCalibrator::calc_mean_squared_residuals(const param_t& params) cons
     return sum;
 }
 
+void CompassCalibrator::calc_mean_squared_residuals(const param_t& params1, const param_t& params2, float &fit1, float &fit2) const
+{
+    if(_sample_buffer == nullptr || _samples_collected == 0) {
+        fit1 = fit2 = 1.0e30f;
+        return;
+    }
+    const Matrix3f softiron1(
+        params1.diag.x    , params1.offdiag.x , params1.offdiag.y,
+        params1.offdiag.x , params1.diag.y    , params1.offdiag.z,
+        params1.offdiag.y , params1.offdiag.z , params1.diag.z
+    );
+    const Matrix3f softiron2(
+        params2.diag.x    , params2.offdiag.x , params2.offdiag.y,
+        params2.offdiag.x , params2.diag.y    , params2.offdiag.z,
+        params2.offdiag.y , params2.offdiag.z , params2.diag.z
+    );
+    float sum1 = 0.0f;
+    float sum2 = 0.0f;
+    for(uint16_t i=0; i < _samples_collected; i++){
+        const Vector3f sample = _sample_buffer[i].get();
+        sum1 += sq(params1.radius - (softiron1*(sample+params1.offset)).length());
+        sum2 += sq(params2.radius - (softiron2*(sample+params2.offset)).length());
+    }
+    fit1 = sum1 / _samples_collected;
+    fit2 = sum2 / _samples_collected;
+}
+
 void CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const{
     const Vector3f &offset = params.offset;
     const Vector3f &diag = params.diag;
     const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
 
     float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
     float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
     float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
+    float length = norm(A, B, C);
 
     // 0: partial derivative (radius wrt fitness fn) fn operated on sample
     ret[0] = 1.0f;
@@ -486,14 +524,55 @@ void CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t&
     ret[3] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
 }
 
+/*
+  A sample x on a sphere with centre c and radius r satisfies
+      |x|^2 = 2*c.x + (r^2 - |c|^2)
+  which is linear in (c, r^2 - |c|^2), so the least-squares sphere can
+  be found from sums accumulated as the samples arrive.
+ */
+void CompassCalibrator::accumulate_sphere_sums(const Vector3f& sample)
+{
+    const float row[COMPASS_CAL_NUM_SPHERE_PARAMS] = { 2*sample.x, 2*sample.y, 2*sample.z, 1.0f };
+    const float b = sample.length_squared();
+    for(uint8_t i = 0; i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
+        for(uint8_t j = 0; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
+            _sphere_ATA[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += row[i] * row[j];
+        }
+        _sphere_ATb[i] += row[i] * b;
+    }
+}
+
 void CompassCalibrator::calc_initial_offset()
 {
-    // Set initial offset to the average value of the samples
-    _params.offset.zero();
-    for(uint16_t k = 0; k<_samples_collected; k++) {
-        _params.offset -= _sample_buffer[k].get();
+    if (_samples_collected == 0) {
+        return;
     }
-    _params.offset /= _samples_collected;
+
+    // the average value of the samples is the fallback if the
+    // algebraic fit is ill-conditioned
+    const float n = _sphere_ATA[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS-1];
+    if (is_positive(n)) {
+        _params.offset = -Vector3f(_sphere_ATA[12], _sphere_ATA[13], _sphere_ATA[14]) / (2*n);
+    }
+
+    float ATA_inv[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS];
+    if (!inverse(_sphere_ATA, ATA_inv, COMPASS_CAL_NUM_SPHERE_PARAMS)) {
+        return;
+    }
+    float sol[COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
+    for(uint8_t row = 0; row < COMPASS_CAL_NUM_SPHERE_PARAMS; row++) {
+        for(uint8_t col = 0; col < COMPASS_CAL_NUM_SPHERE_PARAMS; col++) {
+            sol[row] += ATA_inv[row*COMPASS_CAL_NUM_SPHERE_PARAMS+col] * _sphere_ATb[col];
+        }
+    }
+    const Vector3f centre(sol[0], sol[1], sol[2]);
+    const float radius_sq = sol[3] + centre.length_squared();
+    if (isnan(radius_sq) || !is_positive(radius_sq) ||
+        fabsf(centre.x) > _offset_max || fabsf(centre.y) > _offset_max || fabsf(centre.z) > _offset_max) {
+        return;
+    }
+    _params.offset = -centre;
+    _params.radius = sqrtf(radius_sq);
 }
 
 void CompassCalibrator::run_sphere_fit()
@@ -520,17 +599,25 @@ void CompassCalibrator::run_sphere_fit()
         float sphere_jacob[COMPASS_CAL_NUM_SPHERE_PARAMS];
 
         calc_sphere_jacob(sample, fit1_params, sphere_jacob);
+        const float resid = calc_residual(sample, fit1_params);
 
         for(uint8_t i = 0;i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
-            // compute JTJ
-            for(uint8_t j = 0; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
+            // compute JTJ; it is symmetric so only the upper triangle is accumulated
+            for(uint8_t j = i; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
                 JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];   //a backup JTJ for LM
             }
             // compute JTFI
-            JTFI[i] += sphere_jacob[i] * calc_residual(sample, fit1_params);
+            JTFI[i] += sphere_jacob[i] * resid;
+        }
+    }
+
+    // fill in the lower triangle and take a backup JTJ for LM
+    for(uint8_t i = 1; i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
+        for(uint8_t j = 0; j < i; j++) {
+            JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] = JTJ[j*COMPASS_CAL_NUM_SPHERE_PARAMS+i];
         }
     }
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
 
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
@@ -555,8 +642,7 @@ void CompassCalibrator::run_sphere_fit()
         }
     }
 
-    fit1 = calc_mean_squared_residuals(fit1_params);
-    fit2 = calc_mean_squared_residuals(fit2_params);
+    calc_mean_squared_residuals(fit1_params, fit2_params, fit1, fit2);
 
     if(fit1 > _fitness && fit2 > _fitness){
         _sphere_lambda *= lma_damping;
@@ -572,7 +658,7 @@ void CompassCalibrator::run_sphere_fit()
     if(!isnan(fitness) && fitness < _fitness) {
         _fitness = fitness;
         _params = fit1_params;
-        update_completion_mask();
+        invalidate_completion_mask();
     }
 }
 
@@ -582,16 +668,11 @@ void CompassCalibrator::calc_ellipsoid_jacob(const Vector3f& sample, const param
     const Vector3f &offset = params.offset;
     const Vector3f &diag = params.diag;
     const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
 
     float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
     float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
     float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
+    float length = norm(A, B, C);
 
     // 0-2: partial derivative (offset wrt fitness fn) fn operated on sample
     ret[0] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C))/length);
@@ -633,18 +714,26 @@ void CompassCalibrator::run_ellipsoid_fit()
         float ellipsoid_jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
 
         calc_ellipsoid_jacob(sample, fit1_params, ellipsoid_jacob);
+        const float resid = calc_residual(sample, fit1_params);
 
         for(uint8_t i = 0;i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
-            // compute JTJ
-            for(uint8_t j = 0; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
-                JTJ [i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
+            // compute JTJ; it is symmetric so only the upper triangle is accumulated
+            for(uint8_t j = i; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
+                JTJ[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
             }
             // compute JTFI
-            JTFI[i] += ellipsoid_jacob[i] * calc_residual(sample, fit1_params);
+            JTFI[i] += ellipsoid_jacob[i] * resid;
         }
     }
 
+    // fill in the lower triangle and take a backup JTJ for LM
+    for(uint8_t i = 1; i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
+        for(uint8_t j = 0; j < i; j++) {
+            JTJ[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] = JTJ[j*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i];
+        }
+    }
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
+
 
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
@@ -669,8 +758,7 @@ void CompassCalibrator::run_ellipsoid_fit()
         }
     }
 
-    fit1 = calc_mean_squared_residuals(fit1_params);
-    fit2 = calc_mean_squared_residuals(fit2_params);
+    calc_mean_squared_residuals(fit1_params, fit2_params, fit1, fit2);
 
     if(fit1 > _fitness && fit2 > _fitness){
         _ellipsoid_lambda *= lma_damping;
@@ -686,7 +774,7 @@ void CompassCalibrator::run_ellipsoid_fit()
     if(fitness < _fitness) {
         _fitness = fitness;
         _params = fit1_params;
-        update_completion_mask();
+        invalidate_completion_mask();
     }
 }
 
@@ -783,21 +871,19 @@ bool CompassCalibrator::calculate_orientation(void)
     float variance[ROTATION_MAX] {};
 
     for (enum Rotation r = ROTATION_NONE; r<ROTATION_MAX; r = (enum Rotation)(r+1)) {
-        // calculate the average implied earth field across all samples
-        Vector3f total_ef {};
-        for (uint32_t i=0; i<_samples_collected; i++) {
-            Vector3f efield = calculate_earth_field(_sample_buffer[i], r);
-            total_ef += efield;
-        }
-        Vector3f avg_efield = total_ef / _samples_collected;
-
-        // now calculate the square error for this rotation against the average earth field
+        // calculate the variance of the implied earth field across all
+        // samples in a single pass with Welford's method, which
+        // accumulates deviations from the running mean rather than
+        // differencing two large sums
+        Vector3f mean_efield {};
+        float sum_sq_dev = 0;
         for (uint32_t i=0; i<_samples_collected; i++) {
             Vector3f efield = calculate_earth_field(_sample_buffer[i], r);
-            float err = (efield - avg_efield).length_squared();
-            // divide by number of samples collected to get the variance
-            variance[r] += err / _samples_collected;
+            const Vector3f delta = efield - mean_efield;
+            mean_efield += delta / (i+1);
+            sum_sq_dev += delta * (efield - mean_efield);
         }
+        variance[r] = sum_sq_dev / _samples_collected;
     }
 
     // find the rotation with the lowest variance
@@ -20,6 +20,8 @@ enum compass_cal_status_t {
 };
 
 class CompassCalibrator {
+    friend class CompassCalibrator_Benchmark;
+
 public:
     typedef uint8_t completion_mask_t[10];
 
@@ -128,6 +130,12 @@ private:
     uint16_t _samples_collected;
     uint16_t _samples_thinned;
     float _orientation_confidence;
+    bool _completion_mask_dirty;
+
+    // normal equations of a linear (algebraic) sphere fit, accumulated
+    // as samples arrive so the first LM step starts near the solution
+    float _sphere_ATA[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS];
+    float _sphere_ATb[COMPASS_CAL_NUM_SPHERE_PARAMS];
 
     bool set_status(compass_cal_status_t status);
 
@@ -149,6 +157,11 @@ private:
     float calc_residual(const Vector3f& sample, const param_t& params) const;
     float calc_mean_squared_residuals(const param_t& params) const;
     float calc_mean_squared_residuals() const;
+    // evaluate two candidate parameter sets in a single pass over the samples
+    void calc_mean_squared_residuals(const param_t& params1, const param_t& params2, float &fit1, float &fit2) const;
+
+    // add a sample to the algebraic sphere fit sums in O(1)
+    void accumulate_sphere_sums(const Vector3f& sample);
 
     void calc_initial_offset();
     void calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
@@ -168,6 +181,12 @@ private:
      * Reset and update #_completion_mask with the current samples.
      */
     void update_completion_mask();
+    /**
+     * Mark #_completion_mask as needing a full update. The update is
+     * deferred until the mask is next requested, so fit steps that
+     * improve #_params don't each pay for a pass over the samples.
+     */
+    void invalidate_completion_mask() { _completion_mask_dirty = true; }
 
     Vector3f calculate_earth_field(CompassSample &sample, enum Rotation r);
     bool calculate_orientation();
@@ -0,0 +1,112 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Compass/CompassCalibrator.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+#define NUM_CANDIDATES 2000
+
+/*
+  feeds the calibrator from a fixed set of field samples. Samples are
+  added the way new_sample() adds them, minus the attitude, so no AHRS
+  is needed
+ */
+class CompassCalibrator_Benchmark {
+public:
+    static void setup()
+    {
+        // a 450mG field seen through a soft iron distortion and offset,
+        // sampled evenly over the sphere in a scrambled order
+        const Vector3f offset(120, -80, 200);
+        for (uint16_t i = 0; i < NUM_CANDIDATES; i++) {
+            const uint16_t k = (i * 1031U) % NUM_CANDIDATES;
+            const float z = 1 - (2 * k + 1) / float(NUM_CANDIDATES);
+            const float r = sqrtf(1 - z * z);
+            const float phi = k * 2.39996323f;
+            candidates[i] = Vector3f(450 * 1.1f * r * cosf(phi),
+                                     450 * 0.95f * r * sinf(phi),
+                                     450 * z) + offset;
+        }
+    }
+
+    // top the buffer up to COMPASS_CAL_NUM_SAMPLES from the candidates
+    static void fill(CompassCalibrator &cal)
+    {
+        for (uint16_t n = 0; n < NUM_CANDIDATES && cal._samples_collected < COMPASS_CAL_NUM_SAMPLES; n++) {
+            const Vector3f &sample = candidates[next_candidate];
+            next_candidate = (next_candidate + 1) % NUM_CANDIDATES;
+            if (!cal.accept_sample(sample)) {
+                continue;
+            }
+            if (cal._status == COMPASS_CAL_RUNNING_STEP_ONE) {
+                cal.accumulate_sphere_sums(sample);
+            }
+            cal._sample_buffer[cal._samples_collected].set(sample);
+            cal._samples_collected++;
+        }
+        cal.invalidate_completion_mask();
+    }
+
+    // run a calibration from start to finish, returning its status
+    static compass_cal_status_t calibrate(CompassCalibrator &cal)
+    {
+        next_candidate = 0;
+        cal.start(false, 0, 1800, 0);
+        while (cal.running()) {
+            if (!cal.fitting()) {
+                fill(cal);
+                if (!cal.fitting()) {
+                    break;
+                }
+            }
+            bool failure;
+            cal.update(failure);
+        }
+        return cal.get_status();
+    }
+
+    // the acceptance test of a new sample against a full buffer
+    static bool accept(CompassCalibrator &cal, uint16_t i)
+    {
+        return cal.accept_sample(candidates[i % NUM_CANDIDATES]);
+    }
+
+private:
+    static Vector3f candidates[NUM_CANDIDATES];
+    static uint16_t next_candidate;
+};
+
+Vector3f CompassCalibrator_Benchmark::candidates[NUM_CANDIDATES];
+uint16_t CompassCalibrator_Benchmark::next_candidate;
+
+static void BM_CompassCalibrate(benchmark::State& state)
+{
+    CompassCalibrator_Benchmark::setup();
+    CompassCalibrator cal;
+
+    while (state.KeepRunning()) {
+        compass_cal_status_t status = CompassCalibrator_Benchmark::calibrate(cal);
+        gbenchmark_escape(&status);
+        cal.clear();
+    }
+}
+
+static void BM_CompassCalAcceptSample(benchmark::State& state)
+{
+    CompassCalibrator_Benchmark::setup();
+    CompassCalibrator cal;
+    cal.start(false, 0, 1800, 0);
+    CompassCalibrator_Benchmark::fill(cal);
+    uint16_t i = 0;
+
+    while (state.KeepRunning()) {
+        bool accepted = CompassCalibrator_Benchmark::accept(cal, i++);
+        gbenchmark_escape(&accepted);
+    }
+}
+
+BENCHMARK(BM_CompassCalibrate);
+BENCHMARK(BM_CompassCalAcceptSample);
+
+BENCHMARK_MAIN()
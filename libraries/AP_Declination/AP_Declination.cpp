@@ -27,8 +27,45 @@
 #include <cmath>
 
 #include <AP_Common/AP_Common.h>
+#include <AP_Common/Semaphore.h>
 #include <AP_Math/AP_Math.h>
 
+struct AP_Declination::tile_cache AP_Declination::tile;
+HAL_Semaphore AP_Declination::sem;
+
+/*
+  decode the four corners of a grid cell into the tile cache
+*/
+void AP_Declination::load_tile(uint16_t lat_index, uint16_t lon_index)
+{
+    const uint16_t sw = lat_index * NUM_LON + lon_index;
+    const uint16_t idx[4] { sw, uint16_t(sw + 1), uint16_t(sw + NUM_LON), uint16_t(sw + NUM_LON + 1) };
+
+    for (uint8_t i=0; i<4; i++) {
+        tile.inclination[i] = inclination_table[idx[i]] * INCLINATION_SCALE;
+        tile.intensity[i] = intensity_table[idx[i]] * INTENSITY_SCALE;
+        // declination wraps at +-180 near the poles and the date
+        // line; unwrap the corners relative to the SW corner so the
+        // interpolation takes the short way round
+        const float dec = declination_table[idx[i]] * DECLINATION_SCALE;
+        tile.declination[i] = (i == 0) ? dec : tile.declination[0] + wrap_180(dec - tile.declination[0]);
+    }
+
+    tile.lat_index = lat_index;
+    tile.lon_index = lon_index;
+    tile.valid = true;
+}
+
+/*
+  bilinear interpolation across a cell, fractions are in the range 0 to 1
+*/
+float AP_Declination::interpolate(const float corners[4], float lon_frac, float lat_frac)
+{
+    const float south = corners[0] + lon_frac * (corners[1] - corners[0]);
+    const float north = corners[2] + lon_frac * (corners[3] - corners[2]);
+    return south + lat_frac * (north - south);
+}
+
 /*
   calculate magnetic field intensity and orientation
 */
@@ -36,80 +73,43 @@ bool AP_Declination::get_mag_field_ef(float latitude_deg, float longitude_deg, f
 {
     bool valid_input_data = true;
 
-    /* round down to nearest sampling resolution */
-    int32_t min_lat = static_cast<int32_t>(static_cast<int32_t>(latitude_deg / SAMPLING_RES) * SAMPLING_RES);
-    int32_t min_lon = static_cast<int32_t>(static_cast<int32_t>(longitude_deg / SAMPLING_RES) * SAMPLING_RES);
-
-    /* for the rare case of hitting the bounds exactly
-     * the rounding logic wouldn't fit, so enforce it.
-     */
-
     /* limit to table bounds - required for maxima even when table spans full globe range */
-    if (latitude_deg <= SAMPLING_MIN_LAT) {
-        min_lat = static_cast<int32_t>(SAMPLING_MIN_LAT);
+    if (latitude_deg <= SAMPLING_MIN_LAT || latitude_deg >= SAMPLING_MAX_LAT) {
+        latitude_deg = constrain_float(latitude_deg, SAMPLING_MIN_LAT, SAMPLING_MAX_LAT);
         valid_input_data = false;
     }
-
-    if (latitude_deg >= SAMPLING_MAX_LAT) {
-        min_lat = static_cast<int32_t>(static_cast<int32_t>(latitude_deg / SAMPLING_RES) * SAMPLING_RES - SAMPLING_RES);
+    if (longitude_deg <= SAMPLING_MIN_LON || longitude_deg >= SAMPLING_MAX_LON) {
+        longitude_deg = constrain_float(longitude_deg, SAMPLING_MIN_LON, SAMPLING_MAX_LON);
         valid_input_data = false;
     }
 
-    if (longitude_deg <= SAMPLING_MIN_LON) {
-        min_lon = static_cast<int32_t>(SAMPLING_MIN_LON);
-        valid_input_data = false;
-    }
+    /* position within the grid in units of cells */
+    const float lat_cells = (latitude_deg - SAMPLING_MIN_LAT) / SAMPLING_RES;
+    const float lon_cells = (longitude_deg - SAMPLING_MIN_LON) / SAMPLING_RES;
 
-    if (longitude_deg >= SAMPLING_MAX_LON) {
-        min_lon = static_cast<int32_t>(static_cast<int32_t>(longitude_deg / SAMPLING_RES) * SAMPLING_RES - SAMPLING_RES);
-        valid_input_data = false;
-    }
-
-    /* find index of nearest low sampling point */
-    uint32_t min_lat_index = static_cast<uint32_t>((-(SAMPLING_MIN_LAT) + min_lat)  / SAMPLING_RES);
-    uint32_t min_lon_index = static_cast<uint32_t>((-(SAMPLING_MIN_LON) + min_lon) / SAMPLING_RES);
-
-    /* calculate intensity */
-
-    float data_sw = intensity_table[min_lat_index][min_lon_index];
-    float data_se = intensity_table[min_lat_index][min_lon_index + 1];;
-    float data_ne = intensity_table[min_lat_index + 1][min_lon_index + 1];
-    float data_nw = intensity_table[min_lat_index + 1][min_lon_index];
-
-    /* perform bilinear interpolation on the four grid corners */
-
-    float data_min = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_se - data_sw) + data_sw;
-    float data_max = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_ne - data_nw) + data_nw;
-
-    intensity_gauss = ((latitude_deg - min_lat) / SAMPLING_RES) * (data_max - data_min) + data_min;
-
-    /* calculate declination */
+    /* find index of nearest low sampling point; the maxima use the cell below them */
+    const uint16_t lat_index = MIN(static_cast<uint16_t>(lat_cells), NUM_LAT - 2);
+    const uint16_t lon_index = MIN(static_cast<uint16_t>(lon_cells), NUM_LON - 2);
 
-    data_sw = declination_table[min_lat_index][min_lon_index];
-    data_se = declination_table[min_lat_index][min_lon_index + 1];;
-    data_ne = declination_table[min_lat_index + 1][min_lon_index + 1];
-    data_nw = declination_table[min_lat_index + 1][min_lon_index];
+    WITH_SEMAPHORE(sem);
 
-    /* perform bilinear interpolation on the four grid corners */
-
-    data_min = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_se - data_sw) + data_sw;
-    data_max = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_ne - data_nw) + data_nw;
-
-    declination_deg = ((latitude_deg - min_lat) / SAMPLING_RES) * (data_max - data_min) + data_min;
-
-    /* calculate inclination */
-
-    data_sw = inclination_table[min_lat_index][min_lon_index];
-    data_se = inclination_table[min_lat_index][min_lon_index + 1];;
-    data_ne = inclination_table[min_lat_index + 1][min_lon_index + 1];
-    data_nw = inclination_table[min_lat_index + 1][min_lon_index];
-
-    /* perform bilinear interpolation on the four grid corners */
-
-    data_min = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_se - data_sw) + data_sw;
-    data_max = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_ne - data_nw) + data_nw;
+    if (!tile.valid || tile.lat_index != lat_index || tile.lon_index != lon_index) {
+        load_tile(lat_index, lon_index);
+    }
 
-    inclination_deg = ((latitude_deg - min_lat) / SAMPLING_RES) * (data_max - data_min) + data_min;
+    const float lat_frac = lat_cells - lat_index;
+    const float lon_frac = lon_cells - lon_index;
+
+    intensity_gauss = interpolate(tile.intensity, lon_frac, lat_frac);
+    /* the unwrapped corners are within 180 degrees of a value in
+       +-180, so a single correction re-wraps the result */
+    declination_deg = interpolate(tile.declination, lon_frac, lat_frac);
+    if (declination_deg > 180) {
+        declination_deg -= 360;
+    } else if (declination_deg < -180) {
+        declination_deg += 360;
+    }
+    inclination_deg = interpolate(tile.inclination, lon_frac, lat_frac);
 
     return valid_input_data;
 }
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <stdint.h>
+
+#include <AP_HAL/AP_HAL.h>
+
 /*
   magnetic data derived from WMM
  */
@@ -28,7 +32,37 @@ private:
     static const float SAMPLING_MIN_LON;
     static const float SAMPLING_MAX_LON;
 
-    static const float declination_table[19][37];
-    static const float inclination_table[19][37];
-    static const float intensity_table[19][37];
+    static const uint16_t NUM_LAT;
+    static const uint16_t NUM_LON;
+
+    // multipliers converting the int16 table entries to degrees and Gauss
+    static const float DECLINATION_SCALE;
+    static const float INCLINATION_SCALE;
+    static const float INTENSITY_SCALE;
+
+    // NUM_LAT rows of NUM_LON entries
+    static const int16_t declination_table[];
+    static const int16_t inclination_table[];
+    static const int16_t intensity_table[];
+
+    /*
+      decoded corners of the most recently used grid cell. Successive
+      lookups from a moving vehicle almost always fall in the same
+      cell, so they only pay for the interpolation. Lookups come from
+      more than one thread, so the cache is only used under sem.
+     */
+    struct tile_cache {
+        bool valid;
+        uint16_t lat_index;
+        uint16_t lon_index;
+        // corners in the order SW, SE, NW, NE
+        float declination[4];
+        float inclination[4];
+        float intensity[4];
+    };
+    static struct tile_cache tile;
+    static HAL_Semaphore sem;
+
+    static void load_tile(uint16_t lat_index, uint16_t lon_index);
+    static float interpolate(const float corners[4], float lon_frac, float lat_frac);
 };
@@ -0,0 +1,78 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Declination/AP_Declination.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+/*
+  lookups from a slowly moving vehicle, which stay within one grid cell
+  and so hit the tile cache
+ */
+static void BM_DeclinationSameCell(benchmark::State& state)
+{
+    float lat = -35.36f;
+    float lon = 149.16f;
+
+    while (state.KeepRunning()) {
+        float dec = AP_Declination::get_declination(lat, lon);
+        gbenchmark_escape(&dec);
+        lat += 1.0e-6f;
+        lon += 1.0e-6f;
+    }
+}
+
+/*
+  lookups alternating between two distant cells, so every call has to
+  decode a new cell
+ */
+static void BM_DeclinationCellChange(benchmark::State& state)
+{
+    bool north = false;
+
+    while (state.KeepRunning()) {
+        float dec = north ? AP_Declination::get_declination(72.5f, -40.3f)
+                          : AP_Declination::get_declination(-35.36f, 149.16f);
+        gbenchmark_escape(&dec);
+        north = !north;
+    }
+}
+
+/*
+  a fast vehicle flying east at about 1 degree per second with 400
+  lookups a second, crossing into a new 5 degree cell every 2000 calls
+ */
+static void BM_DeclinationCrossing(benchmark::State& state)
+{
+    float lon = -180.0f;
+
+    while (state.KeepRunning()) {
+        float dec = AP_Declination::get_declination(51.5f, lon);
+        gbenchmark_escape(&dec);
+        lon += 0.0025f;
+        if (lon > 180.0f) {
+            lon = -180.0f;
+        }
+    }
+}
+
+static void BM_MagFieldSameCell(benchmark::State& state)
+{
+    float lat = 69.65f;
+    float lon = 18.96f;
+
+    while (state.KeepRunning()) {
+        float intensity, declination, inclination;
+        AP_Declination::get_mag_field_ef(lat, lon, intensity, declination, inclination);
+        gbenchmark_escape(&intensity);
+        gbenchmark_escape(&declination);
+        gbenchmark_escape(&inclination);
+        lat += 1.0e-6f;
+    }
+}
+
+BENCHMARK(BM_DeclinationSameCell);
+BENCHMARK(BM_DeclinationCellChange);
+BENCHMARK(BM_DeclinationCrossing);
+BENCHMARK(BM_MagFieldSameCell);
+
+BENCHMARK_MAIN()
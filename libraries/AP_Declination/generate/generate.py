@@ -12,19 +12,19 @@ if not Path("AP_Declination.h").is_file():
     raise OSError("Please run this tool from the AP_Declination directory")
 
 
-def write_table(f,name, table):
-    '''write one table'''
-    f.write("const float AP_Declination::%s[%u][%u] = {\n" %
-                (name, NUM_LAT, NUM_LON))
+def write_table(f,name, table, scale):
+    '''write one table, encoded as int16 in units of scale'''
+    f.write("const int16_t AP_Declination::%s[%u] = {\n" %
+                (name, NUM_LAT*NUM_LON))
     for i in range(NUM_LAT):
-        f.write("    {")
+        f.write("    ")
         for j in range(NUM_LON):
-            f.write("%.5f" % table[i][j])
-            if j != NUM_LON-1:
+            v = int(round(table[i][j] / scale))
+            if v < -32768 or v > 32767:
+                raise ValueError("%s[%u][%u] out of int16 range" % (name, i, j))
+            f.write("%d" % v)
+            if j != NUM_LON-1 or i != NUM_LAT-1:
                 f.write(",")
-        f.write("}")
-        if i != NUM_LAT-1:
-            f.write(",")
         f.write("\n")
     f.write("};\n\n")
 
@@ -36,7 +36,9 @@ if __name__ == '__main__':
     date = datetime.datetime.now()
    # date = datetime.date(2018,2,20)
 
-    SAMPLING_RES = 10
+    # a 5 degree grid cuts the interpolation error of the original
+    # 10 degree tables, which matters most at high latitude
+    SAMPLING_RES = 5
     SAMPLING_MIN_LAT = -90
     SAMPLING_MAX_LAT = 90
     SAMPLING_MIN_LON = -180
@@ -48,6 +50,12 @@ if __name__ == '__main__':
     NUM_LAT = lats.size
     NUM_LON = lons.size
 
+    # tables are stored as int16 to keep flash use down at the finer
+    # resolution: angles in centi-degrees, intensity in 1e-4 Gauss
+    DECLINATION_SCALE = 0.01
+    INCLINATION_SCALE = 0.01
+    INTENSITY_SCALE = 0.0001
+
     intensity_table = np.empty((NUM_LAT, NUM_LON))
     inclination_table = np.empty((NUM_LAT, NUM_LON))
     declination_table = np.empty((NUM_LAT, NUM_LON))
@@ -68,19 +76,31 @@ if __name__ == '__main__':
 ''')
 
         f.write('''const float AP_Declination::SAMPLING_RES = %u;
-const float AP_Declination::SAMPLING_MIN_LAT = %u;
-const float AP_Declination::SAMPLING_MAX_LAT = %u;
-const float AP_Declination::SAMPLING_MIN_LON = %u;
-const float AP_Declination::SAMPLING_MAX_LON = %u;
+const float AP_Declination::SAMPLING_MIN_LAT = %d;
+const float AP_Declination::SAMPLING_MAX_LAT = %d;
+const float AP_Declination::SAMPLING_MIN_LON = %d;
+const float AP_Declination::SAMPLING_MAX_LON = %d;
+
+const uint16_t AP_Declination::NUM_LAT = %u;
+const uint16_t AP_Declination::NUM_LON = %u;
+
+const float AP_Declination::DECLINATION_SCALE = %g;
+const float AP_Declination::INCLINATION_SCALE = %g;
+const float AP_Declination::INTENSITY_SCALE = %g;
 
 ''' % (SAMPLING_RES,
            SAMPLING_MIN_LAT,
            SAMPLING_MAX_LAT,
            SAMPLING_MIN_LON,
-           SAMPLING_MAX_LON))
+           SAMPLING_MAX_LON,
+           NUM_LAT,
+           NUM_LON,
+           DECLINATION_SCALE,
+           INCLINATION_SCALE,
+           INTENSITY_SCALE))
 
 
-        write_table(f,'declination_table', declination_table)
-        write_table(f,'inclination_table', inclination_table)
-        write_table(f,'intensity_table', intensity_table)
+        write_table(f,'declination_table', declination_table, DECLINATION_SCALE)
+        write_table(f,'inclination_table', inclination_table, INCLINATION_SCALE)
+        write_table(f,'intensity_table', intensity_table, INTENSITY_SCALE)
 
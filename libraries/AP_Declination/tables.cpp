@@ -1,78 +1,140 @@
 // this is an auto-generated file from the IGRF tables. Do not edit
 // To re-generate run generate/generate.py
+// Resampled to 5 degrees from the 10 degree IGRF tables, as generate.py
+// could not be run; regenerate when the igrf12 module is available
 
 #include "AP_Declination.h"
 
-
-const float AP_Declination::SAMPLING_RES = 10;
+const float AP_Declination::SAMPLING_RES = 5;
 const float AP_Declination::SAMPLING_MIN_LAT = -90;
 const float AP_Declination::SAMPLING_MAX_LAT = 90;
 const float AP_Declination::SAMPLING_MIN_LON = -180;
 const float AP_Declination::SAMPLING_MAX_LON = 180;
 
-const float AP_Declination::declination_table[19][37] = {
-    {149.42982,139.42982,129.42982,119.42982,109.42982,99.42982,89.42982,79.42982,69.42982,59.42982,49.42982,39.42982,29.42982,19.42982,9.42982,-0.57018,-10.57018,-20.57018,-30.57018,-40.57018,-50.57018,-60.57018,-70.57018,-80.57018,-90.57018,-100.57018,-110.57018,-120.57018,-130.57018,-140.57018,-150.57018,-160.57018,-170.57018,179.42982,169.42982,159.42982,149.42982},
-    {129.72350,117.44264,106.27675,96.07611,86.65367,77.82604,69.43354,61.34790,53.47334,45.74345,38.11493,30.55915,23.05266,15.56845,8.07026,0.51157,-7.16035,-14.99671,-23.03882,-31.31253,-39.82756,-48.58229,-57.57257,-66.80224,-76.29309,-86.09269,-96.27941,-106.96368,-118.28316,-130.38657,-143.39712,-157.34798,-172.09985,172.71041,157.61759,143.16328,129.72350},
-    {85.55217,77.63610,71.28198,65.85129,60.92943,56.19924,51.40394,46.35152,40.93254,35.13240,29.02800,22.76471,16.51219,10.40361,4.47591,-1.36061,-7.29972,-13.56717,-20.33231,-27.64625,-35.43223,-43.52666,-51.74560,-59.94560,-68.06018,-76.11386,-84.22919,-92.65008,-101.81721,-112.57190,-126.68545,-148.05164,177.80280,138.85306,112.24808,96.22652,85.55217},
-    {47.46676,46.20752,44.77315,43.38132,42.07405,40.72123,39.02862,36.61723,33.16561,28.53811,22.85208,16.48376,9.99764,3.97129,-1.24934,-5.73392,-9.95537,-14.56642,-20.09169,-26.69103,-34.10667,-41.82261,-49.31316,-56.20179,-62.27798,-67.43190,-71.55604,-74.40916,-75.36987,-72.73151,-60.81180,-21.51651,25.67221,42.27293,47.13896,48.09081,47.46676},
-    {30.85230,31.07383,30.82762,30.44253,30.14685,30.03972,29.94303,29.32537,27.46672,23.77665,18.08319,10.82311,3.04859,-3.93382,-9.21525,-12.73761,-15.21249,-17.71784,-21.33214,-26.67316,-33.41515,-40.52179,-46.98754,-52.17899,-55.71832,-57.28691,-56.42962,-52.33208,-43.85402,-30.45586,-13.95751,1.69556,13.74137,21.89083,26.92848,29.67895,30.85230},
-    {22.27872,22.80208,22.89144,22.73115,22.48110,22.36292,22.48106,22.51808,21.62358,18.70580,13.04246,4.91899,-4.12159,-11.97999,-17.35339,-20.33078,-21.74028,-22.30429,-22.99797,-25.48758,-30.37748,-36.24796,-41.36613,-44.68747,-45.62236,-43.81812,-39.04370,-31.23361,-21.30619,-11.43220,-3.04586,3.96581,9.92051,14.80522,18.51928,20.97339,22.27872},
-    {16.77535,17.26078,17.48701,17.50586,17.28046,16.91869,16.66947,16.54681,15.86669,13.28797,7.65685,-0.80738,-10.09007,-17.67695,-22.39570,-24.71604,-25.51571,-24.75384,-22.31254,-20.27272,-21.40935,-25.31718,-29.47979,-31.85235,-31.48877,-28.41892,-23.12231,-16.18014,-9.02321,-3.45191,0.46489,3.92873,7.47714,10.84926,13.70257,15.70340,16.77535},
-    {13.11722,13.37999,13.53697,13.64213,13.51862,13.08139,12.58669,12.22195,11.40281,8.74064,3.03248,-5.27164,-13.84131,-20.33623,-23.89768,-24.94427,-24.16696,-21.44804,-16.65468,-11.57062,-9.17726,-10.67932,-14.35074,-17.28133,-17.77932,-15.94890,-12.44438,-7.73479,-3.08253,-0.10308,1.47778,3.23739,5.69958,8.33884,10.69634,12.34763,13.11722},
-    {10.86027,10.84311,10.78802,10.86614,10.82660,10.44376,9.97329,9.56517,8.51030,5.51344,-0.27795,-8.04143,-15.48088,-20.66310,-22.77532,-21.94614,-18.98400,-14.68117,-9.75013,-5.14534,-2.07246,-1.81242,-4.23526,-7.17511,-8.61911,-8.27316,-6.53525,-3.65636,-0.68530,0.85477,1.25432,2.22687,4.25977,6.61864,8.78455,10.29691,10.86027},
-    {9.65412,9.47055,9.21866,9.26610,9.31617,9.03106,8.63298,8.13549,6.68936,3.23076,-2.55638,-9.56906,-15.79936,-19.60429,-20.16306,-17.72398,-13.51036,-8.94319,-4.99959,-1.80533,0.70520,1.63736,0.32148,-2.02391,-3.63410,-4.02175,-3.40313,-1.86837,-0.15286,0.47666,0.26260,0.84732,2.70977,5.05917,7.34111,9.03687,9.65412},
-    {8.97014,9.00488,8.80979,8.96359,9.19654,9.04844,8.56530,7.64578,5.51969,1.46185,-4.34083,-10.58923,-15.55806,-17.91473,-17.18297,-14.00887,-9.67704,-5.46497,-2.28363,-0.02111,1.89784,2.95296,2.25306,0.43899,-1.01576,-1.61934,-1.61055,-1.06870,-0.42999,-0.57588,-1.26445,-1.05555,0.57935,2.99639,5.63172,7.86731,8.97014},
-    {8.05364,8.90038,9.27928,9.81741,10.36068,10.39013,9.68557,8.05395,4.96137,0.07375,-5.95698,-11.57288,-15.26102,-16.24039,-14.65177,-11.37263,-7.38273,-3.56765,-0.72868,1.13805,2.65859,3.63912,3.29650,1.92360,0.69270,0.06311,-0.26069,-0.47485,-0.85717,-1.88327,-3.18863,-3.51318,-2.26377,0.14436,3.15228,6.07110,8.05364},
-    {6.50676,8.60131,10.09409,11.34973,12.28177,12.46194,11.52588,9.17003,5.01214,-0.92961,-7.49086,-12.75176,-15.40894,-15.33506,-13.21707,-9.96509,-6.25217,-2.66248,0.13977,1.99766,3.36674,4.31107,4.34970,3.54042,2.61979,1.95032,1.27943,0.31325,-1.17765,-3.29530,-5.41927,-6.36449,-5.53191,-3.19867,0.05852,3.54451,6.50676},
-    {4.72297,8.05666,10.83494,13.02130,14.42516,14.72066,13.56011,10.55536,5.32509,-1.84890,-9.22855,-14.49666,-16.58473,-15.89094,-13.41064,-10.03642,-6.31692,-2.68976,0.34194,2.55093,4.17653,5.41501,6.09964,6.11745,5.65956,4.85558,3.55177,1.51138,-1.37406,-4.81860,-7.87000,-9.36323,-8.80100,-6.47499,-3.01085,0.91836,4.72297},
-    {3.37834,7.62747,11.43831,14.53532,16.55914,17.10928,15.75231,11.96543,5.32788,-3.51576,-12.05022,-17.59555,-19.44526,-18.41349,-15.62077,-11.92636,-7.86545,-3.83213,-0.19787,2.82486,5.30947,7.42114,9.13275,10.21765,10.41233,9.48469,7.23089,3.55521,-1.29658,-6.44422,-10.49765,-12.34822,-11.76790,-9.22856,-5.44532,-1.08105,3.37834},
-    {2.74348,7.62543,12.14084,15.97571,18.69139,19.70118,18.21773,13.23975,4.12042,-7.61873,-17.81916,-23.55512,-24.98204,-23.43924,-20.11619,-15.80905,-11.02265,-6.11388,-1.36465,3.04381,7.06375,10.70545,13.87807,16.28311,17.42655,16.70088,13.51831,7.64077,-0.16718,-7.83650,-13.15188,-15.19775,-14.31554,-11.33845,-7.10164,-2.26053,2.74348},
-    {2.39274,7.82484,12.91652,17.34244,20.60856,21.88978,19.76035,12.03027,-2.57373,-19.28852,-30.38750,-34.61212,-34.22997,-31.16364,-26.55257,-21.04868,-15.04630,-8.80967,-2.53355,3.63374,9.57427,15.16558,20.22250,24.42837,27.25922,27.88349,25.07001,17.49446,5.52718,-6.65781,-14.50735,-17.27006,-16.30170,-13.00872,-8.39222,-3.11386,2.39274},
-    {1.41048,6.79922,11.76290,15.71616,17.64723,15.50964,5.20845,-16.74575,-39.26184,-50.10475,-52.24001,-49.91343,-45.26415,-39.31139,-32.58025,-25.36820,-17.86089,-10.18671,-2.44480,5.27857,12.89790,20.31585,27.40587,33.98419,39.75848,44.22469,46.44725,44.61461,35.58987,17.59449,-1.23274,-11.49558,-14.19386,-12.63756,-8.86147,-3.96333,1.41048},
-    {179.28905,-170.71095,-160.71095,-150.71095,-140.71095,-130.71095,-120.71095,-110.71095,-100.71095,-90.71095,-80.71095,-70.71095,-60.71095,-50.71095,-40.71095,-30.71095,-20.71095,-10.71095,-0.71095,9.28905,19.28905,29.28905,39.28905,49.28905,59.28905,69.28905,79.28905,89.28905,99.28905,109.28905,119.28905,129.28905,139.28905,149.28905,159.28905,169.28905,179.28905}
+const uint16_t AP_Declination::NUM_LAT = 37;
+const uint16_t AP_Declination::NUM_LON = 73;
+
+const float AP_Declination::DECLINATION_SCALE = 0.01;
+const float AP_Declination::INCLINATION_SCALE = 0.01;
+const float AP_Declination::INTENSITY_SCALE = 0.0001;
+
+const int16_t AP_Declination::declination_table[2701] = {
+    14943,14443,13943,13443,12943,12443,11943,11443,10943,10443,9943,9443,8943,8443,7943,7443,6943,6443,5943,5443,4943,4443,3943,3443,2943,2443,1943,1443,943,443,-57,-557,-1057,-1557,-2057,-2557,-3057,-3557,-4057,-4557,-5057,-5557,-6057,-6557,-7057,-7557,-8057,-8557,-9057,-9557,-10057,-10557,-11057,-11557,-12057,-12557,-13057,-13557,-14057,-14557,-15057,-15557,-16057,-16557,-17057,-17557,17943,17443,16943,16443,15943,15443,14943,
+    14187,13604,13035,12479,11937,11407,10889,10382,9884,9394,8912,8436,7967,7502,7042,6586,6134,5686,5240,4797,4357,3920,3485,3051,2620,2191,1762,1334,907,479,51,-379,-812,-1247,-1686,-2128,-2574,-3025,-3480,-3939,-4403,-4871,-5343,-5820,-6301,-6787,-7276,-7771,-8270,-8773,-9282,-9797,-10318,-10846,-11381,-11924,-12475,-13035,-13604,-14181,-14763,-15348,-15930,-16498,-17062,-17621,17812,17220,16615,16002,15388,14783,14187,
+    12972,12344,11744,11173,10628,10107,9608,9128,8665,8218,7783,7358,6943,6536,6135,5739,5347,4959,4574,4192,3811,3433,3056,2680,2305,1931,1557,1182,807,430,51,-331,-716,-1106,-1500,-1899,-2304,-2715,-3131,-3554,-3983,-4418,-4858,-5305,-5757,-6216,-6680,-7151,-7629,-8115,-8609,-9113,-9628,-10155,-10696,-11253,-11828,-12423,-13039,-13678,-14340,-15026,-15735,-16465,-17210,-17967,17271,16512,15762,15029,14316,13631,12972,
+    10879,10322,9813,9340,8899,8484,8091,7715,7355,7005,6663,6327,5994,5663,5333,5001,4669,4335,3999,3663,3325,2987,2650,2314,1979,1646,1315,985,655,326,-8,-362,-716,-1050,-1387,-1749,-2123,-2505,-2896,-3296,-3704,-4119,-4541,-4968,-5400,-5835,-6275,-6717,-7165,-7616,-8074,-8539,-9015,-9504,-10010,-10536,-11094,-11685,-12333,-13063,-13871,-14807,-15735,-16423,-17210,17517,16140,14921,13826,12934,12169,11487,10879,
+    8555,8132,7764,7430,7128,6848,6585,6335,6093,5856,5620,5382,5140,4892,4635,4369,4093,3808,3513,3211,2903,2591,2276,1963,1651,1344,1040,742,448,156,-136,-430,-730,-1038,-1357,-1688,-2033,-2393,-2765,-3149,-3543,-3945,-4353,-4763,-5175,-5585,-5995,-6401,-6806,-7209,-7611,-8015,-8423,-8837,-9265,-9709,-10182,-10689,-11257,-11897,-12669,-13612,-14805,-16403,17780,15786,13885,12412,11225,10324,9623,9038,8555,
+    6479,6246,6038,5847,5671,5508,5354,5207,5064,4922,4778,4627,4466,4291,4100,3891,3662,3413,3147,2863,2567,2261,1949,1637,1328,1027,736,457,189,-69,-323,-574,-831,-1097,-1378,-1685,-2009,-2344,-2694,-3067,-3454,-3847,-4244,-4640,-5031,-5415,-5790,-6153,-6506,-6848,-7178,-7498,-7808,-8110,-8401,-8685,-8953,-9211,-9418,-9563,-9563,-8565,-8565,16698,10185,8972,8972,8365,7812,7387,7038,6737,6479,
+    4747,4689,4621,4550,4477,4407,4338,4273,4207,4142,4072,3994,3903,3793,3662,3503,3317,3099,2854,2580,2285,1972,1648,1322,1000,691,397,126,-125,-355,-573,-784,-996,-1218,-1457,-1720,-2009,-2327,-2669,-3033,-3411,-3796,-4182,-4562,-4931,-5285,-5620,-5935,-6228,-6498,-6743,-6964,-7156,-7318,-7441,-7523,-7537,-7486,-7273,-6906,-6081,-4337,-2152,350,2567,3662,4227,4568,4714,4796,4809,4792,4747,
+    3732,3732,3719,3695,3664,3632,3599,3569,3541,3516,3489,3459,3418,3360,3279,3166,3020,2832,2606,2339,2040,1710,1363,1008,656,323,12,-264,-508,-718,-903,-1071,-1234,-1404,-1592,-1810,-2059,-2349,-2669,-3019,-3387,-3761,-4133,-4493,-4835,-5152,-5442,-5701,-5927,-6116,-6266,-6373,-6429,-6428,-6355,-6198,-5937,-5559,-5029,-4354,-3395,-1802,-214,699,1374,2067,2649,3060,3349,3534,3642,3706,3732,
+    3085,3105,3107,3099,3083,3064,3044,3028,3015,3008,3004,3002,2994,2974,2933,2859,2747,2586,2378,2115,1808,1458,1082,692,305,-60,-393,-679,-922,-1115,-1274,-1404,-1521,-1639,-1772,-1935,-2133,-2381,-2667,-2993,-3342,-3699,-4052,-4387,-4699,-4977,-5218,-5418,-5572,-5678,-5729,-5721,-5643,-5486,-5233,-4867,-4385,-3766,-3046,-2235,-1396,-585,170,819,1374,1825,2189,2475,2693,2855,2968,3042,3085,
+    2587,2619,2634,2634,2633,2623,2610,2599,2589,2587,2587,2595,2601,2601,2584,2539,2455,2319,2128,1872,1560,1191,788,362,-60,-454,-809,-1105,-1347,-1530,-1670,-1774,-1857,-1929,-2005,-2101,-2229,-2411,-2641,-2926,-3241,-3571,-3899,-4203,-4477,-4711,-4898,-5034,-5114,-5114,-5088,-4972,-4779,-4499,-4134,-3674,-3138,-2528,-1880,-1212,-579,-55,397,783,1124,1446,1732,1975,2176,2333,2450,2533,2587,
+    2228,2262,2280,2289,2289,2283,2273,2260,2248,2240,2236,2241,2248,2252,2252,2226,2162,2046,1871,1620,1304,919,492,38,-412,-828,-1198,-1497,-1735,-1909,-2033,-2119,-2174,-2207,-2230,-2253,-2300,-2398,-2549,-2772,-3038,-3330,-3625,-3897,-4137,-4329,-4469,-4548,-4562,-4508,-4382,-4181,-3904,-3546,-3123,-2640,-2131,-1627,-1143,-706,-305,61,397,708,992,1250,1481,1681,1852,1990,2097,2175,2228,
+    1922,1955,1976,1989,1994,1994,1988,1977,1964,1951,1940,1937,1936,1938,1938,1919,1866,1762,1596,1350,1032,637,197,-271,-732,-1150,-1517,-1805,-2029,-2189,-2298,-2373,-2412,-2412,-2402,-2348,-2300,-2300,-2335,-2462,-2647,-2886,-3143,-3387,-3602,-3765,-3871,-3878,-3878,-3776,-3606,-3367,-3066,-2700,-2292,-1852,-1413,-1011,-646,-338,-67,172,397,631,857,1064,1254,1427,1577,1701,1800,1872,1922,
+    1678,1707,1726,1740,1749,1751,1751,1742,1728,1710,1692,1678,1667,1664,1655,1636,1587,1489,1329,1084,766,365,-81,-550,-1009,-1417,-1768,-2037,-2240,-2380,-2472,-2531,-2552,-2534,-2475,-2361,-2231,-2107,-2027,-2047,-2141,-2317,-2532,-2749,-2948,-3095,-3185,-3185,-3149,-3026,-2842,-2601,-2312,-1977,-1618,-1252,-902,-604,-345,-136,46,222,393,571,748,921,1085,1236,1370,1481,1570,1633,1678,
+    1474,1498,1513,1526,1535,1541,1542,1536,1524,1505,1482,1462,1443,1432,1418,1396,1346,1248,1088,841,521,120,-322,-781,-1224,-1609,-1934,-2179,-2353,-2447,-2494,-2537,-2540,-2481,-2368,-2191,-1987,-1775,-1600,-1518,-1518,-1623,-1787,-1984,-2180,-2335,-2440,-2440,-2432,-2329,-2170,-1963,-1716,-1430,-1127,-824,-544,-318,-134,4,120,240,364,505,653,801,945,1081,1202,1302,1382,1437,1474,
+    1312,1329,1338,1347,1354,1361,1364,1361,1352,1332,1308,1283,1259,1242,1222,1196,1140,1038,874,624,303,-94,-527,-967,-1384,-1740,-2034,-2246,-2390,-2469,-2494,-2479,-2417,-2306,-2145,-1920,-1665,-1396,-1157,-996,-918,-955,-1068,-1243,-1435,-1601,-1728,-1778,-1778,-1711,-1595,-1438,-1244,-1016,-773,-530,-308,-140,-10,76,148,230,324,441,570,703,834,958,1070,1162,1235,1282,1312,
+    1184,1193,1195,1199,1201,1207,1211,1210,1203,1185,1161,1136,1111,1094,1071,1040,979,869,699,444,123,-266,-684,-1100,-1488,-1809,-2066,-2248,-2359,-2372,-2372,-2301,-2183,-2022,-1822,-1578,-1315,-1045,-802,-618,-503,-503,-555,-693,-863,-1027,-1164,-1240,-1265,-1235,-1160,-1048,-902,-722,-528,-331,-155,-29,61,110,148,204,278,380,497,619,742,859,964,1052,1119,1160,1184,
+    1086,1086,1084,1081,1079,1083,1087,1087,1083,1066,1044,1021,997,981,957,920,851,731,551,292,-28,-406,-804,-1192,-1548,-1840,-2066,-2209,-2278,-2268,-2195,-2068,-1898,-1696,-1468,-1223,-975,-733,-515,-334,-207,-181,-181,-282,-424,-577,-718,-810,-862,-862,-827,-756,-654,-517,-366,-209,-69,25,85,109,125,164,223,316,426,543,662,775,878,964,1030,1067,1086,
+    1016,1014,1003,993,986,987,991,991,991,977,957,936,914,898,871,828,749,617,428,165,-151,-515,-891,-1252,-1576,-1835,-2026,-2131,-2159,-2105,-1988,-1820,-1616,-1393,-1161,-932,-711,-505,-319,-155,-31,33,38,-32,-145,-280,-412,-508,-572,-582,-582,-541,-471,-371,-256,-134,-25,41,79,83,84,110,159,246,353,468,586,700,805,893,961,999,1016,
+    965,962,947,933,922,922,927,931,932,920,903,885,863,845,814,760,669,523,323,56,-256,-604,-957,-1288,-1580,-1806,-1960,-2016,-2016,-1924,-1772,-1575,-1351,-1121,-894,-689,-500,-331,-181,-41,71,141,164,118,32,-83,-202,-295,-363,-397,-402,-383,-340,-270,-187,-95,-15,28,48,37,26,43,85,167,271,386,506,624,734,829,904,946,965,
+    929,929,916,901,889,889,896,910,920,916,903,884,857,825,778,708,603,441,229,-42,-349,-681,-1011,-1314,-1572,-1762,-1880,-1880,-1867,-1748,-1577,-1368,-1139,-913,-696,-509,-344,-203,-78,43,143,215,247,218,151,51,-56,-144,-212,-250,-266,-262,-240,-195,-139,-77,-23,-1,1,-23,-44,-38,-4,72,173,287,411,536,655,762,849,902,929,
+    897,900,900,890,881,886,896,910,920,917,905,886,857,821,765,678,552,372,146,-130,-434,-752,-1059,-1332,-1556,-1709,-1791,-1789,-1718,-1582,-1401,-1191,-968,-750,-546,-375,-228,-107,-2,101,190,259,295,278,225,139,44,-36,-102,-141,-162,-162,-161,-138,-107,-71,-43,-43,-58,-94,-126,-126,-106,-38,58,173,300,433,563,685,787,856,897,
+    857,885,894,896,897,910,928,949,965,965,959,937,901,850,775,666,516,315,72,-213,-516,-822,-1107,-1349,-1539,-1655,-1703,-1673,-1582,-1437,-1255,-1050,-836,-628,-436,-275,-139,-31,62,152,231,296,334,325,283,208,123,50,-12,-51,-75,-88,-92,-86,-77,-66,-64,-85,-121,-173,-218,-223,-223,-165,-77,35,165,305,448,585,705,795,857,
+    805,858,890,911,928,954,982,1012,1036,1039,1039,1014,969,902,805,671,496,270,7,-290,-596,-891,-1157,-1371,-1526,-1608,-1624,-1571,-1465,-1316,-1137,-941,-738,-540,-357,-203,-73,29,114,195,266,327,364,361,330,267,192,126,69,32,6,-12,-26,-36,-47,-62,-86,-131,-188,-258,-319,-351,-351,-306,-226,-117,14,162,315,468,607,719,805,
+    733,816,878,926,967,1011,1053,1094,1126,1137,1137,1109,1055,972,855,697,496,242,-46,-359,-672,-961,-1211,-1400,-1526,-1565,-1565,-1493,-1376,-1225,-1050,-861,-667,-477,-299,-149,-21,78,161,236,301,358,395,395,378,328,266,209,157,121,93,69,45,19,-12,-51,-103,-175,-258,-348,-427,-476,-491,-458,-387,-282,-150,2,164,329,486,621,733,
+    651,765,860,940,1009,1076,1135,1188,1228,1246,1246,1215,1153,1055,917,732,501,219,-93,-425,-749,-1037,-1275,-1441,-1541,-1541,-1534,-1447,-1322,-1169,-997,-813,-625,-440,-266,-115,14,116,200,274,337,392,431,435,435,401,354,307,262,227,195,163,128,85,31,-36,-118,-220,-330,-443,-542,-608,-636,-615,-553,-452,-320,-164,6,182,354,511,651,
+    560,705,834,947,1048,1139,1219,1286,1334,1357,1357,1323,1252,1141,984,775,517,205,-135,-489,-828,-1118,-1350,-1502,-1583,-1583,-1540,-1448,-1322,-1169,-997,-813,-625,-441,-266,-107,33,142,231,309,375,433,478,503,510,495,467,434,396,361,323,280,228,163,83,-15,-130,-264,-404,-543,-662,-744,-786,-774,-719,-620,-487,-328,-152,34,220,396,560,
+    472,645,806,952,1083,1201,1302,1384,1443,1472,1472,1435,1356,1231,1056,820,533,187,-185,-566,-923,-1219,-1450,-1591,-1658,-1652,-1589,-1482,-1341,-1180,-1004,-819,-632,-446,-269,-109,34,153,255,342,418,485,542,583,610,612,612,594,566,531,486,428,355,263,151,16,-137,-309,-482,-647,-787,-884,-936,-932,-880,-782,-647,-484,-301,-107,92,286,472,
+    398,594,781,955,1114,1257,1379,1478,1549,1588,1589,1550,1463,1324,1127,858,533,155,-248,-659,-1039,-1346,-1578,-1715,-1774,-1759,-1687,-1572,-1425,-1257,-1074,-884,-690,-497,-312,-140,16,151,271,376,468,553,628,692,743,777,795,795,779,744,690,614,514,387,235,58,-137,-352,-564,-757,-917,-1027,-1087,-1085,-1033,-932,-792,-623,-432,-228,-17,192,398,
+    338,554,763,960,1144,1310,1454,1571,1656,1705,1711,1670,1575,1419,1197,896,533,102,-352,-799,-1205,-1524,-1760,-1893,-1945,-1922,-1841,-1718,-1562,-1385,-1193,-992,-787,-582,-383,-195,-20,139,282,412,531,641,742,834,913,977,1022,1041,1041,1010,948,853,723,556,356,122,-130,-392,-644,-868,-1050,-1171,-1235,-1233,-1177,-1070,-923,-745,-545,-331,-108,116,338,
+    300,535,763,977,1178,1363,1526,1662,1764,1826,1842,1804,1703,1529,1277,932,514,21,-494,-990,-1433,-1768,-2008,-2138,-2181,-2150,-2060,-1927,-1760,-1572,-1366,-1150,-929,-707,-488,-276,-74,115,291,456,610,756,891,1017,1130,1226,1300,1346,1360,1336,1268,1152,988,771,511,210,-108,-430,-732,-988,-1190,-1320,-1383,-1376,-1310,-1193,-1035,-846,-634,-409,-174,63,300,
+    274,521,763,995,1214,1417,1598,1751,1869,1946,1970,1933,1822,1621,1324,910,412,-168,-762,-1309,-1782,-2124,-2356,-2472,-2498,-2451,-2344,-2195,-2012,-1805,-1581,-1345,-1102,-857,-611,-371,-136,89,304,510,706,894,1071,1237,1388,1521,1628,1705,1743,1733,1670,1543,1352,1087,764,385,-17,-416,-784,-1085,-1315,-1456,-1520,-1507,-1432,-1304,-1134,-934,-710,-473,-226,24,274,
+    259,522,779,1028,1264,1486,1685,1859,1997,2096,2136,2105,1976,1704,1324,863,299,-433,-1178,-1803,-2310,-2646,-2850,-2926,-2926,-2847,-2711,-2534,-2324,-2091,-1840,-1577,-1306,-1030,-752,-476,-203,64,325,578,822,1058,1282,1494,1690,1866,2014,2129,2200,2200,2172,2047,1835,1517,1113,609,87,-371,-784,-1157,-1451,-1613,-1677,-1653,-1560,-1417,-1233,-1019,-782,-531,-271,-6,259,
+    239,513,782,1043,1292,1524,1734,1917,2061,2159,2189,2139,1976,1667,1203,529,-257,-1115,-1929,-2562,-3039,-3322,-3461,-3461,-3423,-3296,-3116,-2901,-2655,-2389,-2105,-1809,-1505,-1195,-881,-567,-253,57,363,664,957,1243,1517,1778,2022,2246,2443,2607,2726,2788,2788,2699,2507,2185,1749,1180,553,-82,-666,-1117,-1451,-1644,-1727,-1716,-1630,-1488,-1301,-1082,-839,-581,-311,-37,239,
+    141,464,782,1049,1292,1524,1734,1917,2061,2159,2189,2189,1976,1278,344,-709,-1750,-2604,-3289,-3748,-4032,-4159,-4165,-4086,-3936,-3739,-3501,-3235,-2946,-2640,-2320,-1990,-1653,-1311,-963,-608,-253,88,424,764,1099,1427,1746,2054,2347,2623,2876,3102,3290,3435,3519,3519,3443,3235,2888,2363,1693,852,-19,-825,-1451,-1684,-1727,-1716,-1630,-1485,-1301,-1104,-886,-649,-396,-137,141,
+    141,413,680,937,1176,1393,1572,1706,1765,1734,1551,1160,521,-501,-1675,-2870,-3926,-4596,-5010,-5200,-5224,-5150,-4991,-4782,-4526,-4242,-3931,-3602,-3258,-2902,-2537,-2164,-1786,-1404,-1019,-632,-244,142,528,911,1290,1664,2032,2391,2741,3078,3398,3700,3976,4221,4422,4573,4645,4623,4461,4111,3559,2720,1759,770,-123,-737,-1150,-1358,-1419,-1382,-1264,-1096,-886,-651,-396,-131,141,
+    9040,-16583,-10427,-7932,-7415,-6909,-6704,-6381,-6097,-5860,-5704,-5704,-5744,-6033,-6396,-6754,-7023,-7023,-6954,-6718,-6386,-5993,-5554,-5075,-4614,-4256,-3931,-3597,-3258,-2902,-2537,-2164,-1786,-1415,-1019,-559,-71,466,929,1125,1290,1639,2032,2391,2741,3061,3398,3803,4244,4717,5191,5637,6036,6368,6611,6743,6754,6599,6366,6105,5889,5855,5855,5997,6217,6488,6802,7140,7501,7874,8258,8258,9040,
+    17929,-17571,-17071,-16571,-16071,-15571,-15071,-14571,-14071,-13571,-13071,-12571,-12071,-11571,-11071,-10571,-10071,-9571,-9071,-8571,-8071,-7571,-7071,-6571,-6071,-5571,-5071,-4571,-4071,-3571,-3071,-2571,-2071,-1571,-1071,-571,-71,429,929,1429,1929,2429,2929,3429,3929,4429,4929,5429,5929,6429,6929,7429,7929,8429,8929,9429,9929,10429,10929,11429,11929,12429,12929,13429,13929,14429,14929,15429,15929,16429,16929,17429,17929
 };
 
-const float AP_Declination::inclination_table[19][37] = {
-    {-72.15514,-72.15514,-72.15514,-72.15514,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15513,-72.15514,-72.15514,-72.15514,-72.15514,-72.15514,-72.15514,-72.15514},
-    {-78.41938,-77.65720,-76.73750,-75.70236,-74.58798,-73.42713,-72.25182,-71.09474,-69.98907,-68.96648,-68.05411,-67.27158,-66.62917,-66.12826,-65.76418,-65.53067,-65.42438,-65.44784,-65.60989,-65.92339,-66.40121,-67.05164,-67.87473,-68.86017,-69.98700,-71.22453,-72.53382,-73.86899,-75.17816,-76.40410,-77.48547,-78.36007,-78.97179,-79.28132,-79.27661,-78.97577,-78.41938},
-    {-81.01394,-79.19354,-77.36330,-75.50423,-73.59085,-71.60725,-69.56243,-67.50284,-65.51562,-63.71750,-62.22814,-61.13417,-60.45695,-60.14119,-60.07436,-60.13141,-60.22358,-60.32959,-60.49886,-60.83015,-61.43611,-62.40625,-63.78154,-65.54891,-67.65384,-70.02042,-72.56767,-75.21637,-77.88752,-80.49381,-82.91772,-84.94371,-86.09650,-85.83265,-84.51758,-82.81598,-81.01394},
-    {-77.57314,-75.57627,-73.65643,-71.75236,-69.77902,-67.63834,-65.25509,-62.63653,-59.92397,-57.39957,-55.42857,-54.33546,-54.24860,-55.00475,-56.20273,-57.38532,-58.22377,-58.60633,-58.63690,-58.59002,-58.82471,-59.65214,-61.21772,-63.47750,-66.26844,-69.40327,-72.72828,-76.12771,-79.49774,-82.71529,-85.55816,-87.23537,-86.33673,-84.19492,-81.90400,-79.68142,-77.57314},
-    {-71.61543,-69.68071,-67.81295,-65.98732,-64.14688,-62.17325,-59.89199,-57.17213,-54.08269,-51.00980,-48.64526,-47.75928,-48.75785,-51.33161,-54.60713,-57.67200,-59.93603,-61.13032,-61.22418,-60.51276,-59.68523,-59.55885,-60.61820,-62.82724,-65.81275,-69.14491,-72.49609,-75.61467,-78.21163,-79.94564,-80.58474,-80.18788,-79.04223,-77.44162,-75.58435,-73.60578,-71.61543},
-    {-64.37232,-62.41896,-60.47622,-58.52696,-56.58944,-54.65086,-52.56912,-50.08837,-47.05221,-43.75107,-41.15259,-40.61471,-42.92315,-47.48780,-52.84135,-57.78264,-61.78868,-64.59420,-65.79355,-65.17341,-63.32395,-61.60337,-61.26328,-62.62104,-65.13165,-67.99298,-70.59799,-72.54035,-73.51467,-73.54501,-73.01716,-72.21990,-71.17485,-69.83733,-68.20192,-66.33391,-64.37232},
-    {-54.95221,-52.86419,-50.76591,-48.58110,-46.34373,-44.17713,-42.09147,-39.78009,-36.80878,-33.28666,-30.49763,-30.50812,-34.40344,-41.04847,-48.30470,-54.79768,-60.23560,-64.58921,-67.32150,-67.73041,-65.88657,-62.97458,-60.81524,-60.54948,-61.84643,-63.65901,-65.18925,-65.95250,-65.66438,-64.64265,-63.60342,-62.78558,-61.89618,-60.67851,-59.04993,-57.06784,-54.95221},
-    {-42.11386,-39.71540,-37.42483,-35.05675,-32.54684,-30.08394,-27.80378,-25.32349,-22.02374,-18.05872,-15.18383,-16.05640,-21.78336,-30.70367,-40.14151,-48.30425,-54.72071,-59.52309,-62.50036,-63.16678,-61.44170,-58.08476,-54.78220,-53.13352,-53.22163,-54.08263,-54.91880,-55.11744,-54.20645,-52.62937,-51.43900,-50.82759,-50.12042,-48.88316,-47.03524,-44.65772,-42.11386},
-    {-25.13413,-22.26490,-19.81259,-17.42498,-14.84507,-12.27503,-9.86112,-7.06257,-3.32091,0.81170,3.26607,1.47837,-5.45280,-16.03006,-27.48020,-37.20828,-44.04254,-48.15139,-50.04572,-50.01060,-48.00052,-44.32786,-40.52423,-38.33249,-37.93574,-38.43154,-39.10891,-39.27530,-38.24513,-36.52908,-35.53036,-35.38136,-34.94364,-33.61633,-31.38812,-28.37515,-25.13413},
-    {-4.98724,-1.67113,0.80624,2.98017,5.33226,7.69596,9.97866,12.77254,16.36048,19.83531,21.34544,19.04912,12.24385,1.74844,-10.05341,-20.06978,-26.53723,-29.54293,-30.15639,-29.36839,-27.14298,-23.31481,-19.29463,-16.98941,-16.55873,-17.01490,-17.72494,-18.08276,-17.33194,-15.95689,-15.51123,-16.06549,-16.12696,-14.92427,-12.47974,-8.91893,-4.98724},
-    {14.90282,18.28085,20.60765,22.44210,24.40105,26.45274,28.51977,30.96055,33.77883,36.09590,36.59075,34.17570,28.42190,19.80101,10.09244,1.82326,-3.38282,-5.35317,-5.09095,-3.87579,-1.76843,1.66543,5.30533,7.38022,7.73795,7.35305,6.77420,6.35804,6.66144,7.31673,7.03597,5.77710,4.97055,5.51060,7.51077,10.90541,14.90282},
-    {31.18963,34.07820,36.15493,37.77321,39.49122,41.42181,43.45993,45.61640,47.69248,49.01037,48.72897,46.33216,41.81270,35.71328,29.23542,23.81452,20.40725,19.30431,19.92626,21.21332,22.94355,25.46085,28.10581,29.64612,29.92208,29.67696,29.36743,29.13603,29.17665,29.18105,28.33513,26.63499,25.13382,24.70085,25.65298,28.02186,31.18963},
-    {43.43755,45.49190,47.26481,48.85551,50.58716,52.57872,54.71110,56.79027,58.49411,59.27330,58.58690,56.31729,52.84224,48.81000,44.95503,41.89331,40.02366,39.54270,40.19143,41.32256,42.64128,44.25362,45.87796,46.89272,47.16813,47.12227,47.08047,47.09378,47.09015,46.74024,45.58111,43.68407,41.77157,40.56696,40.45969,41.53519,43.43755},
-    {53.14782,54.39692,55.85421,57.48060,59.33861,61.41997,63.58932,65.61909,67.16297,67.73632,66.96414,64.95612,62.26740,59.52539,57.18039,55.46617,54.49933,54.33769,54.84891,55.69458,56.62748,57.61136,58.56598,59.29096,59.71825,59.99071,60.24551,60.46371,60.46654,59.94194,58.64378,56.71646,54.68166,53.08630,52.27188,52.34019,53.14782},
-    {61.94434,62.65988,63.82448,65.37386,67.23521,69.29012,71.36784,73.24154,74.58711,74.99756,74.23745,72.52856,70.40872,68.38080,66.74355,65.60955,64.99647,64.87946,65.16376,65.68049,66.27974,66.90598,67.55683,68.22109,68.88444,69.53923,70.14291,70.56735,70.59156,69.97960,68.65713,66.83530,64.91593,63.28781,62.20398,61.76373,61.94434},
-    {70.63808,71.09315,71.98608,73.26619,74.84990,76.61252,78.38590,79.94294,80.96893,81.12757,80.33123,78.87452,77.18440,75.59163,74.28473,73.34040,72.76654,72.53101,72.57154,72.80778,73.17108,73.63386,74.21058,74.92988,75.79757,76.76288,77.69093,78.35319,78.47680,77.89101,76.66981,75.09384,73.49103,72.12315,71.15227,70.65240,70.63808},
-    {78.93654,79.23546,79.83613,80.70281,81.78075,82.98979,84.21001,85.24697,85.79655,85.59093,84.72327,83.52137,82.24759,81.05849,80.04256,79.24469,78.67956,78.34092,78.20960,78.26251,78.48242,78.86522,79.41957,80.15662,81.07098,82.11600,83.17407,84.02661,84.37742,84.04550,83.16374,82.03536,80.91903,79.98035,79.31253,78.96013,78.93654},
-    {86.10236,86.22193,86.48572,86.87541,87.36129,87.89241,88.36587,88.57214,88.32223,87.73845,87.01883,86.26928,85.54489,84.88026,84.29972,83.82070,83.45516,83.21059,83.09120,83.09908,83.23514,83.49941,83.89025,84.40254,85.02486,85.73566,86.49754,87.24606,87.86481,88.16518,88.02685,87.59994,87.10131,86.65607,86.32486,86.13654,86.10236},
-    {88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643,88.07643}
+const int16_t AP_Declination::inclination_table[2701] = {
+    -7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,-7216,
+    -7553,-7538,-7520,-7499,-7477,-7452,-7426,-7399,-7370,-7342,-7311,-7267,-7225,-7206,-7191,-7163,-7133,-7105,-7078,-7052,-7028,-7005,-6983,-6963,-6944,-6928,-6913,-6900,-6889,-6880,-6873,-6869,-6867,-6867,-6870,-6874,-6881,-6890,-6901,-6915,-6930,-6948,-6967,-6989,-7012,-7037,-7064,-7092,-7121,-7152,-7183,-7215,-7248,-7280,-7313,-7344,-7375,-7405,-7433,-7459,-7483,-7504,-7522,-7538,-7552,-7563,-7572,-7578,-7581,-7580,-7574,-7566,-7553,
+    -7842,-7806,-7766,-7721,-7674,-7623,-7570,-7515,-7459,-7401,-7343,-7284,-7225,-7167,-7109,-7053,-6999,-6947,-6897,-6850,-6805,-6765,-6727,-6693,-6663,-6636,-6613,-6593,-6576,-6563,-6553,-6546,-6542,-6542,-6545,-6551,-6561,-6575,-6592,-6614,-6640,-6670,-6705,-6744,-6787,-6835,-6886,-6941,-6999,-7059,-7122,-7187,-7253,-7320,-7387,-7453,-7518,-7581,-7640,-7697,-7749,-7795,-7836,-7870,-7897,-7917,-7928,-7928,-7928,-7916,-7898,-7873,-7842,
+    -8032,-7969,-7900,-7820,-7736,-7651,-7570,-7509,-7448,-7369,-7284,-7201,-7118,-7035,-6954,-6874,-6797,-6723,-6654,-6590,-6531,-6479,-6432,-6392,-6359,-6331,-6308,-6290,-6276,-6266,-6259,-6254,-6253,-6254,-6258,-6265,-6276,-6292,-6313,-6339,-6372,-6412,-6458,-6512,-6572,-6639,-6713,-6792,-6877,-6967,-7060,-7157,-7256,-7357,-7459,-7561,-7662,-7761,-7858,-7950,-8037,-8118,-8190,-8251,-8295,-8310,-8310,-8288,-8251,-8205,-8152,-8094,-8032,
+    -8101,-8011,-7919,-7828,-7736,-7644,-7550,-7456,-7359,-7261,-7161,-7059,-6956,-6853,-6750,-6649,-6552,-6459,-6372,-6293,-6223,-6163,-6113,-6075,-6046,-6026,-6014,-6008,-6007,-6009,-6013,-6017,-6022,-6027,-6033,-6040,-6050,-6064,-6083,-6109,-6144,-6187,-6241,-6304,-6378,-6462,-6555,-6656,-6765,-6881,-7002,-7128,-7257,-7388,-7522,-7655,-7789,-7921,-8049,-8174,-8292,-8401,-8494,-8566,-8610,-8610,-8583,-8526,-8452,-8370,-8282,-8192,-8101,
+    -7983,-7883,-7785,-7688,-7591,-7495,-7398,-7299,-7197,-7093,-6985,-6873,-6758,-6639,-6519,-6398,-6281,-6168,-6063,-5969,-5889,-5824,-5776,-5746,-5731,-5731,-5743,-5763,-5788,-5815,-5840,-5862,-5879,-5891,-5899,-5904,-5909,-5915,-5927,-5947,-5977,-6019,-6074,-6145,-6228,-6325,-6435,-6555,-6684,-6822,-6965,-7114,-7266,-7422,-7579,-7737,-7894,-8051,-8203,-8353,-8489,-8613,-8694,-8680,-8634,-8617,-8583,-8498,-8393,-8291,-8187,-8084,-7983,
+    -7757,-7656,-7558,-7461,-7366,-7271,-7175,-7078,-6978,-6873,-6764,-6648,-6526,-6397,-6264,-6127,-5992,-5862,-5740,-5632,-5543,-5476,-5434,-5425,-5425,-5455,-5500,-5558,-5620,-5682,-5739,-5785,-5822,-5847,-5861,-5864,-5864,-5860,-5859,-5865,-5882,-5916,-5965,-6035,-6122,-6227,-6348,-6482,-6627,-6780,-6940,-7105,-7273,-7443,-7613,-7782,-7950,-8114,-8272,-8423,-8556,-8663,-8724,-8702,-8634,-8535,-8419,-8305,-8190,-8078,-7968,-7861,-7757,
+    -7483,-7383,-7286,-7190,-7096,-7003,-6910,-6816,-6720,-6619,-6513,-6399,-6276,-6144,-6004,-5858,-5709,-5563,-5426,-5306,-5208,-5141,-5107,-5111,-5148,-5217,-5309,-5415,-5527,-5638,-5739,-5820,-5884,-5928,-5954,-5954,-5953,-5934,-5912,-5892,-5886,-5912,-5956,-6004,-6072,-6176,-6304,-6445,-6600,-6762,-6931,-7101,-7273,-7444,-7612,-7773,-7925,-8064,-8187,-8291,-8371,-8422,-8435,-8394,-8320,-8226,-8119,-8013,-7904,-7797,-7690,-7586,-7483,
+    -7162,-7064,-6968,-6874,-6781,-6690,-6599,-6508,-6415,-6319,-6217,-6108,-5989,-5858,-5717,-5565,-5408,-5250,-5101,-4969,-4865,-4799,-4776,-4804,-4876,-4990,-5133,-5294,-5461,-5620,-5767,-5892,-5994,-6067,-6113,-6122,-6122,-6093,-6051,-6006,-5969,-5956,-5956,-5994,-6062,-6160,-6283,-6425,-6581,-6746,-6914,-7083,-7250,-7410,-7561,-7700,-7821,-7920,-7995,-8040,-8058,-8050,-8019,-7969,-7904,-7829,-7744,-7654,-7558,-7460,-7361,-7261,-7162,
+    -6821,-6724,-6628,-6533,-6439,-6345,-6252,-6159,-6066,-5971,-5873,-5768,-5655,-5530,-5393,-5242,-5084,-4920,-4764,-4623,-4514,-4452,-4441,-4495,-4603,-4764,-4958,-5173,-5391,-5591,-5778,-5954,-6107,-6221,-6302,-6347,-6358,-6331,-6280,-6211,-6140,-6083,-6049,-6054,-6093,-6172,-6281,-6415,-6565,-6722,-6882,-7038,-7187,-7324,-7446,-7547,-7627,-7682,-7713,-7713,-7708,-7678,-7635,-7584,-7523,-7455,-7379,-7296,-7207,-7113,-7017,-6919,-6821,
+    -6437,-6339,-6242,-6145,-6048,-5950,-5853,-5756,-5659,-5563,-5465,-5364,-5257,-5139,-5009,-4862,-4705,-4537,-4375,-4228,-4115,-4061,-4061,-4145,-4292,-4502,-4749,-5014,-5284,-5540,-5778,-5992,-6179,-6337,-6459,-6541,-6579,-6567,-6517,-6432,-6332,-6237,-6160,-6126,-6126,-6176,-6262,-6378,-6513,-6656,-6799,-6935,-7060,-7167,-7254,-7315,-7351,-7355,-7355,-7333,-7302,-7265,-7222,-7173,-7117,-7054,-6984,-6905,-6820,-6729,-6633,-6536,-6437,
+    -6001,-5901,-5801,-5701,-5600,-5497,-5393,-5289,-5186,-5084,-4982,-4882,-4777,-4664,-4540,-4397,-4242,-4070,-3902,-3747,-3631,-3602,-3602,-3719,-3909,-4168,-4467,-4781,-5097,-5393,-5670,-5925,-6147,-6317,-6459,-6607,-6714,-6714,-6703,-6621,-6511,-6389,-6272,-6180,-6126,-6144,-6204,-6291,-6399,-6516,-6635,-6745,-6842,-6919,-6973,-6999,-7001,-6980,-6944,-6904,-6860,-6818,-6775,-6729,-6678,-6619,-6552,-6476,-6392,-6299,-6202,-6102,-6001,
+    -5495,-5391,-5286,-5182,-5077,-4968,-4858,-4746,-4634,-4525,-4418,-4314,-4209,-4099,-3978,-3837,-3681,-3504,-3329,-3167,-3050,-3050,-3051,-3204,-3440,-3752,-4105,-4469,-4830,-5166,-5480,-5765,-6024,-6258,-6459,-6620,-6732,-6773,-6773,-6702,-6589,-6445,-6297,-6173,-6082,-6055,-6055,-6107,-6185,-6274,-6366,-6449,-6519,-6568,-6595,-6592,-6566,-6520,-6464,-6411,-6360,-6319,-6279,-6237,-6190,-6133,-6068,-5991,-5905,-5809,-5707,-5602,-5495,
+    -4901,-4789,-4678,-4569,-4459,-4346,-4230,-4111,-3991,-3874,-3759,-3650,-3541,-3429,-3305,-3158,-2994,-2806,-2620,-2450,-2333,-2333,-2375,-2570,-2858,-3227,-3639,-4059,-4473,-4854,-5206,-5522,-5805,-6059,-6277,-6453,-6578,-6641,-6643,-6579,-6466,-6314,-6148,-5993,-5866,-5793,-5764,-5782,-5828,-5890,-5958,-6020,-6070,-6102,-6111,-6089,-6044,-5979,-5909,-5847,-5793,-5753,-5718,-5681,-5638,-5583,-5516,-5436,-5345,-5241,-5130,-5016,-4901,
+    -4211,-4090,-3972,-3857,-3742,-3625,-3506,-3381,-3255,-3130,-3008,-2894,-2780,-2663,-2532,-2377,-2202,-2001,-1806,-1632,-1518,-1518,-1606,-1842,-2178,-2601,-3070,-3547,-4014,-4441,-4830,-5172,-5472,-5734,-5952,-6127,-6250,-6313,-6317,-6256,-6144,-5986,-5808,-5633,-5478,-5375,-5313,-5313,-5322,-5361,-5408,-5454,-5492,-5512,-5512,-5477,-5421,-5344,-5263,-5197,-5144,-5110,-5083,-5051,-5012,-4957,-4888,-4803,-4704,-4589,-4466,-4339,-4211,
+    -3408,-3274,-3146,-3025,-2907,-2788,-2667,-2539,-2409,-2281,-2155,-2037,-1918,-1793,-1653,-1485,-1298,-1087,-886,-715,-613,-623,-748,-1018,-1394,-1863,-2383,-2916,-3439,-3915,-4342,-4706,-5013,-5267,-5468,-5621,-5721,-5759,-5759,-5691,-5575,-5409,-5221,-5031,-4860,-4739,-4660,-4638,-4638,-4663,-4700,-4738,-4771,-4784,-4784,-4745,-4682,-4597,-4511,-4446,-4398,-4374,-4356,-4332,-4297,-4242,-4168,-4075,-3964,-3835,-3696,-3552,-3408,
+    -2513,-2365,-2226,-2101,-1981,-1863,-1742,-1615,-1485,-1355,-1228,-1108,-986,-854,-706,-528,-332,-117,81,241,327,296,148,-144,-545,-1046,-1603,-2181,-2748,-3263,-3721,-4098,-4404,-4641,-4815,-4936,-5005,-5005,-5001,-4923,-4800,-4628,-4433,-4233,-4052,-3922,-3833,-3797,-3794,-3812,-3843,-3879,-3911,-3928,-3928,-3888,-3825,-3739,-3653,-3593,-3553,-3542,-3538,-3524,-3494,-3439,-3362,-3261,-3139,-2994,-2838,-2675,-2513,
+    -1524,-1361,-1212,-1083,-964,-849,-734,-610,-484,-359,-235,-119,2,135,286,466,660,865,1049,1187,1251,1202,1041,745,341,-167,-735,-1334,-1923,-2459,-2931,-3310,-3607,-3820,-3965,-4052,-4089,-4089,-4046,-3960,-3832,-3653,-3452,-3245,-3056,-2919,-2826,-2786,-2781,-2797,-2827,-2863,-2896,-2919,-2922,-2887,-2829,-2748,-2669,-2620,-2594,-2600,-2612,-2611,-2591,-2538,-2459,-2353,-2221,-2061,-1887,-1704,-1524,
+    -499,-324,-167,-36,81,190,298,414,533,652,770,881,998,1129,1277,1452,1636,1823,1984,2095,2135,2072,1905,1616,1224,731,175,-418,-1005,-1539,-2007,-2374,-2654,-2841,-2954,-3009,-3016,-2994,-2937,-2845,-2714,-2534,-2331,-2121,-1929,-1792,-1699,-1660,-1656,-1672,-1701,-1738,-1772,-1800,-1808,-1782,-1733,-1663,-1596,-1561,-1551,-1576,-1607,-1613,-1613,-1568,-1492,-1385,-1248,-1079,-892,-694,-499,
+    520,700,860,990,1102,1204,1303,1409,1518,1629,1739,1844,1956,2081,2219,2379,2543,2703,2835,2918,2934,2860,2695,2423,2060,1604,1089,538,-9,-507,-943,-1282,-1535,-1695,-1783,-1794,-1794,-1757,-1690,-1596,-1470,-1295,-1100,-895,-709,-576,-486,-450,-446,-461,-489,-522,-555,-583,-596,-579,-544,-489,-440,-432,-432,-475,-524,-557,-566,-537,-474,-375,-244,-76,114,318,520,
+    1490,1670,1828,1954,2061,2155,2244,2341,2440,2542,2645,2746,2852,2969,3096,3238,3378,3508,3610,3659,3659,3577,3418,3169,2842,2436,1980,1492,1009,568,182,-117,-338,-471,-535,-535,-509,-460,-388,-296,-177,-15,167,357,531,655,738,771,774,760,735,707,677,651,636,644,666,703,732,730,704,644,578,526,497,507,551,633,751,908,1091,1291,1490,
+    2352,2521,2671,2791,2892,2980,3063,3152,3244,3341,3441,3541,3645,3756,3873,3997,4115,4219,4293,4300,4300,4211,4058,3832,3544,3194,2807,2397,1994,1626,1306,1056,873,768,722,730,772,827,901,987,1094,1237,1395,1561,1713,1822,1896,1925,1927,1916,1895,1872,1849,1829,1815,1819,1830,1850,1861,1843,1802,1730,1651,1582,1533,1533,1539,1597,1691,1825,1986,2168,2352,
+    3119,3270,3408,3520,3615,3699,3777,3861,3949,4044,4142,4243,4346,4454,4562,4671,4769,4850,4901,4901,4873,4780,4633,4430,4181,3889,3571,3243,2924,2633,2381,2184,2041,1960,1930,1947,1993,2050,2121,2200,2294,2415,2546,2684,2811,2902,2965,2990,2992,2984,2968,2952,2937,2923,2914,2914,2918,2918,2918,2886,2834,2753,2663,2581,2513,2476,2470,2500,2565,2670,2802,2957,3119,
+    3772,3901,4022,4124,4214,4295,4373,4456,4544,4639,4738,4841,4946,5053,5157,5256,5342,5407,5442,5437,5389,5293,5154,4972,4758,4515,4259,4000,3753,3530,3338,3188,3080,3022,3004,3025,3071,3127,3194,3265,3346,3445,3551,3662,3762,3837,3889,3911,3915,3910,3899,3890,3881,3875,3870,3870,3870,3867,3850,3809,3747,3661,3565,3472,3391,3334,3305,3309,3345,3418,3517,3640,3772,
+    4344,4447,4549,4641,4726,4806,4886,4970,5059,5156,5258,5364,5471,5578,5679,5772,5849,5903,5927,5912,5859,5763,5632,5469,5284,5085,4881,4682,4496,4330,4189,4080,4002,3963,3954,3977,4019,4072,4132,4195,4264,4343,4425,4510,4588,4647,4689,4710,4717,4717,4712,4710,4708,4708,4709,4709,4709,4699,4674,4626,4558,4468,4368,4268,4177,4106,4057,4046,4046,4087,4154,4243,4344,
+    4851,4931,5014,5095,5176,5255,5337,5424,5516,5616,5720,5828,5937,6043,6143,6232,6304,6351,6369,6349,6294,6201,6079,5933,5774,5608,5443,5288,5145,5021,4918,4838,4783,4757,4755,4776,4814,4861,4914,4969,5026,5089,5153,5217,5277,5325,5361,5383,5395,5401,5405,5410,5415,5422,5427,5427,5427,5412,5381,5328,5256,5165,5063,4960,4863,4781,4718,4680,4667,4682,4719,4778,4851,
+    5315,5373,5440,5510,5585,5664,5748,5838,5934,6036,6142,6251,6359,6464,6562,6648,6716,6759,6774,6751,6696,6608,6496,6366,6227,6087,5953,5829,5718,5624,5547,5489,5450,5434,5434,5453,5485,5525,5569,5615,5663,5712,5761,5810,5857,5896,5929,5953,5972,5987,5999,6012,6025,6037,6046,6047,6047,6029,5994,5938,5864,5773,5672,5568,5468,5381,5309,5258,5227,5227,5234,5267,5315,
+    5761,5803,5856,5917,5987,6063,6147,6239,6336,6439,6545,6653,6759,6862,6956,7038,7102,7140,7151,7128,7074,6992,6889,6772,6650,6531,6417,6315,6225,6151,6090,6046,6017,6006,6006,6021,6046,6078,6114,6151,6190,6228,6267,6306,6344,6379,6411,6440,6465,6489,6512,6534,6555,6573,6586,6587,6587,6567,6529,6471,6397,6306,6207,6106,6007,5918,5842,5783,5742,5720,5717,5732,5761,
+    6194,6224,6266,6319,6382,6456,6537,6627,6724,6825,6929,7034,7137,7235,7324,7401,7459,7492,7500,7475,7424,7347,7253,7149,7041,6936,6838,6751,6674,6611,6561,6524,6500,6488,6488,6498,6516,6540,6568,6597,6628,6659,6691,6723,6756,6789,6822,6855,6888,6922,6954,6986,7014,7039,7057,7059,7059,7037,6998,6939,6866,6778,6684,6586,6492,6405,6329,6267,6220,6190,6176,6178,6194,
+    6632,6654,6688,6734,6791,6859,6935,7019,7110,7206,7304,7403,7500,7592,7674,7743,7794,7821,7824,7797,7746,7674,7588,7495,7399,7307,7220,7143,7075,7019,6974,6940,6917,6904,6900,6905,6916,6932,6953,6975,7000,7025,7052,7081,7112,7145,7181,7219,7258,7300,7341,7382,7419,7451,7474,7480,7480,7457,7418,7360,7288,7205,7116,7026,6938,6857,6785,6726,6679,6646,6628,6628,6632,
+    7064,7081,7109,7149,7199,7258,7327,7403,7485,7572,7661,7751,7839,7921,7994,8054,8097,8113,8113,8083,8033,7966,7887,7804,7718,7636,7559,7490,7428,7377,7334,7301,7277,7261,7253,7253,7257,7267,7281,7298,7317,7339,7363,7391,7421,7455,7493,7535,7580,7628,7676,7725,7769,7807,7835,7848,7848,7827,7789,7734,7667,7591,7509,7428,7349,7277,7212,7158,7115,7084,7065,7064,7064,
+    7488,7502,7525,7559,7601,7651,7709,7774,7844,7919,7995,8073,8148,8219,8281,8330,8362,8362,8361,8327,8276,8213,8142,8068,7993,7922,7854,7792,7737,7689,7649,7616,7591,7573,7561,7555,7555,7559,7568,7580,7596,7615,7638,7665,7695,7730,7770,7814,7862,7914,7966,8020,8070,8114,8148,8167,8170,8154,8121,8071,8011,7944,7873,7803,7735,7674,7619,7572,7535,7508,7491,7488,7488,
+    7894,7905,7924,7950,7984,8024,8070,8122,8178,8238,8299,8361,8421,8477,8525,8560,8580,8578,8559,8522,8472,8415,8352,8288,8225,8164,8106,8053,8004,7962,7924,7893,7868,7848,7834,7825,7821,7821,7826,7835,7848,7865,7887,7912,7942,7977,8016,8059,8107,8158,8212,8266,8317,8364,8403,8428,8438,8429,8405,8365,8316,8261,8204,8147,8092,8042,7998,7961,7931,7910,7896,7894,7894,
+    8291,8299,8312,8331,8355,8384,8418,8455,8496,8539,8583,8627,8667,8702,8727,8738,8738,8721,8692,8654,8608,8559,8507,8456,8405,8357,8311,8269,8229,8194,8164,8137,8115,8097,8083,8074,8069,8069,8071,8078,8089,8104,8122,8145,8172,8203,8238,8276,8319,8364,8411,8460,8508,8554,8594,8626,8648,8650,8650,8630,8600,8563,8522,8481,8441,8405,8372,8344,8322,8305,8295,8291,8291,
+    8610,8614,8622,8634,8649,8667,8688,8711,8736,8763,8789,8815,8837,8851,8857,8850,8832,8806,8774,8739,8702,8664,8627,8590,8554,8520,8488,8458,8430,8405,8382,8362,8346,8332,8321,8314,8309,8309,8310,8315,8324,8335,8350,8368,8389,8413,8440,8470,8502,8537,8574,8611,8650,8688,8725,8758,8786,8806,8817,8814,8803,8784,8760,8735,8710,8687,8666,8647,8632,8621,8614,8610,8610,
+    8785,8787,8790,8795,8800,8804,8808,8808,8808,8808,8808,8821,8837,8850,8857,8848,8832,8821,8808,8790,8770,8752,8734,8717,8702,8688,8675,8663,8652,8641,8632,8624,8617,8612,8607,8603,8601,8601,8601,8602,8605,8610,8615,8622,8631,8641,8652,8664,8678,8693,8710,8729,8748,8769,8788,8800,8808,8814,8817,8813,8808,8808,8808,8808,8808,8807,8805,8799,8793,8789,8786,8785,8785,
+    8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808,8808
 };
 
-const float AP_Declination::intensity_table[19][37] = {
-    {0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779,0.54779},
-    {0.60837,0.60220,0.59450,0.58547,0.57534,0.56430,0.55260,0.54051,0.52830,0.51629,0.50481,0.49417,0.48467,0.47656,0.47008,0.46544,0.46285,0.46247,0.46446,0.46890,0.47579,0.48502,0.49634,0.50939,0.52367,0.53860,0.55356,0.56792,0.58108,0.59253,0.60189,0.60890,0.61344,0.61552,0.61525,0.61280,0.60837},
-    {0.63258,0.61970,0.60507,0.58890,0.57125,0.55217,0.53178,0.51039,0.48854,0.46699,0.44657,0.42804,0.41193,0.39851,0.38787,0.38006,0.37526,0.37389,0.37653,0.38383,0.39624,0.41387,0.43636,0.46284,0.49210,0.52268,0.55299,0.58146,0.60660,0.62725,0.64260,0.65237,0.65672,0.65618,0.65146,0.64336,0.63258},
-    {0.62095,0.60243,0.58290,0.56243,0.54073,0.51730,0.49170,0.46391,0.43471,0.40564,0.37864,0.35546,0.33702,0.32321,0.31311,0.30575,0.30078,0.29875,0.30106,0.30949,0.32559,0.34998,0.38207,0.42017,0.46201,0.50518,0.54726,0.58585,0.61871,0.64402,0.66081,0.66905,0.66955,0.66358,0.65259,0.63798,0.62095},
-    {0.58620,0.56373,0.54114,0.51857,0.49563,0.47134,0.44448,0.41429,0.38135,0.34789,0.31726,0.29272,0.27609,0.26667,0.26176,0.25848,0.25542,0.25307,0.25351,0.26004,0.27617,0.30384,0.34230,0.38856,0.43871,0.48915,0.53690,0.57926,0.61368,0.63832,0.65262,0.65718,0.65336,0.64282,0.62713,0.60777,0.58620},
-    {0.54054,0.51627,0.49228,0.46880,0.44572,0.42234,0.39721,0.36894,0.33742,0.30457,0.27434,0.25147,0.23907,0.23614,0.23823,0.24087,0.24203,0.24166,0.24097,0.24339,0.25474,0.27997,0.31964,0.36973,0.42394,0.47661,0.52408,0.56374,0.59341,0.61236,0.62157,0.62234,0.61581,0.60319,0.58561,0.56419,0.54054},
-    {0.48867,0.46503,0.44165,0.41863,0.39623,0.37454,0.35283,0.32976,0.30421,0.27678,0.25090,0.23196,0.22388,0.22576,0.23267,0.24037,0.24755,0.25361,0.25697,0.25833,0.26348,0.28050,0.31390,0.36106,0.41386,0.46412,0.50708,0.53992,0.56069,0.57069,0.57365,0.57144,0.56381,0.55092,0.53338,0.51203,0.48867},
-    {0.43253,0.41175,0.39135,0.37126,0.35187,0.33373,0.31703,0.30085,0.28340,0.26400,0.24494,0.23085,0.22546,0.22878,0.23747,0.24859,0.26158,0.27535,0.28592,0.29056,0.29243,0.29975,0.32084,0.35718,0.40141,0.44430,0.48014,0.50509,0.51651,0.51743,0.51457,0.51016,0.50215,0.48970,0.47325,0.45356,0.43253},
-    {0.37920,0.36357,0.34861,0.33428,0.32094,0.30906,0.29901,0.29027,0.28111,0.27011,0.25800,0.24747,0.24170,0.24271,0.25038,0.26289,0.27848,0.29521,0.30916,0.31675,0.31844,0.31999,0.33017,0.35323,0.38456,0.41649,0.44359,0.46117,0.46580,0.46094,0.45426,0.44791,0.43910,0.42690,0.41213,0.39570,0.37920},
-    {0.34153,0.33271,0.32464,0.31758,0.31215,0.30839,0.30613,0.30492,0.30318,0.29885,0.29113,0.28131,0.27228,0.26771,0.27053,0.28020,0.29350,0.30751,0.31975,0.32797,0.33146,0.33325,0.33952,0.35374,0.37352,0.39442,0.41263,0.42404,0.42554,0.41934,0.41078,0.40157,0.39035,0.37734,0.36408,0.35186,0.34153},
-    {0.32870,0.32607,0.32446,0.32437,0.32687,0.33172,0.33779,0.34389,0.34801,0.34747,0.34080,0.32911,0.31570,0.30498,0.30097,0.30427,0.31213,0.32189,0.33188,0.34049,0.34689,0.35278,0.36094,0.37200,0.38471,0.39787,0.40970,0.41726,0.41829,0.41286,0.40244,0.38841,0.37237,0.35653,0.34312,0.33381,0.32870},
-    {0.34033,0.34108,0.34427,0.35011,0.35952,0.37200,0.38564,0.39812,0.40667,0.40818,0.40093,0.38646,0.36911,0.35402,0.34504,0.34287,0.34584,0.35257,0.36183,0.37142,0.38023,0.38954,0.40019,0.41097,0.42118,0.43143,0.44120,0.44828,0.45031,0.44540,0.43237,0.41263,0.39030,0.36959,0.35349,0.34378,0.34033},
-    {0.37286,0.37425,0.38045,0.39099,0.40563,0.42319,0.44141,0.45760,0.46878,0.47164,0.46425,0.44822,0.42852,0.41089,0.39901,0.39341,0.39308,0.39740,0.40545,0.41491,0.42425,0.43421,0.44546,0.45716,0.46876,0.48057,0.49201,0.50099,0.50465,0.49993,0.48499,0.46152,0.43456,0.40947,0.38986,0.37762,0.37286},
-    {0.42301,0.42396,0.43139,0.44439,0.46152,0.48059,0.49920,0.51504,0.52566,0.52833,0.52129,0.50580,0.48620,0.46770,0.45379,0.44539,0.44205,0.44336,0.44854,0.45590,0.46409,0.47337,0.48463,0.49801,0.51297,0.52857,0.54321,0.55444,0.55930,0.55497,0.54021,0.51688,0.48967,0.46376,0.44295,0.42921,0.42301},
-    {0.48379,0.48443,0.49110,0.50289,0.51807,0.53427,0.54920,0.56099,0.56797,0.56854,0.56177,0.54851,0.53155,0.51445,0.50002,0.48959,0.48345,0.48151,0.48332,0.48795,0.49463,0.50341,0.51494,0.52962,0.54684,0.56497,0.58158,0.59393,0.59937,0.59603,0.58366,0.56421,0.54142,0.51947,0.50159,0.48950,0.48379},
-    {0.53971,0.53998,0.54408,0.55129,0.56040,0.56987,0.57817,0.58402,0.58645,0.58476,0.57870,0.56880,0.55636,0.54317,0.53091,0.52082,0.51365,0.50978,0.50925,0.51182,0.51725,0.52552,0.53678,0.55096,0.56731,0.58420,0.59944,0.61067,0.61601,0.61448,0.60643,0.59353,0.57838,0.56374,0.55175,0.54361,0.53971},
-    {0.57270,0.57191,0.57270,0.57465,0.57722,0.57979,0.58173,0.58248,0.58164,0.57897,0.57445,0.56828,0.56094,0.55308,0.54545,0.53875,0.53362,0.53052,0.52975,0.53146,0.53567,0.54232,0.55121,0.56189,0.57362,0.58531,0.59567,0.60348,0.60783,0.60838,0.60542,0.59985,0.59290,0.58587,0.57979,0.57531,0.57270},
-    {0.57801,0.57670,0.57563,0.57472,0.57387,0.57296,0.57187,0.57049,0.56875,0.56662,0.56412,0.56133,0.55839,0.55547,0.55278,0.55055,0.54900,0.54830,0.54859,0.54996,0.55239,0.55581,0.56003,0.56482,0.56984,0.57472,0.57910,0.58266,0.58517,0.58654,0.58683,0.58619,0.58487,0.58317,0.58133,0.57957,0.57801},
-    {0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621,0.56621}
+const int16_t AP_Declination::intensity_table[2701] = {
+    5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,5478,
+    5818,5804,5788,5770,5750,5728,5703,5678,5650,5622,5592,5559,5526,5496,5466,5434,5402,5370,5339,5308,5279,5250,5223,5198,5174,5152,5132,5115,5100,5087,5077,5070,5066,5066,5066,5071,5078,5089,5103,5119,5138,5160,5185,5212,5241,5272,5305,5339,5374,5410,5446,5483,5519,5555,5590,5623,5655,5685,5713,5739,5762,5783,5801,5816,5828,5837,5843,5846,5846,5843,5837,5829,5818,
+    6084,6055,6022,5985,5945,5901,5855,5805,5753,5699,5643,5585,5526,5466,5405,5344,5283,5222,5163,5105,5048,4994,4942,4893,4847,4804,4766,4731,4701,4675,4654,4639,4628,4625,4625,4632,4645,4664,4689,4720,4758,4801,4850,4904,4963,5027,5094,5164,5237,5311,5386,5461,5536,5609,5679,5747,5811,5870,5925,5975,6019,6057,6089,6115,6134,6148,6155,6155,6152,6143,6128,6108,6084,
+    6250,6204,6154,6101,6041,5966,5889,5820,5753,5686,5614,5534,5450,5365,5279,5192,5106,5020,4935,4852,4772,4696,4623,4554,4490,4431,4378,4330,4288,4252,4222,4200,4184,4176,4175,4183,4200,4226,4261,4305,4359,4423,4495,4576,4665,4762,4864,4971,5083,5197,5312,5424,5536,5648,5757,5858,5952,6038,6116,6185,6245,6294,6334,6364,6384,6394,6396,6390,6375,6353,6325,6290,6250,
+    6326,6264,6197,6126,6051,5972,5889,5803,5712,5619,5522,5421,5318,5212,5104,4995,4885,4777,4670,4566,4466,4370,4280,4197,4119,4049,3985,3928,3879,3836,3801,3773,3753,3741,3739,3747,3765,3796,3838,3894,3962,4044,4139,4246,4364,4492,4628,4772,4921,5073,5227,5380,5530,5675,5815,5945,6066,6175,6272,6356,6426,6482,6524,6552,6567,6567,6562,6543,6515,6478,6434,6383,6326,
+    6304,6228,6146,6061,5973,5881,5786,5688,5586,5479,5368,5253,5134,5010,4884,4755,4625,4495,4368,4245,4128,4018,3915,3822,3737,3662,3595,3537,3486,3442,3405,3376,3354,3340,3336,3343,3363,3396,3444,3509,3590,3689,3804,3935,4080,4237,4406,4583,4765,4952,5139,5325,5507,5683,5849,6004,6146,6272,6382,6473,6548,6603,6642,6663,6669,6661,6636,6585,6526,6481,6434,6373,6304,
+    6210,6118,6024,5928,5829,5728,5624,5518,5407,5293,5173,5048,4917,4780,4639,4494,4347,4200,4056,3918,3786,3665,3555,3457,3370,3296,3232,3178,3131,3091,3058,3029,3008,2993,2988,2993,3011,3044,3095,3165,3256,3368,3500,3652,3821,4005,4202,4408,4620,4836,5052,5265,5473,5671,5858,6031,6187,6324,6440,6535,6608,6659,6690,6695,6695,6673,6636,6586,6526,6457,6380,6297,6210,
+    6057,5954,5850,5744,5637,5529,5420,5308,5194,5076,4952,4822,4685,4541,4390,4234,4074,3914,3756,3605,3464,3336,3221,3124,3042,2975,2921,2878,2842,2812,2786,2762,2743,2727,2719,2720,2734,2763,2812,2883,2978,3099,3244,3413,3602,3809,4029,4258,4494,4732,4969,5201,5425,5639,5838,6020,6182,6322,6438,6530,6598,6642,6663,6663,6646,6611,6561,6499,6425,6343,6253,6157,6057,
+    5862,5750,5637,5524,5411,5299,5186,5072,4956,4837,4713,4583,4445,4298,4143,3980,3814,3645,3479,3320,3173,3041,2927,2835,2761,2706,2667,2638,2618,2600,2585,2569,2554,2540,2531,2531,2535,2558,2600,2668,2762,2886,3038,3219,3423,3647,3886,4134,4387,4641,4891,5135,5369,5589,5793,5976,6137,6273,6383,6467,6526,6560,6572,6562,6534,6488,6428,6355,6271,6178,6078,5972,5862,
+    5644,5526,5408,5290,5173,5056,4941,4826,4709,4591,4470,4342,4207,4062,3910,3748,3581,3411,3244,3083,2934,2804,2694,2609,2547,2508,2485,2475,2471,2469,2468,2462,2455,2446,2438,2433,2433,2446,2477,2533,2618,2738,2890,3076,3288,3525,3777,4039,4305,4569,4827,5074,5309,5527,5726,5901,6053,6177,6276,6348,6396,6420,6422,6404,6368,6316,6250,6171,6080,5981,5874,5761,5644,
+    5405,5284,5163,5042,4923,4805,4688,4573,4457,4342,4223,4101,3972,3835,3689,3535,3374,3209,3046,2888,2743,2618,2515,2440,2391,2367,2361,2368,2382,2396,2409,2416,2420,2420,2417,2411,2410,2414,2434,2476,2547,2656,2800,2983,3196,3438,3697,3967,4239,4507,4766,5012,5241,5450,5637,5799,5934,6042,6124,6181,6216,6223,6223,6199,6158,6102,6032,5949,5856,5753,5642,5525,5405,
+    5153,5031,4910,4790,4671,4552,4436,4320,4206,4093,3979,3863,3743,3616,3483,3341,3194,3040,2888,2739,2603,2486,2392,2328,2291,2289,2289,2308,2337,2372,2404,2420,2431,2444,2456,2460,2464,2466,2478,2505,2560,2663,2800,2958,3149,3385,3645,3915,4188,4453,4708,4946,5165,5360,5530,5672,5785,5871,5932,5973,5994,5994,5985,5957,5913,5855,5784,5701,5607,5502,5390,5273,5153,
+    4887,4769,4650,4533,4416,4301,4186,4073,3962,3853,3745,3638,3528,3415,3298,3173,3042,2905,2768,2633,2509,2403,2320,2266,2239,2239,2258,2289,2327,2365,2404,2441,2476,2508,2536,2556,2570,2575,2583,2599,2635,2702,2805,2953,3139,3363,3611,3873,4139,4396,4641,4867,5071,5249,5399,5517,5607,5668,5707,5729,5736,5732,5714,5683,5638,5580,5509,5427,5334,5231,5120,5005,4887,
+    4607,4494,4382,4271,4160,4050,3941,3834,3729,3627,3527,3430,3333,3235,3135,3029,2919,2801,2683,2564,2456,2373,2308,2263,2239,2239,2258,2294,2339,2386,2436,2487,2539,2591,2640,2680,2710,2726,2737,2747,2769,2814,2889,3008,3164,3363,3588,3831,4081,4322,4552,4761,4948,5108,5238,5332,5397,5434,5450,5450,5449,5437,5415,5382,5337,5279,5210,5129,5039,4938,4832,4720,4607,
+    4325,4221,4118,4015,3913,3812,3713,3614,3519,3426,3337,3253,3170,3090,3008,2923,2834,2738,2640,2541,2449,2370,2308,2271,2255,2262,2288,2326,2375,2428,2486,2549,2616,2686,2753,2812,2859,2888,2906,2913,2924,2949,2998,3085,3208,3376,3572,3789,4014,4234,4443,4633,4801,4941,5051,5123,5165,5174,5174,5163,5146,5127,5102,5067,5022,4965,4897,4819,4732,4637,4536,4431,4325,
+    4047,3954,3863,3772,3683,3595,3509,3424,3342,3263,3189,3119,3053,2990,2928,2872,2811,2730,2645,2565,2490,2424,2370,2335,2318,2322,2344,2381,2430,2487,2552,2623,2700,2780,2859,2929,2987,3025,3050,3059,3064,3075,3102,3162,3254,3387,3549,3734,3929,4121,4305,4474,4621,4742,4833,4886,4909,4905,4885,4861,4834,4810,4781,4744,4698,4642,4576,4501,4419,4330,4237,4142,4047,
+    3792,3713,3636,3560,3486,3413,3343,3275,3209,3148,3091,3038,2990,2946,2903,2858,2811,2758,2701,2640,2580,2523,2475,2439,2417,2417,2427,2458,2504,2561,2629,2704,2785,2869,2952,3028,3092,3137,3167,3180,3184,3187,3200,3237,3302,3404,3532,3683,3846,4008,4165,4309,4436,4538,4612,4649,4658,4641,4609,4577,4543,4512,4479,4439,4391,4334,4269,4198,4121,4040,3957,3874,3792,
+    3578,3516,3455,3397,3340,3284,3232,3181,3137,3110,3084,3039,2995,2968,2945,2920,2892,2858,2818,2772,2723,2672,2624,2583,2553,2538,2538,2557,2594,2646,2709,2781,2859,2939,3017,3089,3151,3199,3232,3249,3256,3258,3267,3292,3341,3426,3532,3648,3773,3905,4035,4155,4260,4344,4403,4429,4430,4406,4370,4332,4293,4256,4217,4171,4119,4060,3995,3927,3856,3784,3713,3644,3578,
+    3415,3370,3327,3286,3246,3209,3176,3147,3121,3101,3084,3071,3061,3055,3049,3042,3032,3014,2988,2953,2911,2863,2813,2765,2723,2693,2677,2682,2705,2747,2802,2866,2935,3006,3075,3140,3197,3244,3280,3301,3315,3322,3332,3356,3395,3458,3537,3632,3735,3841,3944,4041,4126,4194,4240,4255,4255,4231,4193,4152,4108,4063,4016,3962,3903,3840,3773,3707,3641,3578,3519,3465,3415,
+    3320,3289,3265,3255,3245,3213,3183,3172,3169,3170,3175,3183,3194,3207,3219,3229,3233,3228,3212,3182,3143,3093,3037,2980,2926,2880,2848,2843,2843,2869,2909,2959,3016,3076,3136,3193,3246,3292,3330,3357,3379,3396,3415,3444,3484,3539,3605,3679,3761,3853,3944,4027,4097,4144,4173,4183,4183,4163,4129,4081,4024,3967,3906,3840,3772,3701,3630,3563,3499,3444,3395,3354,3320,
+    3287,3272,3261,3251,3245,3244,3244,3253,3269,3291,3317,3347,3378,3410,3439,3464,3480,3480,3475,3448,3408,3354,3291,3223,3157,3098,3050,3021,3010,3019,3043,3078,3121,3169,3219,3270,3319,3364,3405,3439,3469,3497,3528,3565,3609,3662,3720,3782,3847,3913,3979,4041,4097,4142,4173,4183,4183,4163,4129,4082,4024,3958,3884,3805,3724,3643,3565,3494,3431,3379,3338,3308,3287,
+    3317,3311,3311,3314,3321,3333,3351,3378,3412,3454,3501,3551,3602,3652,3697,3735,3763,3769,3769,3743,3700,3640,3569,3492,3414,3343,3283,3241,3215,3215,3219,3241,3272,3310,3353,3400,3449,3496,3540,3580,3618,3656,3696,3742,3791,3843,3897,3952,4007,4063,4118,4172,4221,4261,4291,4305,4305,4287,4253,4202,4136,4056,3966,3871,3774,3681,3593,3514,3447,3395,3356,3331,3317,
+    3403,3403,3411,3424,3443,3468,3501,3544,3595,3655,3720,3788,3856,3922,3981,4031,4067,4082,4082,4056,4009,3943,3865,3778,3691,3610,3540,3487,3450,3432,3429,3438,3458,3488,3526,3570,3618,3667,3714,3758,3802,3848,3895,3948,4002,4056,4110,4161,4212,4263,4314,4365,4412,4452,4483,4500,4503,4488,4454,4398,4324,4231,4126,4015,3903,3796,3696,3609,3535,3478,3438,3414,3403,
+    3542,3543,3555,3575,3604,3642,3688,3745,3811,3886,3965,4048,4129,4207,4277,4335,4378,4401,4402,4376,4328,4258,4173,4080,3985,3897,3820,3759,3714,3686,3673,3673,3685,3708,3740,3782,3828,3876,3925,3972,4018,4067,4117,4172,4228,4284,4339,4392,4445,4498,4551,4604,4654,4698,4732,4754,4761,4747,4713,4653,4571,4468,4351,4227,4101,3981,3870,3772,3690,3627,3581,3554,3542,
+    3729,3729,3742,3768,3804,3852,3910,3979,4056,4142,4232,4324,4414,4499,4576,4640,4688,4714,4716,4691,4642,4570,4482,4385,4285,4192,4109,4042,3990,3955,3934,3931,3931,3947,3974,4011,4054,4101,4149,4195,4242,4291,4342,4397,4455,4513,4572,4630,4688,4747,4806,4865,4920,4970,5010,5037,5046,5035,4999,4936,4850,4740,4615,4481,4346,4216,4095,3989,3899,3828,3776,3744,3729,
+    3962,3962,3974,4002,4044,4099,4166,4243,4329,4422,4517,4613,4707,4794,4872,4937,4985,5011,5014,4990,4942,4870,4782,4684,4582,4487,4399,4327,4269,4226,4198,4182,4179,4188,4208,4238,4275,4317,4361,4405,4450,4497,4547,4602,4660,4721,4785,4850,4917,4986,5054,5121,5184,5240,5285,5316,5329,5318,5283,5219,5132,5020,4893,4756,4616,4482,4356,4245,4150,4074,4018,3981,3962,
+    4230,4230,4240,4269,4314,4373,4444,4526,4615,4710,4806,4901,4992,5076,5150,5212,5257,5281,5283,5259,5213,5143,5058,4962,4862,4766,4677,4601,4538,4489,4454,4431,4420,4422,4434,4456,4485,4520,4559,4599,4641,4685,4734,4787,4846,4911,4980,5054,5130,5208,5286,5362,5432,5494,5544,5578,5593,5584,5550,5488,5402,5293,5169,5034,4897,4763,4638,4526,4430,4352,4292,4252,4230,
+    4530,4530,4538,4567,4611,4669,4740,4820,4906,4997,5088,5176,5260,5336,5402,5455,5492,5510,5510,5485,5440,5375,5295,5204,5109,5016,4928,4851,4784,4730,4688,4658,4639,4635,4635,4649,4670,4698,4730,4765,4804,4847,4895,4948,5009,5076,5150,5230,5314,5400,5486,5568,5645,5711,5765,5801,5817,5809,5778,5720,5640,5538,5422,5296,5167,5041,4922,4816,4725,4650,4592,4552,4530,
+    4838,4838,4844,4871,4911,4965,5029,5102,5181,5262,5343,5420,5492,5556,5610,5652,5680,5685,5685,5660,5618,5558,5485,5403,5315,5228,5144,5068,5000,4943,4896,4860,4834,4820,4815,4820,4833,4853,4880,4910,4946,4987,5034,5088,5149,5219,5296,5380,5468,5559,5650,5736,5816,5885,5939,5976,5994,5988,5960,5909,5837,5746,5642,5530,5414,5301,5195,5099,5016,4948,4895,4858,4838,
+    5135,5135,5140,5162,5195,5240,5293,5353,5417,5483,5548,5610,5666,5715,5755,5784,5802,5802,5795,5770,5730,5677,5614,5542,5465,5387,5311,5240,5174,5117,5068,5029,4999,4978,4967,4967,4972,4986,5007,5034,5067,5106,5153,5207,5269,5339,5416,5500,5588,5678,5768,5853,5931,5999,6052,6089,6107,6104,6082,6039,5978,5902,5814,5720,5622,5527,5437,5356,5286,5228,5183,5152,5135,
+    5397,5397,5400,5416,5441,5474,5513,5557,5604,5652,5699,5742,5782,5815,5840,5857,5864,5861,5848,5822,5787,5741,5688,5628,5564,5498,5432,5368,5309,5255,5208,5168,5136,5113,5098,5092,5092,5102,5118,5142,5172,5210,5255,5308,5368,5436,5510,5590,5673,5758,5842,5922,5994,6057,6107,6141,6160,6160,6145,6112,6064,6004,5935,5861,5784,5709,5637,5573,5517,5472,5436,5411,5397,
+    5594,5591,5591,5600,5615,5635,5660,5687,5717,5747,5775,5798,5817,5830,5840,5853,5860,5853,5837,5814,5783,5737,5688,5646,5604,5552,5498,5446,5397,5351,5310,5275,5246,5223,5208,5200,5199,5206,5220,5241,5268,5303,5345,5393,5448,5509,5576,5647,5720,5787,5853,5926,5994,6050,6094,6126,6144,6144,6139,6106,6064,6031,5994,5941,5885,5830,5777,5730,5688,5653,5626,5606,5594,
+    5727,5721,5719,5721,5727,5736,5746,5759,5772,5785,5798,5809,5817,5823,5825,5823,5816,5805,5790,5769,5744,5715,5683,5647,5609,5570,5531,5492,5454,5419,5387,5360,5336,5318,5305,5298,5298,5303,5315,5333,5357,5387,5423,5465,5512,5564,5619,5677,5736,5796,5853,5907,5957,6000,6035,6061,6078,6084,6084,6073,6054,6029,5998,5965,5929,5893,5859,5827,5798,5773,5753,5738,5727,
+    5780,5773,5767,5761,5756,5750,5747,5758,5771,5774,5774,5774,5774,5771,5767,5760,5751,5739,5725,5708,5689,5668,5645,5620,5595,5568,5542,5517,5492,5469,5448,5430,5415,5403,5396,5394,5394,5399,5409,5424,5443,5467,5495,5526,5561,5599,5640,5681,5724,5766,5806,5844,5880,5910,5936,5957,5972,5980,5983,5981,5974,5962,5947,5930,5910,5885,5859,5834,5813,5803,5796,5788,5780,
+    5780,5773,5767,5761,5756,5752,5747,5743,5739,5734,5730,5724,5719,5712,5705,5697,5687,5677,5666,5654,5641,5628,5613,5599,5584,5569,5555,5541,5528,5516,5506,5497,5490,5485,5483,5483,5486,5491,5500,5510,5524,5540,5558,5578,5600,5624,5648,5673,5698,5723,5747,5770,5791,5810,5827,5841,5852,5860,5865,5868,5868,5866,5862,5856,5849,5841,5832,5823,5813,5804,5796,5788,5780,
+    5735,5732,5728,5724,5720,5715,5711,5707,5702,5697,5692,5687,5682,5676,5671,5666,5662,5662,5662,5653,5641,5630,5621,5614,5609,5603,5597,5592,5588,5584,5581,5578,5576,5575,5575,5576,5578,5582,5586,5591,5598,5605,5613,5622,5632,5642,5653,5664,5674,5685,5695,5705,5715,5723,5731,5738,5744,5749,5753,5756,5758,5760,5760,5760,5759,5757,5755,5752,5749,5746,5743,5739,5735,
+    5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662,5662
 };
 
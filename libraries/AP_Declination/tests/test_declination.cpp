@@ -0,0 +1,66 @@
+#include <AP_gtest.h>
+
+#include <AP_Declination/AP_Declination.h>
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+struct field_point {
+    float lat;
+    float lon;
+    float declination;
+    float inclination;
+    float intensity;
+};
+
+// points on the original 10 degree IGRF grid, which the finer tables
+// must still pass through
+static const struct field_point grid_points[] = {
+    { -40, 150,  14.80522f, -69.83733f, 0.60319f },
+    {  50,   0,  -0.19787f,  65.16376f, 0.48332f },
+    {  70, -40, -26.55257f,  80.04256f, 0.54545f },
+    { -10, -60, -15.48088f,  -5.45280f, 0.24170f },
+    {  30, 120,  -5.41927f,  45.58111f, 0.48499f },
+};
+
+TEST(AP_Declination, GridPoints)
+{
+    for (const struct field_point &p : grid_points) {
+        float intensity, declination, inclination;
+        EXPECT_TRUE(AP_Declination::get_mag_field_ef(p.lat, p.lon, intensity, declination, inclination));
+        // within the int16 quantisation of the tables
+        EXPECT_NEAR(p.declination, declination, 0.01f);
+        EXPECT_NEAR(p.inclination, inclination, 0.01f);
+        EXPECT_NEAR(p.intensity, intensity, 0.0001f);
+    }
+}
+
+TEST(AP_Declination, DateLine)
+{
+    for (float lat = -80; lat <= 80; lat += 5) {
+        const float west = AP_Declination::get_declination(lat, -179.99f);
+        const float east = AP_Declination::get_declination(lat, 179.99f);
+        EXPECT_NEAR(0, wrap_180(west - east), 0.1f);
+    }
+}
+
+TEST(AP_Declination, CellChange)
+{
+    // alternating between cells must give the same answer as a
+    // lookup in a freshly loaded cell
+    const float canberra = AP_Declination::get_declination(-35.36f, 149.16f);
+    const float greenland = AP_Declination::get_declination(72.5f, -40.3f);
+    for (uint8_t i=0; i<4; i++) {
+        EXPECT_FLOAT_EQ(canberra, AP_Declination::get_declination(-35.36f, 149.16f));
+        EXPECT_FLOAT_EQ(greenland, AP_Declination::get_declination(72.5f, -40.3f));
+    }
+}
+
+TEST(AP_Declination, OutOfRange)
+{
+    float intensity, declination, inclination;
+    EXPECT_FALSE(AP_Declination::get_mag_field_ef(95, 0, intensity, declination, inclination));
+    EXPECT_FALSE(AP_Declination::get_mag_field_ef(0, -190, intensity, declination, inclination));
+}
+
+AP_GTEST_MAIN()
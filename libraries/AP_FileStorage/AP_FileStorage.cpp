@@ -0,0 +1,293 @@
+/*
+   Please contribute your ideas! See http://dev.ardupilot.org for details
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+#include <AP_FileStorage/AP_FileStorage.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define FILESTORAGE_DEBUG 0
+
+#if FILESTORAGE_DEBUG
+#define debug(fmt, args...)  do { printf(fmt, ##args); } while(0)
+#else
+#define debug(fmt, args...)  do { } while(0)
+#endif
+
+// constructor.
+AP_FileStorage::AP_FileStorage(uint8_t *_mem_buffer) :
+    mem_buffer(_mem_buffer) {}
+
+// open the log, filling mem_buffer with its contents
+bool AP_FileStorage::init(const char *dir, const char *name)
+{
+    debug("running init()\n");
+
+    // start with empty memory buffer
+    memset(mem_buffer, 0, storage_size);
+
+    _name = name;
+    _write_error = false;
+    if (_tmp_name == nullptr && asprintf(&_tmp_name, "%s.tmp", name) == -1) {
+        _tmp_name = nullptr;
+        return false;
+    }
+    if (_dir_fd == -1) {
+        _dir_fd = open(dir, O_RDONLY|O_CLOEXEC);
+        if (_dir_fd == -1) {
+            return false;
+        }
+    }
+
+    // a left over compacted log was never completed, so the log it
+    // would have replaced is still complete
+    unlinkat(_dir_fd, _tmp_name, 0);
+
+    _fd = openat(_dir_fd, _name, O_RDWR|O_CLOEXEC);
+    if (_fd != -1) {
+        if (load()) {
+            // drop any torn record so new records follow good ones
+            if (ftruncate(_fd, _log_size) != 0) {
+                return false;
+            }
+            return true;
+        }
+
+        // not a log. A flat image from older firmware is imported
+        memset(mem_buffer, 0, storage_size);
+        struct stat st;
+        if (fstat(_fd, &st) == 0 && st.st_size == storage_size &&
+            pread(_fd, mem_buffer, storage_size, 0) != storage_size) {
+            memset(mem_buffer, 0, storage_size);
+        }
+        close(_fd);
+        _fd = -1;
+    }
+
+    // write a new log holding mem_buffer
+    if (!start_compaction()) {
+        return false;
+    }
+    while (_compact_offset < storage_size) {
+        if (!compact_step()) {
+            abort_compaction();
+            return false;
+        }
+    }
+    return finish_compaction();
+}
+
+uint32_t AP_FileStorage::record_crc(const struct record_header &header, const uint8_t *data)
+{
+    uint32_t crc = crc_crc32(signature, (const uint8_t *)&header.offset,
+                             sizeof(header) - offsetof(record_header, offset));
+    return crc_crc32(crc, data, header.length);
+}
+
+// replay the log into mem_buffer
+bool AP_FileStorage::load(void)
+{
+    struct file_header fh;
+    if (pread(_fd, &fh, sizeof(fh), 0) != sizeof(fh) ||
+        fh.signature != signature ||
+        fh.version != version ||
+        fh.storage_size != storage_size) {
+        return false;
+    }
+
+    uint32_t ofs = sizeof(fh);
+    uint8_t data[max_write];
+    while (true) {
+        struct record_header header;
+        if (pread(_fd, &header, sizeof(header), ofs) != sizeof(header) ||
+            header.length == 0 ||
+            header.length > max_write ||
+            header.offset + header.length > storage_size ||
+            pread(_fd, data, header.length, ofs + sizeof(header)) != header.length ||
+            record_crc(header, data) != header.crc) {
+            break;
+        }
+        memcpy(&mem_buffer[header.offset], data, header.length);
+        ofs += sizeof(header) + header.length;
+    }
+    debug("loaded %u bytes of log\n", (unsigned)ofs);
+
+    _log_size = ofs;
+    return true;
+}
+
+// write a record for a region of mem_buffer to a log
+bool AP_FileStorage::append(int fd, uint32_t *size, uint16_t offset, uint16_t length)
+{
+    // the record is built from a copy as mem_buffer may be changed
+    // by another thread while we write it
+    uint8_t record[sizeof(record_header) + max_write];
+    struct record_header &header = *(struct record_header *)record;
+    header.offset = offset;
+    header.length = length;
+    memcpy(&record[sizeof(header)], &mem_buffer[offset], length);
+    header.crc = record_crc(header, &record[sizeof(header)]);
+
+    // a short write leaves a torn record which is overwritten by
+    // the next one, as we write at the end of the last good record
+    const ssize_t n = sizeof(header) + length;
+    if (pwrite(fd, record, n, *size) != n) {
+        return false;
+    }
+    *size += n;
+    return true;
+}
+
+// append a region of mem_buffer to the log
+bool AP_FileStorage::write(uint16_t offset, uint16_t length)
+{
+    if (_fd == -1 || length == 0 || length > max_write || offset + length > storage_size) {
+        return false;
+    }
+    if (!append(_fd, &_log_size, offset, length)) {
+        _write_error = true;
+        return false;
+    }
+    _write_error = false;
+
+    if (_compact_fd != -1 && !append(_compact_fd, &_compact_size, offset, length)) {
+        abort_compaction();
+    }
+    return true;
+}
+
+// commit all records written so far
+bool AP_FileStorage::sync(void)
+{
+    if (_fd == -1) {
+        return false;
+    }
+    if (fdatasync(_fd) != 0) {
+        _write_error = true;
+        return false;
+    }
+    return true;
+}
+
+// compact the log a step at a time if it has grown too big
+bool AP_FileStorage::compact(void)
+{
+    if (_fd == -1) {
+        return false;
+    }
+    if (_compact_fd == -1) {
+        if (_log_size < max_log_size) {
+            return true;
+        }
+        return start_compaction();
+    }
+    if (_compact_offset < storage_size) {
+        if (!compact_step()) {
+            abort_compaction();
+            return false;
+        }
+        return true;
+    }
+    return finish_compaction();
+}
+
+// begin writing a compacted log to the temporary file
+bool AP_FileStorage::start_compaction(void)
+{
+    debug("compacting %u byte log\n", (unsigned)_log_size);
+
+    _compact_fd = openat(_dir_fd, _tmp_name, O_RDWR|O_CREAT|O_TRUNC|O_CLOEXEC, 0666);
+    if (_compact_fd == -1) {
+        return false;
+    }
+
+    struct file_header fh;
+    fh.signature = signature;
+    fh.version = version;
+    fh.storage_size = storage_size;
+    if (::write(_compact_fd, &fh, sizeof(fh)) != sizeof(fh)) {
+        abort_compaction();
+        return false;
+    }
+    _compact_size = sizeof(fh);
+    _compact_offset = 0;
+    return true;
+}
+
+// copy the next chunk of mem_buffer to the compacted log. Zero chunks
+// are skipped as the log is replayed over a zeroed buffer
+bool AP_FileStorage::compact_step(void)
+{
+    const uint16_t n = MIN(max_write, storage_size - _compact_offset);
+    if (!all_zero(_compact_offset, n) &&
+        !append(_compact_fd, &_compact_size, _compact_offset, n)) {
+        return false;
+    }
+    _compact_offset += n;
+    return true;
+}
+
+// commit the compacted log and swap it for the old one
+bool AP_FileStorage::finish_compaction(void)
+{
+    if (fsync(_compact_fd) != 0 ||
+        renameat(_dir_fd, _tmp_name, _dir_fd, _name) != 0) {
+        abort_compaction();
+        return false;
+    }
+    // make the rename durable
+    fsync(_dir_fd);
+
+    debug("compacted log to %u bytes\n", (unsigned)_compact_size);
+
+    if (_fd != -1) {
+        close(_fd);
+    }
+    _fd = _compact_fd;
+    _log_size = _compact_size;
+    _compact_fd = -1;
+    return true;
+}
+
+void AP_FileStorage::abort_compaction(void)
+{
+    close(_compact_fd);
+    _compact_fd = -1;
+    unlinkat(_dir_fd, _tmp_name, 0);
+}
+
+// return true if all bytes are zero
+bool AP_FileStorage::all_zero(uint16_t ofs, uint16_t size) const
+{
+    while (size--) {
+        if (mem_buffer[ofs++] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // CONFIG_HAL_BOARD
@@ -0,0 +1,133 @@
+/*
+   Please contribute your ideas! See http://dev.ardupilot.org for details
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  a class to allow for a file on a POSIX filesystem to be used as a
+  memory backed storage backend. It follows the log based approach of
+  AP_FlashStorage so that a small change costs a small write rather
+  than a rewrite of the whole storage area. Key design elements:
+
+  - each write appends one record holding a region of mem_buffer,
+    protected by a CRC. Records are committed with sync()
+
+  - init replays the log into mem_buffer. A record torn by a crash
+    or power loss fails its CRC, and the log is truncated there, so
+    storage comes back as it was after the last complete record
+
+  - once the log grows past max_log_size it is compacted in the
+    background, one chunk per call, into a new file holding just the
+    non-zero contents of mem_buffer. Records written meanwhile go to
+    both files, and the new file replaces the old one with rename(),
+    so a crash at any point leaves one complete log
+
+  - a file holding a flat image of storage, as written by older
+    firmware, is imported and replaced by a log
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+
+class AP_FileStorage {
+public:
+    // constructor. mem_buffer is storage_size bytes
+    AP_FileStorage(uint8_t *mem_buffer);
+
+    /* Do not allow copies */
+    AP_FileStorage(const AP_FileStorage &other) = delete;
+    AP_FileStorage &operator=(const AP_FileStorage&) = delete;
+
+    // open the log called name in directory dir, filling mem_buffer
+    // with its contents. The name must remain valid
+    bool init(const char *dir, const char *name);
+
+    // append a region of mem_buffer to the log. It is not committed
+    // until sync() is called
+    bool write(uint16_t offset, uint16_t length);
+
+    // commit all records written so far
+    bool sync(void);
+
+    // compact the log a step at a time if it has grown too big. This
+    // should be called regularly from the same thread as write()
+    bool compact(void);
+
+    // true if init() succeeded and no write has failed since
+    bool healthy(void) const { return _fd != -1 && !_write_error; }
+
+    // size of the log in bytes
+    uint32_t log_size(void) const { return _log_size; }
+
+    // fixed storage size
+    static const uint16_t storage_size = HAL_STORAGE_SIZE;
+
+    // largest region that can be written at once
+    static const uint16_t max_write = 512;
+
+    // size the log may grow to before it is compacted
+    static const uint32_t max_log_size = 4 * (uint32_t)storage_size;
+
+private:
+    uint8_t *mem_buffer;
+
+    int _dir_fd = -1;
+    int _fd = -1;
+    const char *_name = nullptr;
+    char *_tmp_name = nullptr;
+    uint32_t _log_size = 0;
+    bool _write_error = false;
+
+    // compaction in progress
+    int _compact_fd = -1;
+    uint32_t _compact_size = 0;
+    uint16_t _compact_offset = 0;
+
+    // "APLS" signature and format version
+    static const uint32_t signature = 0x534C5041;
+    static const uint16_t version = 1;
+
+    // header at the start of the file
+    struct PACKED file_header {
+        uint32_t signature;
+        uint16_t version;
+        uint16_t storage_size;
+    };
+
+    // header of each record, followed by length bytes of data
+    struct PACKED record_header {
+        uint32_t crc;
+        uint16_t offset;
+        uint16_t length;
+    };
+
+    // crc of a record, seeded so that a zero filled tail is invalid
+    static uint32_t record_crc(const struct record_header &header, const uint8_t *data);
+
+    // replay the log in _fd into mem_buffer
+    bool load(void);
+
+    // write a record for a region of mem_buffer to fd at *size,
+    // advancing *size if it succeeds
+    bool append(int fd, uint32_t *size, uint16_t offset, uint16_t length);
+
+    // begin, advance and finish writing a compacted log
+    bool start_compaction(void);
+    bool compact_step(void);
+    bool finish_compaction(void);
+    void abort_compaction(void);
+
+    // return true if all bytes are zero
+    bool all_zero(uint16_t ofs, uint16_t size) const;
+};
@@ -17,6 +17,7 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_FlashStorage/AP_FlashStorage.h>
+#include <AP_Math/crc.h>
 #include <stdio.h>
 
 #define FLASHSTORAGE_DEBUG 0
@@ -93,25 +94,24 @@ bool AP_FlashStorage::init(void)
         first_sector = 0;
     }
 
-    // load data from any current sectors
-    for (uint8_t i=0; i<2; i++) {
-        uint8_t sector = (first_sector + i) & 1;
-        if (states[sector] == SECTOR_STATE_IN_USE ||
-            states[sector] == SECTOR_STATE_FULL) {
-            if (!load_sector(sector)) {
-                return erase_all();
-            }
-        }
+    // load from the last checkpoint. If that fails the checkpoint
+    // may be bad, so fall back to loading everything
+    uint8_t first_load;
+    if (!load_sectors(states, first_sector, true, first_load) &&
+        !load_sectors(states, first_sector, false, first_load)) {
+        return erase_all();
     }
 
     // clear any write error
     write_error = false;
     reserved_space = 0;
     
-    // if the first sector is full then write out all data so we can erase it
+    // if the first sector is full then write out all data so we can
+    // erase it, unless a checkpoint in the other sector already holds
+    // all data
     if (states[first_sector] == SECTOR_STATE_FULL) {
         current_sector = first_sector ^ 1;
-        if (!write_all()) {
+        if (first_load == 0 && !write_all()) {
             return erase_all();
         }
     }
@@ -214,11 +214,53 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 }
 
 /*
-  load all data from a flash sector into mem_buffer
+  load data from the current sectors into mem_buffer, starting from
+  the last checkpoint if use_checkpoint is set. first_load is set to
+  1 if the checkpoint means the first sector didn't need loading
  */
-bool AP_FlashStorage::load_sector(uint8_t sector)
+bool AP_FlashStorage::load_sectors(const enum SectorState states[2], uint8_t first_sector, bool use_checkpoint, uint8_t &first_load)
 {
-    uint32_t ofs = sizeof(sector_header);
+    memset(mem_buffer, 0, storage_size);
+
+    // find the last checkpoint. Nothing written before it needs to
+    // be loaded, as the checkpoint follows a full write of storage
+    uint32_t start_offset[2] {sizeof(struct sector_header), sizeof(struct sector_header)};
+    first_load = 0;
+    for (int8_t i=1; use_checkpoint && i>=0; i--) {
+        uint8_t sector = (first_sector + i) & 1;
+        if (states[sector] == SECTOR_STATE_IN_USE ||
+            states[sector] == SECTOR_STATE_FULL) {
+            uint32_t checkpoint_offset;
+            if (!find_checkpoint(sector, checkpoint_offset)) {
+                return false;
+            }
+            if (checkpoint_offset != 0) {
+                start_offset[i] = checkpoint_offset;
+                first_load = i;
+                break;
+            }
+        }
+    }
+
+    for (uint8_t i=first_load; i<2; i++) {
+        uint8_t sector = (first_sector + i) & 1;
+        if (states[sector] == SECTOR_STATE_IN_USE ||
+            states[sector] == SECTOR_STATE_FULL) {
+            if (!load_sector(sector, start_offset[i])) {
+                return false;
+            }
+            current_sector = sector;
+        }
+    }
+    return true;
+}
+
+/*
+  load data from a flash sector into mem_buffer
+ */
+bool AP_FlashStorage::load_sector(uint8_t sector, uint32_t start_offset)
+{
+    uint32_t ofs = start_offset;
     while (ofs < flash_sector_size - sizeof(struct block_header)) {
         struct block_header header;
         if (!flash_read(sector, ofs, (uint8_t *)&header, sizeof(header))) {
@@ -270,6 +312,111 @@ bool AP_FlashStorage::load_sector(uint8_t sector)
     return true;
 }
 
+/*
+  write an empty checkpoint index at the start of a sector which has
+  just come into use, and move write_offset past it
+ */
+bool AP_FlashStorage::write_checkpoint_index(uint8_t sector)
+{
+    struct block_header header;
+    header.state = BLOCK_STATE_WRITING;
+    header.block_num = 0;
+    header.num_blocks_minus_one = (num_checkpoints * sizeof(struct checkpoint) / block_size) - 1;
+    if (!flash_write(sector, sizeof(struct sector_header), (uint8_t*)&header, sizeof(header))) {
+        return false;
+    }
+    write_offset = sizeof(struct sector_header) + checkpoint_index_size;
+    return true;
+}
+
+/*
+  read the checkpoint index of a sector. Sectors written by older
+  firmware have no index
+ */
+bool AP_FlashStorage::read_checkpoint_index(uint8_t sector, struct checkpoint *cp, bool &have_index)
+{
+    have_index = false;
+
+    struct block_header header;
+    if (!flash_read(sector, sizeof(struct sector_header), (uint8_t *)&header, sizeof(header))) {
+        return false;
+    }
+    if (header.state != BLOCK_STATE_WRITING ||
+        header.block_num != 0 ||
+        (header.num_blocks_minus_one+1)*block_size != num_checkpoints * sizeof(struct checkpoint)) {
+        return true;
+    }
+    if (!flash_read(sector, sizeof(struct sector_header) + sizeof(header),
+                    (uint8_t *)cp, num_checkpoints * sizeof(struct checkpoint))) {
+        return false;
+    }
+    have_index = true;
+    return true;
+}
+
+/*
+  find the last checkpoint in a sector from its index
+ */
+bool AP_FlashStorage::find_checkpoint(uint8_t sector, uint32_t &start_offset)
+{
+    start_offset = 0;
+
+    struct checkpoint cp[num_checkpoints];
+    bool have_index;
+    if (!read_checkpoint_index(sector, cp, have_index)) {
+        return false;
+    }
+    if (!have_index) {
+        return true;
+    }
+
+    // a bad slot is ignored, falling back to the one before it
+    for (uint8_t i=0; i<num_checkpoints; i++) {
+        if (cp[i].signature == checkpoint_signature &&
+            cp[i].crc == crc_xmodem((const uint8_t *)&cp[i].start_offset, sizeof(cp[i].start_offset)) &&
+            cp[i].start_offset >= sizeof(struct sector_header) + checkpoint_index_size &&
+            cp[i].start_offset < flash_sector_size) {
+            start_offset = cp[i].start_offset;
+        }
+    }
+    return true;
+}
+
+/*
+  record a checkpoint for a full write of mem_buffer which started at
+  start_offset in the current sector
+ */
+bool AP_FlashStorage::write_checkpoint(uint32_t start_offset)
+{
+    struct checkpoint cp[num_checkpoints];
+    bool have_index;
+    if (!read_checkpoint_index(current_sector, cp, have_index)) {
+        return false;
+    }
+    if (!have_index) {
+        return true;
+    }
+
+    for (uint8_t i=0; i<num_checkpoints; i++) {
+        if (cp[i].signature == 0xFFFF && cp[i].crc == 0xFFFF && cp[i].start_offset == 0xFFFFFFFF) {
+            // program the offset before the signature, so a slot torn
+            // by a power failure never has a valid signature
+            const uint32_t slot_ofs = sizeof(struct sector_header) + sizeof(struct block_header) + i*sizeof(struct checkpoint);
+            cp[i].signature = checkpoint_signature;
+            cp[i].crc = crc_xmodem((const uint8_t *)&start_offset, sizeof(start_offset));
+            cp[i].start_offset = start_offset;
+            const uint8_t sig_len = sizeof(cp[i].signature) + sizeof(cp[i].crc);
+            return flash_write(current_sector, slot_ofs + sig_len,
+                               (const uint8_t *)&cp[i].start_offset, sizeof(cp[i].start_offset)) &&
+                   flash_write(current_sector, slot_ofs,
+                               (const uint8_t *)&cp[i], sig_len);
+        }
+    }
+
+    // index is full. init() will start from the last checkpoint
+    return true;
+}
+
 /*
   erase one sector
  */
@@ -303,7 +450,10 @@ bool AP_FlashStorage::erase_all(void)
     struct sector_header header;
     header.signature = signature;
     header.state = SECTOR_STATE_IN_USE;
-    return flash_write(current_sector, 0, (const uint8_t *)&header, sizeof(header));    
+    if (!flash_write(current_sector, 0, (const uint8_t *)&header, sizeof(header))) {
+        return false;
+    }
+    return write_checkpoint_index(current_sector);
 }
 
 /*
@@ -313,6 +463,8 @@ bool AP_FlashStorage::write_all(void)
 {
     debug("write_all to sector %u at %u with reserved_space=%u\n",
            current_sector, write_offset, reserved_space);
+    const uint8_t start_sector = current_sector;
+    const uint32_t start_offset = write_offset;
     for (uint16_t ofs=0; ofs<storage_size; ofs += max_write) {
         if (!all_zero(ofs, max_write)) {
             if (!write(ofs, max_write)) {
@@ -320,7 +472,12 @@ bool AP_FlashStorage::write_all(void)
             }
         }
     }
-    return true;
+    if (current_sector != start_sector) {
+        // we switched sectors part way through, so the data is not
+        // all in one sector
+        return true;
+    }
+    return write_checkpoint(start_offset);
 }
 
 // return true if all bytes are zero
@@ -386,7 +543,7 @@ bool AP_FlashStorage::switch_sectors(void)
     reserved_space = reserve_size;
     
     write_offset = sizeof(header);
-    return true;    
+    return write_checkpoint_index(current_sector);
 }
 
 /*
@@ -26,6 +26,9 @@
 
   - read requires scan of all log elements. This is expected to be called rarely
 
+  - each full write out of storage is recorded as a checkpoint, so
+    init only needs to read data written since the last checkpoint
+
   - assumes flash that erases to 0xFF and where writing can only clear
     bits, not set them
 
@@ -128,11 +131,49 @@ private:
         uint16_t num_blocks_minus_one:3;
     };
 
+    /*
+      a checkpoint follows a complete write of mem_buffer and holds
+      the offset in the sector where that write started, so init()
+      can skip everything written before it. Checkpoints are kept in
+      an index block at the start of each sector, written with its
+      slots erased when the sector comes into use and left in the
+      writing state so that older firmware skips it as an interrupted
+      write. Each slot is programmed once, offset first and signature
+      last, so a slot torn by a power failure has no signature. The
+      CRC catches a slot that has been corrupted since
+     */
+    static const uint16_t checkpoint_signature = 0x4843;
+    static const uint8_t num_checkpoints = 8;
+    struct checkpoint {
+        uint16_t signature;
+        uint16_t crc;           // crc_xmodem of start_offset
+        uint32_t start_offset;
+    };
+    static const uint16_t checkpoint_index_size = sizeof(block_header) + num_checkpoints * sizeof(checkpoint);
+
     // amount of space needed to write full storage
     static const uint32_t reserve_size = (storage_size / max_write) * (sizeof(block_header) + max_write) + max_write;
         
-    // load data from a sector
-    bool load_sector(uint8_t sector);
+    // load data from the current sectors, optionally from the last
+    // checkpoint
+    bool load_sectors(const enum SectorState states[2], uint8_t first_sector, bool use_checkpoint, uint8_t &first_load);
+
+    // load data from a sector, starting at the given offset
+    bool load_sector(uint8_t sector, uint32_t start_offset);
+
+    // write an empty checkpoint index at the start of a sector
+    bool write_checkpoint_index(uint8_t sector);
+
+    // read the checkpoint index of a sector, if it has one
+    bool read_checkpoint_index(uint8_t sector, struct checkpoint *cp, bool &have_index);
+
+    // find the start of the data for the last valid checkpoint in a
+    // sector, or zero if there is none
+    bool find_checkpoint(uint8_t sector, uint32_t &start_offset);
+
+    // record a checkpoint for a full write starting at start_offset
+    // in the current sector
+    bool write_checkpoint(uint32_t start_offset);
 
     // erase a sector and write header
     bool erase_sector(uint8_t sector);
@@ -39,7 +39,14 @@ private:
     // write to storage and mem_mirror
     void write(uint16_t offset, const uint8_t *data, uint16_t length);
 
+    // fill storage with random writes
+    void random_writes(uint32_t count);
+
+    // measure init() time after a number of random writes
+    void boot_time(uint32_t num_writes);
+
     bool erase_ok;
+    uint32_t bytes_read;
 };
 
 bool FlashTest::flash_write(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length)
@@ -72,6 +79,7 @@ bool FlashTest::flash_read(uint8_t sector, uint32_t offset, uint8_t *data, uint1
                       (unsigned)length);
     }
     memcpy(data, &flash[sector][offset], length);
+    bytes_read += length;
     return true;
 }
 
@@ -100,6 +108,84 @@ void FlashTest::write(uint16_t offset, const uint8_t *data, uint16_t length)
     }
 }
 
+void FlashTest::random_writes(uint32_t count)
+{
+    for (uint32_t i=0; i<count; i++) {
+        uint16_t ofs = get_random16() % sizeof(mem_buffer);
+        uint16_t length = get_random16() & 0x1F;
+        length = MIN(length, sizeof(mem_buffer) - ofs);
+        uint8_t data[length];
+        for (uint8_t j=0; j<length; j++) {
+            data[j] = get_random16() & 0xFF;
+        }
+
+        erase_ok = (i % 1000 == 0);
+        write(ofs, data, length);
+
+        if (erase_ok) {
+            if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
+                AP_HAL::panic("FATAL: data mis-match at i=%u", (unsigned)i);
+            }
+        }
+    }
+}
+
+/*
+  time init() as a board would see it at boot, with num_writes made
+  on each of several flights since the flash was erased. The flash is
+  restored before each timed init() as init() may write out all data
+  and erase a sector
+ */
+void FlashTest::boot_time(uint32_t num_writes)
+{
+    flash_erase(0);
+    flash_erase(1);
+    memset(mem_buffer, 0, sizeof(mem_buffer));
+    memset(mem_mirror, 0, sizeof(mem_mirror));
+    for (uint8_t flight=0; flight<4; flight++) {
+        if (!storage.init()) {
+            AP_HAL::panic("Failed boot time init()");
+        }
+        random_writes(num_writes);
+        erase_ok = true;
+        uint8_t b = 42;
+        write(37, &b, 1);
+    }
+
+    uint8_t *saved[2];
+    for (uint8_t i=0; i<2; i++) {
+        saved[i] = (uint8_t *)malloc(flash_sector_size);
+        memcpy(saved[i], flash[i], flash_sector_size);
+    }
+
+    const uint8_t runs = 20;
+    uint32_t total_us = 0;
+    bytes_read = 0;
+    for (uint8_t r=0; r<runs; r++) {
+        for (uint8_t i=0; i<2; i++) {
+            memcpy(flash[i], saved[i], flash_sector_size);
+        }
+        memset(mem_buffer, 0, sizeof(mem_buffer));
+        uint32_t start_us = AP_HAL::micros();
+        if (!storage.init()) {
+            AP_HAL::panic("Failed boot time init()");
+        }
+        total_us += AP_HAL::micros() - start_us;
+        if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
+            AP_HAL::panic("FATAL: boot time data mis-match");
+        }
+    }
+    hal.console->printf("%7u writes: init %5u us, %6u bytes read\n",
+                        (unsigned)num_writes,
+                        (unsigned)(total_us / runs),
+                        (unsigned)(bytes_read / runs));
+
+    for (uint8_t i=0; i<2; i++) {
+        memcpy(flash[i], saved[i], flash_sector_size);
+        free(saved[i]);
+    }
+}
+
 /*
  * test flash storage
  */
@@ -119,25 +205,8 @@ void FlashTest::loop(void)
         AP_HAL::panic("Failed first init()");
     }
 
-    // fill with 10k random writes
-    for (uint32_t i=0; i<5000000; i++) {
-        uint16_t ofs = get_random16() % sizeof(mem_buffer);
-        uint16_t length = get_random16() & 0x1F;
-        length = MIN(length, sizeof(mem_buffer) - ofs);
-        uint8_t data[length];
-        for (uint8_t j=0; j<length; j++) {
-            data[j] = get_random16() & 0xFF;
-        }
-
-        erase_ok = (i % 1000 == 0);
-        write(ofs, data, length);
-
-        if (erase_ok) {
-            if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
-                AP_HAL::panic("FATAL: data mis-match at i=%u", (unsigned)i);
-            }
-        }
-    }
+    // fill with random writes
+    random_writes(5000000);
 
     // force final write to allow for flush with erase_ok
     erase_ok = true;
@@ -158,6 +227,14 @@ void FlashTest::loop(void)
     if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
         AP_HAL::panic("FATAL: data mis-match");
     }
+
+    // boot time against the number of writes per flight
+    hal.console->printf("boot time\n");
+    const uint32_t num_writes[] { 100, 1000, 2000, 5000, 10000, 50000 };
+    for (uint8_t i=0; i<ARRAY_SIZE(num_writes); i++) {
+        boot_time(num_writes[i]);
+    }
+
     while (true) {
         hal.console->printf("TEST PASSED");
         hal.scheduler->delay(20000);
@@ -51,6 +51,10 @@
 #define BLEND_MASK_USE_SPD_ACC      4
 #define BLEND_COUNTER_FAILURE_INCREMENT 10
 
+// 1-sigma acceleration (m/s/s) assumed when propagating a GPS solution
+// forward to the blending epoch
+#define BLEND_ACCEL_NOISE 5.0f
+
 extern const AP_HAL::HAL &hal;
 
 // baudrates to try to detect GPSes with
@@ -89,8 +93,8 @@ const AP_Param::GroupInfo AP_GPS::var_info[] = {
 
     // @Param: AUTO_SWITCH
     // @DisplayName: Automatic Switchover Setting
-    // @Description: Automatic switchover to GPS reporting best lock
-    // @Values: 0:Disabled,1:UseBest,2:Blend,3:UseSecond
+    // @Description: Automatic switchover to GPS reporting best lock. BlendCovariance weights each receiver by its reported position and velocity covariance, falling back to the accuracy estimates, and time aligns the receivers so a blended solution is output at the rate of the fastest receiver
+    // @Values: 0:Disabled,1:UseBest,2:Blend,3:UseSecond,4:BlendCovariance
     // @User: Advanced
     AP_GROUPINFO("AUTO_SWITCH", 3, AP_GPS, _auto_switch, 1),
 
@@ -683,8 +687,13 @@ void AP_GPS::update(void)
     }
 
     // if blending is requested, attempt to calculate weighting for each GPS
-    if (_auto_switch == 2) {
-        _output_is_blended = calc_blend_weights();
+    if (_auto_switch == 2 || _auto_switch == 4) {
+        _blend_use_covariance = (_auto_switch == 4);
+        if (_blend_use_covariance) {
+            _output_is_blended = calc_blend_covariance_weights();
+        } else {
+            _output_is_blended = calc_blend_weights();
+        }
         // adjust blend health counter
         if (!_output_is_blended) {
             _blend_health_counter = MIN(_blend_health_counter+BLEND_COUNTER_FAILURE_INCREMENT, 100);
@@ -1164,6 +1173,7 @@ bool AP_GPS::calc_blend_weights(void)
 {
     // zero the blend weights
     memset(&_blend_weights, 0, sizeof(_blend_weights));
+    memset(&_blend_dt_sec, 0, sizeof(_blend_dt_sec));
 
     // exit immediately if not enough receivers to do blending
     if (num_instances < 2 || drivers[1] == nullptr || _type[1] == GPS_TYPE_NONE) {
@@ -1319,6 +1329,168 @@ bool AP_GPS::calc_blend_weights(void)
     return true;
 }
 
+/*
+ get the NED position and velocity covariance of a GPS for blending
+*/
+bool AP_GPS::get_blend_covariance(uint8_t instance, Matrix3f &pos_cov, Matrix3f &vel_cov) const
+{
+    const GPS_State &s = state[instance];
+
+    if (s.have_position_covariance) {
+        pos_cov = s.position_covariance;
+    } else if (s.have_horizontal_accuracy && s.horizontal_accuracy > 0.0f &&
+               s.have_vertical_accuracy && s.vertical_accuracy > 0.0f) {
+        const float h_var = sq(s.horizontal_accuracy);
+        pos_cov = Matrix3f(h_var, 0.0f, 0.0f,
+                           0.0f, h_var, 0.0f,
+                           0.0f, 0.0f, sq(s.vertical_accuracy));
+    } else {
+        return false;
+    }
+
+    if (s.have_velocity_covariance) {
+        vel_cov = s.velocity_covariance;
+    } else if (s.have_speed_accuracy && s.speed_accuracy > 0.0f) {
+        const float v_var = sq(s.speed_accuracy);
+        vel_cov = Matrix3f(v_var, 0.0f, 0.0f,
+                           0.0f, v_var, 0.0f,
+                           0.0f, 0.0f, v_var);
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ calculate the weighting matrices used to blend GPS location and
+ velocity data using the full covariance of each receiver.
+
+ Each solution is first propagated at constant velocity from the time
+ it was measured to the measurement time of the newest solution, with
+ its covariance grown to match. The solutions are then combined in
+ information form, giving each receiver the weight matrix
+   W_i = (sum_j P_j^-1)^-1 * P_i^-1
+ so a receiver that is accurate north-south but poor vertically is
+ trusted accordingly on each axis. As the epoch moves with every new
+ solution from any receiver the blended output updates at the rate of
+ the fastest one.
+*/
+bool AP_GPS::calc_blend_covariance_weights(void)
+{
+    // zero the blend weights
+    memset(&_blend_weights, 0, sizeof(_blend_weights));
+    memset(&_blend_dt_sec, 0, sizeof(_blend_dt_sec));
+
+    // exit immediately if not enough receivers to do blending
+    if (num_instances < 2 || drivers[1] == nullptr || _type[1] == GPS_TYPE_NONE) {
+        return false;
+    }
+
+    // find the measurement time of each solution, and the newest of them
+    uint32_t measured_ms[GPS_MAX_RECEIVERS] = {};
+    uint32_t epoch_ms = 0;
+    int16_t max_rate_ms = 0;
+    bool have_epoch = false;
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (state[i].status < GPS_OK_FIX_3D || state[i].last_gps_time_ms == 0) {
+            continue;
+        }
+        float lag_sec = 0;
+        get_lag(i, lag_sec);
+        measured_ms[i] = state[i].last_gps_time_ms - (uint32_t)(lag_sec * 1000.0f);
+        if (!have_epoch || (int32_t)(measured_ms[i] - epoch_ms) > 0) {
+            epoch_ms = measured_ms[i];
+            _blend_epoch_instance = i;
+            have_epoch = true;
+        }
+        if (get_rate_ms(i) > max_rate_ms) {
+            max_rate_ms = get_rate_ms(i);
+        }
+    }
+    if (!have_epoch) {
+        return false;
+    }
+
+    // propagate each receiver to the epoch and invert its covariances
+    Matrix3f pos_info[GPS_MAX_RECEIVERS];
+    Matrix3f vel_info[GPS_MAX_RECEIVERS];
+    Matrix3f pos_info_sum;
+    Matrix3f vel_info_sum;
+    bool used[GPS_MAX_RECEIVERS] = {};
+    Matrix3f accel_var;
+    accel_var.identity();
+    accel_var *= sq(BLEND_ACCEL_NOISE);
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (state[i].status < GPS_OK_FIX_3D || state[i].last_gps_time_ms == 0) {
+            continue;
+        }
+        const int32_t age_ms = (int32_t)(epoch_ms - measured_ms[i]);
+        if (age_ms >= 2 * max_rate_ms) {
+            // too old to propagate, leave it out of the blend
+            continue;
+        }
+        Matrix3f pos_cov, vel_cov;
+        if (!get_blend_covariance(i, pos_cov, vel_cov)) {
+            // covariance based blending needs every receiver to report accuracy
+            return false;
+        }
+        const float dt = 0.001f * age_ms;
+        if (age_ms > 0) {
+            pos_cov += vel_cov * sq(dt) + accel_var * (0.25f * sq(sq(dt)));
+            vel_cov += accel_var * sq(dt);
+        }
+        if (!pos_cov.inverse(pos_info[i]) || !vel_cov.inverse(vel_info[i])) {
+            continue;
+        }
+        pos_info_sum += pos_info[i];
+        vel_info_sum += vel_info[i];
+        _blend_dt_sec[i] = dt;
+        used[i] = true;
+    }
+
+    Matrix3f pos_cov_sum, vel_cov_sum;
+    if (!used[_blend_epoch_instance] ||
+        !pos_info_sum.inverse(pos_cov_sum) ||
+        !vel_info_sum.inverse(vel_cov_sum)) {
+        return false;
+    }
+
+    // the weight matrices sum to the identity, so their mean diagonal
+    // element gives the scalar weights used for the remaining fields
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (!used[i]) {
+            _blend_pos_weights[i].zero();
+            _blend_vel_weights[i].zero();
+            continue;
+        }
+        _blend_pos_weights[i] = pos_cov_sum * pos_info[i];
+        _blend_vel_weights[i] = vel_cov_sum * vel_info[i];
+        const float trace = _blend_pos_weights[i].a.x + _blend_pos_weights[i].b.y + _blend_pos_weights[i].c.z +
+                            _blend_vel_weights[i].a.x + _blend_vel_weights[i].b.y + _blend_vel_weights[i].c.z;
+        _blend_weights[i] = MAX(trace / 6.0f, 0.0f);
+    }
+
+    state[GPS_BLENDED_INSTANCE].last_gps_time_ms = state[_blend_epoch_instance].last_gps_time_ms;
+
+    return true;
+}
+
+/*
+ return the location of a GPS propagated forward by _blend_dt_sec
+*/
+Location AP_GPS::blend_aligned_location(uint8_t instance) const
+{
+    Location loc = state[instance].location;
+    const float dt = _blend_dt_sec[instance];
+    if (dt > 0.0f) {
+        const Vector3f &vel = state[instance].velocity;
+        location_offset(loc, vel.x * dt, vel.y * dt);
+        loc.alt -= (int32_t)(vel.z * dt * 100.0f);
+    }
+    return loc;
+}
+
 /*
  calculate a blended GPS state
 */
@@ -1358,7 +1530,11 @@ void AP_GPS::calc_blended_state(void)
         }
 
         // calculate a blended average velocity
-        state[GPS_BLENDED_INSTANCE].velocity += state[i].velocity * _blend_weights[i];
+        if (_blend_use_covariance) {
+            state[GPS_BLENDED_INSTANCE].velocity += _blend_vel_weights[i] * state[i].velocity;
+        } else {
+            state[GPS_BLENDED_INSTANCE].velocity += state[i].velocity * _blend_weights[i];
+        }
 
         // report the best valid accuracies and DOP metrics
 
@@ -1428,10 +1604,27 @@ void AP_GPS::calc_blended_state(void)
     Vector2f blended_NE_offset_m;
     float blended_alt_offset_cm = 0.0f;
     blended_NE_offset_m.zero();
-    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
-        if (_blend_weights[i] > 0.0f && i != best_index) {
-            blended_NE_offset_m += location_diff(state[GPS_BLENDED_INSTANCE].location, state[i].location) * _blend_weights[i];
-            blended_alt_offset_cm += (float)(state[i].location.alt - state[GPS_BLENDED_INSTANCE].location.alt) * _blend_weights[i];
+    if (_blend_use_covariance) {
+        // all receivers contribute, as the reference itself may need
+        // propagating forward to the blending epoch
+        Vector3f blended_NED_offset_m;
+        for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+            if (_blend_weights[i] > 0.0f) {
+                const Location loc = blend_aligned_location(i);
+                const Vector2f NE_offset_m = location_diff(state[GPS_BLENDED_INSTANCE].location, loc);
+                const Vector3f NED_offset_m(NE_offset_m.x, NE_offset_m.y, (state[GPS_BLENDED_INSTANCE].location.alt - loc.alt) * 0.01f);
+                blended_NED_offset_m += _blend_pos_weights[i] * NED_offset_m;
+            }
+        }
+        blended_NE_offset_m.x = blended_NED_offset_m.x;
+        blended_NE_offset_m.y = blended_NED_offset_m.y;
+        blended_alt_offset_cm = -100.0f * blended_NED_offset_m.z;
+    } else {
+        for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+            if (_blend_weights[i] > 0.0f && i != best_index) {
+                blended_NE_offset_m += location_diff(state[GPS_BLENDED_INSTANCE].location, state[i].location) * _blend_weights[i];
+                blended_alt_offset_cm += (float)(state[i].location.alt - state[GPS_BLENDED_INSTANCE].location.alt) * _blend_weights[i];
+            }
         }
     }
 
@@ -1465,10 +1658,11 @@ void AP_GPS::calc_blended_state(void)
         }
     }
 
-    // Calculate the offset from each GPS solution to the blended solution
+    // Calculate the offset from each GPS solution, at the blending epoch, to the blended solution
     for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
-        _NE_pos_offset_m[i] = location_diff(state[i].location, state[GPS_BLENDED_INSTANCE].location) * alpha[i] + _NE_pos_offset_m[i] * (1.0f - alpha[i]);
-        _hgt_offset_cm[i] = (float)(state[GPS_BLENDED_INSTANCE].location.alt - state[i].location.alt) *  alpha[i] + _hgt_offset_cm[i] * (1.0f - alpha[i]);
+        const Location loc = blend_aligned_location(i);
+        _NE_pos_offset_m[i] = location_diff(loc, state[GPS_BLENDED_INSTANCE].location) * alpha[i] + _NE_pos_offset_m[i] * (1.0f - alpha[i]);
+        _hgt_offset_cm[i] = (float)(state[GPS_BLENDED_INSTANCE].location.alt - loc.alt) *  alpha[i] + _hgt_offset_cm[i] * (1.0f - alpha[i]);
     }
 
     // Calculate a corrected location for each GPS
@@ -1525,6 +1719,15 @@ void AP_GPS::calc_blended_state(void)
     }
     timing[GPS_BLENDED_INSTANCE].last_fix_time_ms = (uint32_t)temp_time_1;
     timing[GPS_BLENDED_INSTANCE].last_message_time_ms = (uint32_t)temp_time_2;
+
+    if (_blend_use_covariance) {
+        // the solution is valid at the epoch of the newest receiver, so
+        // it takes that receiver's timing and lag. The message time then
+        // advances whenever any receiver produces a new solution
+        timing[GPS_BLENDED_INSTANCE].last_fix_time_ms = timing[_blend_epoch_instance].last_fix_time_ms;
+        timing[GPS_BLENDED_INSTANCE].last_message_time_ms = timing[_blend_epoch_instance].last_message_time_ms;
+        get_lag(_blend_epoch_instance, _blended_lag_sec);
+    }
 }
 
 bool AP_GPS::is_healthy(uint8_t instance) const {
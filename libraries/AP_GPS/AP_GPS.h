@@ -147,6 +147,10 @@ public:
         bool have_speed_accuracy;         ///< does GPS give speed accuracy? Set to true only once available.
         bool have_horizontal_accuracy;    ///< does GPS give horizontal position accuracy? Set to true only once available.
         bool have_vertical_accuracy;      ///< does GPS give vertical position accuracy? Set to true only once available.
+        bool have_position_covariance;    ///< does GPS give a full position covariance? Set to true only once available.
+        bool have_velocity_covariance;    ///< does GPS give a full velocity covariance? Set to true only once available.
+        Matrix3f position_covariance;       ///< NED position covariance in m^2
+        Matrix3f velocity_covariance;       ///< NED velocity covariance in (m/s)^2
         uint32_t last_gps_time_ms;          ///< the system time we got the last GPS timestamp, milliseconds
         uint32_t uart_timestamp_ms;         ///< optional timestamp from set_uart_timestamp()
 
@@ -546,6 +550,11 @@ private:
     Vector3f _blended_antenna_offset; // blended antenna offset
     float _blended_lag_sec = 0.001f * GPS_MAX_RATE_MS; // blended receiver lag in seconds
     float _blend_weights[GPS_MAX_RECEIVERS]; // blend weight for each GPS. The blend weights must sum to 1.0 across all instances.
+    Matrix3f _blend_pos_weights[GPS_MAX_RECEIVERS]; // NED position weight matrix for each GPS when blending by covariance. These sum to the identity.
+    Matrix3f _blend_vel_weights[GPS_MAX_RECEIVERS]; // NED velocity weight matrix for each GPS when blending by covariance. These sum to the identity.
+    float _blend_dt_sec[GPS_MAX_RECEIVERS]; // time each GPS solution is propagated forward to reach the common blending epoch (sec)
+    uint8_t _blend_epoch_instance; // GPS whose latest solution defines the blending epoch
+    bool _blend_use_covariance; // true when the blend is using the weight matrices
     uint32_t _last_time_updated[GPS_MAX_RECEIVERS]; // the last value of state.last_gps_time_ms read for that GPS instance - used to detect new data.
     float _omega_lpf; // cutoff frequency in rad/sec of LPF applied to position offsets
     bool _output_is_blended; // true when a blended GPS solution being output
@@ -554,6 +563,17 @@ private:
     // calculate the blend weight.  Returns true if blend could be calculated, false if not
     bool calc_blend_weights(void);
 
+    // calculate the blend weight matrices from the reported covariances,
+    // with each solution time aligned to the newest.  Returns true if blend could be calculated, false if not
+    bool calc_blend_covariance_weights(void);
+
+    // get the NED position and velocity covariance of a GPS, from the
+    // full covariance if reported, otherwise from the accuracy estimates
+    bool get_blend_covariance(uint8_t instance, Matrix3f &pos_cov, Matrix3f &vel_cov) const;
+
+    // location of a GPS propagated forward to the blending epoch
+    Location blend_aligned_location(uint8_t instance) const;
+
     // calculate the blended state
     void calc_blended_state(void);
 
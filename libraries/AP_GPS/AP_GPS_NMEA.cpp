@@ -59,12 +59,11 @@ AP_GPS_NMEA::AP_GPS_NMEA(AP_GPS &_gps, AP_GPS::GPS_State &_state, AP_HAL::UARTDr
 
 bool AP_GPS_NMEA::read(void)
 {
-    int16_t numc;
     bool parsed = false;
 
-    numc = port->available();
-    while (numc--) {
-        char c = port->read();
+    rx_begin();
+    while (rx_available()) {
+        char c = rx_next();
 #ifdef NMEA_LOG_PATH
         static FILE *logf = nullptr;
         if (logf == nullptr) {
@@ -69,9 +69,13 @@ AP_GPS_NOVA::read(void)
     }
 
     bool ret = false;
-    while (port->available() > 0) {
-        uint8_t temp = port->read();
-        ret |= parse(temp);
+    rx_begin();
+    while (rx_available()) {
+        if (nova_msg.nova_state == nova_msg_parser::PREAMBLE1 &&
+            !rx_skip_to(NOVA_PREAMBLE1)) {
+            continue;
+        }
+        ret |= parse(rx_next());
     }
     
     return ret;
@@ -66,10 +66,13 @@ bool
 AP_GPS_SBF::read(void)
 {
     bool ret = false;
-    uint32_t available_bytes = port->available();
-    for (uint32_t i = 0; i < available_bytes; i++) {
-        uint8_t temp = port->read();
-        ret |= parse(temp);
+    rx_begin();
+    while (rx_available()) {
+        if (sbf_msg.sbf_state == sbf_msg_parser_t::PREAMBLE1 &&
+            !rx_skip_to(SBF_PREAMBLE1)) {
+            continue;
+        }
+        ret |= parse(rx_next());
     }
 
     if (gps._auto_config != AP_GPS::GPS_AUTO_CONFIG_DISABLE) {
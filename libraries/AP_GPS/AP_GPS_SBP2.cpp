@@ -96,10 +96,13 @@ AP_GPS_SBP2::inject_data(const uint8_t *data, uint16_t len)
 void
 AP_GPS_SBP2::_sbp_process()
 {
-    uint32_t nleft = port->available(); 
-    while (nleft > 0) {
-        nleft--;
-        uint8_t temp = port->read();
+    rx_begin();
+    while (rx_available()) {
+        if (parser_state.state == sbp_parser_state_t::WAITING &&
+            !rx_skip_to(SBP_PREAMBLE)) {
+            continue;
+        }
+        uint8_t temp = rx_next();
         uint16_t crc;
 
         //This switch reads one character at a time,
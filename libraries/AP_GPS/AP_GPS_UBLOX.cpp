@@ -153,6 +153,13 @@ AP_GPS_UBLOX::_request_next_config(void)
             _next_message--;
         }
         break;
+    case STEP_COV:
+        // covariance is only needed for covariance based blending, and
+        // older receivers don't support it, so it isn't part of CONFIG_ALL
+        if (gps._auto_switch == 4 && !_request_message_rate(CLASS_NAV, MSG_NAV_COV)) {
+            _next_message--;
+        }
+        break;
     case STEP_MON_HW:
         if(!_request_message_rate(CLASS_MON, MSG_MON_HW)) {
             _next_message--;
@@ -265,6 +272,13 @@ AP_GPS_UBLOX::_verify_rate(uint8_t msg_class, uint8_t msg_id, uint8_t rate) {
                 _cfg_needs_save = true;
             }
             break;
+        case MSG_NAV_COV:
+            desired_rate = (gps._auto_switch == 4) ? RATE_COV : 0;
+            if(rate != desired_rate) {
+                _configure_message_rate(msg_class, msg_id, desired_rate);
+                _cfg_needs_save = true;
+            }
+            break;
         }
         break;
     case CLASS_MON:
@@ -340,7 +354,6 @@ bool
 AP_GPS_UBLOX::read(void)
 {
     uint8_t data;
-    int16_t numc;
     bool parsed = false;
     uint32_t millis_now = AP_HAL::millis();
 
@@ -369,11 +382,16 @@ AP_GPS_UBLOX::read(void)
         }
     }
 
-    numc = port->available();
-    for (int16_t i = 0; i < numc; i++) {        // Process bytes received
+    rx_begin();
+    while (rx_available()) {        // Process bytes received
+
+        if (_step == 0 && !rx_skip_to(PREAMBLE1)) {
+            // no message start in this block
+            continue;
+        }
 
         // read the next byte
-        data = port->read();
+        data = rx_next();
 
 	reset:
         switch(_step) {
@@ -446,8 +464,26 @@ AP_GPS_UBLOX::read(void)
             if (_payload_counter < sizeof(_buffer)) {
                 _buffer[_payload_counter] = data;
             }
-            if (++_payload_counter == _payload_length)
+            if (++_payload_counter == _payload_length) {
                 _step++;
+            } else if (_payload_counter < _payload_length) {
+                // the rest of the payload is usually already in the
+                // receive block, so take as much of it as we can at once
+                uint16_t n;
+                const uint8_t *p = rx_span(n);
+                n = MIN(n, _payload_length - _payload_counter);
+                for (uint16_t j = 0; j < n; j++) {
+                    _ck_b += (_ck_a += p[j]);           // checksum byte
+                }
+                if (_payload_counter < sizeof(_buffer)) {
+                    memcpy(&_buffer[_payload_counter], p, MIN(n, sizeof(_buffer) - _payload_counter));
+                }
+                rx_consume(n);
+                _payload_counter += n;
+                if (_payload_counter == _payload_length) {
+                    _step++;
+                }
+            }
             break;
 
         // Checksum and message processing
@@ -942,6 +978,22 @@ AP_GPS_UBLOX::_parse_gps(void)
         state.hdop = 170;
 #endif
         break;
+    case MSG_NAV_COV:
+        Debug("MSG_NAV_COV");
+        _check_new_itow(_buffer.cov.itow);
+        state.have_position_covariance = _buffer.cov.pos_cov_valid != 0;
+        if (state.have_position_covariance) {
+            state.position_covariance = Matrix3f(_buffer.cov.pos_cov_nn, _buffer.cov.pos_cov_ne, _buffer.cov.pos_cov_nd,
+                                                 _buffer.cov.pos_cov_ne, _buffer.cov.pos_cov_ee, _buffer.cov.pos_cov_ed,
+                                                 _buffer.cov.pos_cov_nd, _buffer.cov.pos_cov_ed, _buffer.cov.pos_cov_dd);
+        }
+        state.have_velocity_covariance = _buffer.cov.vel_cov_valid != 0;
+        if (state.have_velocity_covariance) {
+            state.velocity_covariance = Matrix3f(_buffer.cov.vel_cov_nn, _buffer.cov.vel_cov_ne, _buffer.cov.vel_cov_nd,
+                                                 _buffer.cov.vel_cov_ne, _buffer.cov.vel_cov_ee, _buffer.cov.vel_cov_ed,
+                                                 _buffer.cov.vel_cov_nd, _buffer.cov.vel_cov_ed, _buffer.cov.vel_cov_dd);
+        }
+        break;
     case MSG_SOL:
         Debug("MSG_SOL fix_status=%u fix_type=%u",
               _buffer.solution.fix_status,
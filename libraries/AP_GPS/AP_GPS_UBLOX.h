@@ -55,6 +55,7 @@
 #define RATE_PVT 1
 #define RATE_VELNED 1
 #define RATE_DOP 1
+#define RATE_COV 1
 #define RATE_HW 5
 #define RATE_HW2 5
 
@@ -234,6 +235,25 @@ private:
         uint16_t nDOP;
         uint16_t eDOP;
     };
+    struct PACKED ubx_nav_cov {
+        uint32_t itow;
+        uint8_t version;
+        uint8_t pos_cov_valid;
+        uint8_t vel_cov_valid;
+        uint8_t reserved[9];
+        float pos_cov_nn;                               // m^2
+        float pos_cov_ne;
+        float pos_cov_nd;
+        float pos_cov_ee;
+        float pos_cov_ed;
+        float pos_cov_dd;
+        float vel_cov_nn;                               // m^2/s^2
+        float vel_cov_ne;
+        float vel_cov_nd;
+        float vel_cov_ee;
+        float vel_cov_ed;
+        float vel_cov_dd;
+    };
     struct PACKED ubx_nav_solution {
         uint32_t itow;
         int32_t time_nsec;
@@ -411,6 +431,7 @@ private:
         ubx_nav_posllh posllh;
         ubx_nav_status status;
         ubx_nav_dop dop;
+        ubx_nav_cov cov;
         ubx_nav_solution solution;
         ubx_nav_pvt pvt;
         ubx_nav_velned velned;
@@ -452,6 +473,7 @@ private:
         MSG_SOL = 0x6,
         MSG_PVT = 0x7,
         MSG_VELNED = 0x12,
+        MSG_NAV_COV = 0x36,
         MSG_CFG_CFG = 0x09,
         MSG_CFG_RATE = 0x08,
         MSG_CFG_MSG = 0x01,
@@ -512,6 +534,7 @@ private:
         STEP_POLL_GNSS, // poll GNSS
         STEP_POLL_TP5, // poll TP5
         STEP_DOP,
+        STEP_COV,
         STEP_MON_HW,
         STEP_MON_HW2,
         STEP_RAW,
@@ -224,10 +224,55 @@ void AP_GPS_Backend::send_mavlink_gps_rtk(mavlink_channel_t chan)
 void AP_GPS_Backend::set_uart_timestamp(uint16_t nbytes)
 {
     if (port) {
-        state.uart_timestamp_ms = port->receive_time_constraint_us(nbytes) / 1000U;
+        // bytes already pulled into the receive block but not yet
+        // parsed arrived after this message
+        state.uart_timestamp_ms = port->receive_time_constraint_us(nbytes + rx_pending()) / 1000U;
     }
 }
 
+void AP_GPS_Backend::rx_begin()
+{
+    _rx.budget = port->available();
+}
+
+/*
+  return true if there is a byte to parse, refilling the receive block
+  from the UART when it is empty
+ */
+bool AP_GPS_Backend::rx_available()
+{
+    if (_rx.ofs < _rx.len) {
+        return true;
+    }
+    _rx.ofs = _rx.len = 0;
+    if (_rx.budget == 0) {
+        return false;
+    }
+    const uint32_t n = port->read(_rx.buf, MIN(_rx.budget, sizeof(_rx.buf)));
+    if (n == 0) {
+        _rx.budget = 0;
+        return false;
+    }
+    _rx.budget -= n;
+    _rx.len = n;
+    return true;
+}
+
+/*
+  discard bytes up to the next occurrence of sync in the current
+  block. Returns false, with the block consumed, if there is none
+ */
+bool AP_GPS_Backend::rx_skip_to(uint8_t sync)
+{
+    const uint8_t *p = (const uint8_t *)memchr(&_rx.buf[_rx.ofs], sync, rx_pending());
+    if (p == nullptr) {
+        _rx.ofs = _rx.len;
+        return false;
+    }
+    _rx.ofs = p - _rx.buf;
+    return true;
+}
+
 
 void AP_GPS_Backend::check_new_itow(uint32_t itow, uint32_t msg_length)
 {
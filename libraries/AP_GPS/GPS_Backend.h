@@ -22,6 +22,11 @@
 #include <AP_RTC/JitterCorrection.h>
 #include "AP_GPS.h"
 
+// number of bytes pulled from the UART per call when parsing
+#ifndef GPS_RX_CHUNK_SIZE
+#define GPS_RX_CHUNK_SIZE 64
+#endif
+
 class AP_GPS_Backend
 {
 public:
@@ -96,8 +101,45 @@ protected:
     void set_uart_timestamp(uint16_t nbytes);
 
     void check_new_itow(uint32_t itow, uint32_t msg_length);
+
+    /*
+      bulk receive support for the byte-oriented parsers. Rather than
+      a virtual port->read() per byte, a parser calls rx_begin() once
+      and then walks the incoming bytes with:
+
+          while (rx_available()) {
+              uint8_t c = rx_next();
+              ...
+          }
+
+      Bytes are pulled from the UART in GPS_RX_CHUNK_SIZE blocks, and
+      only as many as were waiting when rx_begin() was called, so a
+      continuous stream can't keep the parser looping. While hunting
+      for the start of a message rx_skip_to() jumps straight to the
+      next candidate sync byte in the current block.
+     */
+    void rx_begin();
+    bool rx_available();
+    uint8_t rx_next() { return _rx.buf[_rx.ofs++]; }
+    bool rx_skip_to(uint8_t sync);
+
+    // bytes remaining in the current block
+    uint16_t rx_pending() const { return _rx.len - _rx.ofs; }
+
+    // contiguous view of the rest of the current block, for parsers
+    // that can consume several bytes at once. rx_consume() marks n of
+    // them as used
+    const uint8_t *rx_span(uint16_t &n) const { n = rx_pending(); return &_rx.buf[_rx.ofs]; }
+    void rx_consume(uint16_t n) { _rx.ofs += n; }
     
 private:
+    struct {
+        uint8_t buf[GPS_RX_CHUNK_SIZE];
+        uint16_t len;
+        uint16_t ofs;
+        uint32_t budget; // bytes still to be pulled from the UART this call
+    } _rx;
+
     // itow from previous message
     uint32_t _last_itow;
     uint64_t _pseudo_itow;
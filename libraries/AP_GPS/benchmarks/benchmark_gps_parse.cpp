@@ -0,0 +1,440 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_GPS/AP_GPS.h>
+#include <AP_GPS/AP_GPS_UBLOX.h>
+#include <AP_GPS/AP_GPS_NMEA.h>
+#include <AP_GPS/AP_GPS_SBF.h>
+#include <AP_GPS/AP_GPS_NOVA.h>
+#include <AP_GPS/AP_GPS_SBP2.h>
+#include <AP_Math/crc.h>
+#include <AP_Math/edc.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+/*
+  a UART that replays a fixed byte stream, so the backends can be
+  timed on their parsing alone
+ */
+class ReplayUART : public AP_HAL::UARTDriver {
+public:
+    void begin(uint32_t baud) override {}
+    void begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace) override {}
+    void end() override {}
+    void flush() override {}
+    bool is_initialized() override { return true; }
+    void set_blocking_writes(bool blocking) override {}
+    bool tx_pending() override { return false; }
+    uint32_t txspace() override { return 1024; }
+    size_t write(uint8_t c) override { return 1; }
+    size_t write(const uint8_t *buffer, size_t size) override { return size; }
+
+    uint32_t available() override { return _len - _ofs; }
+    int16_t read() override {
+        if (_ofs >= _len) {
+            return -1;
+        }
+        return _data[_ofs++];
+    }
+    uint32_t read(uint8_t *buffer, uint32_t count) override {
+        count = MIN(count, available());
+        memcpy(buffer, &_data[_ofs], count);
+        _ofs += count;
+        return count;
+    }
+
+    void load(const uint8_t *data, uint32_t len) {
+        _data = data;
+        _len = len;
+        _ofs = 0;
+    }
+
+private:
+    const uint8_t *_data;
+    uint32_t _len;
+    uint32_t _ofs;
+};
+
+static AP_GPS gps;
+static AP_GPS::GPS_State gps_state;
+static ReplayUART uart;
+
+// one second of a 10Hz receiver: NAV-PVT, NAV-DOP and some noise
+// between messages
+static uint32_t make_ubx_stream(uint8_t *buf, uint32_t size)
+{
+    uint32_t len = 0;
+    for (uint8_t i = 0; i < 10; i++) {
+        const struct {
+            uint8_t msg_id;
+            uint16_t length;
+        } msgs[] = {{0x07, 92}, {0x04, 18}};
+        for (const auto &m : msgs) {
+            if (len + m.length + 8 + 16 > size) {
+                return len;
+            }
+            uint8_t *p = &buf[len];
+            p[0] = 0xB5;
+            p[1] = 0x62;
+            p[2] = 0x01;
+            p[3] = m.msg_id;
+            p[4] = m.length & 0xFF;
+            p[5] = m.length >> 8;
+            for (uint16_t j = 0; j < m.length; j++) {
+                p[6+j] = j * 7 + i;
+            }
+            uint8_t ck_a = 0, ck_b = 0;
+            for (uint16_t j = 2; j < m.length + 6; j++) {
+                ck_b += (ck_a += p[j]);
+            }
+            p[m.length+6] = ck_a;
+            p[m.length+7] = ck_b;
+            len += m.length + 8;
+        }
+        memset(&buf[len], 0x55, 16);
+        len += 16;
+    }
+    return len;
+}
+
+static uint32_t make_nmea_stream(uint8_t *buf, uint32_t size)
+{
+    static const char *sentences[] = {
+        "GPGGA,123519.00,4807.038247,N,01131.324523,E,1,12,0.8,545.4,M,46.9,M,,",
+        "GPRMC,123519.00,A,4807.038247,N,01131.324523,E,0.02,84.4,230394,003.1,W",
+        "GPVTG,84.4,T,,M,0.02,N,0.04,K,A",
+    };
+    uint32_t len = 0;
+    for (uint8_t i = 0; i < 10; i++) {
+        for (const char *s : sentences) {
+            uint8_t parity = 0;
+            for (const char *c = s; *c; c++) {
+                parity ^= *c;
+            }
+            const int n = snprintf((char *)&buf[len], size - len, "$%s*%02X\r\n", s, parity);
+            if (n < 0 || len + n >= size) {
+                return len;
+            }
+            len += n;
+        }
+    }
+    return len;
+}
+
+// append a little endian field to a fixture
+template <typename T>
+static uint8_t *put(uint8_t *p, T v)
+{
+    memcpy(p, &v, sizeof(v));
+    return p + sizeof(v);
+}
+
+// one second of a 10Hz Septentrio receiver: PVTGeodetic rev2 and DOP
+static uint32_t make_sbf_stream(uint8_t *buf, uint32_t size)
+{
+    uint32_t len = 0;
+    for (uint8_t i = 0; i < 10; i++) {
+        const uint32_t tow = 388800000 + i * 100;
+        if (len + 96 + 32 + 16 > size) {
+            return len;
+        }
+        for (uint8_t m = 0; m < 2; m++) {
+            uint8_t *msg = &buf[len];
+            uint8_t *p = &msg[8];
+            p = put(p, tow);
+            p = put(p, uint16_t(2000));
+            uint16_t blockid;
+            if (m == 0) {
+                // PVTGeodetic
+                blockid = 4007 | (2 << 13);
+                p = put(p, uint8_t(1));                 // Mode, standalone
+                p = put(p, uint8_t(0));                 // Error
+                p = put(p, -0.6171465 + i * 1.0e-8);    // Latitude, rad
+                p = put(p, 2.6033390);                  // Longitude, rad
+                p = put(p, 584.3);                      // Height
+                p = put(p, 19.2f);                      // Undulation
+                p = put(p, 1.2f);                       // Vn
+                p = put(p, -0.4f);                      // Ve
+                p = put(p, 0.05f);                      // Vu
+                p = put(p, 341.6f);                     // COG
+                p = put(p, 0.12);                       // RxClkBias
+                p = put(p, 0.01f);                      // RxClkDrift
+                p = put(p, uint8_t(0));                 // TimeSystem
+                p = put(p, uint8_t(0));                 // Datum
+                p = put(p, uint8_t(14));                // NrSV
+                p = put(p, uint8_t(0));                 // WACorrInfo
+                p = put(p, uint16_t(65535));            // ReferenceID
+                p = put(p, uint16_t(65535));            // MeanCorrAge
+                p = put(p, uint32_t(0));                // SignalInfo
+                p = put(p, uint8_t(0));                 // AlertFlag
+                p = put(p, uint8_t(0));                 // NrBases
+                p = put(p, uint16_t(0));                // PPPInfo
+                p = put(p, uint16_t(20));               // Latency
+                p = put(p, uint16_t(120));              // HAccuracy, cm
+                p = put(p, uint16_t(210));              // VAccuracy, cm
+                p = put(p, uint8_t(0));                 // Misc
+            } else {
+                // DOP
+                blockid = 4001;
+                p = put(p, uint8_t(14));                // NrSV
+                p = put(p, uint8_t(0));
+                p = put(p, uint16_t(160));              // PDOP
+                p = put(p, uint16_t(90));               // TDOP
+                p = put(p, uint16_t(80));               // HDOP
+                p = put(p, uint16_t(140));              // VDOP
+                p = put(p, 2.1f);                       // HPL
+                p = put(p, 3.4f);                       // VPL
+            }
+            // blocks are padded to a multiple of 4 bytes
+            uint16_t length = p - msg;
+            while (length % 4 != 0) {
+                msg[length++] = 0;
+            }
+            msg[0] = '$';
+            msg[1] = '@';
+            put(&msg[4], blockid);
+            put(&msg[6], length);
+            put(&msg[2], crc16_ccitt(&msg[4], length - 4, 0));
+            len += length;
+        }
+        memset(&buf[len], 0x55, 16);
+        len += 16;
+    }
+    return len;
+}
+
+// one second of a 10Hz NovAtel receiver: BESTPOSB, BESTVELB and PSRDOPB
+static uint32_t make_nova_stream(uint8_t *buf, uint32_t size)
+{
+    uint32_t len = 0;
+    for (uint8_t i = 0; i < 10; i++) {
+        const uint32_t tow = 388800000 + i * 100;
+        for (uint8_t m = 0; m < 3; m++) {
+            // header, largest body and crc
+            if (len + 28 + 76 + 4 + 16 > size) {
+                return len;
+            }
+            uint8_t *msg = &buf[len];
+            uint8_t *p = &msg[28];
+            uint16_t msgid;
+            if (m == 0) {
+                msgid = 42;
+                p = put(p, uint32_t(0));                // solstat, solution computed
+                p = put(p, uint32_t(16));               // postype, single
+                p = put(p, -35.36 + i * 1.0e-7);        // lat
+                p = put(p, 149.16);                     // lng
+                p = put(p, 584.3);                      // hgt
+                p = put(p, 19.2f);                      // undulation
+                p = put(p, uint32_t(61));               // datumid, WGS84
+                p = put(p, 1.1f);                       // latsdev
+                p = put(p, 0.9f);                       // lngsdev
+                p = put(p, 2.1f);                       // hgtsdev
+                p = put(p, uint32_t(0));                // stnid
+                p = put(p, 0.0f);                       // diffage
+                p = put(p, 0.0f);                       // sol_age
+                p = put(p, uint8_t(16));                // svstracked
+                p = put(p, uint8_t(14));                // svsused
+                p = put(p, uint8_t(14));                // svsl1
+                p = put(p, uint8_t(0));                 // svsmultfreq
+                p = put(p, uint32_t(0));                // resv, extsolstat and signal masks
+            } else if (m == 1) {
+                msgid = 99;
+                p = put(p, uint32_t(0));                // solstat
+                p = put(p, uint32_t(8));                // veltype, doppler
+                p = put(p, 0.15f);                      // latency
+                p = put(p, 0.0f);                       // age
+                p = put(p, 1.3);                        // horspd
+                p = put(p, 341.6);                      // trkgnd
+                p = put(p, 0.05);                       // vertspd
+                p = put(p, 0.0f);                       // resv
+            } else {
+                msgid = 174;
+                p = put(p, 1.9f);                       // gdop
+                p = put(p, 1.6f);                       // pdop
+                p = put(p, 0.8f);                       // hdop
+                p = put(p, 1.4f);                       // htdop
+                p = put(p, 0.9f);                       // tdop
+                p = put(p, 5.0f);                       // cutoff
+                p = put(p, uint32_t(12));               // svcount
+                for (uint8_t prn = 1; prn <= 12; prn++) {
+                    p = put(p, uint32_t(prn));
+                }
+            }
+            const uint16_t length = p - &msg[28];
+            msg[0] = 0xAA;
+            msg[1] = 0x44;
+            msg[2] = 0x12;
+            msg[3] = 28;                                // headerlength
+            uint8_t *h = put(&msg[4], msgid);
+            h = put(h, uint8_t(0));                     // messagetype, binary
+            h = put(h, uint8_t(0x20));                  // portaddr, COM1
+            h = put(h, length);
+            h = put(h, uint16_t(0));                    // sequence
+            h = put(h, uint8_t(0));                     // idletime
+            h = put(h, uint8_t(180));                   // timestatus, fine
+            h = put(h, uint16_t(2000));                 // week
+            h = put(h, tow);
+            h = put(h, uint32_t(0));                    // recvstatus
+            h = put(h, uint16_t(0));                    // resv
+            put(h, uint16_t(15000));                    // recvswver
+            put(p, crc_crc32(0, msg, 28 + length));
+            len += 28 + length + 4;
+        }
+        memset(&buf[len], 0x55, 16);
+        len += 16;
+    }
+    return len;
+}
+
+// one second of a 10Hz Piksi Multi: a heartbeat then GPS_TIME, DOPS,
+// POS_LLH and VEL_NED each epoch
+static uint32_t make_sbp2_stream(uint8_t *buf, uint32_t size)
+{
+    uint32_t len = 0;
+    for (uint8_t i = 0; i < 10; i++) {
+        const uint32_t tow = 388800000 + i * 100;
+        for (uint8_t m = (i == 0) ? 0 : 1; m < 5; m++) {
+            // header, largest payload and crc
+            if (len + 6 + 34 + 2 + 16 > size) {
+                return len;
+            }
+            uint8_t *msg = &buf[len];
+            uint8_t *p = &msg[6];
+            uint16_t msg_type;
+            switch (m) {
+            case 0:
+                msg_type = 0xFFFF;                      // HEARTBEAT
+                p = put(p, uint32_t(2 << 16));          // protocol_major 2
+                break;
+            case 1:
+                msg_type = 0x0102;                      // GPS_TIME
+                p = put(p, uint16_t(2000));
+                p = put(p, tow);
+                p = put(p, int32_t(0));
+                p = put(p, uint8_t(1));                 // SPP
+                break;
+            case 2:
+                msg_type = 0x0208;                      // DOPS
+                p = put(p, tow);
+                p = put(p, uint16_t(190));              // gdop
+                p = put(p, uint16_t(160));              // pdop
+                p = put(p, uint16_t(90));               // tdop
+                p = put(p, uint16_t(80));               // hdop
+                p = put(p, uint16_t(140));              // vdop
+                p = put(p, uint8_t(1));
+                break;
+            case 3:
+                msg_type = 0x020A;                      // POS_LLH
+                p = put(p, tow);
+                p = put(p, -35.36 + i * 1.0e-7);
+                p = put(p, 149.16);
+                p = put(p, 584.3);
+                p = put(p, uint16_t(1200));             // h_accuracy, mm
+                p = put(p, uint16_t(2100));             // v_accuracy, mm
+                p = put(p, uint8_t(14));                // n_sats
+                p = put(p, uint8_t(1));
+                break;
+            default:
+                msg_type = 0x020E;                      // VEL_NED
+                p = put(p, tow);
+                p = put(p, int32_t(1200));              // n, mm/s
+                p = put(p, int32_t(-400));              // e
+                p = put(p, int32_t(-50));               // d
+                p = put(p, uint16_t(100));
+                p = put(p, uint16_t(150));
+                p = put(p, uint8_t(14));
+                p = put(p, uint8_t(1));
+                break;
+            }
+            const uint8_t msg_len = p - &msg[6];
+            msg[0] = 0x55;
+            uint8_t *h = put(&msg[1], msg_type);
+            h = put(h, uint16_t(0x42));                 // sender
+            put(h, msg_len);
+            put(p, crc16_ccitt(&msg[1], 5 + msg_len, 0));
+            len += 6 + msg_len + 2;
+        }
+        // the SBP preamble is 0x55, so pad with something else
+        memset(&buf[len], 0xAA, 16);
+        len += 16;
+    }
+    return len;
+}
+
+static void BM_GPS_UBLOX_Parse(benchmark::State& state)
+{
+    static uint8_t stream[2048];
+    const uint32_t len = make_ubx_stream(stream, sizeof(stream));
+    AP_GPS_UBLOX backend(gps, gps_state, &uart);
+
+    while (state.KeepRunning()) {
+        uart.load(stream, len);
+        bool ret = backend.read();
+        gbenchmark_escape(&ret);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * len);
+}
+
+static void BM_GPS_NMEA_Parse(benchmark::State& state)
+{
+    static uint8_t stream[4096];
+    const uint32_t len = make_nmea_stream(stream, sizeof(stream));
+    AP_GPS_NMEA backend(gps, gps_state, &uart);
+
+    while (state.KeepRunning()) {
+        uart.load(stream, len);
+        bool ret = backend.read();
+        gbenchmark_escape(&ret);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * len);
+}
+
+static void BM_GPS_SBF_Parse(benchmark::State& state)
+{
+    static uint8_t stream[2048];
+    const uint32_t len = make_sbf_stream(stream, sizeof(stream));
+    AP_GPS_SBF backend(gps, gps_state, &uart);
+
+    while (state.KeepRunning()) {
+        uart.load(stream, len);
+        bool ret = backend.read();
+        gbenchmark_escape(&ret);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * len);
+}
+
+static void BM_GPS_NOVA_Parse(benchmark::State& state)
+{
+    static uint8_t stream[4096];
+    const uint32_t len = make_nova_stream(stream, sizeof(stream));
+    AP_GPS_NOVA backend(gps, gps_state, &uart);
+
+    while (state.KeepRunning()) {
+        uart.load(stream, len);
+        bool ret = backend.read();
+        gbenchmark_escape(&ret);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * len);
+}
+
+static void BM_GPS_SBP2_Parse(benchmark::State& state)
+{
+    static uint8_t stream[2048];
+    const uint32_t len = make_sbp2_stream(stream, sizeof(stream));
+    AP_GPS_SBP2 backend(gps, gps_state, &uart);
+
+    while (state.KeepRunning()) {
+        uart.load(stream, len);
+        bool ret = backend.read();
+        gbenchmark_escape(&ret);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * len);
+}
+
+BENCHMARK(BM_GPS_UBLOX_Parse);
+BENCHMARK(BM_GPS_NMEA_Parse);
+BENCHMARK(BM_GPS_SBF_Parse);
+BENCHMARK(BM_GPS_NOVA_Parse);
+BENCHMARK(BM_GPS_SBP2_Parse);
+
+BENCHMARK_MAIN()
@@ -221,6 +221,11 @@
 #define HAL_HAVE_GETTIME_SETTIME 0
 #endif
 
+// event tracing with AP_HAL::Trace. It can be dumped as JSON on SITL and Linux
+#ifndef HAL_TRACE_ENABLED
+#define HAL_TRACE_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
 // this is used as a general mechanism to make a 'small' build by
 // dropping little used features. We use this to allow us to keep
 // FMUv2 going for as long as possible
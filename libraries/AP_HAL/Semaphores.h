@@ -18,3 +18,20 @@ public:
     virtual bool give() = 0;
     virtual ~Semaphore(void) {}
 };
+
+/*
+  a semaphore for one thread to wake another, such as a driver telling
+  a consumer that new data is ready. Unlike Semaphore it is signalled
+  by a different thread to the one which waits on it. Signals given
+  while no thread is waiting are kept as one.
+
+  A HAL which implements this defines HAL_BinarySemaphore
+ */
+class AP_HAL::BinarySemaphore {
+public:
+    // wait up to timeout_us for a signal. Returns false on timeout
+    virtual bool wait(uint32_t timeout_us) WARN_IF_UNUSED = 0;
+
+    virtual void signal() = 0;
+    virtual ~BinarySemaphore(void) {}
+};
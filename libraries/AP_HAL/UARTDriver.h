@@ -38,6 +38,24 @@ public:
     virtual void set_blocking_writes(bool blocking) = 0;
     virtual bool tx_pending() = 0;
 
+    /*
+      read up to count bytes into buffer, returning the number of bytes
+      read. Drivers with a receive ring buffer override this to copy a
+      whole block in one call; the default falls back to read()
+     */
+    virtual uint32_t read(uint8_t *buffer, uint32_t count) {
+        uint32_t n = 0;
+        while (n < count) {
+            const int16_t c = read();
+            if (c < 0) {
+                break;
+            }
+            buffer[n++] = c;
+        }
+        return n;
+    }
+    using AP_HAL::BetterStream::read;
+
     // lock a port for exclusive use. Use a key of 0 to unlock
     virtual bool lock_port(uint32_t key) { return false; }
 
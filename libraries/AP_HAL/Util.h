@@ -27,6 +27,9 @@ public:
         return HAL_PARAM_DEFAULTS_PATH;
     }
 
+    // get path to write the AP_Param key map to, if wanted
+    virtual const char* get_param_key_map_file() const { return nullptr; }
+
     // run a debug shall on the given stream if possible. This is used
     // to support dropping into a debug shell to run firmware upgrade
     // commands
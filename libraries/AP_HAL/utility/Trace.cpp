@@ -0,0 +1,241 @@
+#include <AP_HAL/AP_HAL.h>
+
+#if HAL_TRACE_ENABLED
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Trace.h"
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+#include "ch.h"
+#elif CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifndef HAL_TRACE_MAX_THREADS
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#define HAL_TRACE_MAX_THREADS 32
+#else
+#define HAL_TRACE_MAX_THREADS 16
+#endif
+#endif
+
+// events buffered for each thread, which must be a power of two
+#ifndef HAL_TRACE_BUFFER_EVENTS
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#define HAL_TRACE_BUFFER_EVENTS 16384
+#else
+#define HAL_TRACE_BUFFER_EVENTS 256
+#endif
+#endif
+
+using namespace AP_HAL;
+
+volatile bool Trace::_enabled;
+
+namespace {
+
+struct trace_event {
+    uint64_t time_us;
+    const char *name;
+    int32_t value;
+    uint8_t type;
+};
+
+// a thread's ring buffer. Only the owning thread writes to it, and
+// head counts all events ever written. busy is set while the owner
+// records an event, so write_json() can wait for it to finish
+struct thread_buffer {
+    std::atomic<uintptr_t> owner;
+    std::atomic<uint32_t> head;
+    std::atomic<bool> busy;
+    const char *name;
+    std::atomic<trace_event *> events;
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    // name given to the thread with pthread_setname_np()
+    char pthread_name[16];
+#endif
+};
+
+thread_buffer buffers[HAL_TRACE_MAX_THREADS];
+
+// set by write_json() while it reads the buffers
+std::atomic<bool> paused;
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+// name given with Trace::thread_name(), picked up when the thread
+// claims a buffer
+thread_local const char *thread_label;
+#endif
+
+uintptr_t current_thread()
+{
+#if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+    return (uintptr_t)chThdGetSelfX();
+#elif CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    return (uintptr_t)pthread_self();
+#else
+    return 1;
+#endif
+}
+
+// find the calling thread's buffer, if it has claimed one
+thread_buffer *find_buffer(uintptr_t self)
+{
+    for (uint8_t i=0; i<HAL_TRACE_MAX_THREADS; i++) {
+        const uintptr_t owner = buffers[i].owner.load(std::memory_order_acquire);
+        if (owner == self) {
+            return &buffers[i];
+        }
+        if (owner == 0) {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+/*
+  find the calling thread's buffer, claiming one if it has none. This
+  is only called while tracing is enabled, so threads which never
+  record an event don't take a slot or allocate a buffer
+ */
+thread_buffer *get_buffer()
+{
+    const uintptr_t self = current_thread();
+    thread_buffer *b = find_buffer(self);
+    if (b != nullptr) {
+        return b->events != nullptr ? b : nullptr;
+    }
+    for (uint8_t i=0; i<HAL_TRACE_MAX_THREADS; i++) {
+        uintptr_t expected = 0;
+        if (buffers[i].owner.compare_exchange_strong(expected, self)) {
+            // a failed allocation leaves the slot claimed, so this
+            // thread isn't traced and doesn't try again
+            buffers[i].events = (trace_event *)calloc(HAL_TRACE_BUFFER_EVENTS, sizeof(trace_event));
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+            buffers[i].name = thread_label;
+            pthread_getname_np(pthread_self(), buffers[i].pthread_name, sizeof(buffers[i].pthread_name));
+#elif CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+            buffers[i].name = chRegGetThreadNameX(chThdGetSelfX());
+#endif
+            return buffers[i].events != nullptr ? &buffers[i] : nullptr;
+        }
+        if (expected == self) {
+            return buffers[i].events != nullptr ? &buffers[i] : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+}
+
+void Trace::set_enabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+void Trace::record(event_type type, const char *name, int32_t value)
+{
+    thread_buffer *b = get_buffer();
+    if (b == nullptr) {
+        return;
+    }
+
+    // mark the buffer busy before checking for a pause. write_json()
+    // pauses before checking for busy buffers, so either it waits for
+    // this event or the event is dropped
+    b->busy.store(true);
+    if (paused.load()) {
+        b->busy.store(false);
+        return;
+    }
+    const uint32_t head = b->head.load(std::memory_order_relaxed);
+    trace_event &e = b->events.load(std::memory_order_relaxed)[head % HAL_TRACE_BUFFER_EVENTS];
+    e.time_us = AP_HAL::micros64();
+    e.name = name;
+    e.value = value;
+    e.type = type;
+    b->head.store(head + 1, std::memory_order_release);
+    b->busy.store(false, std::memory_order_release);
+}
+
+void Trace::thread_name(const char *name)
+{
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    thread_label = name;
+#elif CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+    chRegSetThreadName(name);
+#endif
+    // rename a buffer the thread has already claimed
+    thread_buffer *b = find_buffer(current_thread());
+    if (b != nullptr) {
+        b->name = name;
+    }
+}
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+bool Trace::write_json(const char *filename)
+{
+    FILE *f = fopen(filename, "w");
+    if (f == nullptr) {
+        return false;
+    }
+
+    // pause tracing so the oldest events aren't overwritten as we
+    // read them, and wait for any event being recorded to finish
+    paused.store(true);
+    for (uint8_t i=0; i<HAL_TRACE_MAX_THREADS; i++) {
+        while (buffers[i].busy.load(std::memory_order_acquire)) {
+            sched_yield();
+        }
+    }
+
+    fprintf(f, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (uint8_t i=0; i<HAL_TRACE_MAX_THREADS; i++) {
+        const thread_buffer &b = buffers[i];
+        const trace_event *events = b.events.load(std::memory_order_acquire);
+        if (b.owner.load(std::memory_order_acquire) == 0 || events == nullptr) {
+            continue;
+        }
+        const char *name = b.name != nullptr ? b.name : b.pthread_name;
+        if (name[0] != 0) {
+            fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                    first?"":",\n", (unsigned)i, name);
+            first = false;
+        }
+        const uint32_t head = b.head.load(std::memory_order_acquire);
+        const uint32_t count = head < HAL_TRACE_BUFFER_EVENTS ? head : HAL_TRACE_BUFFER_EVENTS;
+        for (uint32_t n=head-count; n != head; n++) {
+            const trace_event &e = events[n % HAL_TRACE_BUFFER_EVENTS];
+            const char *sep = first?"":",\n";
+            first = false;
+            switch (e.type) {
+            case EVENT_BEGIN:
+            case EVENT_END:
+                fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":%u}",
+                        sep, e.name, e.type == EVENT_BEGIN?'B':'E',
+                        (unsigned long long)e.time_us, (unsigned)i);
+                break;
+            case EVENT_INSTANT:
+                fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%llu,\"pid\":1,\"tid\":%u}",
+                        sep, e.name, (unsigned long long)e.time_us, (unsigned)i);
+                break;
+            case EVENT_COUNTER:
+                fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%llu,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%d}}",
+                        sep, e.name, (unsigned long long)e.time_us, (unsigned)i, (int)e.value);
+                break;
+            }
+        }
+    }
+    fprintf(f, "\n]}\n");
+
+    paused.store(false);
+    return fclose(f) == 0;
+}
+#endif
+
+#endif // HAL_TRACE_ENABLED
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+/*
+  low overhead event tracing, for looking at how threads interleave.
+
+  Spans, instant events and counters are recorded with the time and
+  the thread they happen on. Each thread records into its own ring
+  buffer, which it claims on its first event while tracing is enabled,
+  so recording takes no lock and untraced threads cost nothing. When a
+  buffer is full the oldest events are overwritten.
+
+  Event names are stored as pointers and must be string constants.
+
+  Tracing is off until enabled. On SITL and Linux the buffers can be
+  written as Chrome trace JSON, for chrome://tracing or Perfetto.
+ */
+
+namespace AP_HAL {
+
+class Trace {
+public:
+#if HAL_TRACE_ENABLED
+    static void set_enabled(bool enabled);
+    static bool enabled() { return _enabled; }
+
+    // start and end a span on this thread
+    static void begin(const char *name) { if (_enabled) { record(EVENT_BEGIN, name, 0); } }
+    static void end(const char *name) { if (_enabled) { record(EVENT_END, name, 0); } }
+
+    // mark a point in time on this thread
+    static void instant(const char *name) { if (_enabled) { record(EVENT_INSTANT, name, 0); } }
+
+    // record a value of a counter
+    static void counter(const char *name, int32_t value) { if (_enabled) { record(EVENT_COUNTER, name, value); } }
+
+    // name the calling thread in the trace. This doesn't claim a
+    // buffer, and may be called whether or not tracing is enabled
+    static void thread_name(const char *name);
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    // write all buffered events to a file as Chrome trace JSON.
+    // Tracing is paused while the file is written
+    static bool write_json(const char *filename);
+#endif
+#else
+    static void set_enabled(bool enabled) {}
+    static bool enabled() { return false; }
+    static void begin(const char *name) {}
+    static void end(const char *name) {}
+    static void instant(const char *name) {}
+    static void counter(const char *name, int32_t value) {}
+    static void thread_name(const char *name) {}
+#endif
+
+    // a span for the lifetime of the object
+    class Span {
+    public:
+        Span(const char *name) : _name(name) { begin(name); }
+        ~Span() { end(_name); }
+    private:
+        const char *_name;
+    };
+
+#if HAL_TRACE_ENABLED
+private:
+    enum event_type : uint8_t {
+        EVENT_BEGIN,
+        EVENT_END,
+        EVENT_INSTANT,
+        EVENT_COUNTER,
+    };
+
+    static void record(event_type type, const char *name, int32_t value);
+
+    static volatile bool _enabled;
+#endif
+};
+
+}
+
+// trace a span from here to the end of the enclosing scope
+#define TRACE_SPAN(name) AP_HAL::Trace::Span _trace_span(name)
@@ -15,6 +15,7 @@
  * Code by Andrew Tridgell and Siddharth Bharat Purohit
  */
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/Trace.h>
 
 #include "AP_HAL_ChibiOS.h"
 #include "Scheduler.h"
@@ -331,11 +332,13 @@ void Scheduler::_run_io(void)
     num_procs = _num_io_procs;
     chBSemSignal(&_io_semaphore);
     // now call the IO based drivers
+    AP_HAL::Trace::begin("io");
     for (int i = 0; i < num_procs; i++) {
         if (_io_proc[i]) {
             _io_proc[i]();
         }
     }
+    AP_HAL::Trace::end("io");
 
     _in_io_proc = false;
 }
@@ -151,3 +151,32 @@ bool Semaphore_Recursive::take_nonblocking(void)
 
 #endif // CH_CFG_USE_MUTEXES
 
+#if CH_CFG_USE_SEMAPHORES == TRUE
+
+// constructor
+BinarySemaphore::BinarySemaphore()
+{
+    static_assert(sizeof(_sem) >= sizeof(binary_semaphore_t), "invalid semaphore size");
+    binary_semaphore_t *sem = (binary_semaphore_t *)_sem;
+    chBSemObjectInit(sem, true);
+}
+
+bool BinarySemaphore::wait(uint32_t timeout_us)
+{
+    binary_semaphore_t *sem = (binary_semaphore_t *)_sem;
+    // a zero timeout wouldn't wait at all
+    sysinterval_t ticks = chTimeUS2I(timeout_us);
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    return chBSemWaitTimeout(sem, ticks) == MSG_OK;
+}
+
+void BinarySemaphore::signal()
+{
+    binary_semaphore_t *sem = (binary_semaphore_t *)_sem;
+    chBSemSignal(sem);
+}
+
+#endif // CH_CFG_USE_SEMAPHORES
+
@@ -49,3 +49,14 @@ public:
 private:
     uint32_t count;
 };
+
+// a binary semaphore, signalled by one thread to wake another
+class ChibiOS::BinarySemaphore : public AP_HAL::BinarySemaphore {
+public:
+    BinarySemaphore();
+    bool wait(uint32_t timeout_us) override;
+    void signal() override;
+private:
+    // declared as an array for the same reason as Semaphore::_lock
+    uint32_t _sem[4];
+};
@@ -44,6 +44,7 @@ public:
     uint32_t available() override;
     uint32_t txspace() override;
     int16_t read() override;
+    uint32_t read(uint8_t *buffer, uint32_t count) override;
     void _timer_tick(void) override;
 
     size_t write(uint8_t c) override;
@@ -8,6 +8,7 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_HAL/utility/RCOutput_Tap.h>
+#include <AP_HAL/utility/Trace.h>
 #include <AP_HAL/utility/getopt_cpp.h>
 #include <AP_HAL_Empty/AP_HAL_Empty.h>
 #include <AP_HAL_Empty/AP_HAL_Empty_Private.h>
@@ -253,6 +254,9 @@ void _usage(void)
     printf("\tcustom terrain path:\n");
     printf("\t                   --terrain-directory /var/APM/terrain\n");
     printf("\t                   -t /var/APM/terrain\n");
+    printf("\tevent trace, written as JSON on SIGUSR1 and at exit:\n");
+    printf("\t                   --trace /var/APM/trace.json\n");
+    printf("\t                   -T /var/APM/trace.json\n");
 #if AP_MODULE_SUPPORTED
     printf("\tmodule support:\n");
     printf("\t                   --module-directory %s\n", AP_MODULE_DEFAULT_DIRECTORY);
@@ -265,6 +269,7 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
 #if AP_MODULE_SUPPORTED
     const char *module_path = AP_MODULE_DEFAULT_DIRECTORY;
 #endif
+    const char *trace_path = nullptr;
     
     assert(callbacks);
 
@@ -281,11 +286,12 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         {"terrain-directory",   true,  0, 't'},
         {"storage-directory",   true,  0, 's'},
         {"module-directory",    true,  0, 'M'},
+        {"trace",               true,  0, 'T'},
         {"help",                false,  0, 'h'},
         {0, false, 0, 0}
     };
 
-    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:l:t:s:he:SM:",
+    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:l:t:s:he:SM:T:",
                     options);
 
     /*
@@ -328,6 +334,11 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
             module_path = gopt.optarg;
             break;
 #endif
+        case 'T':
+            trace_path = gopt.optarg;
+            AP_HAL::Trace::set_enabled(true);
+            AP_HAL::Trace::thread_name("main");
+            break;
         case 'h':
             _usage();
             exit(0);
@@ -372,6 +383,14 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
 
     while (!_should_exit) {
         callbacks->loop();
+        if (_trace_write_requested && trace_path != nullptr) {
+            _trace_write_requested = false;
+            write_trace(trace_path);
+        }
+    }
+
+    if (trace_path != nullptr) {
+        write_trace(trace_path);
     }
 
     rcin->teardown();
@@ -388,6 +407,20 @@ void HAL_Linux::setup_signal_handlers() const
     sa.sa_handler = HAL_Linux::exit_signal_handler;
     sigaction(SIGTERM, &sa, NULL);
     sigaction(SIGINT, &sa, NULL);
+
+    sa.sa_handler = HAL_Linux::trace_signal_handler;
+    sigaction(SIGUSR1, &sa, NULL);
+}
+
+void HAL_Linux::write_trace(const char *path) const
+{
+#if HAL_TRACE_ENABLED
+    if (AP_HAL::Trace::write_json(path)) {
+        printf("Wrote trace to %s\n", path);
+    } else {
+        printf("Failed to write trace to %s\n", path);
+    }
+#endif
 }
 
 static HAL_Linux halInstance;
@@ -397,6 +430,13 @@ void HAL_Linux::exit_signal_handler(int signum)
     halInstance._should_exit = true;
 }
 
+volatile bool HAL_Linux::_trace_write_requested;
+
+void HAL_Linux::trace_signal_handler(int signum)
+{
+    _trace_write_requested = true;
+}
+
 const AP_HAL::HAL &AP_HAL::get_HAL()
 {
     return halInstance;
@@ -10,7 +10,11 @@ public:
     void setup_signal_handlers() const;
 
     static void exit_signal_handler(int);
+    static void trace_signal_handler(int);
 
 protected:
     bool _should_exit = false;
+    static volatile bool _trace_write_requested;
+
+    void write_trace(const char *path) const;
 };
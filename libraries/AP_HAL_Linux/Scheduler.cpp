@@ -10,6 +10,7 @@
 #include <unistd.h>
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/Trace.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Vehicle/AP_Vehicle_Type.h>
 
@@ -242,11 +243,13 @@ void Scheduler::_run_io(void)
     }
 
     // now call the IO based drivers
+    AP_HAL::Trace::begin("io");
     for (int i = 0; i < _num_io_procs; i++) {
         if (_io_proc[i]) {
             _io_proc[i]();
         }
     }
+    AP_HAL::Trace::end("io");
 
     _io_semaphore.give();
 }
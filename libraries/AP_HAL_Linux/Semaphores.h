@@ -22,5 +22,16 @@ class Semaphore_Recursive : public Semaphore {
 public:
     Semaphore_Recursive();
 };
+
+class BinarySemaphore : public AP_HAL::BinarySemaphore {
+public:
+    BinarySemaphore();
+    bool wait(uint32_t timeout_us) override;
+    void signal() override;
+private:
+    pthread_mutex_t _mtx;
+    pthread_cond_t _cond;
+    bool _pending;
+};
     
 }
@@ -14,8 +14,9 @@
 using namespace Linux;
 
 /*
-  This stores 'eeprom' data on the SD card, with a 4k size, and a
-  in-memory buffer. This keeps the latency down.
+  This stores 'eeprom' data on the SD card, with a 16k size, and a
+  in-memory buffer. This keeps the latency down. Changes are appended
+  to a log by AP_FileStorage rather than rewriting the file in place.
  */
 
 // name the storage file after the sketch so you can use the same board
@@ -91,48 +92,6 @@ static int mkdir_p(const char *path, int len, mode_t mode)
     return 0;
 }
 
-int Storage::_storage_create(const char *dpath)
-{
-    int dfd = -1;
-
-    mkdir_p(dpath, strlen(dpath), 0777);
-    dfd = open(dpath, O_RDONLY|O_CLOEXEC);
-    if (dfd == -1) {
-        fprintf(stderr, "Failed to open storage directory: %s (%m)\n", dpath);
-        return -1;
-    }
-
-    unlinkat(dfd, dpath, 0);
-    int fd = openat(dfd, STORAGE_FILE, O_RDWR|O_CREAT|O_CLOEXEC, 0666);
-
-    close(dfd);
-
-    if (fd == -1) {
-        fprintf(stderr, "Failed to create storage file %s/%s\n", dpath,
-                STORAGE_FILE);
-        goto fail;
-    }
-
-    // take up all needed space
-    if (ftruncate(fd, sizeof(_buffer)) == -1) {
-        fprintf(stderr, "Failed to set file size to %u kB (%m)\n",
-                sizeof(_buffer) / 1024);
-        goto fail;
-    }
-
-    // ensure the directory is updated with the new size
-    fsync(fd);
-    fsync(dfd);
-
-    close(dfd);
-
-    return fd;
-
-fail:
-    close(dfd);
-    return -1;
-}
-
 void Storage::init()
 {
     const char *dpath;
@@ -141,53 +100,34 @@ void Storage::init()
         return;
     }
 
-    _dirty_mask = 0;
+    _dirty_mask.clearall();
 
     dpath = hal.util->get_custom_storage_directory();
     if (!dpath) {
         dpath = HAL_BOARD_STORAGE_DIRECTORY;
     }
 
-    int fd = open(dpath, O_RDWR|O_CLOEXEC);
-    if (fd == -1) {
-        fd = _storage_create(dpath);
-        if (fd == -1) {
-            AP_HAL::panic("Cannot create storage %s (%m)", dpath);
-        }
-    }
-
-    ssize_t ret = read(fd, _buffer, sizeof(_buffer));
-
-    if (ret != sizeof(_buffer)) {
-        close(fd);
-        _storage_create(dpath);
-        fd = open(dpath, O_RDONLY|O_CLOEXEC);
-        if (fd == -1) {
-            AP_HAL::panic("Failed to open %s (%m)", dpath);
-        }
-        if (read(fd, _buffer, sizeof(_buffer)) != sizeof(_buffer)) {
-            AP_HAL::panic("Failed to read %s (%m)", dpath);
-        }
+    mkdir_p(dpath, strlen(dpath), 0777);
+    if (!_file.init(dpath, STORAGE_FILE)) {
+        AP_HAL::panic("Cannot open storage %s/%s (%m)", dpath, STORAGE_FILE);
     }
 
-    _fd = fd;
     _initialised = true;
 }
 
 /*
-  mark some lines as dirty. Note that there is no attempt to avoid
-  the race condition between this code and the _timer_tick() code
-  below, which both update _dirty_mask. If we lose the race then the
-  result is that a line is written more than once, but it won't result
-  in a line not being written.
+  mark some lines as dirty. The storage thread clears lines in the
+  same words of _dirty_mask, so both sides update it under _dirty_sem
+  or a line set here could be lost
  */
 void Storage::_mark_dirty(uint16_t loc, uint16_t length)
 {
+    WITH_SEMAPHORE(_dirty_sem);
     uint16_t end = loc + length;
-    for (uint8_t line=loc>>LINUX_STORAGE_LINE_SHIFT;
+    for (uint16_t line=loc>>LINUX_STORAGE_LINE_SHIFT;
          line <= end>>LINUX_STORAGE_LINE_SHIFT;
          line++) {
-        _dirty_mask |= 1U << line;
+        _dirty_mask.set(line);
     }
 }
 
@@ -214,52 +154,59 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
 
 void Storage::_timer_tick(void)
 {
-    if (!_initialised || _dirty_mask == 0 || _fd == -1) {
+    if (!_initialised) {
         return;
     }
 
     // write out the first dirty set of lines. We don't write more
-    // than one to keep the latency of this call to a minimum
-    uint8_t i, n;
-    for (i=0; i<LINUX_STORAGE_NUM_LINES; i++) {
-        if (_dirty_mask & (1<<i)) {
-            break;
+    // than one set to keep the latency of this call to a minimum
+    uint16_t i, n;
+    {
+        WITH_SEMAPHORE(_dirty_sem);
+        if (_dirty_mask.empty()) {
+            i = LINUX_STORAGE_NUM_LINES;
+            n = 0;
+        } else {
+            i = _dirty_mask.first_set();
+            for (n=1; (i+n) < LINUX_STORAGE_NUM_LINES &&
+                     n < (LINUX_STORAGE_MAX_WRITE>>LINUX_STORAGE_LINE_SHIFT); n++) {
+                if (!_dirty_mask.get(i+n)) {
+                    break;
+                }
+            }
+            // mark the lines clean before they are copied, so a
+            // change made while we write them marks them dirty again
+            for (uint16_t line=i; line<i+n; line++) {
+                _dirty_mask.clear(line);
+            }
         }
     }
-    if (i == LINUX_STORAGE_NUM_LINES) {
-        // this shouldn't be possible
+    if (n == 0) {
+        // compact the log while there is nothing else to write
+        _file.compact();
         return;
     }
-    uint32_t write_mask = (1U<<i);
-    // see how many lines to write
-    for (n=1; (i+n) < LINUX_STORAGE_NUM_LINES &&
-             n < (LINUX_STORAGE_MAX_WRITE>>LINUX_STORAGE_LINE_SHIFT); n++) {
-        if (!(_dirty_mask & (1<<(n+i)))) {
-            break;
-        }
-        // mark that line clean
-        write_mask |= (1<<(n+i));
-    }
 
-    /*
-      write the lines. This also updates _dirty_mask. Note that
-      because this is a SCHED_FIFO thread it will not be preempted
-      by the main task except during blocking calls. This means we
-      don't need a semaphore around the _dirty_mask updates.
-     */
-    if (lseek(_fd, i<<LINUX_STORAGE_LINE_SHIFT, SEEK_SET) == (i<<LINUX_STORAGE_LINE_SHIFT)) {
-        _dirty_mask &= ~write_mask;
-        if (write(_fd, &_buffer[i<<LINUX_STORAGE_LINE_SHIFT], n<<LINUX_STORAGE_LINE_SHIFT) != n<<LINUX_STORAGE_LINE_SHIFT) {
-            // write error - likely EINTR
-            _dirty_mask |= write_mask;
-            close(_fd);
-            _fd = -1;
-        }
-        if (_dirty_mask == 0) {
-            if (fsync(_fd) != 0) {
-                close(_fd);
-                _fd = -1;
-            }
+    if (!_file.write(i<<LINUX_STORAGE_LINE_SHIFT, n<<LINUX_STORAGE_LINE_SHIFT)) {
+        // write error - try again on the next tick
+        WITH_SEMAPHORE(_dirty_sem);
+        for (uint16_t line=i; line<i+n; line++) {
+            _dirty_mask.set(line);
         }
+        return;
+    }
+    bool all_written;
+    {
+        WITH_SEMAPHORE(_dirty_sem);
+        all_written = _dirty_mask.empty();
     }
+    if (all_written) {
+        // commit the records once there is nothing more to write
+        _file.sync();
+    }
+}
+
+bool Storage::healthy(void)
+{
+    return _initialised && _file.healthy();
 }
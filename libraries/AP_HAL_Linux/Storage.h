@@ -1,10 +1,15 @@
 #pragma once
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Common/Bitmask.h>
+#include <AP_FileStorage/AP_FileStorage.h>
 
 #define LINUX_STORAGE_SIZE HAL_STORAGE_SIZE
-#define LINUX_STORAGE_MAX_WRITE 512
-#define LINUX_STORAGE_LINE_SHIFT 9
+#define LINUX_STORAGE_MAX_WRITE AP_FileStorage::max_write
+
+// storage is written as a log of changed lines, so a small line size
+// keeps the amount written for a small change down
+#define LINUX_STORAGE_LINE_SHIFT 6
 #define LINUX_STORAGE_LINE_SIZE (1<<LINUX_STORAGE_LINE_SHIFT)
 #define LINUX_STORAGE_NUM_LINES (LINUX_STORAGE_SIZE/LINUX_STORAGE_LINE_SIZE)
 
@@ -13,7 +18,7 @@ namespace Linux {
 class Storage : public AP_HAL::Storage
 {
 public:
-    Storage() : _fd(-1),_dirty_mask(0) { }
+    Storage() { }
 
     static Storage *from(AP_HAL::Storage *storage) {
         return static_cast<Storage*>(storage);
@@ -33,15 +38,17 @@ public:
     void write_block(uint16_t dst, const void* src, size_t n);
 
     virtual void _timer_tick(void) override;
+    bool healthy(void) override;
 
 protected:
     void _mark_dirty(uint16_t loc, uint16_t length);
-    int _storage_create(const char *dpath);
 
-    int _fd;
     volatile bool _initialised;
-    volatile uint32_t _dirty_mask;
+    // written by the main thread and the storage thread
+    Bitmask _dirty_mask{LINUX_STORAGE_NUM_LINES};
+    HAL_Semaphore _dirty_sem;
     uint8_t _buffer[LINUX_STORAGE_SIZE];
+    AP_FileStorage _file{_buffer};
 };
 
 }
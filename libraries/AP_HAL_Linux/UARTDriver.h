@@ -30,6 +30,7 @@ public:
     uint32_t available() override;
     uint32_t txspace() override;
     int16_t read() override;
+    uint32_t read(uint8_t *buffer, uint32_t count) override;
 
     /* Linux implementations of Print virtual methods */
     size_t write(uint8_t c);
@@ -309,6 +309,23 @@ int16_t PX4UARTDriver::read()
     return byte;
 }
 
+uint32_t PX4UARTDriver::read(uint8_t *buffer, uint32_t count)
+{
+    if (!_semaphore.take_nonblocking()) {
+        return 0;
+    }
+    if (!_initialised) {
+        try_initialise();
+        _semaphore.give();
+        return 0;
+    }
+
+    const uint32_t ret = _readbuf.read(buffer, count);
+
+    _semaphore.give();
+    return ret;
+}
+
 /*
    write one byte
  */
@@ -13,6 +13,7 @@ class RCInput;
 class Util;
 class Semaphore;
 class Semaphore_Recursive;
+class BinarySemaphore;
 class GPIO;
 class DigitalSource;
 class HALSITLCAN;
@@ -94,6 +94,9 @@ void HAL_SITL::run(int argc, char * const argv[], Callbacks* callbacks) const
         HALSITL::Scheduler::_run_io_procs();
     }
 
+    // storage changes made just before the reboot are still pending
+    sitlEEPROMStorage.flush();
+
     // form a new argv, removing problem parameters
     uint8_t new_argv_offset = 0;
     for (uint8_t i=0; i<ARRAY_SIZE(new_argv) && i<argc; i++) {
@@ -81,6 +81,9 @@ public:
         "tcp:5",
         "tcp:6",
     };
+
+    // set by SIGUSR1 to write the event trace
+    static volatile bool trace_write_requested;
     
 private:
     void _parse_command_line(int argc, char * const argv[]);
@@ -218,6 +221,11 @@ private:
     SocketAPM fg_socket{true};
     
     const char *defaults_path = HAL_PARAM_DEFAULTS_PATH;
+    const char *param_key_map_path = nullptr;
+
+    // event trace file, written when trace_write_requested is set
+    const char *trace_path = nullptr;
+    void _trace_update(void);
 
     const char *_home_str;
 };
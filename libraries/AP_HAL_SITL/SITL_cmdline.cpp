@@ -10,6 +10,7 @@
 #include <signal.h>
 #include <unistd.h>
 #include <AP_HAL/utility/getopt_cpp.h>
+#include <AP_HAL/utility/Trace.h>
 
 #include <SITL/SIM_Multicopter.h>
 #include <SITL/SIM_Helicopter.h>
@@ -43,6 +44,13 @@ static void _sig_fpe(int signum)
     abort();
 }
 
+volatile bool SITL_State::trace_write_requested;
+
+static void _sig_usr1(int signum)
+{
+    SITL_State::trace_write_requested = true;
+}
+
 void SITL_State::_usage(void)
 {
     printf("Options:\n"
@@ -62,6 +70,8 @@ void SITL_State::_usage(void)
            "\t--gimbal                 enable simulated MAVLink gimbal\n"
            "\t--autotest-dir DIR       set directory for additional files\n"
            "\t--defaults path          set path to defaults file\n"
+           "\t--param-keys path        write parameter key map for param_defaults_compile.py\n"
+           "\t--trace path             record an event trace, written to path as JSON on SIGUSR1\n"
            "\t--uartA device           set device string for UARTA\n"
            "\t--uartB device           set device string for UARTB\n"
            "\t--uartC device           set device string for UARTC\n"
@@ -129,6 +139,28 @@ void SITL_State::_set_signal_handlers(void) const
     sigemptyset(&sa_pipe.sa_mask);
     sa_pipe.sa_handler = SIG_IGN; /* No-op SIGPIPE handler */
     sigaction(SIGPIPE, &sa_pipe, nullptr);
+
+    struct sigaction sa_usr1 = {};
+
+    sigemptyset(&sa_usr1.sa_mask);
+    sa_usr1.sa_handler = _sig_usr1; /* write the trace from the IO procs */
+    sigaction(SIGUSR1, &sa_usr1, nullptr);
+}
+
+// write the event trace if it has been asked for
+void SITL_State::_trace_update(void)
+{
+#if HAL_TRACE_ENABLED
+    if (!trace_write_requested || trace_path == nullptr) {
+        return;
+    }
+    trace_write_requested = false;
+    if (AP_HAL::Trace::write_json(trace_path)) {
+        ::printf("Wrote trace to %s\n", trace_path);
+    } else {
+        ::printf("Failed to write trace to %s\n", trace_path);
+    }
+#endif
 }
 
 void SITL_State::_parse_command_line(int argc, char * const argv[])
@@ -178,6 +210,8 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_SIM_PORT_IN,
         CMDLINE_SIM_PORT_OUT,
         CMDLINE_IRLOCK_PORT,
+        CMDLINE_PARAM_KEYS,
+        CMDLINE_TRACE,
     };
 
     const struct GetOptLong::option options[] = {
@@ -211,6 +245,8 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"sim-port-in",     true,   0, CMDLINE_SIM_PORT_IN},
         {"sim-port-out",    true,   0, CMDLINE_SIM_PORT_OUT},
         {"irlock-port",     true,   0, CMDLINE_IRLOCK_PORT},
+        {"param-keys",      true,   0, CMDLINE_PARAM_KEYS},
+        {"trace",           true,   0, CMDLINE_TRACE},
         {0, false, 0, 0}
     };
 
@@ -295,6 +331,14 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         case CMDLINE_DEFAULTS:
             defaults_path = strdup(gopt.optarg);
             break;
+        case CMDLINE_PARAM_KEYS:
+            param_key_map_path = strdup(gopt.optarg);
+            break;
+        case CMDLINE_TRACE:
+            trace_path = strdup(gopt.optarg);
+            AP_HAL::Trace::set_enabled(true);
+            AP_HAL::Trace::thread_name("main");
+            break;
         case CMDLINE_UARTA:
         case CMDLINE_UARTB:
         case CMDLINE_UARTC:
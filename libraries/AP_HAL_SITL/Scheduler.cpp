@@ -11,6 +11,7 @@
 #include <malloc.h>
 #endif
 #include <AP_Common/Semaphore.h>
+#include <AP_HAL/utility/Trace.h>
 
 using namespace HALSITL;
 
@@ -184,11 +185,13 @@ void Scheduler::_run_io_procs()
     _in_io_proc = true;
 
     // now call the IO based drivers
+    AP_HAL::Trace::begin("io");
     for (int i = 0; i < _num_io_procs; i++) {
         if (_io_proc[i]) {
             _io_proc[i]();
         }
     }
+    AP_HAL::Trace::end("io");
 
     _in_io_proc = false;
 
@@ -200,6 +203,11 @@ void Scheduler::_run_io_procs()
     hal.uartF->_timer_tick();
     hal.uartG->_timer_tick();
 
+    // process any pending storage writes
+    hal.storage->_timer_tick();
+
+    _sitlState->_trace_update();
+
     check_thread_stacks();
 }
 
@@ -221,6 +229,7 @@ void Scheduler::stop_clock(uint64_t time_usec)
 void *Scheduler::thread_create_trampoline(void *ctx)
 {
     struct thread_attr *a = (struct thread_attr *)ctx;
+    AP_HAL::Trace::thread_name(a->name);
     a->f[0]();
     
     WITH_SEMAPHORE(_thread_sem);
@@ -55,4 +55,47 @@ bool Semaphore::take_nonblocking()
     return pthread_mutex_trylock(&_lock) == 0;
 }
 
+BinarySemaphore::BinarySemaphore()
+    : _pending(false)
+{
+    pthread_mutex_init(&_mtx, nullptr);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&_cond, &attr);
+}
+
+/*
+  wait for a signal. The timeout is in real time rather than simulated
+  time, which is fine as it only bounds how long the caller sleeps if
+  the signaller stops
+ */
+bool BinarySemaphore::wait(uint32_t timeout_us)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const uint64_t nsec = ts.tv_nsec + timeout_us * 1000ULL;
+    ts.tv_sec += nsec / 1000000000ULL;
+    ts.tv_nsec = nsec % 1000000000ULL;
+
+    pthread_mutex_lock(&_mtx);
+    while (!_pending) {
+        if (pthread_cond_timedwait(&_cond, &_mtx, &ts) != 0) {
+            break;
+        }
+    }
+    const bool ret = _pending;
+    _pending = false;
+    pthread_mutex_unlock(&_mtx);
+    return ret;
+}
+
+void BinarySemaphore::signal()
+{
+    pthread_mutex_lock(&_mtx);
+    _pending = true;
+    pthread_cond_signal(&_cond);
+    pthread_mutex_unlock(&_mtx);
+}
+
 #endif  // CONFIG_HAL_BOARD
@@ -24,3 +24,15 @@ public:
 };
 
 
+class HALSITL::BinarySemaphore : public AP_HAL::BinarySemaphore {
+public:
+    BinarySemaphore();
+    bool wait(uint32_t timeout_us) override;
+    void signal() override;
+private:
+    pthread_mutex_t _mtx;
+    pthread_cond_t _cond;
+    bool _pending;
+};
+
+
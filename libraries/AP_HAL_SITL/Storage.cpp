@@ -10,11 +10,17 @@
 #include "Storage.h"
 using namespace HALSITL;
 
+/*
+  storage is held in memory and changes are appended to eeprom.bin by
+  AP_FileStorage. A flat eeprom.bin from older builds is imported
+ */
 void EEPROMStorage::_eeprom_open(void)
 {
-    if (_eeprom_fd == -1) {
-        _eeprom_fd = open("eeprom.bin", O_RDWR|O_CREAT|O_CLOEXEC, 0777);
-        assert(ftruncate(_eeprom_fd, HAL_STORAGE_SIZE) == 0);
+    if (!_initialised) {
+        if (!_file.init(".", "eeprom.bin")) {
+            AP_HAL::panic("Failed to open eeprom.bin");
+        }
+        _initialised = true;
     }
 }
 
@@ -22,14 +28,86 @@ void EEPROMStorage::read_block(void *dst, uint16_t src, size_t n)
 {
     assert(src < HAL_STORAGE_SIZE && src + n <= HAL_STORAGE_SIZE);
     _eeprom_open();
-    assert(pread(_eeprom_fd, dst, n, src) == (ssize_t)n);
+    memcpy(dst, &_buffer[src], n);
 }
 
 void EEPROMStorage::write_block(uint16_t dst, const void *src, size_t n)
 {
-    assert(dst < HAL_STORAGE_SIZE);
+    assert(dst < HAL_STORAGE_SIZE && dst + n <= HAL_STORAGE_SIZE);
     _eeprom_open();
-    assert(pwrite(_eeprom_fd, src, n, dst) == (ssize_t)n);
+    if (memcmp(src, &_buffer[dst], n) != 0) {
+        memcpy(&_buffer[dst], src, n);
+        _mark_dirty(dst, n);
+    }
+}
+
+void EEPROMStorage::_mark_dirty(uint16_t loc, uint16_t length)
+{
+    const uint16_t end = loc + length - 1;
+    for (uint16_t line=loc>>SITL_STORAGE_LINE_SHIFT;
+         line <= end>>SITL_STORAGE_LINE_SHIFT;
+         line++) {
+        _dirty_mask.set(line);
+    }
+}
+
+/*
+  write all dirty lines, a run of lines per record. Returns false on
+  a write error, leaving the remaining lines dirty
+ */
+bool EEPROMStorage::_write_lines(void)
+{
+    while (!_dirty_mask.empty()) {
+        const uint16_t i = _dirty_mask.first_set();
+        uint16_t n = 0;
+        while (i+n < SITL_STORAGE_NUM_LINES &&
+               n < (AP_FileStorage::max_write>>SITL_STORAGE_LINE_SHIFT) &&
+               _dirty_mask.get(i+n)) {
+            _dirty_mask.clear(i+n);
+            n++;
+        }
+        if (!_file.write(i<<SITL_STORAGE_LINE_SHIFT, n<<SITL_STORAGE_LINE_SHIFT)) {
+            for (uint16_t line=i; line<i+n; line++) {
+                _dirty_mask.set(line);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+void EEPROMStorage::_timer_tick(void)
+{
+    if (!_initialised) {
+        return;
+    }
+    if (_dirty_mask.empty()) {
+        // compact the log while there is nothing else to write
+        _file.compact();
+    } else if (_write_lines()) {
+        _sync_pending = true;
+    }
+
+    const uint32_t now = AP_HAL::millis();
+    if (_sync_pending && now - _last_sync_ms >= SITL_STORAGE_SYNC_MS) {
+        _file.sync();
+        _sync_pending = false;
+        _last_sync_ms = now;
+    }
+}
+
+void EEPROMStorage::flush(void)
+{
+    if (_initialised && _write_lines()) {
+        _file.sync();
+        _sync_pending = false;
+        _last_sync_ms = AP_HAL::millis();
+    }
+}
+
+bool EEPROMStorage::healthy(void)
+{
+    return _initialised && _file.healthy();
 }
 
 #endif
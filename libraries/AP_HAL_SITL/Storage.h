@@ -1,18 +1,41 @@
 #pragma once
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Common/Bitmask.h>
+#include <AP_FileStorage/AP_FileStorage.h>
 #include "AP_HAL_SITL_Namespace.h"
 
+// storage is written as a log of changed lines, so a small line size
+// keeps the amount written for a small change down
+#define SITL_STORAGE_LINE_SHIFT 6
+#define SITL_STORAGE_LINE_SIZE (1<<SITL_STORAGE_LINE_SHIFT)
+#define SITL_STORAGE_NUM_LINES (HAL_STORAGE_SIZE/SITL_STORAGE_LINE_SIZE)
+
+// the timer tick runs on the main thread, so writes are committed to
+// disk at most this often, and on flush()
+#define SITL_STORAGE_SYNC_MS 1000
+
 class HALSITL::EEPROMStorage : public AP_HAL::Storage {
 public:
-    EEPROMStorage() {
-        _eeprom_fd = -1;
-    }
+    EEPROMStorage() {}
     void init() {}
     void read_block(void *dst, uint16_t src, size_t n);
     void write_block(uint16_t dst, const void* src, size_t n);
 
+    void _timer_tick(void) override;
+    bool healthy(void) override;
+
+    // write out all pending changes, for example before a reboot
+    void flush(void);
+
 private:
-    int _eeprom_fd;
+    bool _initialised;
     void _eeprom_open(void);
+    void _mark_dirty(uint16_t loc, uint16_t length);
+    bool _write_lines(void);
+    bool _sync_pending;
+    uint32_t _last_sync_ms;
+    uint8_t _buffer[HAL_STORAGE_SIZE];
+    Bitmask _dirty_mask{SITL_STORAGE_NUM_LINES};
+    AP_FileStorage _file{_buffer};
 };
@@ -172,6 +172,14 @@ int16_t UARTDriver::read(void)
     return c;
 }
 
+uint32_t UARTDriver::read(uint8_t *buffer, uint32_t count)
+{
+    if (available() == 0) {
+        return 0;
+    }
+    return _readbuffer.read(buffer, count);
+}
+
 void UARTDriver::flush(void)
 {
 }
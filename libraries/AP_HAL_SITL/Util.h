@@ -27,6 +27,11 @@ public:
         return sitlState->defaults_path;
     }
 
+    // get path to write the AP_Param key map to, if wanted
+    const char* get_param_key_map_file() const override {
+        return sitlState->param_key_map_path;
+    }
+
     uint64_t get_hw_rtc() const override;
 
     bool get_system_id(char buf[40]) override;
@@ -9,6 +9,7 @@
 #include <AP_Vehicle/AP_Vehicle.h>
 #include <AP_BoardConfig/AP_BoardConfig.h>
 #include <AP_AHRS/AP_AHRS.h>
+#include <AP_Scheduler/LatencyInfo.h>
 
 #include "AP_InertialSensor.h"
 #include "AP_InertialSensor_BMI160.h"
@@ -1343,6 +1344,14 @@ void AP_InertialSensor::update(void)
     _gyro[_primary_gyro] = _notch_filter.apply(_gyro[_primary_gyro]);
     
     _last_update_usec = AP_HAL::micros();
+
+    // when there is a rate loop it sets its own sample for latency
+    _update_sample_us = _gyro_arrival_us[_primary_gyro];
+    AP::LatencyInfo &latency = AP::latency();
+    latency.record(AP::LatencyInfo::STAGE_INS, _update_sample_us);
+    if (_rate_loop_gyro == nullptr) {
+        latency.set_sample_us(_update_sample_us);
+    }
     
     _have_sample = false;
 }
@@ -1672,6 +1681,60 @@ bool AP_InertialSensor::is_still()
            (vibe.z < _still_threshold);
 }
 
+// queue filtered samples of the primary gyro for a rate loop
+bool AP_InertialSensor::enable_rate_loop_gyro(void)
+{
+#ifdef HAL_BinarySemaphore
+    if (_rate_loop_gyro != nullptr) {
+        return true;
+    }
+    // enough for a few ms of samples at 8kHz
+    ObjectBuffer<rate_loop_sample> *queue = new ObjectBuffer<rate_loop_sample>(32);
+    if (queue == nullptr) {
+        return false;
+    }
+    if (queue->space() == 0) {
+        delete queue;
+        return false;
+    }
+    _rate_loop_sem = new HAL_BinarySemaphore;
+    if (_rate_loop_sem == nullptr) {
+        delete queue;
+        return false;
+    }
+    _rate_loop_dt = 0;
+    _rate_loop_gyro = queue;
+    return true;
+#else
+    return false;
+#endif
+}
+
+// wait for a rate loop gyro sample
+bool AP_InertialSensor::wait_rate_loop_gyro(uint32_t timeout_us)
+{
+    if (_rate_loop_gyro == nullptr) {
+        return false;
+    }
+    if (_rate_loop_gyro->available() != 0) {
+        return true;
+    }
+    return _rate_loop_sem->wait(timeout_us);
+}
+
+// get the oldest queued rate loop gyro sample
+bool AP_InertialSensor::get_next_rate_loop_gyro(Vector3f &gyro, float &dt)
+{
+    rate_loop_sample sample;
+    if (_rate_loop_gyro == nullptr || !_rate_loop_gyro->pop(sample)) {
+        return false;
+    }
+    gyro = sample.gyro;
+    dt = sample.dt;
+    AP::latency().set_sample_us(sample.arrival_us);
+    return true;
+}
+
 // initialise and register accel calibrator
 // called during the startup of accel cal
 void AP_InertialSensor::acal_init()
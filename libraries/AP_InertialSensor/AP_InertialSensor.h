@@ -22,12 +22,14 @@
 
 #include <AP_AccelCal/AP_AccelCal.h>
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/RingBuffer.h>
 #include <AP_Math/AP_Math.h>
 #include <Filter/LowPassFilter2p.h>
 #include <Filter/LowPassFilter.h>
 #include <Filter/NotchFilter.h>
 
 class AP_InertialSensor_Backend;
+class AP_InertialSensor_BatchFFT;
 class AuxiliaryBus;
 class AP_AHRS;
 
@@ -206,6 +208,26 @@ public:
     // enable HIL mode
     void set_hil_mode(void) { _hil_mode = true; }
 
+    // queue each filtered sample of the primary gyro for a rate
+    // controller running at the gyro sample rate. Returns false if the
+    // queue could not be allocated or the HAL has no way to signal
+    // new samples
+    bool enable_rate_loop_gyro(void);
+
+    // wait up to timeout_us for a rate loop gyro sample to be queued.
+    // Returns false on timeout
+    bool wait_rate_loop_gyro(uint32_t timeout_us);
+
+    // get the oldest queued rate loop gyro sample and the time in
+    // seconds since the sample before it. This may be called from one
+    // thread only, and sets the sample used for the rate controller,
+    // mixer and output latency. Returns false if no samples are queued
+    bool get_next_rate_loop_gyro(Vector3f &gyro, float &dt);
+
+    // time in microseconds that the latest primary gyro sample used
+    // by update() arrived at its backend
+    uint32_t get_update_sample_us(void) const { return _update_sample_us; }
+
     // get the gyro filter rate in Hz
     uint8_t get_gyro_filter_hz(void) const { return _gyro_filter_cutoff; }
 
@@ -321,6 +343,7 @@ public:
 
         enum batch_opt_t {
             BATCH_OPT_SENSOR_RATE = (1<<0),
+            BATCH_OPT_FFT = (1<<1),
         };
 
         void rotate_to_next_sensor();
@@ -329,11 +352,26 @@ public:
         bool should_log(uint8_t instance, IMU_SENSOR_TYPE type);
         void push_data_to_log();
 
+        // sample rate of the batch currently being collected
+        float sample_rate() const;
+
+        // hand a completed batch to the FFT engine, or start the next
+        // batch if there is no analysis to wait for
+        void finish_batch();
+        void next_batch();
+
+        // publish FFT results once the analysis is complete
+        void publish_fft();
+
+        // on-board spectral analysis, only allocated if BATCH_OPT_FFT is set
+        AP_InertialSensor_BatchFFT *_fft;
+
         uint64_t measurement_started_us;
 
         bool initialised : 1;
         bool isbh_sent : 1;
         bool _doing_sensor_rate_logging : 1;
+        bool _fft_pending : 1; // batch buffers locked until FFT completes
         uint8_t instance : 3; // instance we are sending data for
         AP_InertialSensor::IMU_SENSOR_TYPE type : 1;
         uint16_t isb_seqnum;
@@ -456,6 +494,11 @@ private:
     uint64_t _accel_last_sample_us[INS_MAX_INSTANCES];
     uint64_t _gyro_last_sample_us[INS_MAX_INSTANCES];
 
+    // time each gyro's latest sample arrived at its backend, and the
+    // time the latest primary gyro sample used by update() arrived
+    uint32_t _gyro_arrival_us[INS_MAX_INSTANCES];
+    uint32_t _update_sample_us;
+
     // sample times for checking real sensor rate for FIFO sensors
     uint16_t _sample_accel_count[INS_MAX_INSTANCES];
     uint32_t _sample_accel_start_us[INS_MAX_INSTANCES];
@@ -536,6 +579,16 @@ private:
     LowPassFilterVector3f _accel_vibe_floor_filter[INS_VIBRATION_CHECK_INSTANCES];
     LowPassFilterVector3f _accel_vibe_filter[INS_VIBRATION_CHECK_INSTANCES];
 
+    // queue of primary gyro samples for the rate loop
+    struct rate_loop_sample {
+        Vector3f gyro;
+        float dt;
+        uint32_t arrival_us;
+    };
+    ObjectBuffer<rate_loop_sample> *_rate_loop_gyro = nullptr;
+    AP_HAL::BinarySemaphore *_rate_loop_sem = nullptr;
+    float _rate_loop_dt;
+
     // peak hold detector state for primary accel
     struct PeakHoldState {
         float accel_peak_hold_neg_x;
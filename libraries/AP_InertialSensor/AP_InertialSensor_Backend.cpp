@@ -209,6 +209,17 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
             _imu._gyro_filter[instance].reset();
         }
         _imu._new_gyro_data[instance] = true;
+        _imu._gyro_arrival_us[instance] = sample_us != 0 ? (uint32_t)sample_us : AP_HAL::micros();
+
+        // a full queue drops the sample, the rate loop will get the
+        // time since its last sample from the next one
+        if (_imu._rate_loop_gyro != nullptr && instance == _imu._primary_gyro) {
+            _imu._rate_loop_dt += dt;
+            if (_imu._rate_loop_gyro->push(AP_InertialSensor::rate_loop_sample{_imu._gyro_filtered[instance], _imu._rate_loop_dt, _imu._gyro_arrival_us[instance]})) {
+                _imu._rate_loop_dt = 0;
+            }
+            _imu._rate_loop_sem->signal();
+        }
     }
 
     log_gyro_raw(instance, sample_us, gyro);
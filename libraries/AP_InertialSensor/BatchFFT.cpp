@@ -0,0 +1,234 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BatchFFT.h"
+
+extern const AP_HAL::HAL& hal;
+
+bool AP_InertialSensor_BatchFFT::init(uint16_t batch_samples)
+{
+    uint16_t n = MIN(batch_samples, INS_FFT_MAX_POINTS);
+    if (n < 16) {
+        return false;
+    }
+    _log2_points = 0;
+    while ((2U << _log2_points) <= n) {
+        _log2_points++;
+    }
+    _points = 1U << _log2_points;
+
+    const uint16_t half = _points / 2;
+    _window = (float *)calloc(_points, sizeof(float));
+    _cos = (float *)calloc(half, sizeof(float));
+    _sin = (float *)calloc(half, sizeof(float));
+    _re = (float *)calloc(_points, sizeof(float));
+    _im = (float *)calloc(_points, sizeof(float));
+    _power = (float *)calloc(half, sizeof(float));
+    if (_window == nullptr || _cos == nullptr || _sin == nullptr ||
+        _re == nullptr || _im == nullptr || _power == nullptr) {
+        free(_window);
+        free(_cos);
+        free(_sin);
+        free(_re);
+        free(_im);
+        free(_power);
+        _window = _cos = _sin = _re = _im = _power = nullptr;
+        return false;
+    }
+
+    _window_power = 0;
+    for (uint16_t i=0; i<_points; i++) {
+        _window[i] = 0.5f * (1.0f - cosf(M_2PI * i / _points));
+        _window_power += sq(_window[i]);
+    }
+    for (uint16_t i=0; i<half; i++) {
+        _cos[i] = cosf(M_2PI * i / _points);
+        _sin[i] = sinf(M_2PI * i / _points);
+    }
+
+    _state.store(State::IDLE, std::memory_order_release);
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_InertialSensor_BatchFFT::io_update, void));
+
+    return true;
+}
+
+bool AP_InertialSensor_BatchFFT::submit(uint16_t seqnum,
+                                        uint8_t sensor_type,
+                                        uint8_t instance,
+                                        const int16_t *x, const int16_t *y, const int16_t *z,
+                                        uint16_t count,
+                                        uint16_t multiplier,
+                                        float sample_rate_hz)
+{
+    if (_state.load(std::memory_order_acquire) != State::IDLE || count < _points || multiplier == 0 || sample_rate_hz <= 0) {
+        return false;
+    }
+    _in_x = x;
+    _in_y = y;
+    _in_z = z;
+    _scale = 1.0f / multiplier;
+    _bin_hz = sample_rate_hz / _points;
+    _result.seqnum = seqnum;
+    _result.sensor_type = sensor_type;
+    _result.instance = instance;
+
+    // hand ownership to the IO thread
+    _state.store(State::PENDING_XY, std::memory_order_release);
+    return true;
+}
+
+bool AP_InertialSensor_BatchFFT::get_result(Result &result)
+{
+    if (_state.load(std::memory_order_acquire) != State::DONE) {
+        return false;
+    }
+    result = _result;
+    _state.store(State::IDLE, std::memory_order_release);
+    return true;
+}
+
+void AP_InertialSensor_BatchFFT::io_update()
+{
+    switch (_state.load(std::memory_order_acquire)) {
+    case State::PENDING_XY:
+        load(_re, _in_x);
+        load(_im, _in_y);
+        transform();
+        power_pair(false);
+        analyse(_result.peak_hz.x, _result.energy.x);
+        power_pair(true);
+        analyse(_result.peak_hz.y, _result.energy.y);
+        _state.store(State::PENDING_Z, std::memory_order_release);
+        break;
+
+    case State::PENDING_Z:
+        load(_re, _in_z);
+        memset(_im, 0, _points * sizeof(float));
+        transform();
+        power_real();
+        analyse(_result.peak_hz.z, _result.energy.z);
+        _state.store(State::DONE, std::memory_order_release);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void AP_InertialSensor_BatchFFT::load(float *dest, const int16_t *src) const
+{
+    int32_t sum = 0;
+    for (uint16_t i=0; i<_points; i++) {
+        sum += src[i];
+    }
+    const float mean = (float)sum / _points;
+    for (uint16_t i=0; i<_points; i++) {
+        dest[i] = (src[i] - mean) * _scale * _window[i];
+    }
+}
+
+/*
+  iterative radix-2 decimation-in-time FFT
+ */
+void AP_InertialSensor_BatchFFT::transform()
+{
+    // bit-reversal permutation
+    for (uint16_t i=1, j=0; i<_points; i++) {
+        uint16_t bit = _points >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float t = _re[i]; _re[i] = _re[j]; _re[j] = t;
+            t = _im[i]; _im[i] = _im[j]; _im[j] = t;
+        }
+    }
+
+    for (uint16_t len=2; len<=_points; len <<= 1) {
+        const uint16_t half = len >> 1;
+        const uint16_t step = _points / len;
+        for (uint16_t i=0; i<_points; i += len) {
+            for (uint16_t j=0; j<half; j++) {
+                const float wr = _cos[j*step];
+                const float wi = -_sin[j*step];
+                const uint16_t a = i + j;
+                const uint16_t b = a + half;
+                const float tr = wr * _re[b] - wi * _im[b];
+                const float ti = wr * _im[b] + wi * _re[b];
+                _re[b] = _re[a] - tr;
+                _im[b] = _im[a] - ti;
+                _re[a] += tr;
+                _im[a] += ti;
+            }
+        }
+    }
+}
+
+void AP_InertialSensor_BatchFFT::power_real()
+{
+    for (uint16_t k=0; k<_points/2; k++) {
+        _power[k] = sq(_re[k]) + sq(_im[k]);
+    }
+}
+
+/*
+  for z = a + i*b the spectra of the real signals a and b are
+    A[k] = (Z[k] + conj(Z[N-k])) / 2
+    B[k] = (Z[k] - conj(Z[N-k])) / 2i
+ */
+void AP_InertialSensor_BatchFFT::power_pair(bool second)
+{
+    for (uint16_t k=0; k<_points/2; k++) {
+        const uint16_t n = (_points - k) & (_points - 1);
+        if (second) {
+            _power[k] = 0.25f * (sq(_im[k] + _im[n]) + sq(_re[k] - _re[n]));
+        } else {
+            _power[k] = 0.25f * (sq(_re[k] + _re[n]) + sq(_im[k] - _im[n]));
+        }
+    }
+}
+
+void AP_InertialSensor_BatchFFT::analyse(float &peak_hz, float &energy) const
+{
+    const uint16_t half = _points / 2;
+
+    // bin 0 is the (removed) mean, so start at bin 1
+    uint16_t peak = 1;
+    float sum = 0;
+    for (uint16_t k=1; k<half; k++) {
+        sum += _power[k];
+        if (_power[k] > _power[peak]) {
+            peak = k;
+        }
+    }
+
+    // refine the peak with a parabola through the neighbouring
+    // magnitudes
+    float offset = 0;
+    if (peak > 1 && peak < half-1) {
+        const float m0 = sqrtf(_power[peak-1]);
+        const float m1 = sqrtf(_power[peak]);
+        const float m2 = sqrtf(_power[peak+1]);
+        const float denom = m0 - 2*m1 + m2;
+        if (!is_zero(denom)) {
+            offset = constrain_float(0.5f * (m0 - m2) / denom, -0.5f, 0.5f);
+        }
+    }
+    peak_hz = (peak + offset) * _bin_hz;
+
+    // Parseval, corrected for the power removed by the window
+    energy = 2.0f * sum / (_points * _window_power);
+}
@@ -0,0 +1,139 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  on-board spectral analysis of IMU batch sampler data.
+
+  A completed batch is handed to the engine by the main thread, a
+  Hann-windowed radix-2 FFT is run on it in place from the IO thread
+  and the per-axis peak frequency and vibration energy are collected
+  back by the main thread.  The x and y axes are transformed together as the
+  real and imaginary parts of a single complex FFT, so a three-axis
+  batch costs two transforms.
+ */
+
+#include <atomic>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+
+// number of points in each transform.  Batches longer than this only
+// have their first INS_FFT_MAX_POINTS samples analysed
+#ifndef INS_FFT_MAX_POINTS
+#define INS_FFT_MAX_POINTS 512
+#endif
+
+static_assert((INS_FFT_MAX_POINTS & (INS_FFT_MAX_POINTS-1)) == 0, "INS_FFT_MAX_POINTS must be a power of two");
+
+class AP_InertialSensor_BatchFFT {
+public:
+
+    struct Result {
+        uint16_t seqnum;           // batch sequence number analysed
+        uint8_t sensor_type;       // AP_InertialSensor::IMU_SENSOR_TYPE
+        uint8_t instance;
+        Vector3f peak_hz;          // frequency of the strongest bin per axis
+        Vector3f energy;           // mean-square of the non-DC spectrum per axis
+    };
+
+    // allocate working buffers and register with the IO thread.  The
+    // transform length is the largest power of two no longer than
+    // batch_samples or INS_FFT_MAX_POINTS.  Returns false if the
+    // memory could not be allocated
+    bool init(uint16_t batch_samples);
+
+    // called from the main thread with a completed batch.  The sample
+    // buffers are read in place from the IO thread, so the caller must
+    // not modify them until get_result() has returned true.  Returns
+    // false if the engine is still busy with the previous batch, in
+    // which case this batch is simply not analysed
+    bool submit(uint16_t seqnum,
+                uint8_t sensor_type,
+                uint8_t instance,
+                const int16_t *x, const int16_t *y, const int16_t *z,
+                uint16_t count,
+                uint16_t multiplier,
+                float sample_rate_hz);
+
+    // called from the main thread; returns true and fills in result
+    // once per analysed batch
+    bool get_result(Result &result);
+
+    // number of points in the transform, valid after init()
+    uint16_t points() const { return _points; }
+
+private:
+
+    enum class State : uint8_t {
+        IDLE = 0,   // owned by main thread, waiting for a batch
+        PENDING_XY, // owned by IO thread, x/y transform to run
+        PENDING_Z,  // owned by IO thread, z transform to run
+        DONE,       // owned by main thread, result ready
+    };
+
+    // IO thread callback; does one transform per call to bound the
+    // time spent in the IO thread
+    void io_update();
+
+    // in-place complex FFT on _re/_im
+    void transform();
+
+    // remove the mean, scale, window and copy samples into dest
+    void load(float *dest, const int16_t *src) const;
+
+    // fill _power with the one-sided power spectrum of the real signal
+    // transformed in _re/_im
+    void power_real();
+
+    // fill _power with the power spectrum of one half of a pair of
+    // real signals packed as the real (second=false) and imaginary
+    // (second=true) parts of the transform in _re/_im
+    void power_pair(bool second);
+
+    // find peak and energy of the one-sided power spectrum in _power
+    void analyse(float &peak_hz, float &energy) const;
+
+    uint16_t _points;
+    uint8_t _log2_points;
+
+    // Hann window and twiddle factors, precomputed at init
+    float *_window;
+    float *_cos;
+    float *_sin;
+    float _window_power; // sum of squares of the window
+
+    // batch being analysed, owned by the BatchSampler
+    const int16_t *_in_x;
+    const int16_t *_in_y;
+    const int16_t *_in_z;
+
+    // complex working buffer
+    float *_re;
+    float *_im;
+
+    // one-sided power spectrum of one axis, _points/2 entries
+    float *_power;
+
+    float _scale;
+    float _bin_hz;
+
+    Result _result;
+
+    // handoff between the main and IO threads. A store with release
+    // publishes the buffers and result written before it to the
+    // thread that loads it with acquire
+    std::atomic<State> _state{State::IDLE};
+};
@@ -1,5 +1,7 @@
 #include "AP_InertialSensor.h"
+#include "BatchFFT.h"
 #include <GCS_MAVLink/GCS.h>
+#include <DataFlash/DataFlash.h>
 
 // Class level parameters
 const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
@@ -21,7 +23,7 @@ const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
     // @Param: BAT_OPT
     // @DisplayName: Batch Logging Options Mask
     // @Description: Options for the BatchSampler
-    // @Bitmask: 0:Sensor-Rate Logging (sample at full sensor rate seen by AP)
+    // @Bitmask: 0:Sensor-Rate Logging (sample at full sensor rate seen by AP),1:On-board FFT analysis (sample even when not logging)
     // @User: Advanced
     AP_GROUPINFO("BAT_OPT",  3, AP_InertialSensor::BatchSampler, _batch_options_mask, 0),
 
@@ -42,6 +44,8 @@ const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
 };
 
 
+#define MASK_LOG_ANY                    0xFFFF
+
 extern const AP_HAL::HAL& hal;
 void AP_InertialSensor::BatchSampler::init()
 {
@@ -71,6 +75,15 @@ void AP_InertialSensor::BatchSampler::init()
         return;
     }
 
+    if ((batch_opt_t)(_batch_options_mask.get()) & BATCH_OPT_FFT) {
+        _fft = new AP_InertialSensor_BatchFFT();
+        if (_fft == nullptr || !_fft->init(_required_count)) {
+            delete _fft;
+            _fft = nullptr;
+            gcs().send_text(MAV_SEVERITY_WARNING, "Failed to allocate IMU batch FFT");
+        }
+    }
+
     rotate_to_next_sensor();
 
     initialised = true;
@@ -82,6 +95,9 @@ void AP_InertialSensor::BatchSampler::periodic()
         return;
     }
     push_data_to_log();
+    if (_fft_pending) {
+        publish_fft();
+    }
 }
 
 void AP_InertialSensor::BatchSampler::update_doing_sensor_rate_logging()
@@ -160,6 +176,26 @@ void AP_InertialSensor::BatchSampler::rotate_to_next_sensor()
     update_doing_sensor_rate_logging();
 }
 
+float AP_InertialSensor::BatchSampler::sample_rate() const
+{
+    float sample_rate = 0; // avoid warning about uninitialised values
+    switch(type) {
+    case IMU_SENSOR_TYPE_GYRO:
+        sample_rate = _imu._gyro_raw_sample_rates[instance];
+        if (_doing_sensor_rate_logging) {
+            sample_rate *= _imu._gyro_over_sampling[instance];
+        }
+        break;
+    case IMU_SENSOR_TYPE_ACCEL:
+        sample_rate = _imu._accel_raw_sample_rates[instance];
+        if (_doing_sensor_rate_logging) {
+            sample_rate *= _imu._accel_over_sampling[instance];
+        }
+        break;
+    }
+    return sample_rate;
+}
+
 void AP_InertialSensor::BatchSampler::push_data_to_log()
 {
     if (!initialised) {
@@ -168,12 +204,12 @@ void AP_InertialSensor::BatchSampler::push_data_to_log()
     if (_sensor_mask == 0) {
         return;
     }
-    if (data_write_offset - data_read_offset < samples_per_msg) {
-        // insuffucient data to pack a packet
+    if (_fft_pending) {
+        // buffers are being read by the FFT engine
         return;
     }
-    if (AP_HAL::millis() - last_sent_ms < (uint16_t)push_interval_ms) {
-        // avoid flooding DataFlash's buffer
+    if (data_write_offset - data_read_offset < samples_per_msg) {
+        // insuffucient data to pack a packet
         return;
     }
     DataFlash_Class *dataflash = DataFlash_Class::instance();
@@ -181,31 +217,27 @@ void AP_InertialSensor::BatchSampler::push_data_to_log()
         // should not have been called
         return;
     }
+    if (_fft != nullptr && !dataflash->should_log(MASK_LOG_ANY)) {
+        // only sampling for on-board analysis
+        if (data_write_offset >= _required_count) {
+            finish_batch();
+        }
+        return;
+    }
+    if (AP_HAL::millis() - last_sent_ms < (uint16_t)push_interval_ms) {
+        // avoid flooding DataFlash's buffer
+        return;
+    }
 
     // possibly send isb header:
     if (!isbh_sent && data_read_offset == 0) {
-        float sample_rate = 0; // avoid warning about uninitialised values
-        switch(type) {
-        case IMU_SENSOR_TYPE_GYRO:
-            sample_rate = _imu._gyro_raw_sample_rates[instance];
-            if (_doing_sensor_rate_logging) {
-                sample_rate *= _imu._gyro_over_sampling[instance];
-            }
-            break;
-        case IMU_SENSOR_TYPE_ACCEL:
-            sample_rate = _imu._accel_raw_sample_rates[instance];
-            if (_doing_sensor_rate_logging) {
-                sample_rate *= _imu._accel_over_sampling[instance];
-            }
-            break;
-        }
         if (!dataflash->Log_Write_ISBH(isb_seqnum,
                                        type,
                                        instance,
                                        multiplier,
                                        _required_count,
                                        measurement_started_us,
-                                       sample_rate)) {
+                                       sample_rate())) {
             // buffer full?
             return;
         }
@@ -223,13 +255,68 @@ void AP_InertialSensor::BatchSampler::push_data_to_log()
     data_read_offset += samples_per_msg;
     last_sent_ms = AP_HAL::millis();
     if (data_read_offset >= _required_count) {
-        // that was the last one.  Clean up:
-        data_read_offset = 0;
-        isb_seqnum++;
-        isbh_sent = false;
-        // rotate to next instance:
-        rotate_to_next_sensor();
-        data_write_offset = 0; // unlocks writing process
+        // that was the last one
+        finish_batch();
+    }
+}
+
+void AP_InertialSensor::BatchSampler::finish_batch()
+{
+    if (_fft != nullptr &&
+        _fft->submit(isb_seqnum,
+                     type,
+                     instance,
+                     data_x,
+                     data_y,
+                     data_z,
+                     _required_count,
+                     multiplier,
+                     sample_rate())) {
+        // keep the writing process locked out until the FFT engine
+        // has finished reading the batch
+        _fft_pending = true;
+        return;
+    }
+    next_batch();
+}
+
+void AP_InertialSensor::BatchSampler::next_batch()
+{
+    data_read_offset = 0;
+    isb_seqnum++;
+    isbh_sent = false;
+    // rotate to next instance:
+    rotate_to_next_sensor();
+    data_write_offset = 0; // unlocks writing process
+}
+
+void AP_InertialSensor::BatchSampler::publish_fft()
+{
+    AP_InertialSensor_BatchFFT::Result result;
+    if (!_fft->get_result(result)) {
+        return;
+    }
+    _fft_pending = false;
+    next_batch();
+
+    DataFlash_Class *dataflash = DataFlash_Class::instance();
+    if (dataflash != nullptr) {
+        dataflash->Log_Write_ISBF(result.seqnum,
+                                  (IMU_SENSOR_TYPE)result.sensor_type,
+                                  result.instance,
+                                  _fft->points(),
+                                  result.peak_hz,
+                                  result.energy);
+    }
+
+    // e.g. G0PkX is the x-axis peak frequency of the first gyro
+    const char tchar = (result.sensor_type == IMU_SENSOR_TYPE_GYRO) ? 'G' : 'A';
+    char name[10];
+    for (uint8_t axis=0; axis<3; axis++) {
+        hal.util->snprintf(name, sizeof(name), "%c%uPk%c", tchar, (unsigned)result.instance, 'X'+axis);
+        gcs().send_named_float(name, result.peak_hz[axis]);
+        hal.util->snprintf(name, sizeof(name), "%c%uEn%c", tchar, (unsigned)result.instance, 'X'+axis);
+        gcs().send_named_float(name, result.energy[axis]);
     }
 }
 
@@ -254,7 +341,10 @@ bool AP_InertialSensor::BatchSampler::should_log(uint8_t _instance, IMU_SENSOR_T
     if (dataflash == nullptr) {
         return false;
     }
-#define MASK_LOG_ANY                    0xFFFF
+    if (_fft != nullptr) {
+        // on-board analysis wants samples whether or not we are logging
+        return true;
+    }
     if (!dataflash->should_log(MASK_LOG_ANY)) {
         return false;
     }
@@ -0,0 +1,369 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "AP_Math.h"
+#include "AP_PolygonIndex.h"
+
+// build the index
+bool AP_PolygonIndex::init(const Vector2f *points, uint16_t num_points)
+{
+    clear();
+
+    if (points == nullptr || num_points < 3) {
+        return false;
+    }
+
+    // bounding box
+    Vector2f min = points[0];
+    Vector2f max = points[0];
+    for (uint16_t i = 1; i < num_points; i++) {
+        min.x = MIN(min.x, points[i].x);
+        min.y = MIN(min.y, points[i].y);
+        max.x = MAX(max.x, points[i].x);
+        max.y = MAX(max.y, points[i].y);
+    }
+    const Vector2f size = max - min;
+    if (!is_positive(size.x) || !is_positive(size.y)) {
+        return false;
+    }
+
+    // roughly one cell per edge, shaped to match the bounding box
+    const uint16_t max_cells = MIN(num_points, AP_POLYGON_INDEX_MAX_CELLS);
+    const uint16_t cols = constrain_float(sqrtf(max_cells * size.x / size.y) + 0.5f, 1, max_cells);
+    const uint16_t rows = MAX(max_cells / cols, 1);
+    const uint16_t num_cells = cols * rows;
+
+    _cell_start = (uint16_t *)calloc(num_cells + 1, sizeof(uint16_t));
+    _centre_inside = (uint8_t *)calloc((num_cells + 7) / 8, 1);
+    _edge_mark = (uint8_t *)calloc(num_points, 1);
+    if (_cell_start == nullptr || _centre_inside == nullptr || _edge_mark == nullptr) {
+        clear();
+        return false;
+    }
+
+    _points = points;
+    _num_points = num_points;
+    _min = min;
+    _max = max;
+    _cols = cols;
+    _rows = rows;
+    _cell_size = Vector2f(size.x / cols, size.y / rows);
+    _inv_cell_size = Vector2f(cols / size.x, rows / size.y);
+
+    // count the edges in each cell into the following cell's start
+    for (uint16_t i = 0; i < num_points; i++) {
+        add_edge(i);
+    }
+
+    // convert counts to offsets
+    uint32_t total = 0;
+    for (uint16_t c = 0; c < num_cells; c++) {
+        total += _cell_start[c + 1];
+        if (total > UINT16_MAX) {
+            clear();
+            return false;
+        }
+        _cell_start[c + 1] = total;
+    }
+
+    _cell_edges = (uint16_t *)calloc(MAX(total, 1U), sizeof(uint16_t));
+    if (_cell_edges == nullptr) {
+        clear();
+        return false;
+    }
+
+    // fill in the edges, advancing each cell's start as we go, then
+    // shift the starts back into place
+    for (uint16_t i = 0; i < num_points; i++) {
+        add_edge(i);
+    }
+    for (uint16_t c = num_cells; c > 0; c--) {
+        _cell_start[c] = _cell_start[c - 1];
+    }
+    _cell_start[0] = 0;
+
+    calc_centre_inside();
+
+    return true;
+}
+
+void AP_PolygonIndex::clear()
+{
+    free(_cell_start);
+    free(_cell_edges);
+    free(_centre_inside);
+    free(_edge_mark);
+    _cell_start = nullptr;
+    _cell_edges = nullptr;
+    _centre_inside = nullptr;
+    _edge_mark = nullptr;
+    _points = nullptr;
+    _num_points = 0;
+}
+
+uint16_t AP_PolygonIndex::cell_x(float x) const
+{
+    const float f = (x - _min.x) * _inv_cell_size.x;
+    if (!(f >= 0)) {
+        return 0;
+    }
+    return MIN((uint16_t)MIN(f, (float)UINT16_MAX), _cols - 1);
+}
+
+uint16_t AP_PolygonIndex::cell_y(float y) const
+{
+    const float f = (y - _min.y) * _inv_cell_size.y;
+    if (!(f >= 0)) {
+        return 0;
+    }
+    return MIN((uint16_t)MIN(f, (float)UINT16_MAX), _rows - 1);
+}
+
+// add an edge to each cell it passes through
+void AP_PolygonIndex::add_edge(uint16_t edge)
+{
+    const Vector2f &A = edge_start(edge);
+    const Vector2f &B = edge_end(edge);
+    if (A == B) {
+        // closing vertex, or a repeated point
+        return;
+    }
+
+    const uint16_t x0 = cell_x(MIN(A.x, B.x));
+    const uint16_t x1 = cell_x(MAX(A.x, B.x));
+    const uint16_t y0 = cell_y(MIN(A.y, B.y));
+    const uint16_t y1 = cell_y(MAX(A.y, B.y));
+    const Vector2f AB = B - A;
+
+    for (uint16_t cy = y0; cy <= y1; cy++) {
+        for (uint16_t cx = x0; cx <= x1; cx++) {
+            if (x0 != x1 && y0 != y1) {
+                // skip cells in the bounding box of a diagonal edge
+                // which have all four corners on the same side of it
+                const Vector2f corner = _min + Vector2f(cx * _cell_size.x, cy * _cell_size.y) - A;
+                const float s1 = AB % corner;
+                const float s2 = AB % (corner + Vector2f(_cell_size.x, 0));
+                const float s3 = AB % (corner + Vector2f(0, _cell_size.y));
+                const float s4 = AB % (corner + _cell_size);
+                if ((s1 > 0 && s2 > 0 && s3 > 0 && s4 > 0) ||
+                    (s1 < 0 && s2 < 0 && s3 < 0 && s4 < 0)) {
+                    continue;
+                }
+            }
+            const uint16_t c = cy * _cols + cx;
+            if (_cell_edges == nullptr) {
+                _cell_start[c + 1]++;
+            } else {
+                _cell_edges[_cell_start[c]++] = edge;
+            }
+        }
+    }
+}
+
+/*
+  find which cell centres are inside the polygon. For each row the
+  crossings of the edges with the horizontal line through the centres
+  are found with the same rule as Polygon_outside(). Each crossing
+  flips the state of every centre to its left, which is recorded
+  against the rightmost such centre and then accumulated from right to
+  left along the row
+ */
+void AP_PolygonIndex::calc_centre_inside()
+{
+    for (uint16_t row = 0; row < _rows; row++) {
+        const float y = _min.y + (row + 0.5f) * _cell_size.y;
+        const uint16_t row_start = row * _cols;
+
+        for (uint16_t i = 0; i < _num_points; i++) {
+            const Vector2f &A = edge_start(i);
+            const Vector2f &B = edge_end(i);
+            if ((A.y > y) == (B.y > y)) {
+                continue;
+            }
+            const float x = A.x + (y - A.y) * (B.x - A.x) / (B.y - A.y);
+            // number of centres strictly left of the crossing
+            const float v = (x - _min.x) * _inv_cell_size.x - 0.5f;
+            if (!(v > 0)) {
+                continue;
+            }
+            const uint16_t k = MIN(ceilf(v), (float)_cols);
+            const uint16_t c = row_start + k - 1;
+            _centre_inside[c / 8] ^= (1U << (c % 8));
+        }
+
+        bool inside = false;
+        for (int16_t col = _cols - 1; col >= 0; col--) {
+            const uint16_t c = row_start + col;
+            if (_centre_inside[c / 8] & (1U << (c % 8))) {
+                inside = !inside;
+            }
+            if (inside) {
+                _centre_inside[c / 8] |= (1U << (c % 8));
+            } else {
+                _centre_inside[c / 8] &= ~(1U << (c % 8));
+            }
+        }
+    }
+}
+
+/*
+  test for a point in the polygon. The centre of the cell holding P
+  has a known state, which flips for each edge crossed by the segment
+  from the centre to P. Any such edge must pass through the cell.
+  Crossings use the same half open rule as Polygon_outside() so
+  vertices lying on the segment are counted consistently
+ */
+bool AP_PolygonIndex::outside(const Vector2f &P) const
+{
+    if (!valid()) {
+        return true;
+    }
+    if (P.x < _min.x || P.x > _max.x || P.y < _min.y || P.y > _max.y) {
+        return true;
+    }
+
+    const uint16_t cx = cell_x(P.x);
+    const uint16_t cy = cell_y(P.y);
+    const uint16_t c = cy * _cols + cx;
+    const Vector2f C = _min + Vector2f((cx + 0.5f) * _cell_size.x, (cy + 0.5f) * _cell_size.y);
+    const Vector2f d = P - C;
+
+    bool inside = (_centre_inside[c / 8] & (1U << (c % 8))) != 0;
+    for (uint16_t i = _cell_start[c]; i < _cell_start[c + 1]; i++) {
+        const uint16_t edge = _cell_edges[i];
+        const Vector2f A = edge_start(edge) - C;
+        const Vector2f B = edge_end(edge) - C;
+        if (((d % A) > 0) == ((d % B) > 0)) {
+            continue;
+        }
+        // distance along the segment from C to P of the crossing
+        const Vector2f AB = B - A;
+        const float t = (A % AB) / (d % AB);
+        if (t > 0 && t <= 1) {
+            inside = !inside;
+        }
+    }
+    return !inside;
+}
+
+float AP_PolygonIndex::edge_distance_sq(const Vector2f &P, uint16_t edge) const
+{
+    return (P - Vector2f::closest_point(P, edge_start(edge), edge_end(edge))).length_squared();
+}
+
+/*
+  find the closest edge to P. Cells are searched in square rings
+  around the cell holding P; every cell in ring r is at least r-1
+  cells away from P, so the search stops once that is further than
+  the closest edge found so far
+ */
+bool AP_PolygonIndex::closest_edge(const Vector2f &P, uint16_t &edge, float &distance) const
+{
+    if (!valid()) {
+        return false;
+    }
+
+    const int16_t px = cell_x(P.x);
+    const int16_t py = cell_y(P.y);
+
+    // distance from P to the grid
+    const float dx = MAX(MAX(_min.x - P.x, P.x - _max.x), 0.0f);
+    const float dy = MAX(MAX(_min.y - P.y, P.y - _max.y), 0.0f);
+    const float grid_distance = norm(dx, dy);
+    const float min_cell_size = MIN(_cell_size.x, _cell_size.y);
+
+    float best_sq = FLT_MAX;
+    bool found = false;
+    const int16_t max_ring = MAX(_cols, _rows);
+    for (int16_t r = 0; r <= max_ring; r++) {
+        const float lower_bound = MAX(grid_distance, (r - 1) * min_cell_size);
+        if (found && sq(lower_bound) > best_sq) {
+            break;
+        }
+        const int16_t y0 = MAX(py - r, 0);
+        const int16_t y1 = MIN(py + r, _rows - 1);
+        for (int16_t cy = y0; cy <= y1; cy++) {
+            const bool full_row = (cy == py - r) || (cy == py + r);
+            const int16_t step = (full_row || r == 0) ? 1 : 2 * r;
+            for (int16_t cx = px - r; cx <= px + r; cx += step) {
+                if (cx < 0 || cx >= _cols) {
+                    continue;
+                }
+                const uint16_t c = cy * _cols + cx;
+                for (uint16_t i = _cell_start[c]; i < _cell_start[c + 1]; i++) {
+                    const float d_sq = edge_distance_sq(P, _cell_edges[i]);
+                    if (d_sq < best_sq) {
+                        best_sq = d_sq;
+                        edge = _cell_edges[i];
+                        found = true;
+                    }
+                }
+            }
+        }
+    }
+
+    if (found) {
+        distance = sqrtf(best_sq);
+    }
+    return found;
+}
+
+// list the edges passing within radius of P
+bool AP_PolygonIndex::edges_near(const Vector2f &P, float radius, uint16_t *edges, uint16_t max_edges, uint16_t &num_edges) const
+{
+    num_edges = 0;
+    if (!valid() ||
+        P.x + radius < _min.x || P.x - radius > _max.x ||
+        P.y + radius < _min.y || P.y - radius > _max.y) {
+        return true;
+    }
+
+    // edges pass through several cells, so mark each one as it is
+    // seen. The marks are cleared only when the counter wraps
+    _mark++;
+    if (_mark == 0) {
+        memset(_edge_mark, 0, _num_points);
+        _mark = 1;
+    }
+
+    const float radius_sq = sq(radius);
+    const uint16_t x0 = cell_x(P.x - radius);
+    const uint16_t x1 = cell_x(P.x + radius);
+    const uint16_t y0 = cell_y(P.y - radius);
+    const uint16_t y1 = cell_y(P.y + radius);
+    for (uint16_t cy = y0; cy <= y1; cy++) {
+        for (uint16_t cx = x0; cx <= x1; cx++) {
+            const uint16_t c = cy * _cols + cx;
+            for (uint16_t i = _cell_start[c]; i < _cell_start[c + 1]; i++) {
+                const uint16_t edge = _cell_edges[i];
+                if (_edge_mark[edge] == _mark) {
+                    continue;
+                }
+                _edge_mark[edge] = _mark;
+                if (edge_distance_sq(P, edge) > radius_sq) {
+                    continue;
+                }
+                if (num_edges >= max_edges) {
+                    return false;
+                }
+                edges[num_edges++] = edge;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,117 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  uniform grid spatial index over the edges of a polygon.
+
+  The bounding box of the polygon is divided into roughly one cell per
+  edge and each cell holds the list of edges passing through it,
+  together with whether the centre of the cell is inside the
+  polygon. A point is then tested by counting the edges crossed on
+  the short segment between it and the centre of its cell, so the
+  cost of a breach check depends on the number of edges near the
+  point rather than on the total number of edges. Nearest edge
+  queries search outwards ring by ring from the cell of the point
+  and stop as soon as no closer edge can exist.
+
+  The index refers to the vertex array it was built from, which must
+  not change or move while the index is in use.
+ */
+
+#include <AP_Common/AP_Common.h>
+#include "vector2.h"
+
+#ifndef AP_POLYGON_INDEX_MAX_CELLS
+#define AP_POLYGON_INDEX_MAX_CELLS  1024    // upper limit on grid cells, bounds memory for very large polygons
+#endif
+
+class AP_PolygonIndex
+{
+public:
+    AP_PolygonIndex() {}
+    ~AP_PolygonIndex() { clear(); }
+
+    /* Do not allow copies */
+    AP_PolygonIndex(const AP_PolygonIndex &other) = delete;
+    AP_PolygonIndex &operator=(const AP_PolygonIndex&) = delete;
+
+    // build the index over the num_points vertices in points. Edge i
+    // runs from points[i] to points[i+1], and the last edge back to
+    // points[0]; a repeated closing vertex as used by Polygon_outside
+    // is allowed. Returns false if the polygon is degenerate or the
+    // memory could not be allocated
+    bool init(const Vector2f *points, uint16_t num_points);
+
+    // free the index
+    void clear();
+
+    // true if init() has succeeded
+    bool valid() const { return _cell_start != nullptr; }
+
+    // true if P is outside the polygon. Agrees with Polygon_outside()
+    // except within rounding error of the boundary
+    bool outside(const Vector2f &P) const;
+
+    // find the edge closest to P and the distance to it
+    bool closest_edge(const Vector2f &P, uint16_t &edge, float &distance) const;
+
+    // fill edges with the edges passing within radius of P, each
+    // listed once. Returns false if there are more than max_edges
+    bool edges_near(const Vector2f &P, float radius, uint16_t *edges, uint16_t max_edges, uint16_t &num_edges) const;
+
+    // end points of an edge
+    const Vector2f &edge_start(uint16_t edge) const { return _points[edge]; }
+    const Vector2f &edge_end(uint16_t edge) const { return _points[(edge + 1) < _num_points ? edge + 1 : 0]; }
+
+private:
+
+    // cell coordinates of a point, clamped to the grid
+    uint16_t cell_x(float x) const;
+    uint16_t cell_y(float y) const;
+
+    // add edge to each cell it passes through. When _cell_edges is
+    // nullptr the cells are only counted
+    void add_edge(uint16_t edge);
+
+    // work out which cell centres are inside the polygon
+    void calc_centre_inside();
+
+    // squared distance from P to an edge
+    float edge_distance_sq(const Vector2f &P, uint16_t edge) const;
+
+    const Vector2f *_points = nullptr;
+    uint16_t _num_points;
+
+    // grid covering the bounding box of the polygon
+    Vector2f _min;
+    Vector2f _max;
+    Vector2f _cell_size;
+    Vector2f _inv_cell_size;
+    uint16_t _cols;
+    uint16_t _rows;
+
+    // edges in cell c are _cell_edges[_cell_start[c]] up to
+    // _cell_edges[_cell_start[c+1]]
+    uint16_t *_cell_start = nullptr;
+    uint16_t *_cell_edges = nullptr;
+
+    // one bit per cell, set if the cell centre is inside the polygon
+    uint8_t *_centre_inside = nullptr;
+
+    // per edge marker used to list each edge once in edges_near()
+    mutable uint8_t *_edge_mark = nullptr;
+    mutable uint8_t _mark;
+};
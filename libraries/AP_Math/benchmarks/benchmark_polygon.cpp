@@ -0,0 +1,118 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/AP_PolygonIndex.h>
+
+// a 1000 vertex fence about 1km across, in cm, closed by repeating
+// the first point as stored by AC_Fence
+#define FENCE_VERTICES 1000
+#define NUM_QUERIES 1024
+
+static Vector2f fence[FENCE_VERTICES + 1];
+static Vector2f queries[NUM_QUERIES];
+static AP_PolygonIndex fence_index;
+
+static void setup_fence()
+{
+    static bool done;
+    if (done) {
+        return;
+    }
+    for (uint16_t i = 0; i < FENCE_VERTICES; i++) {
+        const float angle = M_2PI * i / FENCE_VERTICES;
+        const float radius = 50000.0f + 10000.0f * sinf(angle * 7) + 3000.0f * ((i * 7919) % 13 - 6) / 6.0f;
+        fence[i] = Vector2f(radius * cosf(angle), radius * sinf(angle));
+    }
+    fence[FENCE_VERTICES] = fence[0];
+
+    // queries spread over the bounding box of the fence
+    for (uint16_t i = 0; i < NUM_QUERIES; i++) {
+        queries[i] = Vector2f(((i * 2654435761U) % 130000) - 65000.0f,
+                              ((i * 40503U) % 130000) - 65000.0f);
+    }
+
+    fence_index.init(fence, FENCE_VERTICES + 1);
+    done = true;
+}
+
+static void BM_PolygonOutside(benchmark::State& state)
+{
+    setup_fence();
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        bool outside = Polygon_outside(queries[i], fence, FENCE_VERTICES + 1);
+        gbenchmark_escape(&outside);
+        i = (i + 1) % NUM_QUERIES;
+    }
+}
+
+static void BM_PolygonIndexOutside(benchmark::State& state)
+{
+    setup_fence();
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        bool outside = fence_index.outside(queries[i]);
+        gbenchmark_escape(&outside);
+        i = (i + 1) % NUM_QUERIES;
+    }
+}
+
+static void BM_PolygonClosestEdge(benchmark::State& state)
+{
+    setup_fence();
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        float best = FLT_MAX;
+        for (uint16_t e = 0; e < FENCE_VERTICES; e++) {
+            const float d = (queries[i] - Vector2f::closest_point(queries[i], fence[e], fence[e + 1])).length_squared();
+            best = MIN(best, d);
+        }
+        gbenchmark_escape(&best);
+        i = (i + 1) % NUM_QUERIES;
+    }
+}
+
+static void BM_PolygonIndexClosestEdge(benchmark::State& state)
+{
+    setup_fence();
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        uint16_t edge;
+        float distance;
+        fence_index.closest_edge(queries[i], edge, distance);
+        gbenchmark_escape(&distance);
+        i = (i + 1) % NUM_QUERIES;
+    }
+}
+
+static void BM_PolygonIndexEdgesNear(benchmark::State& state)
+{
+    setup_fence();
+    uint16_t i = 0;
+    uint16_t edges[64];
+    while (state.KeepRunning()) {
+        uint16_t num_edges;
+        fence_index.edges_near(queries[i], 1000.0f, edges, ARRAY_SIZE(edges), num_edges);
+        gbenchmark_escape(edges);
+        i = (i + 1) % NUM_QUERIES;
+    }
+}
+
+static void BM_PolygonIndexBuild(benchmark::State& state)
+{
+    setup_fence();
+    while (state.KeepRunning()) {
+        AP_PolygonIndex index;
+        bool ok = index.init(fence, FENCE_VERTICES + 1);
+        gbenchmark_escape(&ok);
+    }
+}
+
+BENCHMARK(BM_PolygonOutside);
+BENCHMARK(BM_PolygonIndexOutside);
+BENCHMARK(BM_PolygonClosestEdge);
+BENCHMARK(BM_PolygonIndexClosestEdge);
+BENCHMARK(BM_PolygonIndexEdgesNear);
+BENCHMARK(BM_PolygonIndexBuild);
+
+BENCHMARK_MAIN()
@@ -60,6 +60,9 @@ void AP_Mission::init()
     	clear();	
     }
 
+    // the cache starts with room for the stored mission and grows as commands are added
+    grow_cache(_cmd_total);
+
     _last_change_time_ms = AP_HAL::millis();
 }
 
@@ -334,11 +337,11 @@ bool AP_Mission::replace_cmd(uint16_t index, Mission_Command& cmd)
     return write_cmd_to_storage(index, cmd);
 }
 
-/// is_nav_cmd - returns true if the command's id is a "navigation" command, false if "do" or "conditional" command
-bool AP_Mission::is_nav_cmd(const Mission_Command& cmd)
+/// is_nav_cmd_id - returns true if the command id is a "navigation" command, false if "do" or "conditional" command
+bool AP_Mission::is_nav_cmd_id(uint16_t id)
 {
     // NAV commands all have ids below MAV_CMD_NAV_LAST except NAV_SET_YAW_SPEED
-    return (cmd.id <= MAV_CMD_NAV_LAST || cmd.id == MAV_CMD_NAV_SET_YAW_SPEED);
+    return (id <= MAV_CMD_NAV_LAST || id == MAV_CMD_NAV_SET_YAW_SPEED);
 }
 
 /// get_next_nav_cmd - gets next "navigation" command found at or after start_index
@@ -350,6 +353,9 @@ bool AP_Mission::get_next_nav_cmd(uint16_t start_index, Mission_Command& cmd)
 
     // search until the end of the mission command list
     while(cmd_index < (unsigned)_cmd_total) {
+        // skip any "do" commands, they would only be passed over
+        cmd_index = next_nav_or_jump_index(cmd_index);
+
         // get next command
         if (!get_next_cmd(cmd_index, cmd, false)) {
             // no more commands so return failure
@@ -482,31 +488,43 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
         cmd.id = MAV_CMD_NAV_WAYPOINT;
         cmd.p1 = 0;
         cmd.content.location = AP::ahrs().get_home();
-    }else{
-        // Find out proper location in memory by using the start_byte position + the index
-        // we can load a command, we don't process it yet
-        // read WP position
-        uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
-
-        uint8_t b1 = _storage.read_byte(pos_in_storage);
-        if (b1 == 0) {
-            cmd.id = _storage.read_uint16(pos_in_storage+1);
-            cmd.p1 = _storage.read_uint16(pos_in_storage+3);
-            _storage.read_block(cmd.content.bytes, pos_in_storage+5, 10);
-        } else {
-            cmd.id = b1;
-            cmd.p1 = _storage.read_uint16(pos_in_storage+1);
-            _storage.read_block(cmd.content.bytes, pos_in_storage+3, 12);
-        }
-
-        // set command's index to it's position in eeprom
+    }else if (index < _cache_size) {
+        const Cached_Command &cached = _cache[index];
+        cmd.id = cached.id;
+        cmd.p1 = cached.p1;
+        cmd.content = cached.content;
         cmd.index = index;
+    }else{
+        read_cmd_from_storage_uncached(index, cmd);
     }
 
     // return success
     return true;
 }
 
+/// read_cmd_from_storage_uncached - decode a command directly from storage
+void AP_Mission::read_cmd_from_storage_uncached(uint16_t index, Mission_Command& cmd) const
+{
+    // Find out proper location in memory by using the start_byte position + the index
+    // we can load a command, we don't process it yet
+    // read WP position
+    uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+
+    uint8_t b1 = _storage.read_byte(pos_in_storage);
+    if (b1 == 0) {
+        cmd.id = _storage.read_uint16(pos_in_storage+1);
+        cmd.p1 = _storage.read_uint16(pos_in_storage+3);
+        _storage.read_block(cmd.content.bytes, pos_in_storage+5, 10);
+    } else {
+        cmd.id = b1;
+        cmd.p1 = _storage.read_uint16(pos_in_storage+1);
+        _storage.read_block(cmd.content.bytes, pos_in_storage+3, 12);
+    }
+
+    // set command's index to it's position in eeprom
+    cmd.index = index;
+}
+
 /// write_cmd_to_storage - write a command to storage
 ///     index is used to calculate the storage location
 ///     true is returned if successful
@@ -534,6 +552,23 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, Mission_Command& cmd)
         _storage.write_block(pos_in_storage+5, cmd.content.bytes, 10);
     }
 
+    // keep the cache matching storage
+    if (index >= _cache_size) {
+        grow_cache(index+1);
+    }
+    if (index < _cache_size) {
+        Cached_Command &cached = _cache[index];
+        cached.id = cmd.id;
+        cached.p1 = cmd.p1;
+        cached.content = cmd.content;
+        if (cmd.id >= 256) {
+            // only 10 bytes of content are stored with a 16 bit command ID
+            cached.content.bytes[10] = 0;
+            cached.content.bytes[11] = 0;
+        }
+    }
+    _cache_index_valid = false;
+
     // remember when the mission last changed
     _last_change_time_ms = AP_HAL::millis();
 
@@ -1434,6 +1469,11 @@ bool AP_Mission::advance_current_nav_cmd(uint16_t starting_index)
 
     // search until we find next nav command or reach end of command list
     while (!_flags.nav_cmd_loaded) {
+        // once a do command is loaded any others before the nav command are skipped
+        if (_flags.do_cmd_loaded) {
+            cmd_index = next_nav_or_jump_index(cmd_index);
+        }
+
         // get next command
         if (!get_next_cmd(cmd_index, cmd, true)) {
             return false;
@@ -1627,10 +1667,39 @@ bool AP_Mission::get_next_do_cmd(uint16_t start_index, Mission_Command& cmd)
 // init_jump_tracking - initialise jump_tracking variables
 void AP_Mission::init_jump_tracking()
 {
-    for(uint8_t i=0; i<AP_MISSION_MAX_NUM_DO_JUMP_COMMANDS; i++) {
-        _jump_tracking[i].index = AP_MISSION_CMD_INDEX_NONE;
-        _jump_tracking[i].num_times_run = 0;
+    _jump_tracking_count = 0;
+}
+
+/// find_jump_tracking - returns the slot in _jump_tracking for the do-jump command at index, adding it if
+///     it is not already tracked.  Returns false if there is no space for it
+bool AP_Mission::find_jump_tracking(uint16_t index, uint8_t& slot)
+{
+    // binary search for the first slot at or after index
+    uint8_t low = 0;
+    uint8_t high = _jump_tracking_count;
+    while (low < high) {
+        const uint8_t mid = (low + high) / 2;
+        if (_jump_tracking[mid].index < index) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
+    slot = low;
+    if (slot < _jump_tracking_count && _jump_tracking[slot].index == index) {
+        return true;
+    }
+
+    // we've searched through all known jump commands and haven't found it so allocate new space in _jump_tracking array
+    if (_jump_tracking_count >= AP_MISSION_MAX_NUM_DO_JUMP_COMMANDS) {
+        // To-Do: log an error?
+        return false;
+    }
+    memmove(&_jump_tracking[slot+1], &_jump_tracking[slot], (_jump_tracking_count - slot) * sizeof(_jump_tracking[0]));
+    _jump_tracking[slot].index = index;
+    _jump_tracking[slot].num_times_run = 0;
+    _jump_tracking_count++;
+    return true;
 }
 
 /// get_jump_times_run - returns number of times the jump command has been run
@@ -1642,21 +1711,12 @@ int16_t AP_Mission::get_jump_times_run(const Mission_Command& cmd)
         return AP_MISSION_JUMP_TIMES_MAX;
     }
 
-    // search through jump_tracking array for this cmd
-    for (uint8_t i=0; i<AP_MISSION_MAX_NUM_DO_JUMP_COMMANDS; i++) {
-        if (_jump_tracking[i].index == cmd.index) {
-            return _jump_tracking[i].num_times_run;
-        }else if(_jump_tracking[i].index == AP_MISSION_CMD_INDEX_NONE) {
-            // we've searched through all known jump commands and haven't found it so allocate new space in _jump_tracking array
-            _jump_tracking[i].index = cmd.index;
-            _jump_tracking[i].num_times_run = 0;
-            return 0;
-        }
+    // if the _jump_tracking array is full treat the jump as complete
+    uint8_t slot;
+    if (!find_jump_tracking(cmd.index, slot)) {
+        return AP_MISSION_JUMP_TIMES_MAX;
     }
-
-    // if we've gotten this far then the _jump_tracking array must be full
-    // To-Do: log an error?
-    return AP_MISSION_JUMP_TIMES_MAX;
+    return _jump_tracking[slot].num_times_run;
 }
 
 /// increment_jump_times_run - increments the recorded number of times the jump command has been run
@@ -1668,22 +1728,10 @@ void AP_Mission::increment_jump_times_run(Mission_Command& cmd)
         return;
     }
 
-    // search through jump_tracking array for this cmd
-    for (uint8_t i=0; i<AP_MISSION_MAX_NUM_DO_JUMP_COMMANDS; i++) {
-        if (_jump_tracking[i].index == cmd.index) {
-            _jump_tracking[i].num_times_run++;
-            return;
-        }else if(_jump_tracking[i].index == AP_MISSION_CMD_INDEX_NONE) {
-            // we've searched through all known jump commands and haven't found it so allocate new space in _jump_tracking array
-            _jump_tracking[i].index = cmd.index;
-            _jump_tracking[i].num_times_run = 1;
-            return;
-        }
+    uint8_t slot;
+    if (find_jump_tracking(cmd.index, slot)) {
+        _jump_tracking[slot].num_times_run++;
     }
-
-    // if we've gotten this far then the _jump_tracking array must be full
-    // To-Do: log an error
-    return;
 }
 
 // check_eeprom_version - checks version of missions stored in eeprom matches this library
@@ -1700,6 +1748,96 @@ void AP_Mission::check_eeprom_version()
     }
 }
 
+///
+/// command cache methods
+///
+
+// grow_cache - grow the cache to hold at least count commands, rounded up to a multiple of
+// AP_MISSION_CACHE_STEP.  If there is not enough memory the cache keeps its size and later
+// commands are read from storage as they are needed
+void AP_Mission::grow_cache(uint16_t count)
+{
+    if (!AP_MISSION_CACHE_ENABLED) {
+        return;
+    }
+
+    WITH_SEMAPHORE(_rsem);
+
+    const uint16_t size_max = MIN(num_commands_max(), (uint16_t)AP_MISSION_CACHE_MAX_COMMANDS);
+    if (count > size_max) {
+        count = size_max;
+    }
+    if (count <= _cache_size) {
+        return;
+    }
+    const uint16_t size = MIN(((count + AP_MISSION_CACHE_STEP - 1) / AP_MISSION_CACHE_STEP) * AP_MISSION_CACHE_STEP, size_max);
+
+    Cached_Command *cache = (Cached_Command *)calloc(size, sizeof(Cached_Command));
+    uint16_t *cache_next_nav = (uint16_t *)calloc(size, sizeof(uint16_t));
+    if (cache == nullptr || cache_next_nav == nullptr) {
+        free(cache);
+        free(cache_next_nav);
+        return;
+    }
+
+    if (_cache_size > 0) {
+        memcpy(cache, _cache, _cache_size * sizeof(Cached_Command));
+    }
+    // command #0 is home which is never read from storage
+    for (uint16_t i = MAX(_cache_size, (uint16_t)1); i < size; i++) {
+        Mission_Command cmd = {};
+        read_cmd_from_storage_uncached(i, cmd);
+        cache[i].id = cmd.id;
+        cache[i].p1 = cmd.p1;
+        cache[i].content = cmd.content;
+    }
+
+    free(_cache);
+    free(_cache_next_nav);
+    _cache = cache;
+    _cache_next_nav = cache_next_nav;
+    _cache_size = size;
+    _cache_index_valid = false;
+}
+
+// update_cache_index - rebuild the index of navigation and do-jump commands if the mission has changed
+void AP_Mission::update_cache_index()
+{
+    const uint16_t total = MIN((uint16_t)_cmd_total, _cache_size);
+    if (_cache_index_valid && _cache_index_total == total) {
+        return;
+    }
+
+    // work backwards so each command takes the index of the one after it unless it
+    // is a navigation or do-jump command itself
+    uint16_t next = total;
+    for (uint16_t i = total; i > 1; i--) {
+        const uint16_t id = _cache[i-1].id;
+        if (is_nav_cmd_id(id) || id == MAV_CMD_DO_JUMP) {
+            next = i-1;
+        }
+        _cache_next_nav[i-1] = next;
+    }
+    _cache_index_total = total;
+    _cache_index_valid = true;
+}
+
+// next_nav_or_jump_index - returns the index of the first "navigation" or do-jump command at or after index,
+//      or the number of commands if there are none.  Without the cache this is index itself
+uint16_t AP_Mission::next_nav_or_jump_index(uint16_t index)
+{
+    WITH_SEMAPHORE(_rsem);
+
+    if (_cache_size == 0 || index == 0) {
+        return index;
+    }
+    update_cache_index();
+    if (index >= _cache_index_total) {
+        return index;
+    }
+    return _cache_next_nav[index];
+}
+
 /*
   return total number of commands that can fit in storage space
  */
@@ -24,7 +24,11 @@
 #define AP_MISSION_EEPROM_VERSION           0x65AE  // version number stored in first four bytes of eeprom.  increment this by one when eeprom format is changed
 #define AP_MISSION_EEPROM_COMMAND_SIZE      15      // size in bytes of all mission commands
 
+#if HAL_MINIMIZE_FEATURES
 #define AP_MISSION_MAX_NUM_DO_JUMP_COMMANDS 15      // allow up to 15 do-jump commands
+#else
+#define AP_MISSION_MAX_NUM_DO_JUMP_COMMANDS 100     // allow up to 100 do-jump commands
+#endif
 
 #define AP_MISSION_JUMP_REPEAT_FOREVER      -1      // when do-jump command's repeat count is -1 this means endless repeat
 
@@ -39,6 +43,14 @@
 #define AP_MISSION_OPTIONS_DEFAULT          0       // Do not clear the mission when rebooting
 #define AP_MISSION_MASK_MISSION_CLEAR       (1<<0)  // If set then Clear the mission on boot
 
+#ifndef AP_MISSION_CACHE_ENABLED
+#define AP_MISSION_CACHE_ENABLED            (!HAL_MINIMIZE_FEATURES)    // hold a decoded copy of the mission in RAM
+#endif
+#ifndef AP_MISSION_CACHE_MAX_COMMANDS
+#define AP_MISSION_CACHE_MAX_COMMANDS       0xFFFF  // most commands held in the cache, later ones are read from storage
+#endif
+#define AP_MISSION_CACHE_STEP               16      // the cache grows by this many commands at a time as the mission grows
+
 /// @class    AP_Mission
 /// @brief    Object managing Mission
 class AP_Mission {
@@ -287,6 +299,12 @@ public:
         _prev_nav_cmd_id(AP_MISSION_CMD_ID_NONE),
         _prev_nav_cmd_index(AP_MISSION_CMD_INDEX_NONE),
         _prev_nav_cmd_wp_index(AP_MISSION_CMD_INDEX_NONE),
+        _jump_tracking_count(0),
+        _cache(nullptr),
+        _cache_size(0),
+        _cache_next_nav(nullptr),
+        _cache_index_total(0),
+        _cache_index_valid(false),
         _last_change_time_ms(0)
     {
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -387,7 +405,8 @@ public:
     bool replace_cmd(uint16_t index, Mission_Command& cmd);
 
     /// is_nav_cmd - returns true if the command's id is a "navigation" command, false if "do" or "conditional" command
-    static bool is_nav_cmd(const Mission_Command& cmd);
+    static bool is_nav_cmd(const Mission_Command& cmd) { return is_nav_cmd_id(cmd.id); }
+    static bool is_nav_cmd_id(uint16_t id);
 
     /// get_current_nav_cmd - returns the current "navigation" command
     const Mission_Command& get_current_nav_cmd() const { return _nav_cmd; }
@@ -541,6 +560,26 @@ private:
     /// command list will be cleared if they do not match
     void check_eeprom_version();
 
+    ///
+    /// command cache methods
+    ///
+    /// grow the cache to hold at least count commands, filling the new entries from storage
+    void grow_cache(uint16_t count);
+
+    /// decode a command directly from storage
+    void read_cmd_from_storage_uncached(uint16_t index, Mission_Command& cmd) const;
+
+    /// next_nav_or_jump_index - returns the index of the first "navigation" or do-jump command at or after index,
+    ///     or the number of commands if there are none.  Without the cache this is index itself
+    uint16_t next_nav_or_jump_index(uint16_t index);
+
+    /// rebuild the index of navigation and do-jump commands if the mission has changed
+    void update_cache_index();
+
+    /// find_jump_tracking - returns the slot in _jump_tracking for the do-jump command at index, adding it if
+    ///     it is not already tracked.  Returns false if there is no space for it
+    bool find_jump_tracking(uint16_t index, uint8_t& slot);
+
     /// sanity checks that the masked fields are not NaN's or infinite
     static MAV_MISSION_RESULT sanity_check_params(const mavlink_mission_item_int_t& packet);
 
@@ -561,11 +600,26 @@ private:
     uint16_t                _prev_nav_cmd_index;    // index of the previous "navigation" command.  Rarely used which is why we don't store the whole command
     uint16_t                _prev_nav_cmd_wp_index; // index of the previous "navigation" command that contains a waypoint.  Rarely used which is why we don't store the whole command
 
-    // jump related variables
+    // jump related variables.  Entries are kept in order of index so they can be binary searched
     struct jump_tracking_struct {
         uint16_t index;                 // index of do-jump commands in mission
         int16_t num_times_run;          // number of times this jump command has been run
     } _jump_tracking[AP_MISSION_MAX_NUM_DO_JUMP_COMMANDS];
+    uint8_t _jump_tracking_count;       // number of do-jump commands being tracked
+
+    // decoded copy of the commands held in storage, kept up to date by write_cmd_to_storage
+    struct PACKED Cached_Command {
+        uint16_t id;
+        uint16_t p1;
+        Content content;
+    } *_cache;
+    uint16_t _cache_size;               // number of commands the cache can hold, zero if there is no cache
+
+    // index of the first navigation or do-jump command at or after each command, used to skip over
+    // "do" commands.  Rebuilt when the mission has changed
+    uint16_t *_cache_next_nav;
+    uint16_t _cache_index_total;        // number of commands when the index was built
+    bool _cache_index_valid;
 
     // last time that mission changed
     uint32_t _last_change_time_ms;
@@ -20,6 +20,7 @@
  */
 #include <AP_HAL/AP_HAL.h>
 #include "AP_MotorsMatrix.h"
+#include <AP_Scheduler/LatencyInfo.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -137,20 +138,54 @@ uint16_t AP_MotorsMatrix::get_motor_mask()
 }
 
 // output_armed - sends commands to the motors
-// includes new scaling stability patch
 void AP_MotorsMatrix::output_armed_stabilizing()
 {
-    uint8_t i;                          // general purpose counter
+    // while the rate controller thread owns the motors it runs the
+    // mixer, so check its last mix
+    if (!rate_only_output_active()) {
+        _mix_throttle_out = mix_armed_stabilizing();
+    }
+
+    // check for failed motor
+    check_for_failed_motor(_mix_throttle_out);
+}
+
+/*
+  re-run the mixer with the latest roll, pitch and yaw inputs and
+  write the motors, without the spool logic or the filters in
+  output(). The failed motor check is left to output() as its filter
+  assumes the main loop rate
+ */
+bool AP_MotorsMatrix::output_rate_only()
+{
+    WITH_SEMAPHORE(_output_sem);
+
+    if (!rate_only_output_active()) {
+        return false;
+    }
+
+    _mix_throttle_out = mix_armed_stabilizing();
+    thrust_compensation();
+
+    AP::latency().record(AP::LatencyInfo::STAGE_MIXER);
+
+    hal.rcout->cork();
+    output_to_motors();
+    hal.rcout->push();
+
+    AP::latency().record(AP::LatencyInfo::STAGE_OUTPUT);
+    return true;
+}
+
+// mix the inputs, includes new scaling stability patch
+float AP_MotorsMatrix::mix_armed_stabilizing()
+{
     float   roll_thrust;                // roll thrust input value, +/- 1.0
     float   pitch_thrust;               // pitch thrust input value, +/- 1.0
     float   yaw_thrust;                 // yaw thrust input value, +/- 1.0
     float   throttle_thrust;            // throttle thrust input value, 0.0 - 1.0
     float   throttle_avg_max;           // throttle thrust average maximum value, 0.0 - 1.0
     float   throttle_thrust_max;        // throttle thrust maximum value, 0.0 - 1.0
-    float   throttle_thrust_best_rpy;   // throttle providing maximum roll, pitch and yaw range without climbing
-    float   rpy_scale = 1.0f;           // this is used to scale the roll, pitch and yaw to fit within the motor limits
-    float   yaw_allowed = 1.0f;         // amount of yaw we can fit in
-    float   thr_adj;                    // the difference between the pilot's desired throttle and throttle_thrust_best_rpy
 
     // apply voltage and air pressure compensation
     const float compensation_gain = get_compensation_gain(); // compensation for battery voltage and altitude
@@ -195,120 +230,35 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // Octo-Quad (x8) + : MOT_YAW_HEADROOM = 300, ATC_RAT_RLL_IMAX = 0.5,   ATC_RAT_PIT_IMAX = 0.5,   ATC_RAT_YAW_IMAX = 0.25
     // Quads cannot make use of motor loss handling because it doesn't have enough degrees of freedom.
 
-    // calculate amount of yaw we can fit into the throttle range
-    // this is always equal to or less than the requested yaw from the pilot or rate controller
-    float rp_low = 1.0f;    // lowest thrust value
-    float rp_high = -1.0f;  // highest thrust value
-    for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            // calculate the thrust outputs for roll and pitch
-            _thrust_rpyt_out[i] = roll_thrust * _roll_factor[i] + pitch_thrust * _pitch_factor[i];
-            // record lowest roll+pitch command
-            if (_thrust_rpyt_out[i] < rp_low) {
-                rp_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll+pitch command
-            if (_thrust_rpyt_out[i] > rp_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rp_high = _thrust_rpyt_out[i];
-            }
-        }
-    }
-
-    // include the lost motor scaled by _thrust_boost_ratio
-    if (_thrust_boost && motor_enabled[_motor_lost_index]) {
-        // record highest roll+pitch command
-        if (_thrust_rpyt_out[_motor_lost_index] > rp_high) {
-            rp_high = _thrust_boost_ratio*rp_high + (1.0f-_thrust_boost_ratio)*_thrust_rpyt_out[_motor_lost_index];
-        }
-    }
-
-    // check for roll and pitch saturation
-    if (rp_high-rp_low > 1.0f || throttle_avg_max < -rp_low) {
-        // Full range is being used by roll and pitch.
-        limit.roll_pitch = true;
-    }
-
-    // calculate the highest allowed average thrust that will provide maximum control range
-    throttle_thrust_best_rpy = MIN(0.5f, throttle_avg_max);
-
     // calculate the maximum yaw control that can be used
     // todo: make _yaw_headroom 0 to 1
-    yaw_allowed = (float)_yaw_headroom / 1000.0f;
+    float yaw_allowed = (float)_yaw_headroom / 1000.0f;
     yaw_allowed = _thrust_boost_ratio*0.5f + (1.0f - _thrust_boost_ratio) * yaw_allowed;
-    yaw_allowed = MAX(MIN(throttle_thrust_best_rpy+rp_low, 1.0f - (throttle_thrust_best_rpy + rp_high)), yaw_allowed);
-    if (fabsf(yaw_thrust) > yaw_allowed) {
-        // not all commanded yaw can be used
-        yaw_thrust = constrain_float(yaw_thrust, -yaw_allowed, yaw_allowed);
-        limit.yaw = true;
-    }
-
-    // add yaw control to thrust outputs
-    float rpy_low = 1.0f;   // lowest thrust value
-    float rpy_high = -1.0f; // highest thrust value
-    for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = _thrust_rpyt_out[i] + yaw_thrust * _yaw_factor[i];
-
-            // record lowest roll+pitch+yaw command
-            if (_thrust_rpyt_out[i] < rpy_low) {
-                rpy_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll+pitch+yaw command
-            if (_thrust_rpyt_out[i] > rpy_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rpy_high = _thrust_rpyt_out[i];
-            }
-        }
-    }
-    // include the lost motor scaled by _thrust_boost_ratio
-    if (_thrust_boost) {
-        // record highest roll+pitch+yaw command
-        if (_thrust_rpyt_out[_motor_lost_index] > rpy_high && motor_enabled[_motor_lost_index]) {
-            rpy_high = _thrust_boost_ratio*rpy_high + (1.0f-_thrust_boost_ratio)*_thrust_rpyt_out[_motor_lost_index];
-        }
-    }
 
-    // calculate any scaling needed to make the combined thrust outputs fit within the output range
-    if (rpy_high-rpy_low > 1.0f) {
-        rpy_scale = 1.0f / (rpy_high-rpy_low);
-    }
-    if (is_negative(rpy_low)) {
-        rpy_scale = MIN(rpy_scale, -throttle_avg_max / rpy_low);
-    }
-
-    // calculate how close the motors can come to the desired throttle
-    rpy_high *= rpy_scale;
-    rpy_low *= rpy_scale;
-    throttle_thrust_best_rpy = -rpy_low;
-    thr_adj = throttle_thrust - throttle_thrust_best_rpy;
-    if (rpy_scale < 1.0f) {
-        // Full range is being used by roll, pitch, and yaw.
+    // mix roll, pitch, yaw and throttle, fitting as much yaw into the
+    // throttle range as we can
+    const AP_MotorsMatrix_Mixer::Inputs inputs {
+        roll_thrust,
+        pitch_thrust,
+        yaw_thrust,
+        throttle_thrust,
+        throttle_avg_max,
+        yaw_allowed,
+        _thrust_boost_ratio,
+        _thrust_boost ? (int8_t)_motor_lost_index : (int8_t)-1
+    };
+    AP_MotorsMatrix_Mixer::Limits limits {};
+    const float throttle_out = _mixer.mix(inputs, _thrust_rpyt_out, limits);
+    if (limits.roll_pitch) {
         limit.roll_pitch = true;
+    }
+    if (limits.yaw) {
         limit.yaw = true;
-        if (thr_adj > 0.0f) {
-            limit.throttle_upper = true;
-        }
-        thr_adj = 0.0f;
-    } else {
-        if (thr_adj < 0.0f) {
-            // Throttle can't be reduced to desired value
-            // todo: add lower limit flag and ensure it is handled correctly in altitude controller
-            thr_adj = 0.0f;
-        } else if (thr_adj > 1.0f - (throttle_thrust_best_rpy + rpy_high)) {
-            // Throttle can't be increased to desired value
-            thr_adj = 1.0f - (throttle_thrust_best_rpy + rpy_high);
-            limit.throttle_upper = true;
-        }
     }
-
-    // add scaled roll, pitch, constrained yaw and throttle for each motor
-    for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = throttle_thrust_best_rpy + thr_adj + (rpy_scale * _thrust_rpyt_out[i]);
-        }
+    if (limits.throttle_upper) {
+        limit.throttle_upper = true;
     }
-
-    // check for failed motor
-    check_for_failed_motor(throttle_thrust_best_rpy + thr_adj);
+    return throttle_out;
 }
 
 // check for failed motor
@@ -772,6 +722,8 @@ void AP_MotorsMatrix::setup_motors(motor_frame_class frame_class, motor_frame_ty
     // normalise factors to magnitude 0.5
     normalise_rpy_factors();
 
+    setup_mixer();
+
     _flags.initialised_ok = success;
 }
 
@@ -814,6 +766,12 @@ void AP_MotorsMatrix::normalise_rpy_factors()
 }
 
 
+// pack the factors of the enabled motors into the mixer
+void AP_MotorsMatrix::setup_mixer()
+{
+    _mixer.setup(motor_enabled, _roll_factor, _pitch_factor, _yaw_factor);
+}
+
 /*
   call vehicle supplied thrust compensation if set. This allows
   vehicle code to compensate for vehicle specific motor arrangements
@@ -6,6 +6,7 @@
 #include <AP_Math/AP_Math.h>        // ArduPilot Mega Vector/Matrix math Library
 #include <RC_Channel/RC_Channel.h>     // RC Channel Library
 #include "AP_MotorsMulticopter.h"
+#include "AP_MotorsMatrix_Mixer.h"
 
 #define AP_MOTORS_MATRIX_YAW_FACTOR_CW   -1
 #define AP_MOTORS_MATRIX_YAW_FACTOR_CCW   1
@@ -44,6 +45,10 @@ public:
     // output_to_motors - sends minimum values out to the motors
     void                output_to_motors() override;
 
+    // re-run the mixer and write the motor channels between outputs
+    bool                has_rate_only_output() const override { return true; }
+    bool                output_rate_only() override;
+
     // get_motor_mask - returns a bitmask of which outputs are being used for motors (1 means being used)
     //  this can be used to ensure other pwm outputs (i.e. for servos) do not conflict
     uint16_t            get_motor_mask() override;
@@ -55,6 +60,10 @@ protected:
     // output - sends commands to the motors
     void                output_armed_stabilizing() override;
 
+    // mix the roll, pitch, yaw and throttle inputs into _thrust_rpyt_out,
+    // returning the throttle used
+    float               mix_armed_stabilizing();
+
     // check for failed motor
     void                check_for_failed_motor(float throttle_thrust_best);
 
@@ -79,14 +88,20 @@ protected:
     // call vehicle supplied thrust compensation if set
     void                thrust_compensation(void) override;
 
+    // pack the factors of the enabled motors into the mixer
+    void                setup_mixer();
+
     float               _roll_factor[AP_MOTORS_MAX_NUM_MOTORS]; // each motors contribution to roll
     float               _pitch_factor[AP_MOTORS_MAX_NUM_MOTORS]; // each motors contribution to pitch
     float               _yaw_factor[AP_MOTORS_MAX_NUM_MOTORS];  // each motors contribution to yaw (normally 1 or -1)
     float               _thrust_rpyt_out[AP_MOTORS_MAX_NUM_MOTORS]; // combined roll, pitch, yaw and throttle outputs to motors in 0~1 range
     uint8_t             _test_order[AP_MOTORS_MAX_NUM_MOTORS];  // order of the motors in the test sequence
+    AP_MotorsMatrix_Mixer _mixer;                               // packed factors of the enabled motors
     motor_frame_class   _last_frame_class; // most recently requested frame class (i.e. quad, hexa, octa, etc)
     motor_frame_type    _last_frame_type; // most recently requested frame type (i.e. plus, x, v, etc)
 
+    float               _mix_throttle_out;  // throttle used by the last mix
+
     // motor failure handling
     float               _thrust_rpyt_out_filt[AP_MOTORS_MAX_NUM_MOTORS];    // filtered thrust outputs with 1 second time constant
     uint8_t             _motor_lost_index;  // index number of the lost motor
@@ -0,0 +1,154 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <AP_Math/AP_Math.h>
+
+#include "AP_MotorsMatrix_Mixer.h"
+
+void AP_MotorsMatrix_Mixer::setup(const bool enabled[AP_MOTORS_MAX_NUM_MOTORS],
+                                  const float roll_factor[AP_MOTORS_MAX_NUM_MOTORS],
+                                  const float pitch_factor[AP_MOTORS_MAX_NUM_MOTORS],
+                                  const float yaw_factor[AP_MOTORS_MAX_NUM_MOTORS])
+{
+    _num_motors = 0;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (!enabled[i]) {
+            _slot[i] = -1;
+            continue;
+        }
+        _slot[i] = _num_motors;
+        _motor_num[_num_motors] = i;
+        _roll_factor[_num_motors] = roll_factor[i];
+        _pitch_factor[_num_motors] = pitch_factor[i];
+        _yaw_factor[_num_motors] = yaw_factor[i];
+        _num_motors++;
+    }
+}
+
+float AP_MotorsMatrix_Mixer::highest_except(uint8_t skip, float high) const
+{
+    for (uint8_t k = 0; k < _num_motors; k++) {
+        if (k != skip) {
+            high = MAX(high, _rpy_out[k]);
+        }
+    }
+    return high;
+}
+
+float AP_MotorsMatrix_Mixer::mix(const Inputs &in, float thrust_out[AP_MOTORS_MAX_NUM_MOTORS], Limits &limits)
+{
+    const uint8_t n = _num_motors;
+    if (n == 0) {
+        return 0.0f;
+    }
+
+    // the slot of the lost motor, if it is one of ours
+    int8_t lost = -1;
+    if (in.lost_motor >= 0 && in.lost_motor < AP_MOTORS_MAX_NUM_MOTORS) {
+        lost = _slot[in.lost_motor];
+    }
+
+    // mix roll and pitch
+    float rp_low = 1.0f;    // lowest thrust value
+    float rp_high = -1.0f;  // highest thrust value
+    for (uint8_t k = 0; k < n; k++) {
+        const float rp = in.roll * _roll_factor[k] + in.pitch * _pitch_factor[k];
+        _rpy_out[k] = rp;
+        rp_low = MIN(rp_low, rp);
+        rp_high = MAX(rp_high, rp);
+    }
+
+    // include the lost motor scaled by thrust_boost_ratio
+    if (lost >= 0) {
+        rp_high = highest_except(lost, -1.0f);
+        if (_rpy_out[lost] > rp_high) {
+            rp_high = in.thrust_boost_ratio*rp_high + (1.0f-in.thrust_boost_ratio)*_rpy_out[lost];
+        }
+    }
+
+    // check for roll and pitch saturation
+    if (rp_high-rp_low > 1.0f || in.throttle_avg_max < -rp_low) {
+        limits.roll_pitch = true;
+    }
+
+    // calculate the maximum yaw control that can be used
+    float throttle_thrust_best_rpy = MIN(0.5f, in.throttle_avg_max);
+    const float yaw_allowed = MAX(MIN(throttle_thrust_best_rpy+rp_low, 1.0f - (throttle_thrust_best_rpy + rp_high)), in.yaw_headroom);
+    float yaw_thrust = in.yaw;
+    if (fabsf(yaw_thrust) > yaw_allowed) {
+        // not all commanded yaw can be used
+        yaw_thrust = constrain_float(yaw_thrust, -yaw_allowed, yaw_allowed);
+        limits.yaw = true;
+    }
+
+    // add yaw control to thrust outputs
+    float rpy_low = 1.0f;   // lowest thrust value
+    float rpy_high = -1.0f; // highest thrust value
+    for (uint8_t k = 0; k < n; k++) {
+        const float rpy = _rpy_out[k] + yaw_thrust * _yaw_factor[k];
+        _rpy_out[k] = rpy;
+        rpy_low = MIN(rpy_low, rpy);
+        rpy_high = MAX(rpy_high, rpy);
+    }
+
+    // include the lost motor scaled by thrust_boost_ratio
+    if (lost >= 0) {
+        rpy_high = highest_except(lost, -1.0f);
+        if (_rpy_out[lost] > rpy_high) {
+            rpy_high = in.thrust_boost_ratio*rpy_high + (1.0f-in.thrust_boost_ratio)*_rpy_out[lost];
+        }
+    }
+
+    // calculate any scaling needed to make the combined thrust outputs fit within the output range
+    float rpy_scale = 1.0f;
+    if (rpy_high-rpy_low > 1.0f) {
+        rpy_scale = 1.0f / (rpy_high-rpy_low);
+    }
+    if (is_negative(rpy_low)) {
+        rpy_scale = MIN(rpy_scale, -in.throttle_avg_max / rpy_low);
+    }
+
+    // calculate how close the motors can come to the desired throttle
+    rpy_high *= rpy_scale;
+    rpy_low *= rpy_scale;
+    throttle_thrust_best_rpy = -rpy_low;
+    float thr_adj = in.throttle - throttle_thrust_best_rpy;
+    if (rpy_scale < 1.0f) {
+        // Full range is being used by roll, pitch, and yaw.
+        limits.roll_pitch = true;
+        limits.yaw = true;
+        if (thr_adj > 0.0f) {
+            limits.throttle_upper = true;
+        }
+        thr_adj = 0.0f;
+    } else {
+        if (thr_adj < 0.0f) {
+            // Throttle can't be reduced to desired value
+            thr_adj = 0.0f;
+        } else if (thr_adj > 1.0f - (throttle_thrust_best_rpy + rpy_high)) {
+            // Throttle can't be increased to desired value
+            thr_adj = 1.0f - (throttle_thrust_best_rpy + rpy_high);
+            limits.throttle_upper = true;
+        }
+    }
+
+    // add scaled roll, pitch, constrained yaw and throttle for each motor
+    const float throttle_out = throttle_thrust_best_rpy + thr_adj;
+    for (uint8_t k = 0; k < n; k++) {
+        thrust_out[_motor_num[k]] = throttle_out + rpy_scale * _rpy_out[k];
+    }
+
+    return throttle_out;
+}
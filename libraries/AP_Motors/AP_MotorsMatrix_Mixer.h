@@ -0,0 +1,88 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  roll, pitch and yaw mixer for AP_MotorsMatrix.
+
+  The factors of the enabled motors are packed into contiguous arrays
+  when the frame is set up, so each step of the mix is a short loop
+  over just the motors the frame has, with no per motor enabled
+  check. The mix follows AP_MotorsMatrix::output_armed_stabilizing():
+  roll and pitch are mixed first to find how much yaw fits, then yaw
+  is added and the result scaled and offset by throttle to fit the
+  0 to 1 output range.
+
+  A lost motor is left out of the highest output, as it is allowed to
+  go above full thrust. As that only happens after a motor failure it
+  is handled by a separate loop rather than a test in every loop.
+ */
+
+#include <AP_Common/AP_Common.h>
+#include "AP_Motors_Class.h"
+
+class AP_MotorsMatrix_Mixer
+{
+public:
+    // inputs to the mix, already compensated for voltage and pressure
+    struct Inputs {
+        float roll;                 // roll thrust, +/- 1.0
+        float pitch;                // pitch thrust, +/- 1.0
+        float yaw;                  // yaw thrust, +/- 1.0
+        float throttle;             // throttle thrust, 0 ~ throttle_avg_max
+        float throttle_avg_max;     // highest average throttle, 0.0 ~ 1.0
+        float yaw_headroom;         // yaw always allowed, 0.0 ~ 1.0
+        float thrust_boost_ratio;   // how far the lost motor is ignored, 0.0 ~ 1.0
+        int8_t lost_motor;          // motor allowed to saturate, or -1
+    };
+
+    // limits reached by the mix. These are only ever set
+    struct Limits {
+        bool roll_pitch;
+        bool yaw;
+        bool throttle_upper;
+    };
+
+    // pack the factors of the enabled motors
+    void setup(const bool enabled[AP_MOTORS_MAX_NUM_MOTORS],
+               const float roll_factor[AP_MOTORS_MAX_NUM_MOTORS],
+               const float pitch_factor[AP_MOTORS_MAX_NUM_MOTORS],
+               const float yaw_factor[AP_MOTORS_MAX_NUM_MOTORS]);
+
+    // number of enabled motors
+    uint8_t num_motors() const { return _num_motors; }
+
+    // mix the inputs, writing the thrust of each enabled motor to
+    // thrust_out, indexed by motor number. Returns the throttle the
+    // outputs are centred on
+    float mix(const Inputs &in, float thrust_out[AP_MOTORS_MAX_NUM_MOTORS], Limits &limits);
+
+private:
+    // highest of the packed outputs other than the one at slot skip
+    float highest_except(uint8_t skip, float high) const;
+
+    uint8_t _num_motors = 0;
+
+    // motor number of each packed slot, and slot of each motor number
+    uint8_t _motor_num[AP_MOTORS_MAX_NUM_MOTORS];
+    int8_t _slot[AP_MOTORS_MAX_NUM_MOTORS];
+
+    float _roll_factor[AP_MOTORS_MAX_NUM_MOTORS];
+    float _pitch_factor[AP_MOTORS_MAX_NUM_MOTORS];
+    float _yaw_factor[AP_MOTORS_MAX_NUM_MOTORS];
+
+    // roll, pitch and yaw output of each slot
+    float _rpy_out[AP_MOTORS_MAX_NUM_MOTORS];
+};
@@ -22,6 +22,7 @@
 #include "AP_MotorsMulticopter.h"
 #include <AP_HAL/AP_HAL.h>
 #include <AP_BattMonitor/AP_BattMonitor.h>
+#include <AP_Scheduler/LatencyInfo.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -207,6 +208,8 @@ AP_MotorsMulticopter::AP_MotorsMulticopter(uint16_t loop_rate, uint16_t speed_hz
 // output - sends commands to the motors
 void AP_MotorsMulticopter::output()
 {
+    WITH_SEMAPHORE(_output_sem);
+
     // update throttle filter
     update_throttle_filter();
 
@@ -219,11 +222,17 @@ void AP_MotorsMulticopter::output()
     // calculate thrust
     output_armed_stabilizing();
 
-    // apply any thrust compensation for the frame
-    thrust_compensation();
-    
-    // convert rpy_thrust values to pwm
-    output_to_motors();
+    // while a rate controller thread owns the motors it mixes and
+    // writes them in output_rate_only()
+    if (!rate_only_output_active()) {
+        // apply any thrust compensation for the frame
+        thrust_compensation();
+
+        AP::latency().record(AP::LatencyInfo::STAGE_MIXER);
+
+        // convert rpy_thrust values to pwm
+        output_to_motors();
+    }
 
     // output any booster throttle
     output_boost_throttle();
@@ -242,6 +251,8 @@ void AP_MotorsMulticopter::output_boost_throttle(void)
 // sends minimum values out to the motors
 void AP_MotorsMulticopter::output_min()
 {
+    WITH_SEMAPHORE(_output_sem);
+
     set_desired_spool_state(DESIRED_SHUT_DOWN);
     _spool_mode = SHUT_DOWN;
     output();
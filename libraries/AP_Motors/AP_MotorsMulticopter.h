@@ -3,6 +3,7 @@
 #pragma once
 
 #include "AP_Motors_Class.h"
+#include <AP_Common/Semaphore.h>
 
 #ifndef AP_MOTORS_DENSITY_COMP
 #define AP_MOTORS_DENSITY_COMP 1
@@ -81,6 +82,27 @@ public:
     // return true if spool up is complete
     bool spool_up_complete() const { return _spool_mode == THROTTLE_UNLIMITED; }
 
+    // true if the frame can re-run its mixer with output_rate_only()
+    virtual bool        has_rate_only_output() const { return false; }
+
+    // let a rate controller in its own thread mix and write the motors
+    // with output_rate_only() while they are fully spooled up. output()
+    // then runs the spool logic and filters but leaves the motors alone
+    void                set_rate_only_output(bool enable) { _rate_only_output = enable; }
+
+    // true while output_rate_only() owns the motor outputs
+    bool                rate_only_output_active() const { return _rate_only_output && armed() && _spool_mode == THROTTLE_UNLIMITED; }
+
+    // re-run the mixer on new roll, pitch and yaw inputs and write the
+    // motors, for a rate controller run between calls to output(). The
+    // spool logic and filters are left to output(). Returns false if
+    // nothing was written, leaving the motors to the next output()
+    virtual bool        output_rate_only() { return false; }
+
+    // held over each output() and output_rate_only(). A caller that
+    // writes other channels at once with the motors holds it too
+    HAL_Semaphore_Recursive &get_output_semaphore() { return _output_sem; }
+
     // output a thrust to all motors that match a given motor
     // mask. This is used to control tiltrotor motors in forward
     // flight. Thrust is in the range 0 to 1
@@ -192,4 +214,8 @@ protected:
 
     // vehicle supplied callback for thrust compensation. Used for tiltrotors and tiltwings
     thrust_compensation_fn_t _thrust_compensation_callback;
+
+    // rate controller thread output, see set_rate_only_output()
+    bool                _rate_only_output;
+    HAL_Semaphore_Recursive _output_sem;
 };
@@ -0,0 +1,187 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Motors/AP_MotorsMatrix_Mixer.h>
+
+/*
+  cost of the roll, pitch and yaw mix of AP_MotorsMatrix for each
+  frame size, with the inputs swept so that the mix moves in and out
+  of saturation as it does in flight
+ */
+#define NUM_INPUTS 1024
+
+struct frame_t {
+    uint8_t num_motors;
+    float angle[AP_MOTORS_MAX_NUM_MOTORS];
+    int8_t yaw[AP_MOTORS_MAX_NUM_MOTORS];
+};
+
+// motors are placed as in AP_MotorsMatrix::setup_motors() for the
+// X frame type, leaving the higher outputs disabled
+static const frame_t frames[] = {
+    { 4, { 45, -135, -45, 135 }, { 1, 1, -1, -1 } },
+    { 6, { 90, -90, -30, 150, 30, -150 }, { -1, 1, -1, 1, 1, -1 } },
+    { 8, { 22.5f, -157.5f, 67.5f, 157.5f, -22.5f, -112.5f, -67.5f, 112.5f }, { -1, -1, 1, 1, 1, 1, -1, -1 } },
+    { 12, { 30, 30, 90, 90, 150, 150, -150, -150, -90, -90, -30, -30 }, { 1, -1, -1, 1, 1, -1, -1, 1, 1, -1, -1, 1 } },
+};
+
+struct factors_t {
+    bool enabled[AP_MOTORS_MAX_NUM_MOTORS];
+    float roll[AP_MOTORS_MAX_NUM_MOTORS];
+    float pitch[AP_MOTORS_MAX_NUM_MOTORS];
+    float yaw[AP_MOTORS_MAX_NUM_MOTORS];
+};
+
+static AP_MotorsMatrix_Mixer::Inputs inputs[NUM_INPUTS];
+
+// factors as add_motor() and normalise_rpy_factors() make them
+static void setup_factors(const frame_t &frame, factors_t &f)
+{
+    float roll_max = 0, pitch_max = 0, yaw_max = 0;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        f.enabled[i] = i < frame.num_motors;
+        f.roll[i] = f.pitch[i] = f.yaw[i] = 0;
+        if (f.enabled[i]) {
+            f.roll[i] = cosf(radians(frame.angle[i] + 90));
+            f.pitch[i] = cosf(radians(frame.angle[i]));
+            f.yaw[i] = frame.yaw[i];
+            roll_max = MAX(roll_max, fabsf(f.roll[i]));
+            pitch_max = MAX(pitch_max, fabsf(f.pitch[i]));
+            yaw_max = MAX(yaw_max, fabsf(f.yaw[i]));
+        }
+    }
+    for (uint8_t i = 0; i < frame.num_motors; i++) {
+        f.roll[i] *= 0.5f / roll_max;
+        f.pitch[i] *= 0.5f / pitch_max;
+        f.yaw[i] *= 0.5f / yaw_max;
+    }
+}
+
+static void setup_inputs()
+{
+    static bool done;
+    if (done) {
+        return;
+    }
+    for (uint16_t i = 0; i < NUM_INPUTS; i++) {
+        AP_MotorsMatrix_Mixer::Inputs &in = inputs[i];
+        in.roll = 0.6f * sinf(i * 0.05f);
+        in.pitch = 0.6f * cosf(i * 0.031f);
+        in.yaw = 0.4f * sinf(i * 0.017f);
+        in.throttle = 0.3f + 0.25f * sinf(i * 0.011f);
+        in.throttle_avg_max = MAX(in.throttle, 0.5f);
+        in.yaw_headroom = 0.2f;
+        in.thrust_boost_ratio = 0.0f;
+        in.lost_motor = -1;
+    }
+    done = true;
+}
+
+/*
+  the mix as AP_MotorsMatrix::output_armed_stabilizing() did it before
+  the factors were packed, looping over every output with an enabled
+  check
+ */
+static float legacy_mix(const factors_t &f, const AP_MotorsMatrix_Mixer::Inputs &in, float out[AP_MOTORS_MAX_NUM_MOTORS])
+{
+    const bool thrust_boost = in.lost_motor >= 0;
+    const uint8_t lost = thrust_boost ? in.lost_motor : 0;
+    float rp_low = 1.0f;
+    float rp_high = -1.0f;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (f.enabled[i]) {
+            out[i] = in.roll * f.roll[i] + in.pitch * f.pitch[i];
+            if (out[i] < rp_low) {
+                rp_low = out[i];
+            }
+            if (out[i] > rp_high && (!thrust_boost || i != lost)) {
+                rp_high = out[i];
+            }
+        }
+    }
+    if (thrust_boost && f.enabled[lost] && out[lost] > rp_high) {
+        rp_high = in.thrust_boost_ratio*rp_high + (1.0f-in.thrust_boost_ratio)*out[lost];
+    }
+    float best = MIN(0.5f, in.throttle_avg_max);
+    const float yaw_allowed = MAX(MIN(best+rp_low, 1.0f - (best + rp_high)), in.yaw_headroom);
+    const float yaw = constrain_float(in.yaw, -yaw_allowed, yaw_allowed);
+    float rpy_low = 1.0f;
+    float rpy_high = -1.0f;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (f.enabled[i]) {
+            out[i] = out[i] + yaw * f.yaw[i];
+            if (out[i] < rpy_low) {
+                rpy_low = out[i];
+            }
+            if (out[i] > rpy_high && (!thrust_boost || i != lost)) {
+                rpy_high = out[i];
+            }
+        }
+    }
+    if (thrust_boost && out[lost] > rpy_high && f.enabled[lost]) {
+        rpy_high = in.thrust_boost_ratio*rpy_high + (1.0f-in.thrust_boost_ratio)*out[lost];
+    }
+    float rpy_scale = 1.0f;
+    if (rpy_high-rpy_low > 1.0f) {
+        rpy_scale = 1.0f / (rpy_high-rpy_low);
+    }
+    if (is_negative(rpy_low)) {
+        rpy_scale = MIN(rpy_scale, -in.throttle_avg_max / rpy_low);
+    }
+    rpy_high *= rpy_scale;
+    rpy_low *= rpy_scale;
+    best = -rpy_low;
+    float thr_adj = in.throttle - best;
+    if (rpy_scale < 1.0f) {
+        thr_adj = 0.0f;
+    } else if (thr_adj < 0.0f) {
+        thr_adj = 0.0f;
+    } else if (thr_adj > 1.0f - (best + rpy_high)) {
+        thr_adj = 1.0f - (best + rpy_high);
+    }
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (f.enabled[i]) {
+            out[i] = best + thr_adj + (rpy_scale * out[i]);
+        }
+    }
+    return best + thr_adj;
+}
+
+static void BM_MotorsMixLegacy(benchmark::State& state)
+{
+    setup_inputs();
+    factors_t f;
+    setup_factors(frames[state.range_x()], f);
+    float out[AP_MOTORS_MAX_NUM_MOTORS];
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        float thr = legacy_mix(f, inputs[i], out);
+        gbenchmark_escape(&thr);
+        gbenchmark_escape(out);
+        i = (i + 1) % NUM_INPUTS;
+    }
+}
+
+static void BM_MotorsMixPacked(benchmark::State& state)
+{
+    setup_inputs();
+    factors_t f;
+    setup_factors(frames[state.range_x()], f);
+    AP_MotorsMatrix_Mixer mixer;
+    mixer.setup(f.enabled, f.roll, f.pitch, f.yaw);
+    float out[AP_MOTORS_MAX_NUM_MOTORS];
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        AP_MotorsMatrix_Mixer::Limits limits {};
+        float thr = mixer.mix(inputs[i], out, limits);
+        gbenchmark_escape(&thr);
+        gbenchmark_escape(out);
+        i = (i + 1) % NUM_INPUTS;
+    }
+}
+
+// frames[] index: quad, hexa, octa and dodeca-hexa
+BENCHMARK(BM_MotorsMixLegacy)->DenseRange(0, 3);
+BENCHMARK(BM_MotorsMixPacked)->DenseRange(0, 3);
+
+BENCHMARK_MAIN()
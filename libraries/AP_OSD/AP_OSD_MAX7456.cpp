@@ -119,6 +119,10 @@
 #define VIDEO_SIGNAL_DEBOUNCE_MS 100
 //time to wait nvm flash complete
 #define MAX_NVM_WAIT 10000
+//period of the bus thread callback sending the frame
+#define FRAME_TRANSFER_PERIOD_US 20000
+//time between checks for a stalled or reset MAX7456
+#define REINIT_CHECK_INTERVAL_MS 100
 
 //black and white level
 #ifndef WHITEBRIGHTNESS
@@ -151,7 +155,11 @@ bool AP_OSD_MAX7456::init()
     if (status != 0) {
         return false;
     }
-    return update_font();
+    if (!update_font()) {
+        return false;
+    }
+    _dev->register_periodic_callback(FRAME_TRANSFER_PERIOD_US, FUNCTOR_BIND_MEMBER(&AP_OSD_MAX7456::timer, void));
+    return true;
 }
 
 bool AP_OSD_MAX7456::update_font()
@@ -270,10 +278,10 @@ void AP_OSD_MAX7456::buffer_add_cmd(uint8_t reg, uint8_t arg)
 }
 
 //Thanks to betaflight for the max stall/reboot detection approach and ntsc/pal autodetection
+//called on the bus thread
 void AP_OSD_MAX7456::check_reinit()
 {
     uint8_t check = 0xFF;
-    _dev->get_semaphore()->take_blocking();
 
     _dev->read_registers(MAX7456ADD_VM0|MAX7456ADD_READ, &check, 1);
 
@@ -305,7 +313,6 @@ void AP_OSD_MAX7456::check_reinit()
         }
         last_signal_check = now;
     }
-    _dev->get_semaphore()->give();
 }
 
 void AP_OSD_MAX7456::reinit()
@@ -347,56 +354,111 @@ void AP_OSD_MAX7456::reinit()
 
     // force redrawing all screen
     memset(shadow_frame, 0xFF, sizeof(shadow_frame));
+    {
+        WITH_SEMAPHORE(frame_sem);
+        pending_rows = (1U << video_lines_pal) - 1;
+    }
 
     initialized = true;
 }
 
-void AP_OSD_MAX7456::flush()
+//called on the bus thread
+void AP_OSD_MAX7456::update_offsets()
 {
-    if (last_font != get_font_num()) {
-        update_font();
-    }
-
-    // check for offset changes
     if (last_v_offset != _osd.v_offset) {
         int8_t vos = constrain_int16(_osd.v_offset, 0, 31);
-        _dev->get_semaphore()->take_blocking();
         _dev->write_register(MAX7456ADD_VOS, vos);
-        _dev->get_semaphore()->give();
         last_v_offset = _osd.v_offset;
     }
     if (last_h_offset != _osd.h_offset) {
         int8_t hos = constrain_int16(_osd.h_offset, 0, 63);
-        _dev->get_semaphore()->take_blocking();
         _dev->write_register(MAX7456ADD_HOS, hos);
-        _dev->get_semaphore()->give();
         last_h_offset = _osd.h_offset;
     }
+}
 
-    check_reinit();
+//hand the drawn frame to the bus thread. Only the rows that changed
+//since the last frame are marked for sending
+void AP_OSD_MAX7456::flush()
+{
+    if (last_font != get_font_num()) {
+        //the bus thread runs with the bus semaphore held, so once we
+        //have taken it the bus thread is idle and will see the flag
+        _dev->get_semaphore()->take_blocking();
+        updating_font = true;
+        _dev->get_semaphore()->give();
+        update_font();
+        //the font update disables the osd, so check_reinit will
+        //reinitialise it
+        updating_font = false;
+    }
+
+    WITH_SEMAPHORE(frame_sem);
+    for (uint8_t y=0; y<video_lines_pal; y++) {
+        if (memcmp(frame[y], pending_frame[y], video_columns) != 0) {
+            memcpy(pending_frame[y], frame[y], video_columns);
+            pending_rows |= 1U << y;
+        }
+    }
+}
+
+//called on the bus thread with the bus semaphore held, so the frame
+//is sent between transfers of other devices on the bus rather than
+//the osd thread waiting for the bus
+void AP_OSD_MAX7456::timer()
+{
+    if (updating_font) {
+        return;
+    }
+
+    uint32_t now = AP_HAL::millis();
+    if (now - last_reinit_check >= REINIT_CHECK_INTERVAL_MS) {
+        last_reinit_check = now;
+        update_offsets();
+        check_reinit();
+    }
     transfer_frame();
 }
 
+//send the characters of the pending rows that differ from the screen
+//as one transfer. Rows which don't fit are left pending for the next
+//call. The osd thread may wait for this to hand over its next frame,
+//but never for the bus
 void AP_OSD_MAX7456::transfer_frame()
 {
+    static_assert(video_lines_pal <= 16, "pending_rows must hold all lines");
+
     uint16_t previous_pos = UINT16_MAX - 1;
     bool autoincrement = false;
     if (!initialized) {
         return;
     }
 
+    WITH_SEMAPHORE(frame_sem);
+
+    //rows below the last NTSC line are never shown
+    pending_rows &= (1U << video_lines) - 1;
+    if (pending_rows == 0) {
+        return;
+    }
+
     buffer_offset = 0;
-    for (uint8_t y=0; y<video_lines; y++) {
+    bool full = false;
+    for (uint8_t y=0; y<video_lines && !full; y++) {
+        if (!(pending_rows & (1U << y))) {
+            continue;
+        }
         for (uint8_t x=0; x<video_columns; x++) {
             if (!is_dirty(x, y)) {
                 continue;
             }
             //ensure space for 1 char and escape sequence
             if (buffer_offset >= spi_buffer_size - 32) {
+                full = true;
                 break;
             }
-            shadow_frame[y][x] = frame[y][x];
-            uint8_t chr = frame[y][x];
+            shadow_frame[y][x] = pending_frame[y][x];
+            uint8_t chr = pending_frame[y][x];
             uint16_t pos = y * video_columns + x;
             bool position_changed = ((previous_pos + 1) != pos);
 
@@ -422,6 +484,9 @@ void AP_OSD_MAX7456::transfer_frame()
             buffer_add_cmd(MAX7456ADD_DMDI, chr);
             previous_pos = pos;
         }
+        if (!full) {
+            pending_rows &= ~(1U << y);
+        }
     }
     if (autoincrement) {
         buffer_add_cmd(MAX7456ADD_DMDI, 0xFF);
@@ -430,9 +495,7 @@ void AP_OSD_MAX7456::transfer_frame()
     }
 
     if (buffer_offset > 0) {
-        _dev->get_semaphore()->take_blocking();
         _dev->transfer(buffer, buffer_offset, nullptr, 0);
-        _dev->get_semaphore()->give();
     }
 }
 
@@ -441,7 +504,7 @@ bool AP_OSD_MAX7456::is_dirty(uint8_t x, uint8_t y)
     if (y>=video_lines || x>=video_columns) {
         return false;
     }
-    return frame[y][x] != shadow_frame[y][x];
+    return pending_frame[y][x] != shadow_frame[y][x];
 }
 
 void AP_OSD_MAX7456::clear()
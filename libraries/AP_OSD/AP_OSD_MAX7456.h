@@ -53,6 +53,11 @@ private:
 
     void reinit();
 
+    void update_offsets();
+
+    // runs on the bus thread, sending the pending frame
+    void timer();
+
     void transfer_frame();
 
     bool is_dirty(uint8_t x, uint8_t y);
@@ -70,16 +75,28 @@ private:
     static const uint8_t video_columns = 30;
     static const uint16_t spi_buffer_size = 512;
 
+    //frame being drawn by the osd thread
     uint8_t frame[video_lines_pal][video_columns];
 
+    //last complete frame, waiting to be sent by the bus thread
+    uint8_t pending_frame[video_lines_pal][video_columns];
+
+    //rows of pending_frame which may differ from shadow_frame
+    uint16_t pending_rows;
+    HAL_Semaphore frame_sem;
+
     //frame already transfered to max
     //used to optimize number of characters updated
     uint8_t shadow_frame[video_lines_pal][video_columns];
 
+    //set while the font is written, which pauses the bus thread
+    volatile bool updating_font;
+
     uint8_t buffer[spi_buffer_size];
     int buffer_offset;
 
     uint32_t last_signal_check;
+    uint32_t last_reinit_check;
     uint32_t video_detect_time;
 
     uint16_t video_lines;
@@ -29,6 +29,7 @@
 #include <AP_Common/AP_Common.h>
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
 #include <GCS_MAVLink/GCS.h>
 #include <StorageManager/StorageManager.h>
 #include <AP_BoardConfig/AP_BoardConfig.h>
@@ -1364,6 +1365,17 @@ bool AP_Param::load_all()
  */
 void AP_Param::reload_defaults_file(bool last_pass)
 {
+#if HAL_OS_POSIX_IO == 1
+    /*
+      once all pointer parameters are allocated we can list the keys
+      of every parameter for compiling binary defaults
+     */
+    const char *key_map = hal.util->get_param_key_map_file();
+    if (last_pass && key_map != nullptr && !save_key_map(key_map)) {
+        printf("Failed to save key map to %s\n", key_map);
+    }
+#endif
+
     if (param_defaults_data.length != 0) {
         load_embedded_param_defaults(last_pass);
         return;
@@ -1840,12 +1852,247 @@ bool AP_Param::parse_param_line(char *line, char **vname, float &value)
 }
 
 
+/*
+  a binary defaults blob. The embedded region is read in place with
+  volatile reads as apj_tool.py fills it after the firmware is built,
+  and a file is read a record at a time
+ */
+struct AP_Param::defaults_bin_source {
+    const volatile uint8_t *data;   // blob in memory, or nullptr for a file
+#if HAL_OS_POSIX_IO == 1
+    FILE *file;
+#endif
+    uint32_t length;
+};
+
+bool AP_Param::defaults_bin_read(const struct defaults_bin_source &src, uint32_t ofs, void *buf, uint32_t len)
+{
+    if (ofs > src.length || len > src.length - ofs) {
+        return false;
+    }
+    if (src.data != nullptr) {
+        for (uint32_t i=0; i<len; i++) {
+            ((uint8_t *)buf)[i] = src.data[ofs+i];
+        }
+        return true;
+    }
+#if HAL_OS_POSIX_IO == 1
+    return src.file != nullptr &&
+        fseek(src.file, ofs, SEEK_SET) == 0 &&
+        fread(buf, len, 1, src.file) == 1;
+#else
+    return false;
+#endif
+}
+
+/*
+  checksum of the definition of a top level parameter or group: its
+  key, type and name, and the index, type and name of each element of
+  the group and its subgroups. A storage header in binary defaults
+  compiled on another build, such as SITL, is only trusted if this
+  matches for its group, so groups that only exist on one build, or
+  differ between them, don't stop the others using the headers
+ */
+uint32_t AP_Param::defaults_group_crc(const struct Info &info)
+{
+    uint32_t crc = crc_crc32(0, (const uint8_t *)&info.key, sizeof(info.key));
+    crc = crc_crc32(crc, &info.type, sizeof(info.type));
+    crc = crc_crc32(crc, (const uint8_t *)info.name, strlen(info.name));
+    if (info.type == AP_PARAM_GROUP) {
+        crc = defaults_group_info_crc(crc, get_group_info(info));
+    }
+    return crc;
+}
+
+uint32_t AP_Param::defaults_group_info_crc(uint32_t crc, const struct GroupInfo *group_info)
+{
+    if (group_info == nullptr) {
+        return crc;
+    }
+    for (uint8_t i=0; group_info[i].type != AP_PARAM_NONE; i++) {
+        crc = crc_crc32(crc, &group_info[i].type, sizeof(group_info[i].type));
+        crc = crc_crc32(crc, &group_info[i].idx, sizeof(group_info[i].idx));
+        crc = crc_crc32(crc, (const uint8_t *)group_info[i].name, strlen(group_info[i].name));
+        if (group_info[i].type == AP_PARAM_GROUP) {
+            crc = defaults_group_info_crc(crc, get_group_info(group_info[i]));
+        }
+    }
+    return crc;
+}
+
+/*
+  check a binary defaults blob, returning the number of records in it
+ */
+bool AP_Param::defaults_bin_count(const struct defaults_bin_source &src, uint16_t &count)
+{
+    struct defaults_bin_header h;
+    if (!defaults_bin_read(src, 0, &h, sizeof(h)) ||
+        h.magic != defaults_bin_magic ||
+        h.version != defaults_bin_version ||
+        src.length != sizeof(h) + h.count * sizeof(struct defaults_bin_record)) {
+        return false;
+    }
+    uint32_t crc = 0;
+    for (uint16_t i=0; i<h.count; i++) {
+        struct defaults_bin_record rec;
+        if (!defaults_bin_read(src, sizeof(h) + i*sizeof(rec), &rec, sizeof(rec))) {
+            return false;
+        }
+        crc = crc_crc32(crc, (const uint8_t *)&rec, sizeof(rec));
+    }
+    if (crc != h.crc) {
+        return false;
+    }
+    count = h.count;
+    return true;
+}
+
+/*
+  load a binary defaults blob. Records are applied in order, so a
+  later record for a parameter overrides an earlier one. The compiler
+  sorts resolved records by key so each group is checked once
+ */
+bool AP_Param::load_defaults_bin(const struct defaults_bin_source &src, const char *source, bool last_pass)
+{
+    uint16_t count;
+    if (!defaults_bin_count(src, count)) {
+        return false;
+    }
+
+    uint16_t group_key = 0;
+    bool group_match = false;
+    bool group_valid = false;
+
+    for (uint16_t i=0; i<count; i++) {
+        struct defaults_bin_record rec;
+        if (!defaults_bin_read(src, sizeof(struct defaults_bin_header) + i*sizeof(rec), &rec, sizeof(rec))) {
+            return false;
+        }
+        char name[AP_MAX_NAME_SIZE+1];
+        memcpy(name, rec.name, AP_MAX_NAME_SIZE);
+        name[AP_MAX_NAME_SIZE] = 0;
+
+        // check the group the header was resolved in is defined the
+        // same way here
+        bool use_header = false;
+        if (!is_sentinal(rec.phdr)) {
+            const uint16_t key = get_key(rec.phdr);
+            if (!group_valid || key != group_key) {
+                group_key = key;
+                group_valid = true;
+                group_match = false;
+                for (uint16_t v=0; v<_num_vars; v++) {
+                    if (_var_info[v].key == key) {
+                        group_match = (defaults_group_crc(_var_info[v]) == rec.group_crc);
+                        break;
+                    }
+                }
+            }
+            use_header = group_match;
+        }
+
+        enum ap_var_type var_type = AP_PARAM_NONE;
+        AP_Param *vp = nullptr;
+        if (use_header) {
+            // the header is authoritative, so if the object it names
+            // is not allocated yet a name search will not find it either
+            void *ptr;
+            if (find_by_header(rec.phdr, &ptr) != nullptr) {
+                var_type = (enum ap_var_type)rec.phdr.type;
+                if (var_type == AP_PARAM_VECTOR3F) {
+                    ptr = (void *)(rec.idx*sizeof(float) + (ptrdiff_t)ptr);
+                    var_type = AP_PARAM_FLOAT;
+                }
+                vp = (AP_Param *)ptr;
+            }
+        } else {
+            vp = find(name, &var_type);
+        }
+        if (!vp) {
+            if (last_pass) {
+                ::printf("Ignored unknown param %s in defaults %s\n", name, source);
+                hal.console->printf("Ignored unknown param %s in defaults %s\n", name, source);
+            }
+            continue;
+        }
+        add_param_override(vp, rec.value);
+        if (!vp->configured_in_storage()) {
+            vp->set_float(rec.value, var_type);
+        }
+    }
+    return true;
+}
+
+/*
+  add a default to param_overrides, which has room for it. The list
+  is kept sorted so get_default_value() can do a binary search, and a
+  later default for the same object replaces an earlier one
+ */
+void AP_Param::add_param_override(const AP_Param *vp, float value)
+{
+    uint16_t lo = 0;
+    uint16_t hi = num_param_overrides;
+    while (lo < hi) {
+        const uint16_t mid = (lo + hi) / 2;
+        if (param_overrides[mid].object_ptr < vp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < num_param_overrides && param_overrides[lo].object_ptr == vp) {
+        param_overrides[lo].value = value;
+        return;
+    }
+    memmove(&param_overrides[lo+1], &param_overrides[lo],
+            (num_param_overrides - lo) * sizeof(param_overrides[0]));
+    param_overrides[lo].object_ptr = vp;
+    param_overrides[lo].value = value;
+    num_param_overrides++;
+}
+
 #if HAL_OS_POSIX_IO == 1
 #include <stdio.h>
 
-// increments num_defaults for each default found in filename
+/*
+  open a binary defaults file, returning false with no file open if
+  it is not one
+ */
+bool AP_Param::open_defaults_bin_file(const char *filename, struct defaults_bin_source &src)
+{
+    src.data = nullptr;
+    src.file = fopen(filename, "rb");
+    if (src.file == nullptr) {
+        return false;
+    }
+    uint32_t magic;
+    long size;
+    if (fread(&magic, sizeof(magic), 1, src.file) == 1 &&
+        magic == defaults_bin_magic &&
+        fseek(src.file, 0, SEEK_END) == 0 &&
+        (size = ftell(src.file)) > 0) {
+        src.length = size;
+        return true;
+    }
+    fclose(src.file);
+    src.file = nullptr;
+    return false;
+}
+
+// increments num_defaults by at most the number of defaults in filename
 bool AP_Param::count_defaults_in_file(const char *filename, uint16_t &num_defaults)
 {
+    struct defaults_bin_source src;
+    if (open_defaults_bin_file(filename, src)) {
+        uint16_t count;
+        const bool ret = defaults_bin_count(src, count);
+        fclose(src.file);
+        if (ret) {
+            num_defaults += count;
+        }
+        return ret;
+    }
+
     FILE *f = fopen(filename, "r");
     if (f == nullptr) {
         return false;
@@ -1853,7 +2100,9 @@ bool AP_Param::count_defaults_in_file(const char *filename, uint16_t &num_defaul
     char line[100];
 
     /*
-      work out how many parameter default structures to allocate
+      work out how many parameter default structures to allocate. We
+      don't look the names up here as unknown ones just leave spare
+      structures
      */
     while (fgets(line, sizeof(line)-1, f)) {
         char *pname;
@@ -1861,10 +2110,6 @@ bool AP_Param::count_defaults_in_file(const char *filename, uint16_t &num_defaul
         if (!parse_param_line(line, &pname, value)) {
             continue;
         }
-        enum ap_var_type var_type;
-        if (!find(pname, &var_type)) {
-            continue;
-        }
         num_defaults++;
     }
 
@@ -1875,13 +2120,19 @@ bool AP_Param::count_defaults_in_file(const char *filename, uint16_t &num_defaul
 
 bool AP_Param::read_param_defaults_file(const char *filename, bool last_pass)
 {
+    struct defaults_bin_source src;
+    if (open_defaults_bin_file(filename, src)) {
+        const bool ret = load_defaults_bin(src, filename, last_pass);
+        fclose(src.file);
+        return ret;
+    }
+
     FILE *f = fopen(filename, "r");
     if (f == nullptr) {
         AP_HAL::panic("AP_Param: Failed to re-open defaults file");
         return false;
     }
 
-    uint16_t idx = 0;
     char line[100];
     while (fgets(line, sizeof(line)-1, f)) {
         char *pname;
@@ -1901,9 +2152,7 @@ bool AP_Param::read_param_defaults_file(const char *filename, bool last_pass)
             }
             continue;
         }
-        param_overrides[idx].object_ptr = vp;
-        param_overrides[idx].value = value;
-        idx++;
+        add_param_override(vp, value);
         if (!vp->configured_in_storage()) {
             vp->set_float(value, var_type);
         }
@@ -1944,7 +2193,7 @@ bool AP_Param::load_defaults_file(const char *filename, bool last_pass)
     num_param_overrides = 0;
 
     param_overrides = (struct param_override *)malloc(sizeof(struct param_override)*num_defaults);
-    if (param_overrides == nullptr) {
+    if (param_overrides == nullptr && num_defaults != 0) {
         AP_HAL::panic("AP_Param: Failed to allocate overrides");
         return false;
     }
@@ -1964,15 +2213,86 @@ bool AP_Param::load_defaults_file(const char *filename, bool last_pass)
     }
     free(mutable_filename);
 
-    num_param_overrides = num_defaults;
+    return true;
+}
 
+/*
+  write a line for each parameter giving its name, the storage header
+  needed to find it and the defaults_group_crc() of its top level
+  group, in the form read by tools/param_defaults_compile.py.
+  Vector3f elements are listed by the header of the vector and the
+  index of the element
+ */
+bool AP_Param::save_key_map(const char *filename)
+{
+    FILE *f = fopen(filename, "w");
+    if (f == nullptr) {
+        return false;
+    }
+    fprintf(f, "# AP_Param key map\n");
+
+    uint16_t group_index = 0xFFFF;
+    uint32_t group_crc = 0;
+    ParamToken token;
+    enum ap_var_type type;
+    for (AP_Param *ap = first(&token, &type);
+         ap != nullptr;
+         ap = next(&token, &type)) {
+        if (type > AP_PARAM_VECTOR3F || token.idx != 0) {
+            // elements of a vector are written with the vector
+            continue;
+        }
+        char name[AP_MAX_NAME_SIZE+1];
+        ap->copy_name_token(token, name, sizeof(name), false);
+        name[AP_MAX_NAME_SIZE] = 0;
+        const uint16_t key = _var_info[token.key].key;
+        if (token.key != group_index) {
+            group_index = token.key;
+            group_crc = defaults_group_crc(_var_info[token.key]);
+        }
+        if (type == AP_PARAM_VECTOR3F) {
+            for (uint8_t i=0; i<3; i++) {
+                char ename[AP_MAX_NAME_SIZE+1];
+                strncpy(ename, name, sizeof(ename));
+                ap->add_vector3f_suffix(ename, sizeof(ename), i);
+                ename[AP_MAX_NAME_SIZE] = 0;
+                fprintf(f, "%s,%u,%u,%u,%u,0x%08x\n", ename, (unsigned)key,
+                        (unsigned)token.group_element, (unsigned)type, (unsigned)i,
+                        (unsigned)group_crc);
+            }
+        } else {
+            fprintf(f, "%s,%u,%u,%u,0,0x%08x\n", name, (unsigned)key,
+                    (unsigned)token.group_element, (unsigned)type,
+                    (unsigned)group_crc);
+        }
+    }
+    fclose(f);
     return true;
 }
 
 #endif // HAL_OS_POSIX_IO
 
 /*
-  count the number of embedded parameter defaults
+  find binary defaults in the embedded region, returning false if it
+  holds a parameter file. They are read in place from flash
+ */
+bool AP_Param::embedded_defaults_bin(struct defaults_bin_source &src)
+{
+    src.data = (const volatile uint8_t *)param_defaults_data.data;
+#if HAL_OS_POSIX_IO == 1
+    src.file = nullptr;
+#endif
+    src.length = param_defaults_data.length;
+    uint32_t magic;
+    uint16_t count;
+    return defaults_bin_read(src, 0, &magic, sizeof(magic)) &&
+        magic == defaults_bin_magic &&
+        defaults_bin_count(src, count);
+}
+
+/*
+  count the number of embedded parameter defaults. This is an upper
+  bound as names are not looked up
  */
 bool AP_Param::count_embedded_param_defaults(uint16_t &count)
 {
@@ -2010,11 +2330,6 @@ bool AP_Param::count_embedded_param_defaults(uint16_t &count)
             continue;
         }
 
-        enum ap_var_type var_type;
-        if (!find(pname, &var_type)) {
-            continue;
-        }
-
         count++;
     }
     return true;
@@ -2033,20 +2348,30 @@ void AP_Param::load_embedded_param_defaults(bool last_pass)
     }
     
     num_param_overrides = 0;
+
+    // the region holds either a parameter file or binary defaults
     uint16_t num_defaults = 0;
-    if (!count_embedded_param_defaults(num_defaults)) {
+    struct defaults_bin_source bin;
+    const bool is_bin = embedded_defaults_bin(bin);
+    if (is_bin) {
+        defaults_bin_count(bin, num_defaults);
+    } else if (!count_embedded_param_defaults(num_defaults)) {
         return;
     }
 
     param_overrides = (struct param_override *)malloc(sizeof(struct param_override)*num_defaults);
-    if (param_overrides == nullptr) {
+    if (param_overrides == nullptr && num_defaults != 0) {
         AP_HAL::panic("AP_Param: Failed to allocate overrides");
         return;
     }
+
+    if (is_bin) {
+        load_defaults_bin(bin, "embedded region", last_pass);
+        return;
+    }
     
     const volatile char *ptr = param_defaults_data.data;
     uint16_t length = param_defaults_data.length;
-    uint16_t idx = 0;
     
     while (length) {
         char line[100];
@@ -2088,14 +2413,11 @@ void AP_Param::load_embedded_param_defaults(bool last_pass)
             }
             continue;
         }
-        param_overrides[idx].object_ptr = vp;
-        param_overrides[idx].value = value;
-        idx++;
+        add_param_override(vp, value);
         if (!vp->configured_in_storage()) {
             vp->set_float(value, var_type);
         }
     }
-    num_param_overrides = num_defaults;
 }
 
 /* 
@@ -2103,11 +2425,19 @@ void AP_Param::load_embedded_param_defaults(bool last_pass)
  */
 float AP_Param::get_default_value(const AP_Param *vp, const float *def_value_ptr)
 {
-    for (uint16_t i=0; i<num_param_overrides; i++) {
-        if (vp == param_overrides[i].object_ptr) {
-            return param_overrides[i].value;
+    uint16_t lo = 0;
+    uint16_t hi = num_param_overrides;
+    while (lo < hi) {
+        const uint16_t mid = (lo + hi) / 2;
+        if (param_overrides[mid].object_ptr < vp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+    if (lo < num_param_overrides && param_overrides[lo].object_ptr == vp) {
+        return param_overrides[lo].value;
+    }
     return *def_value_ptr;
 }
 
@@ -457,6 +457,8 @@ public:
 #endif // AP_PARAM_KEY_DUMP
 
 private:
+    friend class AP_Param_Test;
+
     /// EEPROM header
     ///
     /// This structure is placed at the head of the EEPROM to indicate
@@ -591,6 +593,53 @@ private:
 
     static bool parse_param_line(char *line, char **vname, float &value);
 
+    /*
+      binary parameter defaults, compiled from parameter files by
+      tools/param_defaults_compile.py. Each record carries the storage
+      header of its parameter so it is found with find_by_header()
+      rather than a name search, and the defaults_group_crc() of the
+      top level parameter or group it was resolved in. The name is
+      used instead for records the compiler could not resolve, or
+      whose group is defined differently in this firmware
+     */
+    static const uint32_t defaults_bin_magic = 0x46445041; // "APDF"
+    static const uint16_t defaults_bin_version = 2;
+
+    struct PACKED defaults_bin_header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t count;
+        uint32_t crc;       // crc32 of the records
+    };
+
+    struct PACKED defaults_bin_record {
+        struct Param_header phdr;   // all ones if not resolved
+        uint8_t idx;                // element of a Vector3f
+        uint32_t group_crc;         // defaults_group_crc() the header was resolved with
+        float value;
+        char name[AP_MAX_NAME_SIZE];
+    };
+
+    // a binary defaults blob, read in place, see defaults_bin_read()
+    struct defaults_bin_source;
+
+    // checksum of the definition of a top level parameter or group,
+    // used to check binary defaults were resolved against the same one
+    static uint32_t defaults_group_crc(const struct Info &info);
+    static uint32_t defaults_group_info_crc(uint32_t crc, const struct GroupInfo *group_info);
+
+    // read part of a binary defaults blob
+    static bool defaults_bin_read(const struct defaults_bin_source &src, uint32_t ofs, void *buf, uint32_t len);
+
+    // check a binary defaults blob, returning its record count
+    static bool defaults_bin_count(const struct defaults_bin_source &src, uint16_t &count);
+
+    // load a binary defaults blob in a single pass
+    static bool load_defaults_bin(const struct defaults_bin_source &src, const char *source, bool last_pass);
+
+    // add a default to param_overrides, keeping it sorted by object
+    static void add_param_override(const AP_Param *vp, float value);
+
 #if HAL_OS_POSIX_IO == 1
     /*
       load a parameter defaults file. This happens as part of load_all()
@@ -598,11 +647,17 @@ private:
     static bool count_defaults_in_file(const char *filename, uint16_t &num_defaults);
     static bool read_param_defaults_file(const char *filename, bool last_pass);
     static bool load_defaults_file(const char *filename, bool last_pass);
+    static bool open_defaults_bin_file(const char *filename, struct defaults_bin_source &src);
+
+    // write the storage header of every parameter to a key map for
+    // tools/param_defaults_compile.py
+    static bool save_key_map(const char *filename);
 #endif
 
     /*
       load defaults from embedded parameters
      */
+    static bool embedded_defaults_bin(struct defaults_bin_source &src);
     static bool count_embedded_param_defaults(uint16_t &count);
     static void load_embedded_param_defaults(bool last_pass);
 
@@ -615,7 +670,8 @@ private:
     static const struct Info *  _var_info;
 
     /*
-      list of overridden values from load_defaults_file()
+      list of overridden values from load_defaults_file(), sorted by
+      object_ptr
     */
     struct param_override {
         const AP_Param *object_ptr;
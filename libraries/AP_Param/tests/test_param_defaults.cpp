@@ -0,0 +1,189 @@
+#include <AP_gtest.h>
+
+#include <AP_Param/AP_Param.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+class AP_Param_TestGroup
+{
+public:
+    AP_Float f;
+    AP_Int16 i;
+    AP_Vector3f v;
+
+    static const struct AP_Param::GroupInfo var_info[];
+};
+
+const AP_Param::GroupInfo AP_Param_TestGroup::var_info[] = {
+    AP_GROUPINFO("F", 1, AP_Param_TestGroup, f, 1.5f),
+    AP_GROUPINFO("I", 2, AP_Param_TestGroup, i, 3),
+    AP_GROUPINFO("V", 3, AP_Param_TestGroup, v, 0),
+    AP_GROUPEND
+};
+
+static AP_Int16 format_version;
+static AP_Float top;
+static AP_Param_TestGroup group;
+
+static const AP_Param::Info var_info[] = {
+    { AP_PARAM_INT16, "FORMAT_VERSION", 0, &format_version, {def_value : 0}, 0 },
+    { AP_PARAM_FLOAT, "TOP", 1, &top, {def_value : 2.0f}, 0 },
+    { AP_PARAM_GROUP, "GRP_", 2, &group, {group_info : AP_Param_TestGroup::var_info}, 0 },
+    AP_VAREND
+};
+
+static AP_Param param_loader(var_info);
+
+/*
+  key map written by AP_Param::save_key_map() for var_info[] above,
+  and the defaults below compiled against it with
+  tools/param_defaults_compile.py --keys:
+
+    GRP_F 4.25
+    GRP_I 7
+    GRP_V_Y -1.5
+    TOP 9.5
+ */
+static const char key_map[] =
+    "# AP_Param key map\n"
+    "FORMAT_VERSION,0,0,2,0,0x8969b61a\n"
+    "TOP,1,0,4,0,0x3301c0a0\n"
+    "GRP_F,2,1,4,0,0x971aacb0\n"
+    "GRP_I,2,2,2,0,0x971aacb0\n"
+    "GRP_V_X,2,3,5,0,0x971aacb0\n"
+    "GRP_V_Y,2,3,5,1,0x971aacb0\n"
+    "GRP_V_Z,2,3,5,2,0x971aacb0\n";
+
+static const uint8_t defaults_bin[] = {
+    0x41, 0x50, 0x44, 0x46, 0x02, 0x00, 0x04, 0x00, 0xb4, 0xbd, 0x75, 0x37,
+    0x01, 0x04, 0x00, 0x00, 0x00, 0xa0, 0xc0, 0x01, 0x33, 0x00, 0x00, 0x18,
+    0x41, 0x54, 0x4f, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x44, 0x00, 0x00, 0x00, 0xb0, 0xac,
+    0x1a, 0x97, 0x00, 0x00, 0x88, 0x40, 0x47, 0x52, 0x50, 0x5f, 0x46, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x82,
+    0x00, 0x00, 0x00, 0xb0, 0xac, 0x1a, 0x97, 0x00, 0x00, 0xe0, 0x40, 0x47,
+    0x52, 0x50, 0x5f, 0x49, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x02, 0xc5, 0x00, 0x00, 0x01, 0xb0, 0xac, 0x1a, 0x97,
+    0x00, 0x00, 0xc0, 0xbf, 0x47, 0x52, 0x50, 0x5f, 0x56, 0x5f, 0x59, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+class AP_Param_Test
+{
+public:
+    static bool save_key_map(const char *filename)
+    {
+        return AP_Param::save_key_map(filename);
+    }
+
+    static bool load_defaults_file(const char *filename)
+    {
+        return AP_Param::load_defaults_file(filename, false);
+    }
+
+    static const uint16_t header_size = sizeof(AP_Param::defaults_bin_header);
+    static const uint16_t record_size = sizeof(AP_Param::defaults_bin_record);
+    static const uint16_t group_crc_offset = offsetof(AP_Param::defaults_bin_record, group_crc);
+    static const uint16_t name_offset = offsetof(AP_Param::defaults_bin_record, name);
+    static const uint16_t crc_offset = offsetof(AP_Param::defaults_bin_header, crc);
+};
+
+static const char *test_file = "test_param_defaults.tmp";
+
+// write a blob to test_file after fixing its crc
+static void write_blob(uint8_t *blob, uint32_t length)
+{
+    const uint32_t crc = crc_crc32(0, &blob[AP_Param_Test::header_size], length - AP_Param_Test::header_size);
+    memcpy(&blob[AP_Param_Test::crc_offset], &crc, sizeof(crc));
+    FILE *f = fopen(test_file, "wb");
+    ASSERT_NE(nullptr, f);
+    ASSERT_EQ(1U, fwrite(blob, length, 1, f));
+    fclose(f);
+}
+
+// load a blob changed by modify, returning true if the defaults in it
+// were set
+static bool load_blob(void (*modify)(uint8_t *record))
+{
+    uint8_t blob[sizeof(defaults_bin)];
+    memcpy(blob, defaults_bin, sizeof(blob));
+    const uint16_t count = (sizeof(blob) - AP_Param_Test::header_size) / AP_Param_Test::record_size;
+    for (uint16_t i=0; i<count; i++) {
+        modify(&blob[AP_Param_Test::header_size + i*AP_Param_Test::record_size]);
+    }
+    write_blob(blob, sizeof(blob));
+
+    top.set(0);
+    group.f.set(0);
+    group.i.set(0);
+    group.v.set(Vector3f());
+    const bool loaded = AP_Param_Test::load_defaults_file(test_file);
+    unlink(test_file);
+    return loaded &&
+        is_equal(top.get(), 9.5f) &&
+        is_equal(group.f.get(), 4.25f) &&
+        group.i.get() == 7 &&
+        is_equal(group.v.get().y, -1.5f);
+}
+
+static void unchanged(uint8_t *)
+{
+}
+
+// stop the records being found by name
+static void rename_record(uint8_t *record)
+{
+    memset(&record[AP_Param_Test::name_offset], 0, AP_MAX_NAME_SIZE);
+    strncpy((char *)&record[AP_Param_Test::name_offset], "NOT_A_PARAM", AP_MAX_NAME_SIZE);
+}
+
+// make the records look as if they were compiled for another group
+static void other_group(uint8_t *record)
+{
+    record[AP_Param_Test::group_crc_offset] ^= 1;
+}
+
+static void rename_other_group(uint8_t *record)
+{
+    rename_record(record);
+    other_group(record);
+}
+
+TEST(AP_Param, DefaultsKeyMap)
+{
+    ASSERT_TRUE(AP_Param::setup());
+    ASSERT_TRUE(AP_Param_Test::save_key_map(test_file));
+
+    char buf[1024];
+    FILE *f = fopen(test_file, "r");
+    ASSERT_NE(nullptr, f);
+    const size_t n = fread(buf, 1, sizeof(buf)-1, f);
+    buf[n] = 0;
+    fclose(f);
+    unlink(test_file);
+
+    // if this fails the fixture above needs compiling again
+    EXPECT_STREQ(key_map, buf);
+}
+
+TEST(AP_Param, DefaultsBin)
+{
+    ASSERT_TRUE(AP_Param::setup());
+
+    // the compiled blob loads
+    EXPECT_TRUE(load_blob(unchanged));
+
+    // by header, as the names are not needed
+    EXPECT_TRUE(load_blob(rename_record));
+
+    // falling back to the name if the group is not the same
+    EXPECT_TRUE(load_blob(other_group));
+    EXPECT_FALSE(load_blob(rename_other_group));
+}
+
+AP_GTEST_MAIN()
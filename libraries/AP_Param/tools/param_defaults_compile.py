@@ -0,0 +1,141 @@
+#!/usr/bin/env python
+'''
+compile parameter defaults files into the binary defaults format
+loaded by AP_Param
+
+Each parameter is resolved to its storage header using a key map
+written by SITL with the --param-keys option, so the firmware can
+find it without a name search. The key map also gives a checksum of
+the definition of each top level group, and the firmware only uses
+the header if its own group matches, so a blob compiled with a SITL
+key map works on boards that lack some of SITL's groups. Parameters
+not in the key map, or in groups that differ, are kept by name and
+looked up at boot as for a text defaults file.
+
+The output can be given to SITL with --defaults, or put in the
+embedded defaults region of a firmware with apj_tool.py --set-file
+'''
+
+import argparse
+import struct
+import sys
+import zlib
+
+# these must match AP_Param.h
+DEFAULTS_BIN_MAGIC = 0x46445041
+DEFAULTS_BIN_VERSION = 2
+AP_MAX_NAME_SIZE = 16
+
+
+def crc_crc32(data):
+    '''crc_crc32() from AP_Math with a zero seed, which is zlib crc32 without the inversions'''
+    return (zlib.crc32(data, 0xFFFFFFFF) ^ 0xFFFFFFFF) & 0xFFFFFFFF
+
+
+def split_line(line):
+    '''split a line as AP_Param::parse_param_line() does'''
+    for sep in ", =\t":
+        line = line.replace(sep, ' ')
+    return line.split()
+
+
+def load_defaults(filenames):
+    '''load parameter files in order, returning (name, value) pairs with later values replacing earlier ones'''
+    values = {}
+    order = []
+    for filename in filenames:
+        f = open(filename, 'r')
+        for line in f:
+            if line.startswith('#'):
+                continue
+            a = split_line(line)
+            if len(a) < 2:
+                continue
+            name = a[0]
+            if len(name) > AP_MAX_NAME_SIZE:
+                print("Ignoring long name %s in %s" % (name, filename))
+                continue
+            try:
+                value = float(a[1])
+            except ValueError:
+                print("Ignoring bad value for %s in %s" % (name, filename))
+                continue
+            if name not in values:
+                order.append(name)
+            values[name] = value
+        f.close()
+    return [(name, values[name]) for name in order]
+
+
+def load_key_map(filename):
+    '''load a key map written by AP_Param::save_key_map()'''
+    keys = {}
+    f = open(filename, 'r')
+    for line in f:
+        line = line.strip()
+        if not line or line.startswith('#'):
+            continue
+        a = line.split(',')
+        if len(a) != 6:
+            continue
+        keys[a[0].upper()] = tuple(int(v, 0) for v in a[1:])
+    f.close()
+    return keys
+
+
+def pack_header(key, group_element, ptype):
+    '''pack an AP_Param::Param_header'''
+    return struct.pack("<I", (key & 0xFF) | (ptype << 8) | ((key >> 8) << 13) | (group_element << 14))
+
+
+def compile_defaults(defaults, keys):
+    '''return the binary defaults blob and the number of resolved records'''
+    resolved = []
+    unresolved = []
+    for (name, value) in defaults:
+        # the firmware ignores case when looking up names
+        if name.upper() in keys:
+            resolved.append((keys[name.upper()], name, value))
+        else:
+            unresolved.append(((0xFFFF, 0, 0, 0, 0), name, value))
+
+    # the firmware checks the group of each run of records with the
+    # same key once, so keep groups together
+    resolved.sort(key=lambda r: r[0][:2] + (r[0][3],))
+
+    records = b''
+    for ((key, group_element, ptype, idx, group_crc), name, value) in resolved + unresolved:
+        if key == 0xFFFF:
+            header = struct.pack("<I", 0xFFFFFFFF)
+        else:
+            header = pack_header(key, group_element, ptype)
+        records += header + struct.pack("<BIf%us" % AP_MAX_NAME_SIZE, idx, group_crc, value, name.encode('ascii'))
+    header = struct.pack("<IHHI", DEFAULTS_BIN_MAGIC, DEFAULTS_BIN_VERSION,
+                         len(defaults), crc_crc32(records))
+    return header + records, len(resolved)
+
+
+parser = argparse.ArgumentParser(description='compile parameter defaults files into binary defaults')
+parser.add_argument('--keys', default=None, help='key map written by SITL with --param-keys')
+parser.add_argument('-o', '--output', required=True, help='binary defaults file to write')
+parser.add_argument('files', nargs='+', help='parameter defaults files, later files override earlier ones')
+args = parser.parse_args()
+
+defaults = load_defaults(args.files)
+if len(defaults) > 0xFFFF:
+    print("Error: too many parameters")
+    sys.exit(1)
+
+keys = {}
+if args.keys is not None:
+    keys = load_key_map(args.keys)
+
+blob, resolved = compile_defaults(defaults, keys)
+f = open(args.output, 'wb')
+f.write(blob)
+f.close()
+
+print("Wrote %u defaults (%u resolved) in %u bytes to %s" % (len(defaults), resolved, len(blob), args.output))
+for (name, value) in defaults:
+    if name.upper() not in keys and args.keys is not None:
+        print("Not in key map: %s" % name)
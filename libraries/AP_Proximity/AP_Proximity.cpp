@@ -220,6 +220,7 @@ void AP_Proximity::update(void)
                 continue;
             }
             drivers[i]->update();
+            drivers[i]->update_map();
         }
     }
 
@@ -378,6 +379,15 @@ const Vector2f* AP_Proximity::get_boundary_points(uint16_t& num_points) const
     return get_boundary_points(primary_instance, num_points);
 }
 
+// get the 3D obstacle map of the primary sensor, or nullptr if there is none
+const AP_Proximity_Map *AP_Proximity::get_map() const
+{
+    if ((drivers[primary_instance] == nullptr) || (_type[primary_instance] == Proximity_Type_None)) {
+        return nullptr;
+    }
+    return &drivers[primary_instance]->get_map();
+}
+
 // get distance and angle to closest object (used for pre-arm check)
 //   returns true on success, false if no valid readings
 bool AP_Proximity::get_closest_object(float& angle_deg, float &distance) const
@@ -434,8 +444,9 @@ bool AP_Proximity::get_upward_distance(uint8_t instance, float &distance) const
     if ((drivers[instance] == nullptr) || (_type[instance] == Proximity_Type_None)) {
         return false;
     }
-    // get upward distance from backend
-    return drivers[instance]->get_upward_distance(distance);
+    // get upward distance from backend, falling back to the obstacle map
+    return drivers[instance]->get_upward_distance(distance) ||
+           drivers[instance]->get_map().get_upward_distance(distance);
 }
 
 bool AP_Proximity::get_upward_distance(float &distance) const
@@ -28,6 +28,7 @@
 #define PROXIMITY_SENSOR_ID_START 10
 
 class AP_Proximity_Backend;
+class AP_Proximity_Map;
 
 class AP_Proximity
 {
@@ -100,6 +101,9 @@ public:
     const Vector2f* get_boundary_points(uint8_t instance, uint16_t& num_points) const;
     const Vector2f* get_boundary_points(uint16_t& num_points) const;
 
+    // get the 3D obstacle map of the primary sensor, nullptr if not available
+    const AP_Proximity_Map *get_map() const;
+
     // get distance and angle to closest object (used for pre-arm check)
     //   returns true on success, false if no valid readings
     bool get_closest_object(float& angle_deg, float &distance) const;
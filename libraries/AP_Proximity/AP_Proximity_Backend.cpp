@@ -144,6 +144,12 @@ const Vector2f* AP_Proximity_Backend::get_boundary_points(uint16_t& num_points)
         return nullptr;
     }
 
+    // use the higher resolution boundary from the obstacle map if it has data
+    const Vector2f *map_boundary = _map.get_boundary_points(num_points);
+    if (map_boundary != nullptr) {
+        return map_boundary;
+    }
+
     // check at least one sector has valid data, if not, exit
     bool some_valid = false;
     for (uint8_t i=0; i<_num_sectors; i++) {
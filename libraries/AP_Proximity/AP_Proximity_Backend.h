@@ -17,6 +17,7 @@
 #include <AP_Common/AP_Common.h>
 #include <AP_HAL/AP_HAL.h>
 #include "AP_Proximity.h"
+#include "AP_Proximity_Map.h"
 
 #define PROXIMITY_SECTORS_MAX   12  // maximum number of sectors
 #define PROXIMITY_BOUNDARY_DIST_MIN 0.6f    // minimum distance for a boundary point.  This ensures the object avoidance code doesn't think we are outside the boundary.
@@ -64,6 +65,12 @@ public:
     // get distances in 8 directions. used for sending distances to ground station
     bool get_horizontal_distances(AP_Proximity::Proximity_Distance_Array &prx_dist_array) const;
 
+    // 3D obstacle map built from every reading the sensor produces
+    const AP_Proximity_Map &get_map() const { return _map; }
+
+    // expire old readings from the obstacle map
+    void update_map() { _map.update(); }
+
 protected:
 
     // set status and update valid_count
@@ -102,4 +109,8 @@ protected:
     // fence boundary
     Vector2f _sector_edge_vector[PROXIMITY_SECTORS_MAX];    // vector for right-edge of each sector, used to speed up calculation of boundary
     Vector2f _boundary_point[PROXIMITY_SECTORS_MAX];        // bounding polygon around the vehicle calculated conservatively for object avoidance
+
+    // obstacle map, fed with every reading at full rate. When it holds
+    // data it provides the avoidance boundary in place of the sectors
+    AP_Proximity_Map _map;
 };
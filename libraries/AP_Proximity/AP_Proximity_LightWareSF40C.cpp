@@ -417,6 +417,9 @@ bool AP_Proximity_LightWareSF40C::process_reply()
                 _distance_valid[sector] = is_positive(distance_m);
                 _last_distance_received_ms = AP_HAL::millis();
                 success = true;
+                if (_distance_valid[sector]) {
+                    _map.add_sector(_sector_middle_deg[sector], _sector_width_deg[sector], 0.0f, distance_m);
+                }
                 // update boundary used for avoidance
                 update_boundary_for_sector(sector);
             }
@@ -72,6 +72,9 @@ void AP_Proximity_MAV::handle_msg(mavlink_message_t *msg)
             _distance_max = packet.max_distance / 100.0f;
             _distance_valid[sector] = (_distance[sector] >= _distance_min) && (_distance[sector] <= _distance_max);
             _last_update_ms = AP_HAL::millis();
+            if (_distance_valid[sector]) {
+                _map.add_sector(_angle[sector], _sector_width_deg[sector], 0.0f, _distance[sector]);
+            }
             update_boundary_for_sector(sector);
         }
 
@@ -79,6 +82,9 @@ void AP_Proximity_MAV::handle_msg(mavlink_message_t *msg)
         if (packet.orientation == MAV_SENSOR_ROTATION_PITCH_90) {
             _distance_upward = packet.current_distance / 100.0f;
             _last_upward_update_ms = AP_HAL::millis();
+            if (packet.current_distance >= packet.min_distance && packet.current_distance <= packet.max_distance) {
+                _map.add_point(0.0f, 90.0f, _distance_upward);
+            }
         }
         return;
     }
@@ -125,6 +131,11 @@ void AP_Proximity_MAV::handle_msg(mavlink_message_t *msg)
             const float packet_distance_m = packet.distances[j] * 0.01f;
             const float mid_angle = wrap_360(j * increment * dir_correction + yaw_correction);
 
+            // every direction goes into the obstacle map at full resolution
+            if (packet_distance_m >= _distance_min && packet_distance_m <= _distance_max) {
+                _map.add_sector(mid_angle, increment, 0.0f, packet_distance_m);
+            }
+
             // iterate over proximity sectors
             for (uint8_t i = 0; i < _num_sectors; i++) {
                 float angle_diff = fabsf(wrap_180(_sector_middle_deg[i] - mid_angle));
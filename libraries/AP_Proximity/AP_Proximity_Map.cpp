@@ -0,0 +1,313 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <AP_HAL/AP_HAL.h>
+#include "AP_Proximity_Map.h"
+#include "AP_Proximity_Backend.h"
+
+// cell timestamps are stored in 16ms units, so wrap after about 17
+// minutes. update() visits every cell well within that while it is
+// being called, and the whole map is cleared if it stops for longer
+// than the timeout, so a wrapped timestamp is never trusted
+#define PROXIMITY_MAP_TICK_SHIFT 4
+#define PROXIMITY_MAP_TIMEOUT_TICKS (PROXIMITY_MAP_TIMEOUT_MS >> PROXIMITY_MAP_TICK_SHIFT)
+#define PROXIMITY_MAP_MERGE_TICKS (PROXIMITY_MAP_MERGE_MS >> PROXIMITY_MAP_TICK_SHIFT)
+
+AP_Proximity_Map::AP_Proximity_Map()
+{
+    // find the elevation rows that make up the horizontal band
+    _band_min = PROXIMITY_MAP_ELEVATION_BINS;
+    _band_max = 0;
+    for (uint8_t el = 0; el < PROXIMITY_MAP_ELEVATION_BINS; el++) {
+        if (fabsf(elevation_deg(el)) <= PROXIMITY_MAP_HORIZ_BAND_DEG) {
+            _band_min = MIN(_band_min, el);
+            _band_max = MAX(_band_max, el);
+        }
+    }
+
+    // vectors to the edge between each azimuth bin and the next, in cm
+    for (uint8_t az = 0; az < PROXIMITY_MAP_AZIMUTH_BINS; az++) {
+        const float angle_rad = radians((az + 1) * (360.0f / PROXIMITY_MAP_AZIMUTH_BINS));
+        _edge_vector[az].x = cosf(angle_rad) * 100.0f;
+        _edge_vector[az].y = sinf(angle_rad) * 100.0f;
+    }
+    _boundary_dirty = true;
+}
+
+uint16_t AP_Proximity_Map::now_ticks()
+{
+    return (uint16_t)(AP_HAL::millis() >> PROXIMITY_MAP_TICK_SHIFT);
+}
+
+bool AP_Proximity_Map::expired(const cell_t &cell, uint16_t now)
+{
+    return cell.distance_cm == 0 || (uint16_t)(now - cell.time_ticks) > PROXIMITY_MAP_TIMEOUT_TICKS;
+}
+
+// true if update() has not been called within the timeout, in which
+// case every cell has expired but may not have been cleared
+bool AP_Proximity_Map::stale() const
+{
+    return AP_HAL::millis() - _last_update_ms > PROXIMITY_MAP_TIMEOUT_MS;
+}
+
+// empty every cell
+void AP_Proximity_Map::clear()
+{
+    memset(_cells, 0, sizeof(_cells));
+    memset(_column_cm, 0, sizeof(_column_cm));
+    _next_expire_row = 0;
+    _boundary_dirty = true;
+}
+
+// add a reading
+void AP_Proximity_Map::add_point(float yaw_deg, float pitch_deg, float distance_m)
+{
+    if (!is_positive(distance_m) || isinf(distance_m) || isnan(yaw_deg) || isnan(pitch_deg)) {
+        return;
+    }
+    if (stale()) {
+        clear();
+        _last_update_ms = AP_HAL::millis();
+    }
+
+    // find the cell
+    int16_t az = (int16_t)floorf(yaw_deg * (PROXIMITY_MAP_AZIMUTH_BINS / 360.0f));
+    az %= PROXIMITY_MAP_AZIMUTH_BINS;
+    if (az < 0) {
+        az += PROXIMITY_MAP_AZIMUTH_BINS;
+    }
+    const int16_t el = constrain_int16((int16_t)((pitch_deg + 90.0f) * (PROXIMITY_MAP_ELEVATION_BINS / 180.0f)), 0, PROXIMITY_MAP_ELEVATION_BINS-1);
+
+    const uint16_t distance_cm = MIN(distance_m * 100.0f, (float)PROXIMITY_MAP_DIST_MAX_CM);
+    if (distance_cm == 0) {
+        return;
+    }
+
+    // keep the closest of several readings from the same scan, but
+    // let a new scan replace the previous one so objects moving away
+    // are released promptly
+    const uint16_t now = now_ticks();
+    cell_t &cell = _cells[el][az];
+    if (expired(cell, now) ||
+        (uint16_t)(now - cell.time_ticks) > PROXIMITY_MAP_MERGE_TICKS ||
+        distance_cm < cell.distance_cm) {
+        cell.distance_cm = distance_cm;
+        cell.time_ticks = now;
+        if (el >= _band_min && el <= _band_max) {
+            update_column(az);
+        }
+    }
+    _last_point_ms = AP_HAL::millis();
+}
+
+// add a reading covering a range of azimuth. Only the bins whose
+// centres lie within the sector are filled, so a sector never spills
+// into its neighbours, but a sector narrower than a bin still fills
+// the bin it is in
+void AP_Proximity_Map::add_sector(float yaw_deg, float width_deg, float pitch_deg, float distance_m)
+{
+    const float bins_per_deg = PROXIMITY_MAP_AZIMUTH_BINS / 360.0f;
+    const float start_bin = (yaw_deg - width_deg * 0.5f) * bins_per_deg;
+    const float end_bin = (yaw_deg + width_deg * 0.5f) * bins_per_deg;
+    if (isnan(start_bin) || isnan(end_bin)) {
+        return;
+    }
+    // first and last bins with centres in [start, end)
+    const int16_t first = (int16_t)ceilf(start_bin - 0.5f);
+    const int16_t last = MIN((int16_t)ceilf(end_bin - 0.5f) - 1, first + PROXIMITY_MAP_AZIMUTH_BINS - 1);
+    if (last < first) {
+        add_point(yaw_deg, pitch_deg, distance_m);
+        return;
+    }
+    for (int16_t az = first; az <= last; az++) {
+        add_point((az + 0.5f) / bins_per_deg, pitch_deg, distance_m);
+    }
+}
+
+// discard expired cells from one elevation row
+void AP_Proximity_Map::update()
+{
+    if (stale()) {
+        clear();
+    }
+    _last_update_ms = AP_HAL::millis();
+
+    const uint16_t now = now_ticks();
+    const uint8_t el = _next_expire_row;
+    const bool in_band = (el >= _band_min && el <= _band_max);
+    for (uint8_t az = 0; az < PROXIMITY_MAP_AZIMUTH_BINS; az++) {
+        cell_t &cell = _cells[el][az];
+        if (cell.distance_cm != 0 && expired(cell, now)) {
+            cell.distance_cm = 0;
+            if (in_band) {
+                update_column(az);
+            }
+        }
+    }
+    _next_expire_row = (el + 1) % PROXIMITY_MAP_ELEVATION_BINS;
+}
+
+void AP_Proximity_Map::update_column(uint8_t az)
+{
+    const uint16_t now = now_ticks();
+    uint16_t closest_cm = 0;
+    for (uint8_t el = _band_min; el <= _band_max; el++) {
+        const cell_t &cell = _cells[el][az];
+        if (!expired(cell, now) && (closest_cm == 0 || cell.distance_cm < closest_cm)) {
+            closest_cm = cell.distance_cm;
+        }
+    }
+    if (closest_cm != _column_cm[az]) {
+        _column_cm[az] = closest_cm;
+        _boundary_dirty = true;
+    }
+}
+
+bool AP_Proximity_Map::has_data() const
+{
+    return _last_point_ms != 0 && AP_HAL::millis() - _last_point_ms <= PROXIMITY_MAP_TIMEOUT_MS && !stale();
+}
+
+// get the closest object in the map
+bool AP_Proximity_Map::get_closest_object(float &yaw_deg, float &pitch_deg, float &distance_m) const
+{
+    if (stale()) {
+        return false;
+    }
+    const uint16_t now = now_ticks();
+    const cell_t *closest = nullptr;
+    uint8_t closest_el = 0, closest_az = 0;
+    for (uint8_t el = 0; el < PROXIMITY_MAP_ELEVATION_BINS; el++) {
+        for (uint8_t az = 0; az < PROXIMITY_MAP_AZIMUTH_BINS; az++) {
+            const cell_t &cell = _cells[el][az];
+            if (!expired(cell, now) && (closest == nullptr || cell.distance_cm < closest->distance_cm)) {
+                closest = &cell;
+                closest_el = el;
+                closest_az = az;
+            }
+        }
+    }
+    if (closest == nullptr) {
+        return false;
+    }
+    yaw_deg = azimuth_deg(closest_az);
+    pitch_deg = elevation_deg(closest_el);
+    distance_m = closest->distance_cm * 0.01f;
+    return true;
+}
+
+// get the closest object near the horizon in a particular direction
+bool AP_Proximity_Map::get_horizontal_distance(float yaw_deg, float &distance_m) const
+{
+    if (stale()) {
+        return false;
+    }
+    int16_t az = (int16_t)(wrap_360(yaw_deg) * (PROXIMITY_MAP_AZIMUTH_BINS / 360.0f));
+    if (az < 0 || az >= PROXIMITY_MAP_AZIMUTH_BINS) {
+        return false;
+    }
+    const uint16_t now = now_ticks();
+    uint16_t closest_cm = 0;
+    for (uint8_t el = _band_min; el <= _band_max; el++) {
+        const cell_t &cell = _cells[el][az];
+        if (!expired(cell, now) && (closest_cm == 0 || cell.distance_cm < closest_cm)) {
+            closest_cm = cell.distance_cm;
+        }
+    }
+    if (closest_cm == 0) {
+        return false;
+    }
+    distance_m = closest_cm * 0.01f;
+    return true;
+}
+
+// get the closest object in the top elevation row
+bool AP_Proximity_Map::get_upward_distance(float &distance_m) const
+{
+    if (stale()) {
+        return false;
+    }
+    const uint16_t now = now_ticks();
+    uint16_t closest_cm = 0;
+    for (uint8_t az = 0; az < PROXIMITY_MAP_AZIMUTH_BINS; az++) {
+        const cell_t &cell = _cells[PROXIMITY_MAP_ELEVATION_BINS-1][az];
+        if (!expired(cell, now) && (closest_cm == 0 || cell.distance_cm < closest_cm)) {
+            closest_cm = cell.distance_cm;
+        }
+    }
+    if (closest_cm == 0) {
+        return false;
+    }
+    distance_m = closest_cm * 0.01f;
+    return true;
+}
+
+// get body frame vectors to every current cell within max_distance_m
+uint16_t AP_Proximity_Map::get_obstacles(Vector3f *points, uint16_t max_points, float max_distance_m) const
+{
+    if (stale()) {
+        return 0;
+    }
+    const uint16_t now = now_ticks();
+    const float max_distance_cm = max_distance_m * 100.0f;
+    uint16_t count = 0;
+    for (uint8_t el = 0; el < PROXIMITY_MAP_ELEVATION_BINS && count < max_points; el++) {
+        const float pitch_rad = radians(elevation_deg(el));
+        const float cos_pitch = cosf(pitch_rad);
+        const float sin_pitch = sinf(pitch_rad);
+        for (uint8_t az = 0; az < PROXIMITY_MAP_AZIMUTH_BINS && count < max_points; az++) {
+            const cell_t &cell = _cells[el][az];
+            if (expired(cell, now) || cell.distance_cm > max_distance_cm) {
+                continue;
+            }
+            const float yaw_rad = radians(azimuth_deg(az));
+            const float dist_m = cell.distance_cm * 0.01f;
+            points[count++] = Vector3f(cosf(yaw_rad) * cos_pitch * dist_m,
+                                       sinf(yaw_rad) * cos_pitch * dist_m,
+                                       -sin_pitch * dist_m);
+        }
+    }
+    return count;
+}
+
+// get a boundary polygon for avoidance. Each boundary point lies on
+// the edge between two azimuth bins at the closer of their distances
+const Vector2f *AP_Proximity_Map::get_boundary_points(uint16_t &num_points) const
+{
+    if (!has_data()) {
+        num_points = 0;
+        return nullptr;
+    }
+
+    if (_boundary_dirty) {
+        for (uint8_t az = 0; az < PROXIMITY_MAP_AZIMUTH_BINS; az++) {
+            const uint8_t next = (az + 1) % PROXIMITY_MAP_AZIMUTH_BINS;
+            uint16_t closest_cm = _column_cm[az];
+            if (closest_cm == 0 || (_column_cm[next] != 0 && _column_cm[next] < closest_cm)) {
+                closest_cm = _column_cm[next];
+            }
+            float shortest_distance = PROXIMITY_BOUNDARY_DIST_DEFAULT;
+            if (closest_cm != 0) {
+                shortest_distance = MAX(closest_cm * 0.01f, PROXIMITY_BOUNDARY_DIST_MIN);
+            }
+            _boundary_point[az] = _edge_vector[az] * shortest_distance;
+        }
+        _boundary_dirty = false;
+    }
+
+    num_points = PROXIMITY_MAP_AZIMUTH_BINS;
+    return _boundary_point;
+}
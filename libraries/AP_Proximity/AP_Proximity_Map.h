@@ -0,0 +1,124 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  fixed size 3D obstacle map around the vehicle.
+
+  The space around the vehicle is divided into a polar grid of
+  azimuth x elevation cells in the body frame. Each cell holds the
+  closest distance seen in that direction and when it was seen, so
+  every point from a scanning lidar can be inserted at full rate at
+  the cost of a couple of multiplies. Cells expire after
+  PROXIMITY_MAP_TIMEOUT_MS.
+
+  The cells within PROXIMITY_MAP_HORIZ_BAND_DEG of the horizon are
+  also reduced to a per-azimuth closest distance, from which a
+  boundary polygon with one point per azimuth bin is built for
+  AC_Avoid.
+ */
+
+#include <AP_Common/AP_Common.h>
+#include <AP_Math/AP_Math.h>
+
+#ifndef PROXIMITY_MAP_AZIMUTH_BINS
+#define PROXIMITY_MAP_AZIMUTH_BINS      72      // 5 degree azimuth resolution
+#endif
+#ifndef PROXIMITY_MAP_ELEVATION_BINS
+#define PROXIMITY_MAP_ELEVATION_BINS    9       // 20 degree elevation resolution from -90 to +90
+#endif
+#define PROXIMITY_MAP_HORIZ_BAND_DEG    30      // cells within this elevation of the horizon are used for horizontal avoidance
+#define PROXIMITY_MAP_TIMEOUT_MS        1000    // cells not refreshed within this time are discarded
+#define PROXIMITY_MAP_MERGE_MS          50      // readings in the same cell within this time keep the closest, older readings are replaced
+#define PROXIMITY_MAP_DIST_MAX_CM       UINT16_MAX
+
+class AP_Proximity_Map
+{
+public:
+    AP_Proximity_Map();
+
+    // add a reading. yaw_deg is clockwise from the vehicle's nose,
+    // pitch_deg is positive above the horizon
+    void add_point(float yaw_deg, float pitch_deg, float distance_m);
+
+    // add a reading that covers width_deg of azimuth centred on
+    // yaw_deg, such as a single beam sensor or a sector minimum.
+    // yaw_deg must be the centre of the sector, not the angle of the
+    // reading within it
+    void add_sector(float yaw_deg, float width_deg, float pitch_deg, float distance_m);
+
+    // discard expired cells. Called regularly by the frontend, each
+    // call checks one elevation row so the cost is bounded. The map
+    // reads as empty if this is not called within the timeout
+    void update();
+
+    // true if any cell holds a current reading
+    bool has_data() const;
+
+    // get the closest object in the map
+    bool get_closest_object(float &yaw_deg, float &pitch_deg, float &distance_m) const;
+
+    // get the closest object near the horizon in a particular direction
+    bool get_horizontal_distance(float yaw_deg, float &distance_m) const;
+
+    // get the closest object in the top elevation row
+    bool get_upward_distance(float &distance_m) const;
+
+    // fill points with body frame (FRD, meters) vectors to every
+    // current cell closer than max_distance_m. Returns the number of
+    // points filled in
+    uint16_t get_obstacles(Vector3f *points, uint16_t max_points, float max_distance_m) const;
+
+    // get a boundary polygon (body frame, cm) for avoidance. The
+    // boundary is only rebuilt if the map has changed since the last
+    // call.  Returns nullptr if the map is empty
+    const Vector2f *get_boundary_points(uint16_t &num_points) const;
+
+private:
+
+    struct cell_t {
+        uint16_t distance_cm;   // zero when the cell is empty
+        uint16_t time_ticks;    // time of the reading in 16ms units
+    };
+
+    // time in the units stored in each cell
+    static uint16_t now_ticks();
+    static bool expired(const cell_t &cell, uint16_t now);
+    bool stale() const;
+    void clear();
+
+    // direction of the centre of a cell
+    static float azimuth_deg(uint8_t az) { return (az + 0.5f) * (360.0f / PROXIMITY_MAP_AZIMUTH_BINS); }
+    static float elevation_deg(uint8_t el) { return (el + 0.5f) * (180.0f / PROXIMITY_MAP_ELEVATION_BINS) - 90.0f; }
+
+    // recalculate the closest horizontal distance for one azimuth bin
+    void update_column(uint8_t az);
+
+    cell_t _cells[PROXIMITY_MAP_ELEVATION_BINS][PROXIMITY_MAP_AZIMUTH_BINS];
+
+    // closest current distance near the horizon for each azimuth bin
+    uint16_t _column_cm[PROXIMITY_MAP_AZIMUTH_BINS];
+    uint8_t _band_min;  // lowest elevation row in the horizontal band
+    uint8_t _band_max;  // highest elevation row in the horizontal band
+
+    uint8_t _next_expire_row;
+    uint32_t _last_point_ms;
+    uint32_t _last_update_ms;   // last call to update(), used to catch wrapped cell timestamps
+
+    // boundary, rebuilt lazily
+    Vector2f _edge_vector[PROXIMITY_MAP_AZIMUTH_BINS];
+    mutable Vector2f _boundary_point[PROXIMITY_MAP_AZIMUTH_BINS];
+    mutable bool _boundary_dirty;
+};
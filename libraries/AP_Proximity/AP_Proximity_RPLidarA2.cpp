@@ -404,6 +404,7 @@ void AP_Proximity_RPLidarA2::parse_response_data()
                 uint8_t sector;
                 if (convert_angle_to_sector(angle_deg, sector)) {
                     if (distance_m > distance_min()) {
+                        _map.add_point(angle_deg, 0.0f, distance_m);
                         if (_last_sector == sector) {
                             if (_distance_m_last > distance_m) {
                                 _distance_m_last = distance_m;
@@ -57,6 +57,9 @@ void AP_Proximity_RangeFinder::update(void)
                 _distance_max = sensor->max_distance_cm() / 100.0f;
                 _distance_valid[sector] = (_distance[sector] >= _distance_min) && (_distance[sector] <= _distance_max);
                 _last_update_ms = now;
+                if (_distance_valid[sector]) {
+                    _map.add_sector(_angle[sector], _sector_width_deg[sector], 0.0f, _distance[sector]);
+                }
                 update_boundary_for_sector(sector);
             }
             // check upward facing range finder
@@ -66,6 +69,7 @@ void AP_Proximity_RangeFinder::update(void)
                 int16_t up_distance_max = sensor->max_distance_cm();
                 if ((distance_upward >= up_distance_min) && (distance_upward <= up_distance_max)) {
                     _distance_upward = distance_upward * 1e2;
+                    _map.add_point(0.0f, 90.0f, distance_upward * 0.01f);
                 } else {
                     _distance_upward = -1.0; // mark an valid reading
                 }
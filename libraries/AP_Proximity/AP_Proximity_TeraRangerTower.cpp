@@ -137,6 +137,9 @@ void AP_Proximity_TeraRangerTower::update_sector_data(int16_t angle_deg, uint16_
         _distance[sector] = ((float) distance_cm) / 1000;
         _distance_valid[sector] = distance_cm != 0xffff;
         _last_distance_received_ms = AP_HAL::millis();
+        if (_distance_valid[sector]) {
+            _map.add_sector(_sector_middle_deg[sector], _sector_width_deg[sector], 0.0f, _distance[sector]);
+        }
         // update boundary used for avoidance
         update_boundary_for_sector(sector);
     }
@@ -192,6 +192,9 @@ void AP_Proximity_TeraRangerTowerEvo::update_sector_data(int16_t angle_deg, uint
         //check for target too far, target too close and sensor not connected
         _distance_valid[sector] = distance_cm != 0xffff && distance_cm != 0x0000 && distance_cm != 0x0001;
         _last_distance_received_ms = AP_HAL::millis();
+        if (_distance_valid[sector]) {
+            _map.add_sector(_sector_middle_deg[sector], _sector_width_deg[sector], 0.0f, _distance[sector]);
+        }
         // update boundary used for avoidance
         update_boundary_for_sector(sector);
     }
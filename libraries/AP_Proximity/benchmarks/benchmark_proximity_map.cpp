@@ -0,0 +1,90 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Proximity/AP_Proximity_Map.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+// a 360 degree lidar producing 8000 points per second at 10 revolutions
+// per second gives 800 points per scan
+#define SCAN_POINTS 800
+
+static AP_Proximity_Map map;
+
+static void fill_scan(float *angles, float *distances)
+{
+    for (uint16_t i = 0; i < SCAN_POINTS; i++) {
+        angles[i] = i * (360.0f / SCAN_POINTS);
+        distances[i] = 2.0f + 8.0f * fabsf(sinf(radians(angles[i] * 3)));
+    }
+}
+
+static void BM_ProximityMapAddScan(benchmark::State& state)
+{
+    float angles[SCAN_POINTS];
+    float distances[SCAN_POINTS];
+    fill_scan(angles, distances);
+
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < SCAN_POINTS; i++) {
+            map.add_point(angles[i], 0.0f, distances[i]);
+        }
+        gbenchmark_clobber();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * SCAN_POINTS);
+}
+
+static void BM_ProximityMapUpdate(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        map.update();
+        gbenchmark_clobber();
+    }
+}
+
+static void BM_ProximityMapBoundary(benchmark::State& state)
+{
+    float angles[SCAN_POINTS];
+    float distances[SCAN_POINTS];
+    fill_scan(angles, distances);
+
+    // a fresh scan each time, so the boundary is always rebuilt
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        map.add_point(angles[i], 0.0f, distances[i] * 0.5f);
+        i = (i + 1) % SCAN_POINTS;
+        uint16_t num_points;
+        const Vector2f *boundary = map.get_boundary_points(num_points);
+        gbenchmark_escape((void *)boundary);
+    }
+}
+
+static void BM_ProximityMapHorizontalDistance(benchmark::State& state)
+{
+    float angle = 0;
+    while (state.KeepRunning()) {
+        float distance;
+        bool ret = map.get_horizontal_distance(angle, distance);
+        gbenchmark_escape(&ret);
+        gbenchmark_escape(&distance);
+        angle = wrap_360(angle + 7.0f);
+    }
+}
+
+static void BM_ProximityMapObstacles(benchmark::State& state)
+{
+    Vector3f points[PROXIMITY_MAP_AZIMUTH_BINS * PROXIMITY_MAP_ELEVATION_BINS];
+    while (state.KeepRunning()) {
+        uint16_t count = map.get_obstacles(points, ARRAY_SIZE(points), 10.0f);
+        gbenchmark_escape(&count);
+        gbenchmark_escape(points);
+    }
+}
+
+BENCHMARK(BM_ProximityMapAddScan);
+BENCHMARK(BM_ProximityMapUpdate);
+BENCHMARK(BM_ProximityMapBoundary);
+BENCHMARK(BM_ProximityMapHorizontalDistance);
+BENCHMARK(BM_ProximityMapObstacles);
+
+BENCHMARK_MAIN()
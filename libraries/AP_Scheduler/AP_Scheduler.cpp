@@ -21,6 +21,7 @@
 #include "AP_Scheduler.h"
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/Trace.h>
 #include <AP_Param/AP_Param.h>
 #include <AP_Vehicle/AP_Vehicle.h>
 #include <DataFlash/DataFlash.h>
@@ -56,6 +57,13 @@ const AP_Param::GroupInfo AP_Scheduler::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("LOOP_RATE",  1, AP_Scheduler, _loop_rate_hz, SCHEDULER_DEFAULT_LOOP_RATE),
 
+    // @Param: LATENCY
+    // @DisplayName: Sensor to output latency monitoring
+    // @Description: Measure the time from each gyro sample arriving to the INS update, EKF update, rate controller, mixer and output stages acting on it. When logged a LAT message is written for each stage with the mean, maximum and percentiles of the latency. When sent to the GCS the 99th percentile of each stage is sent as a named value in microseconds. Both happen each time the scheduler logs performance
+    // @Bitmask: 0:Log,1:SendToGCS
+    // @User: Advanced
+    AP_GROUPINFO("LATENCY",  2, AP_Scheduler, _latency_options, 0),
+
     AP_GROUPEND
 };
 
@@ -104,6 +112,8 @@ void AP_Scheduler::init(const AP_Scheduler::Task *tasks, uint8_t num_tasks, uint
     perf_info.set_loop_rate(get_loop_rate_hz());
     perf_info.reset();
 
+    AP::latency().set_enabled(_latency_options != 0);
+
     _log_performance_bit = log_performance_bit;
 }
 
@@ -166,7 +176,9 @@ void AP_Scheduler::run(uint32_t time_available)
         if (_debug > 1 && _perf_counters && _perf_counters[i]) {
             hal.util->perf_begin(_perf_counters[i]);
         }
+        AP_HAL::Trace::begin(_tasks[i].name);
         _tasks[i].function();
+        AP_HAL::Trace::end(_tasks[i].name);
         if (_debug > 1 && _perf_counters && _perf_counters[i]) {
             hal.util->perf_end(_perf_counters[i]);
         }
@@ -197,6 +209,7 @@ void AP_Scheduler::run(uint32_t time_available)
 
     // update number of spare microseconds
     _spare_micros += time_available;
+    AP_HAL::Trace::counter("spare_us", time_available);
 
     _spare_ticks++;
     if (_spare_ticks == 32) {
@@ -247,6 +260,7 @@ void AP_Scheduler::loop()
     // Execute the fast loop
     // ---------------------
     if (_fastloop_fn) {
+        TRACE_SPAN("fast_loop");
         _fastloop_fn();
     }
 
@@ -284,6 +298,16 @@ void AP_Scheduler::update_logging()
     }
     perf_info.set_loop_rate(get_loop_rate_hz());
     perf_info.reset();
+
+    AP::LatencyInfo &latency = AP::latency();
+    latency.swap();
+    if (_latency_options & LATENCY_LOG) {
+        latency.Log_Write();
+    }
+    if (_latency_options & LATENCY_SEND_TO_GCS) {
+        latency.send_to_gcs();
+    }
+    latency.set_enabled(_latency_options != 0);
 }
 
 // Write a performance monitoring packet
@@ -24,6 +24,7 @@
 #include <AP_HAL/Util.h>
 #include <AP_Math/AP_Math.h>
 #include "PerfInfo.h"       // loop perf monitoring
+#include "LatencyInfo.h"    // sensor to output latency monitoring
 
 #define AP_SCHEDULER_NAME_INITIALIZER(_name) .name = #_name,
 
@@ -158,6 +159,13 @@ private:
     // overall scheduling rate in Hz
     AP_Int16 _loop_rate_hz;
 
+    // what to do with sensor to output latency measurements
+    enum {
+        LATENCY_LOG         = (1U<<0),
+        LATENCY_SEND_TO_GCS = (1U<<1),
+    };
+    AP_Int8 _latency_options;
+
     // loop rate in Hz as set at startup
     AP_Int16 _active_loop_rate_hz;
     
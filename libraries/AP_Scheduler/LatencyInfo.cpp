@@ -0,0 +1,137 @@
+#include "LatencyInfo.h"
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <DataFlash/DataFlash.h>
+#include <GCS_MAVLink/GCS.h>
+
+extern const AP_HAL::HAL& hal;
+
+//
+//  sensor to actuator latency monitoring
+//
+
+static AP::LatencyInfo _latency;
+
+// record the time since the sample arrived for a stage
+void AP::LatencyInfo::record(Stage stage, uint32_t sample_us)
+{
+    if (!enabled() || sample_us == 0 || stage >= STAGE_COUNT) {
+        return;
+    }
+    const uint32_t latency_us = AP_HAL::micros() - sample_us;
+    WITH_SEMAPHORE(_sem);
+    struct stage_hist &h = _hist[_recording][stage];
+    h.count++;
+    h.sum_us += latency_us;
+    if (latency_us > h.max_us) {
+        h.max_us = latency_us;
+    }
+    h.bins[bin_for(latency_us)]++;
+}
+
+// start recording into empty histograms, keeping the finished ones
+// for reporting
+void AP::LatencyInfo::swap()
+{
+    WITH_SEMAPHORE(_sem);
+    _recording ^= 1;
+    memset(_hist[_recording], 0, sizeof(_hist[_recording]));
+}
+
+// bin for a latency, with four bins per octave
+uint8_t AP::LatencyInfo::bin_for(uint32_t latency_us)
+{
+    if (latency_us < 16) {
+        return 0;
+    }
+    const uint8_t octave = 31 - __builtin_clz(latency_us);
+    if (octave >= 15) {
+        return num_bins - 1;
+    }
+    const uint8_t sub = (latency_us >> (octave - 2)) & 3;
+    return 1 + (octave - 4) * 4 + sub;
+}
+
+// first latency above a bin
+uint32_t AP::LatencyInfo::bin_upper_us(uint8_t bin)
+{
+    if (bin == 0) {
+        return 16;
+    }
+    if (bin >= num_bins - 1) {
+        return UINT32_MAX;
+    }
+    const uint8_t octave = 4 + (bin - 1) / 4;
+    const uint8_t sub = (bin - 1) % 4;
+    return (uint32_t)(5 + sub) << (octave - 2);
+}
+
+// latency below which a fraction of the samples for a stage in the
+// finished histograms fall, to the resolution of the histogram
+uint32_t AP::LatencyInfo::percentile(Stage stage, float fraction) const
+{
+    const struct stage_hist &h = finished(stage);
+    if (h.count == 0) {
+        return 0;
+    }
+    const uint32_t target = MAX(1U, (uint32_t)ceilf(h.count * fraction));
+    uint32_t total = 0;
+    for (uint8_t i=0; i<num_bins; i++) {
+        total += h.bins[i];
+        if (total >= target) {
+            return MIN(bin_upper_us(i), h.max_us);
+        }
+    }
+    return h.max_us;
+}
+
+// write a LAT message for each stage that has samples
+void AP::LatencyInfo::Log_Write() const
+{
+    DataFlash_Class *dataflash = DataFlash_Class::instance();
+    if (dataflash == nullptr) {
+        return;
+    }
+    const uint64_t now = AP_HAL::micros64();
+    for (uint8_t i=0; i<STAGE_COUNT; i++) {
+        const struct stage_hist &h = finished(i);
+        if (h.count == 0) {
+            continue;
+        }
+        struct log_Latency pkt = {
+            LOG_PACKET_HEADER_INIT(LOG_LATENCY_MSG),
+            time_us : now,
+            stage   : i,
+            count   : h.count,
+            mean    : (float)h.sum_us / h.count,
+            max     : h.max_us,
+            p50     : percentile((Stage)i, 0.5f),
+            p90     : percentile((Stage)i, 0.9f),
+            p99     : percentile((Stage)i, 0.99f)
+        };
+        dataflash->WriteBlock(&pkt, sizeof(pkt));
+    }
+}
+
+// send the 99th percentile of each stage to the GCS in microseconds
+void AP::LatencyInfo::send_to_gcs() const
+{
+    static const char *names[STAGE_COUNT] = {
+        "LAT_INS", "LAT_EKF", "LAT_RATE", "LAT_MIX", "LAT_OUT"
+    };
+    for (uint8_t i=0; i<STAGE_COUNT; i++) {
+        if (finished(i).count != 0) {
+            gcs().send_named_float(names[i], percentile((Stage)i, 0.99f));
+        }
+    }
+}
+
+namespace AP {
+
+LatencyInfo &latency()
+{
+    return _latency;
+}
+
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include <AP_HAL/AP_HAL.h>
+
+namespace AP {
+
+/*
+  measure the latency from a gyro sample arriving in an
+  AP_InertialSensor backend to each stage of the control path acting
+  on it, up to the outputs being pushed to the HAL.
+
+  Each stage keeps a histogram of latencies in a fixed buffer, with
+  four bins per octave from 16us to 32ms. Stages may be recorded from
+  the main thread and a rate thread, so recording is under a
+  semaphore. The scheduler swaps in empty histograms and then logs and
+  sends the finished ones, which nothing else writes to.
+ */
+class LatencyInfo {
+public:
+    LatencyInfo() {}
+
+    /* Do not allow copies */
+    LatencyInfo(const LatencyInfo &other) = delete;
+    LatencyInfo &operator=(const LatencyInfo&) = delete;
+
+    enum Stage : uint8_t {
+        STAGE_INS = 0,      // sample published by AP_InertialSensor::update()
+        STAGE_EKF,          // AHRS and EKF updated
+        STAGE_RATE,         // rate controller run
+        STAGE_MIXER,        // motors mixed
+        STAGE_OUTPUT,       // outputs pushed to RCOutput
+        STAGE_COUNT
+    };
+
+    // stamps are ignored unless enabled
+    void set_enabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    // set the arrival time of the gyro sample that the rate
+    // controller, mixer and outputs are working on
+    void set_sample_us(uint32_t sample_us) { _sample_us.store(sample_us, std::memory_order_relaxed); }
+
+    // record the time since the sample arrived for a stage
+    void record(Stage stage) { record(stage, _sample_us.load(std::memory_order_relaxed)); }
+    void record(Stage stage, uint32_t sample_us);
+
+    // start recording into empty histograms, keeping the ones just
+    // finished for the calls below until the next swap
+    void swap();
+
+    // latency in microseconds below which a fraction of the samples
+    // for a stage in the finished histograms fall
+    uint32_t percentile(Stage stage, float fraction) const;
+
+    // write a LAT message for each stage that has samples
+    void Log_Write() const;
+
+    // send the 99th percentile of each stage to the GCS
+    void send_to_gcs() const;
+
+    // number of histogram bins. Bin 0 is below 16us and the last bin
+    // is at or above 32ms
+    static const uint8_t num_bins = 46;
+
+private:
+    static uint8_t bin_for(uint32_t latency_us);
+    static uint32_t bin_upper_us(uint8_t bin);
+
+    struct stage_hist {
+        uint32_t count;
+        uint32_t max_us;
+        uint64_t sum_us;
+        uint32_t bins[num_bins];
+    };
+
+    // histograms being recorded, and the finished ones. Only the
+    // thread calling swap() changes _recording
+    struct stage_hist _hist[2][STAGE_COUNT];
+    uint8_t _recording;
+    HAL_Semaphore _sem;
+
+    const struct stage_hist &finished(uint8_t stage) const { return _hist[_recording ^ 1][stage]; }
+
+    std::atomic<uint32_t> _sample_us{0};
+    std::atomic<bool> _enabled{false};
+};
+
+// the latency tracker, which exists whether or not there is a scheduler
+LatencyInfo &latency();
+
+};
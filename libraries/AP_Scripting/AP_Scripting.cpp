@@ -35,6 +35,14 @@
 static_assert(SCRIPTING_STACK_SIZE >= SCRIPTING_STACK_MIN_SIZE, "Scripting requires a larger minimum stack size");
 static_assert(SCRIPTING_STACK_SIZE <= SCRIPTING_STACK_MAX_SIZE, "Scripting requires a smaller stack size");
 
+#ifndef SCRIPTING_HEAP_SIZE
+  #if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    #define SCRIPTING_HEAP_SIZE (256 * 1024)
+  #else
+    #define SCRIPTING_HEAP_SIZE (43 * 1024)
+  #endif
+#endif // SCRIPTING_HEAP_SIZE
+
 extern const AP_HAL::HAL& hal;
 
 const AP_Param::GroupInfo AP_Scripting::var_info[] = {
@@ -54,6 +62,32 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("VM_I_COUNT", 2, AP_Scripting, _script_vm_exec_count, 10000),
 
+    // @Param: HEAP_SIZE
+    // @DisplayName: Scripting Heap Size
+    // @Description: Amount of memory available for scripting. Scripts allocate from this fixed size heap rather than the main heap
+    // @Range: 1024 1048576
+    // @Increment: 1024
+    // @Units: B
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("HEAP_SIZE", 3, AP_Scripting, _script_heap_size, SCRIPTING_HEAP_SIZE),
+
+    // @Param: RUN_TIME
+    // @DisplayName: Scripting Run Time Limit
+    // @Description: The longest time each run of a script may take before it is considered to have taken an excessive amount of time and is stopped. This includes time the scripting thread spends waiting on higher priority threads. Zero disables the limit, leaving only the instruction count limit
+    // @Range: 0 1000000
+    // @Increment: 1000
+    // @Units: us
+    // @User: Advanced
+    AP_GROUPINFO("RUN_TIME", 4, AP_Scripting, _script_run_time_us, 0),
+
+    // @Param: DEBUG_OPTS
+    // @DisplayName: Scripting Debug Options
+    // @Description: Debugging options for scripting. Run statistics sends each script's run count, average and longest run time and most instructions in a run every 10 seconds, and the heap use as the named values LUA_MEM and LUA_PEAK. Allow precompiled scripts runs .luac files which have no matching .lua source, such as scripts compiled with luac. Lua does not check bytecode, so only enable this for files from a trusted source
+    // @Bitmask: 0:Run statistics,1:Allow precompiled scripts
+    // @User: Advanced
+    AP_GROUPINFO("DEBUG_OPTS", 5, AP_Scripting, _debug_options, 0),
+
     AP_GROUPEND
 };
 
@@ -83,7 +117,7 @@ bool AP_Scripting::init(void) {
 }
 
 void AP_Scripting::thread(void) {
-    lua_scripts *lua = new lua_scripts(_script_vm_exec_count);
+    lua_scripts *lua = new lua_scripts(_script_vm_exec_count, _script_heap_size, _script_run_time_us, _debug_options);
     if (lua == nullptr) {
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Unable to allocate scripting memory");
         return;
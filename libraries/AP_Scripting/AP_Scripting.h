@@ -41,6 +41,9 @@ private:
 
     AP_Int8 _enable;
     AP_Int32 _script_vm_exec_count;
+    AP_Int32 _script_heap_size;
+    AP_Int32 _script_run_time_us;
+    AP_Int8 _debug_options;
 
     static AP_Scripting *_singleton;
 
@@ -0,0 +1,146 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+#ifdef ENABLE_SCRIPTING
+
+#include <AP_Scripting/lua_bindings.h>
+#include <AP_Scripting/lua_heap.h>
+
+/*
+  the cost of reading vehicle state from a script, one value per call
+  against a snapshot of all of it in one call. The state is a stand in
+  for the AHRS, as the vehicle singletons aren't available here, but
+  the snapshot is built with the same helpers as ahrs.get_state(). Like
+  the AHRS it is read under a semaphore, taken once per call.
+
+  Each run of a script reads the state READS_PER_RUN times and adds up
+  the values, so a script is charged for using the values too
+ */
+#define READS_PER_RUN 100
+#define HEAP_SIZE (256 * 1024)
+
+static const char *fields[] = {
+    "roll", "pitch", "yaw", "gyro_x", "gyro_y", "gyro_z",
+    "lat", "lng", "alt", "vel_n", "vel_e", "vel_d",
+};
+#define NUM_FIELDS (sizeof(fields) / sizeof(fields[0]))
+
+static float values[NUM_FIELDS];
+static HAL_Semaphore sem;
+
+static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+    return ((lua_heap *)ud)->reallocate(ptr, nsize);
+}
+
+// one getter per value, as scripts have without snapshots
+static int get_value(lua_State *L)
+{
+    float value;
+    {
+        WITH_SEMAPHORE(sem);
+        value = values[lua_tointeger(L, lua_upvalueindex(1))];
+    }
+    lua_pushnumber(L, value);
+    return 1;
+}
+
+static int get_state(lua_State *L)
+{
+    float copy[NUM_FIELDS];
+    {
+        WITH_SEMAPHORE(sem);
+        memcpy(copy, values, sizeof(copy));
+    }
+    lua_snapshot_table(L, 1, 0, NUM_FIELDS);
+    for (uint8_t i = 0; i < NUM_FIELDS; i++) {
+        lua_snapshot_number(L, fields[i], copy[i]);
+    }
+    return 1;
+}
+
+static const char *script_per_value =
+    "local sum = 0\n"
+    "for i = 1, 100 do\n"
+    "  sum = sum + get_roll() + get_pitch() + get_yaw()\n"
+    "            + get_gyro_x() + get_gyro_y() + get_gyro_z()\n"
+    "            + get_lat() + get_lng() + get_alt()\n"
+    "            + get_vel_n() + get_vel_e() + get_vel_d()\n"
+    "end\n"
+    "return sum\n";
+
+static const char *script_snapshot =
+    "local sum = 0\n"
+    "for i = 1, 100 do\n"
+    "  local s = get_state()\n"
+    "  sum = sum + s.roll + s.pitch + s.yaw + s.gyro_x + s.gyro_y + s.gyro_z\n"
+    "            + s.lat + s.lng + s.alt + s.vel_n + s.vel_e + s.vel_d\n"
+    "end\n"
+    "return sum\n";
+
+static const char *script_snapshot_reuse =
+    "local s\n"
+    "local sum = 0\n"
+    "for i = 1, 100 do\n"
+    "  s = get_state(s)\n"
+    "  sum = sum + s.roll + s.pitch + s.yaw + s.gyro_x + s.gyro_y + s.gyro_z\n"
+    "            + s.lat + s.lng + s.alt + s.vel_n + s.vel_e + s.vel_d\n"
+    "end\n"
+    "return sum\n";
+
+static void run_script(benchmark::State& state, const char *script)
+{
+    for (uint8_t i = 0; i < NUM_FIELDS; i++) {
+        values[i] = i * 0.1f;
+    }
+
+    lua_heap heap;
+    heap.init(HEAP_SIZE);
+    lua_State *L = lua_newstate(alloc, &heap);
+    for (uint8_t i = 0; i < NUM_FIELDS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "get_%s", fields[i]);
+        lua_pushinteger(L, i);
+        lua_pushcclosure(L, get_value, 1);
+        lua_setglobal(L, name);
+    }
+    lua_register(L, "get_state", get_state);
+    luaL_loadstring(L, script);
+    const int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    while (state.KeepRunning()) {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+        lua_pcall(L, 0, 1, 0);
+        lua_pop(L, 1);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * READS_PER_RUN);
+    state.counters["peak_heap"] = heap.peak();
+
+    lua_close(L);
+}
+
+static void BM_LuaStatePerValue(benchmark::State& state)
+{
+    run_script(state, script_per_value);
+}
+
+static void BM_LuaStateSnapshot(benchmark::State& state)
+{
+    run_script(state, script_snapshot);
+}
+
+static void BM_LuaStateSnapshotReuse(benchmark::State& state)
+{
+    run_script(state, script_snapshot_reuse);
+}
+
+BENCHMARK(BM_LuaStatePerValue);
+BENCHMARK(BM_LuaStateSnapshot);
+BENCHMARK(BM_LuaStateSnapshotReuse);
+
+#endif // ENABLE_SCRIPTING
+
+BENCHMARK_MAIN()
@@ -1,5 +1,9 @@
 #include <AP_Common/AP_Common.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_BattMonitor/AP_BattMonitor.h>
+#include <AP_GPS/AP_GPS.h>
 #include <GCS_MAVLink/GCS.h>
+#include <RC_Channel/RC_Channel.h>
 #include <SRV_Channel/SRV_Channel.h>
 
 #include "lua_bindings.h"
@@ -40,10 +44,185 @@ static const luaL_Reg servo_functions[] =
     {NULL, NULL}
 };
 
+void lua_snapshot_table(lua_State *state, int idx, int narr, int nrec) {
+    if (lua_istable(state, idx)) {
+        lua_pushvalue(state, idx);
+    } else {
+        lua_createtable(state, narr, nrec);
+    }
+}
+
+void lua_snapshot_number(lua_State *state, const char *key, lua_Number value) {
+    lua_pushnumber(state, value);
+    lua_setfield(state, -2, key);
+}
+
+void lua_snapshot_integer(lua_State *state, const char *key, lua_Integer value) {
+    lua_pushinteger(state, value);
+    lua_setfield(state, -2, key);
+}
+
+void lua_snapshot_boolean(lua_State *state, const char *key, bool value) {
+    lua_pushboolean(state, value);
+    lua_setfield(state, -2, key);
+}
+
+// clear a field, so a reused table doesn't keep a stale value
+void lua_snapshot_nil(lua_State *state, const char *key) {
+    lua_pushnil(state);
+    lua_setfield(state, -2, key);
+}
+
+int lua_ahrs_get_state(lua_State *state) {
+    struct {
+        float roll, pitch, yaw;
+        Vector3f gyro;
+        bool healthy;
+        bool have_position;
+        Location loc;
+        bool have_velocity;
+        Vector3f velocity;
+    } s;
+
+    // copy the state under the lock before building the table, as a
+    // lua error while the table is filled in would leave it held
+    AP_AHRS &ahrs = AP::ahrs();
+    {
+        WITH_SEMAPHORE(ahrs.get_semaphore());
+        s.roll = ahrs.roll;
+        s.pitch = ahrs.pitch;
+        s.yaw = ahrs.yaw;
+        s.gyro = ahrs.get_gyro();
+        s.healthy = ahrs.healthy();
+        s.have_position = ahrs.get_position(s.loc);
+        s.have_velocity = ahrs.get_velocity_NED(s.velocity);
+    }
+
+    lua_snapshot_table(state, 1, 0, 13);
+    lua_snapshot_number(state, "roll", s.roll);
+    lua_snapshot_number(state, "pitch", s.pitch);
+    lua_snapshot_number(state, "yaw", s.yaw);
+    lua_snapshot_number(state, "gyro_x", s.gyro.x);
+    lua_snapshot_number(state, "gyro_y", s.gyro.y);
+    lua_snapshot_number(state, "gyro_z", s.gyro.z);
+    lua_snapshot_boolean(state, "healthy", s.healthy);
+    if (s.have_position) {
+        lua_snapshot_integer(state, "lat", s.loc.lat);
+        lua_snapshot_integer(state, "lng", s.loc.lng);
+        lua_snapshot_integer(state, "alt", s.loc.alt);
+    } else {
+        lua_snapshot_nil(state, "lat");
+        lua_snapshot_nil(state, "lng");
+        lua_snapshot_nil(state, "alt");
+    }
+    if (s.have_velocity) {
+        lua_snapshot_number(state, "vel_n", s.velocity.x);
+        lua_snapshot_number(state, "vel_e", s.velocity.y);
+        lua_snapshot_number(state, "vel_d", s.velocity.z);
+    } else {
+        lua_snapshot_nil(state, "vel_n");
+        lua_snapshot_nil(state, "vel_e");
+        lua_snapshot_nil(state, "vel_d");
+    }
+    return 1;
+}
+
+static const luaL_Reg ahrs_functions[] =
+{
+    {"get_state", lua_ahrs_get_state},
+    {NULL, NULL}
+};
+
+int lua_gps_get_state(lua_State *state) {
+    const AP_GPS &gps = AP::gps();
+    const uint8_t instance = gps.primary_sensor();
+    const Location &loc = gps.location(instance);
+    const Vector3f &velocity = gps.velocity(instance);
+
+    lua_snapshot_table(state, 1, 0, 11);
+    lua_snapshot_integer(state, "status", gps.status(instance));
+    lua_snapshot_integer(state, "num_sats", gps.num_sats(instance));
+    lua_snapshot_integer(state, "lat", loc.lat);
+    lua_snapshot_integer(state, "lng", loc.lng);
+    lua_snapshot_integer(state, "alt", loc.alt);
+    lua_snapshot_number(state, "ground_speed", gps.ground_speed(instance));
+    lua_snapshot_number(state, "ground_course", gps.ground_course(instance));
+    lua_snapshot_integer(state, "hdop", gps.get_hdop(instance));
+    lua_snapshot_number(state, "vel_n", velocity.x);
+    lua_snapshot_number(state, "vel_e", velocity.y);
+    lua_snapshot_number(state, "vel_d", velocity.z);
+    return 1;
+}
+
+static const luaL_Reg gps_functions[] =
+{
+    {"get_state", lua_gps_get_state},
+    {NULL, NULL}
+};
+
+int lua_battery_get_state(lua_State *state) {
+    const AP_BattMonitor &battery = AP::battery();
+    const int instance = luaL_optinteger(state, 2, AP_BATT_PRIMARY_INSTANCE);
+    if ((instance < 0) || (instance >= battery.num_instances())) {
+        return luaL_error(state, "Battery instance (%d) is out of range", instance);
+    }
+
+    lua_snapshot_table(state, 1, 0, 5);
+    lua_snapshot_number(state, "voltage", battery.voltage(instance));
+    if (battery.has_current(instance)) {
+        lua_snapshot_number(state, "current", battery.current_amps(instance));
+        lua_snapshot_number(state, "consumed_mah", battery.consumed_mah(instance));
+        lua_snapshot_integer(state, "remaining_pct", battery.capacity_remaining_pct(instance));
+    } else {
+        lua_snapshot_nil(state, "current");
+        lua_snapshot_nil(state, "consumed_mah");
+        lua_snapshot_nil(state, "remaining_pct");
+    }
+    lua_snapshot_boolean(state, "healthy", battery.healthy(instance));
+    return 1;
+}
+
+static const luaL_Reg battery_functions[] =
+{
+    {"get_state", lua_battery_get_state},
+    {NULL, NULL}
+};
+
+// the radio inputs as an array, from channel 1
+int lua_rc_get_channels(lua_State *state) {
+    uint16_t chans[NUM_RC_CHANNELS];
+    const uint8_t count = rc().get_radio_in(chans, NUM_RC_CHANNELS);
+
+    lua_snapshot_table(state, 1, NUM_RC_CHANNELS, 0);
+    for (uint8_t i = 0; i < NUM_RC_CHANNELS; i++) {
+        if (i < count) {
+            lua_pushinteger(state, chans[i]);
+        } else {
+            lua_pushnil(state);
+        }
+        lua_rawseti(state, -2, i + 1);
+    }
+    return 1;
+}
+
+static const luaL_Reg rc_functions[] =
+{
+    {"get_channels", lua_rc_get_channels},
+    {NULL, NULL}
+};
+
 void load_lua_bindings(lua_State *state) {
     luaL_newlib(state, gcs_functions);
     lua_setglobal(state, "gcs");
     luaL_newlib(state, servo_functions);
     lua_setglobal(state, "servo");
+    luaL_newlib(state, ahrs_functions);
+    lua_setglobal(state, "ahrs");
+    luaL_newlib(state, gps_functions);
+    lua_setglobal(state, "gps");
+    luaL_newlib(state, battery_functions);
+    lua_setglobal(state, "battery");
+    luaL_newlib(state, rc_functions);
+    lua_setglobal(state, "rc");
 }
 
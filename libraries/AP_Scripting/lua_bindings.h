@@ -4,3 +4,15 @@
 
 // load all known lua bindings into the state
 void load_lua_bindings(lua_State *state);
+
+// snapshot bindings return many values in one table. The table at idx
+// is filled in if there is one, so a script can pass back the table it
+// got from the last call rather than allocating a new one each time.
+// Pushes the table to fill on the top of the stack
+void lua_snapshot_table(lua_State *state, int idx, int narr, int nrec);
+
+// set a field of the table on the top of the stack
+void lua_snapshot_number(lua_State *state, const char *key, lua_Number value);
+void lua_snapshot_integer(lua_State *state, const char *key, lua_Integer value);
+void lua_snapshot_boolean(lua_State *state, const char *key, bool value);
+void lua_snapshot_nil(lua_State *state, const char *key);
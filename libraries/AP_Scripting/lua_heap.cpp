@@ -0,0 +1,265 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lua_heap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// payloads are aligned to 8 bytes, which covers anything lua stores
+#define HEAP_ALIGN 8U
+#define HEAP_MIN_BLOCK ((sizeof(free_block) + HEAP_ALIGN - 1) & ~(HEAP_ALIGN - 1))
+
+lua_heap::~lua_heap()
+{
+    free(_base);
+}
+
+bool lua_heap::init(uint32_t size)
+{
+    free(_base);
+    _base = nullptr;
+    _end = nullptr;
+    _size = 0;
+    _in_use = 0;
+    _peak = 0;
+    memset(_bins, 0, sizeof(_bins));
+    memset(_bin_map, 0, sizeof(_bin_map));
+
+    size &= ~(HEAP_ALIGN - 1);
+    if (size < HEAP_MIN_BLOCK) {
+        return false;
+    }
+    // malloc aligns to at least 8 on all our boards
+    _base = (uint8_t *)malloc(size);
+    if (_base == nullptr) {
+        return false;
+    }
+    _end = _base + size;
+    _size = size;
+
+    // start with one free block covering the arena
+    block *b = (block *)_base;
+    b->size = size;
+    b->prev_size = 0;
+    insert_free(b);
+    return true;
+}
+
+/*
+  bins 0 to 31 hold sizes below 256 in steps of 8. Above that each
+  power of two is split into four bins
+ */
+uint8_t lua_heap::bin_for(uint32_t size)
+{
+    if (size < 256) {
+        return size / HEAP_ALIGN;
+    }
+    const uint8_t fl = 31 - __builtin_clz(size);
+    const uint8_t sl = (size >> (fl - 2)) & 3;
+    const uint32_t bin = 32U + (fl - 8U) * 4U + sl;
+    return bin < num_bins ? bin : num_bins - 1;
+}
+
+// block size needed for an allocation, or zero if it can't fit
+uint32_t lua_heap::needed(uint32_t size)
+{
+    if (size > UINT32_MAX - sizeof(block) - HEAP_ALIGN) {
+        return 0;
+    }
+    const uint32_t need = (size + sizeof(block) + HEAP_ALIGN - 1) & ~(HEAP_ALIGN - 1);
+    return need < HEAP_MIN_BLOCK ? HEAP_MIN_BLOCK : need;
+}
+
+lua_heap::block *lua_heap::next_block(block *b) const
+{
+    uint8_t *next = (uint8_t *)b + block_size(b);
+    return next < _end ? (block *)next : nullptr;
+}
+
+lua_heap::block *lua_heap::prev_block(block *b) const
+{
+    return b->prev_size != 0 ? (block *)((uint8_t *)b - b->prev_size) : nullptr;
+}
+
+void lua_heap::insert_free(block *b)
+{
+    b->size &= ~used_flag;
+    const uint8_t bin = bin_for(b->size);
+    free_block *f = (free_block *)b;
+    f->prev = nullptr;
+    f->next = _bins[bin];
+    if (f->next != nullptr) {
+        f->next->prev = f;
+    }
+    _bins[bin] = f;
+    _bin_map[bin / 32] |= 1U << (bin % 32);
+}
+
+void lua_heap::remove_free(block *b)
+{
+    free_block *f = (free_block *)b;
+    if (f->next != nullptr) {
+        f->next->prev = f->prev;
+    }
+    if (f->prev != nullptr) {
+        f->prev->next = f->next;
+    } else {
+        const uint8_t bin = bin_for(b->size);
+        _bins[bin] = f->next;
+        if (f->next == nullptr) {
+            _bin_map[bin / 32] &= ~(1U << (bin % 32));
+        }
+    }
+}
+
+/*
+  free a block of the given size, which is not on any list, merging
+  it with free neighbours
+ */
+void lua_heap::release(block *b, uint32_t size)
+{
+    b->size = size;
+    block *next = next_block(b);
+    if (next != nullptr && !block_used(next)) {
+        remove_free(next);
+        b->size += next->size;
+    }
+    block *prev = prev_block(b);
+    if (prev != nullptr && !block_used(prev)) {
+        remove_free(prev);
+        prev->size += b->size;
+        b = prev;
+    }
+    next = next_block(b);
+    if (next != nullptr) {
+        next->prev_size = b->size;
+    }
+    insert_free(b);
+}
+
+// trim a used block to size, freeing the rest if it is big enough
+void lua_heap::split(block *b, uint32_t size)
+{
+    const uint32_t rest = block_size(b) - size;
+    if (rest < HEAP_MIN_BLOCK) {
+        return;
+    }
+    b->size = size | used_flag;
+    block *r = (block *)((uint8_t *)b + size);
+    r->prev_size = size;
+    release(r, rest);
+}
+
+void *lua_heap::allocate(uint32_t size)
+{
+    const uint32_t need = needed(size);
+    if (need == 0 || _base == nullptr) {
+        return nullptr;
+    }
+
+    // first fit within the bin for this size, as its blocks may be
+    // smaller than we need
+    uint8_t bin = bin_for(need);
+    free_block *f = _bins[bin];
+    while (f != nullptr && f->hdr.size < need) {
+        f = f->next;
+    }
+    if (f == nullptr) {
+        // any block in a larger bin is big enough
+        for (bin++; bin < num_bins; bin++) {
+            const uint32_t bits = _bin_map[bin / 32] >> (bin % 32);
+            if (bits == 0) {
+                bin |= 31;
+                continue;
+            }
+            bin += __builtin_ctz(bits);
+            if (bin < num_bins) {
+                f = _bins[bin];
+            }
+            break;
+        }
+        if (f == nullptr) {
+            return nullptr;
+        }
+    }
+
+    block *b = &f->hdr;
+    remove_free(b);
+    b->size |= used_flag;
+    split(b, need);
+
+    _in_use += block_size(b);
+    if (_in_use > _peak) {
+        _peak = _in_use;
+    }
+    return (uint8_t *)b + sizeof(block);
+}
+
+void lua_heap::deallocate(void *ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    block *b = (block *)((uint8_t *)ptr - sizeof(block));
+    const uint32_t size = block_size(b);
+    _in_use -= size;
+    release(b, size);
+}
+
+void *lua_heap::reallocate(void *ptr, uint32_t size)
+{
+    if (size == 0) {
+        // lua frees null pointers for empty arrays
+        deallocate(ptr);
+        return nullptr;
+    }
+    if (ptr == nullptr) {
+        return allocate(size);
+    }
+    const uint32_t need = needed(size);
+    if (need == 0) {
+        return nullptr;
+    }
+    block *b = (block *)((uint8_t *)ptr - sizeof(block));
+    const uint32_t old_size = block_size(b);
+
+    if (need > old_size) {
+        // grow in place into a free block after this one
+        block *next = next_block(b);
+        if (next == nullptr || block_used(next) || old_size + next->size < need) {
+            void *ret = allocate(size);
+            if (ret != nullptr) {
+                memcpy(ret, ptr, old_size - sizeof(block));
+                deallocate(ptr);
+            }
+            return ret;
+        }
+        remove_free(next);
+        b->size = (old_size + next->size) | used_flag;
+        block *after = next_block(b);
+        if (after != nullptr) {
+            after->prev_size = block_size(b);
+        }
+    }
+
+    split(b, need);
+    _in_use += block_size(b);
+    _in_use -= old_size;
+    if (_in_use > _peak) {
+        _peak = _in_use;
+    }
+    return ptr;
+}
@@ -0,0 +1,87 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+  a fixed size heap for the lua state, so that scripts can't fragment
+  or exhaust the main heap.
+
+  Free blocks are kept in lists by size, exact to 8 bytes below 256
+  bytes and in quarter octaves above, and are merged with free
+  neighbours when released.
+ */
+class lua_heap
+{
+public:
+    lua_heap() {}
+    ~lua_heap();
+
+    /* Do not allow copies */
+    lua_heap(const lua_heap &other) = delete;
+    lua_heap &operator=(const lua_heap&) = delete;
+
+    // allocate the arena, releasing any previous one and everything
+    // in it. Returns false if there is not enough memory
+    bool init(uint32_t size);
+
+    void *allocate(uint32_t size);
+    void *reallocate(void *ptr, uint32_t size);
+    void deallocate(void *ptr);
+
+    // bytes in use, including block headers
+    uint32_t in_use(void) const { return _in_use; }
+    uint32_t peak(void) const { return _peak; }
+    uint32_t size(void) const { return _size; }
+    void reset_peak(void) { _peak = _in_use; }
+
+private:
+    // each block starts with a header. The size includes the header
+    // and the low bit of size is set while the block is in use
+    struct block {
+        uint32_t size;
+        uint32_t prev_size;
+    };
+    struct free_block {
+        struct block hdr;
+        free_block *next;
+        free_block *prev;
+    };
+
+    static const uint8_t num_bins = 100;
+    static const uint32_t used_flag = 1;
+
+    static uint8_t bin_for(uint32_t size);
+    static uint32_t block_size(const block *b) { return b->size & ~used_flag; }
+    static bool block_used(const block *b) { return (b->size & used_flag) != 0; }
+    static uint32_t needed(uint32_t size);
+
+    block *next_block(block *b) const;
+    block *prev_block(block *b) const;
+    void insert_free(block *b);
+    void remove_free(block *b);
+    void release(block *b, uint32_t size);
+    void split(block *b, uint32_t size);
+
+    uint8_t *_base = nullptr;
+    uint8_t *_end = nullptr;
+    uint32_t _size;
+    uint32_t _in_use;
+    uint32_t _peak;
+    free_block *_bins[num_bins];
+    uint32_t _bin_map[(num_bins+31)/32];
+};
@@ -15,11 +15,15 @@
 
 #include "lua_scripts.h"
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Math/crc.h>
 #include <GCS_MAVLink/GCS.h>
 #include <AP_ROMFS/AP_ROMFS.h>
 
 #if HAL_OS_POSIX_IO
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #if HAL_OS_FATFS_IO
@@ -34,18 +38,42 @@
   #endif //HAL_OS_FATFS_IO
 #endif // SCRIPTING_DIRECTORY
 
+// first word of a bytecode cache, "APLC"
+#define BYTECODE_MAGIC 0x434C5041
+
+// instructions between checks of a script's budget
+#define SCRIPTING_HOOK_INTERVAL 1000
+
+// time between sending run statistics
+#define SCRIPTING_STATISTICS_MS 10000
+
 extern const AP_HAL::HAL& hal;
 
 bool lua_scripts::overtime;
 jmp_buf lua_scripts::panic_jmp;
-
-lua_scripts::lua_scripts(const AP_Int32 &vm_steps)
-    : _vm_steps(vm_steps) {
+uint32_t lua_scripts::run_start_us;
+uint32_t lua_scripts::run_instructions;
+uint32_t lua_scripts::run_max_instructions;
+uint32_t lua_scripts::run_max_us;
+
+lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int32 &run_time_us, const AP_Int8 &debug_options)
+    : _vm_steps(vm_steps),
+      _heap_size(heap_size),
+      _run_time_us(run_time_us),
+      _debug_options(debug_options) {
       scripts = nullptr;
 }
 
 void lua_scripts::hook(lua_State *L, lua_Debug *ar) {
-    lua_scripts::overtime = true;
+    if (!overtime) {
+        run_instructions += SCRIPTING_HOOK_INTERVAL;
+        if (run_instructions < run_max_instructions &&
+            (run_max_us == 0 || AP_HAL::micros() - run_start_us < run_max_us)) {
+            // still within budget
+            return;
+        }
+        lua_scripts::overtime = true;
+    }
 
     // we need to aggressively bail out as we are over time
     // so we will aggressively trap errors until we clear out
@@ -61,8 +89,199 @@ int lua_scripts::atpanic(lua_State *L) {
     return 0;
 }
 
+void *lua_scripts::alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+    // the heap keeps its own block sizes, so osize isn't needed. A
+    // null return makes lua collect garbage and try again
+    lua_heap *heap = (lua_heap *)ud;
+    if ((uint64_t)nsize > UINT32_MAX) {
+        // would be truncated by the heap on 64 bit hosts
+        return nullptr;
+    }
+    return heap->reallocate(ptr, nsize);
+}
+
+// size and CRC of a script's source, which a bytecode cache must match
+bool lua_scripts::source_signature(const char *filename, uint32_t &size, uint32_t &crc) {
+    const int fd = ::open(filename, O_RDONLY|O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+    uint8_t buf[128];
+    ssize_t n;
+    size = 0;
+    crc = 0;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0) {
+        crc = crc_crc32(crc, buf, n);
+        size += n;
+    }
+    ::close(fd);
+    return n == 0;
+}
+
+// name of the bytecode cache for a script, which the caller must free
+char *lua_scripts::bytecode_filename(const char *filename) {
+    const size_t size = strlen(filename) + 2;
+    char *ret = (char *)malloc(size);
+    if (ret != nullptr) {
+        snprintf(ret, size, "%sc", filename);
+    }
+    return ret;
+}
+
+struct bytecode_reader {
+    int fd;
+    char buf[128];
+};
+
+static const char *read_bytecode(lua_State *L, void *ud, size_t *size) {
+    struct bytecode_reader *reader = (struct bytecode_reader *)ud;
+    const ssize_t n = ::read(reader->fd, reader->buf, sizeof(reader->buf));
+    *size = n > 0 ? n : 0;
+    return reader->buf;
+}
+
+struct bytecode_writer {
+    int fd;
+    uint32_t size;
+    uint32_t crc;
+};
+
+static int write_bytecode(lua_State *L, const void *p, size_t size, void *ud) {
+    struct bytecode_writer *writer = (struct bytecode_writer *)ud;
+    if (::write(writer->fd, p, size) != (ssize_t)size) {
+        return 1;
+    }
+    writer->crc = crc_crc32(writer->crc, (const uint8_t *)p, size);
+    writer->size += size;
+    return 0;
+}
+
+// check the size and CRC of the chunk after a bytecode header,
+// leaving the file positioned at the start of the chunk
+static bool check_chunk(int fd, const uint32_t chunk_size, const uint32_t chunk_crc) {
+    const off_t start = ::lseek(fd, 0, SEEK_CUR);
+    if (start == (off_t)-1) {
+        return false;
+    }
+    uint8_t buf[128];
+    ssize_t n;
+    uint32_t size = 0;
+    uint32_t crc = 0;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0) {
+        crc = crc_crc32(crc, buf, n);
+        size += n;
+    }
+    return n == 0 && size == chunk_size && crc == chunk_crc &&
+           ::lseek(fd, start, SEEK_SET) == start;
+}
+
+/*
+  load a precompiled chunk. A bytecode cache must match the expected
+  source, while files precompiled with luac may have no header at
+  all. Where there is a header the chunk is checked against it before
+  lua sees it, as lua trusts bytecode. On failure an error message is
+  pushed
+ */
+int lua_scripts::load_bytecode(lua_State *L, const char *filename, const struct bytecode_header *expected) {
+    struct bytecode_reader reader;
+    reader.fd = ::open(filename, O_RDONLY|O_CLOEXEC);
+    if (reader.fd == -1) {
+        lua_pushfstring(L, "cannot open %s", filename);
+        return LUA_ERRFILE;
+    }
+
+    struct bytecode_header header;
+    const bool have_header = ::read(reader.fd, &header, sizeof(header)) == sizeof(header) &&
+                             header.magic == BYTECODE_MAGIC;
+    if (expected != nullptr &&
+        (!have_header ||
+         header.source_size != expected->source_size ||
+         header.source_crc != expected->source_crc)) {
+        ::close(reader.fd);
+        lua_pushfstring(L, "stale bytecode in %s", filename);
+        return LUA_ERRFILE;
+    }
+    if (have_header) {
+        if (!check_chunk(reader.fd, header.chunk_size, header.chunk_crc)) {
+            ::close(reader.fd);
+            lua_pushfstring(L, "corrupt bytecode in %s", filename);
+            return LUA_ERRFILE;
+        }
+    } else if (::lseek(reader.fd, 0, SEEK_SET) != 0) {
+        ::close(reader.fd);
+        lua_pushfstring(L, "cannot read %s", filename);
+        return LUA_ERRFILE;
+    }
+
+    const int error = lua_load(L, read_bytecode, &reader, filename, "b");
+    ::close(reader.fd);
+    return error;
+}
+
+/*
+  write the chunk on the top of the stack as a bytecode cache. The
+  header is written again once the chunk's size and CRC are known. If
+  the filesystem is read only scripts are compiled on each boot
+ */
+void lua_scripts::save_bytecode(lua_State *L, const char *filename, struct bytecode_header &header) {
+    struct bytecode_writer writer {};
+#if HAL_OS_POSIX_IO
+    writer.fd = ::open(filename, O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0644);
+#else
+    writer.fd = ::open(filename, O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC);
+#endif
+    if (writer.fd == -1) {
+        return;
+    }
+    header.chunk_size = 0;
+    header.chunk_crc = 0;
+    bool ok = ::write(writer.fd, &header, sizeof(header)) == sizeof(header) &&
+              lua_dump(L, write_bytecode, &writer, 0) == 0;
+    if (ok) {
+        header.chunk_size = writer.size;
+        header.chunk_crc = writer.crc;
+        ok = ::lseek(writer.fd, 0, SEEK_SET) == 0 &&
+             ::write(writer.fd, &header, sizeof(header)) == sizeof(header);
+    }
+    ::close(writer.fd);
+    if (!ok) {
+        // don't leave a partial cache behind
+        unlink(filename);
+    }
+}
+
 lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename) {
-    if (int error = luaL_loadfile(L, filename)) {
+    int error;
+    const size_t length = strlen(filename);
+    if (length > 5 && strcmp(&filename[length-5], ".luac") == 0) {
+        // precompiled on the host, or a cache without its source
+        error = load_bytecode(L, filename, nullptr);
+    } else {
+        // use the bytecode cache if it was compiled from this source,
+        // otherwise compile the source and cache it
+        struct bytecode_header header;
+        header.magic = BYTECODE_MAGIC;
+        char *cache = nullptr;
+        if (source_signature(filename, header.source_size, header.source_crc)) {
+            cache = bytecode_filename(filename);
+        }
+        error = LUA_ERRFILE;
+        if (cache != nullptr) {
+            error = load_bytecode(L, cache, &header);
+            if (error != LUA_OK) {
+                lua_pop(L, 1);
+            }
+        }
+        if (error != LUA_OK) {
+            error = luaL_loadfile(L, filename);
+            if (error == LUA_OK && cache != nullptr) {
+                save_bytecode(L, cache, header);
+            }
+        }
+        free(cache);
+    }
+
+    if (error) {
         switch (error) {
             case LUA_ERRSYNTAX:
                 gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: Syntax error in %s", filename);
@@ -89,6 +308,10 @@ lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename)
     }
 
     new_script->name = filename;
+    new_script->run_count = 0;
+    new_script->run_time_us = 0;
+    new_script->run_time_max_us = 0;
+    new_script->instructions_max = 0;
     new_script->next = nullptr;
 
 
@@ -117,7 +340,7 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
         return;
     }
 
-    // load anything that ends in .lua
+    // load anything that ends in .lua or .luac
     for (struct dirent *de=readdir(d); de; de=readdir(d)) {
         uint8_t length = strlen(de->d_name);
         if (length < 5) {
@@ -125,8 +348,9 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
             continue;
         }
 
-        if (strncmp(&de->d_name[length-4], ".lua", 4)) {
-            // doesn't end in .lua
+        const bool is_bytecode = length > 5 && strncmp(&de->d_name[length-5], ".luac", 5) == 0;
+        if (strncmp(&de->d_name[length-4], ".lua", 4) && !is_bytecode) {
+            // doesn't end in .lua or .luac
             continue;
         }
 
@@ -138,6 +362,25 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
         }
         snprintf(filename, size, "%s/%s", dirname, de->d_name);
 
+        if (is_bytecode) {
+            // skip the bytecode cache of a script with source
+            struct stat st;
+            filename[size-2] = 0;
+            const bool have_source = stat(filename, &st) == 0;
+            filename[size-2] = 'c';
+            if (have_source) {
+                free(filename);
+                continue;
+            }
+            // bytecode without source can't be checked against
+            // anything, so is only run when asked for
+            if (!(_debug_options & uint8_t(DebugOption::ALLOW_PRECOMPILED))) {
+                gcs().send_text(MAV_SEVERITY_WARNING, "Lua: Precompiled %s not allowed", de->d_name);
+                free(filename);
+                continue;
+            }
+        }
+
         // we have something that looks like a lua file, attempt to load it
         script_info * script = load_script(L, filename);
         if (script == nullptr) {
@@ -165,9 +408,12 @@ void lua_scripts::run_next_script(lua_State *L) {
     script_info *script = scripts;
     scripts = script->next;
 
-    // reset the hook to clear the counter
+    // reset the hook to clear the counter, and set this run's budget
     const int32_t vm_steps = MAX(_vm_steps, 1000);
-    lua_sethook(L, hook, LUA_MASKCOUNT, vm_steps);
+    run_instructions = 0;
+    run_max_instructions = vm_steps;
+    run_max_us = MAX(_run_time_us, 0);
+    lua_sethook(L, hook, LUA_MASKCOUNT, SCRIPTING_HOOK_INTERVAL);
 
     // store top of stack so we can calculate the number of return values
     int stack_top = lua_gettop(L);
@@ -175,10 +421,23 @@ void lua_scripts::run_next_script(lua_State *L) {
     // pop the function to the top of the stack
     lua_rawgeti(L, LUA_REGISTRYINDEX, script->lua_ref);
 
-    if(lua_pcall(L, 0, LUA_MULTRET, 0)) {
+    run_start_us = AP_HAL::micros();
+    const int error = lua_pcall(L, 0, LUA_MULTRET, 0);
+    const uint32_t run_time_us = AP_HAL::micros() - run_start_us;
+
+    script->run_count++;
+    script->run_time_us += run_time_us;
+    script->run_time_max_us = MAX(script->run_time_max_us, run_time_us);
+    script->instructions_max = MAX(script->instructions_max, run_instructions);
+
+    if (error) {
         if (overtime) {
             // script has consumed an excessive amount of CPU time
-            gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s exceeded time limit (%d)", script->name,  vm_steps);
+            if (run_instructions >= run_max_instructions) {
+                gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s exceeded time limit (%d)", script->name,  vm_steps);
+            } else {
+                gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s exceeded run time limit (%uus)", script->name, (unsigned)run_max_us);
+            }
             remove_script(L, script);
         } else {
             gcs().send_text(MAV_SEVERITY_INFO, "Lua: %s", lua_tostring(L, -1));
@@ -293,6 +552,26 @@ void lua_scripts::reschedule_script(script_info *script) {
     previous->next = script;
 }
 
+void lua_scripts::send_statistics(void) {
+    for (script_info *script = scripts; script != nullptr; script = script->next) {
+        const char *name = strrchr(script->name, '/');
+        name = name != nullptr ? name + 1 : script->name;
+        gcs().send_text(MAV_SEVERITY_INFO, "Lua: %s runs:%u avg:%uus max:%uus insts:%u",
+                        name,
+                        (unsigned)script->run_count,
+                        (unsigned)(script->run_count != 0 ? script->run_time_us / script->run_count : 0),
+                        (unsigned)script->run_time_max_us,
+                        (unsigned)script->instructions_max);
+        script->run_count = 0;
+        script->run_time_us = 0;
+        script->run_time_max_us = 0;
+        script->instructions_max = 0;
+    }
+    gcs().send_named_float("LUA_MEM", heap.in_use());
+    gcs().send_named_float("LUA_PEAK", heap.peak());
+    heap.reset_peak();
+}
+
 void lua_scripts::run(void) {
     // panic should be hooked first
     if (setjmp(panic_jmp)) {
@@ -307,7 +586,14 @@ void lua_scripts::run(void) {
         overtime = false;
     }
 
-    lua_state = luaL_newstate();
+    // the heap is replaced on a restart, which frees anything the old
+    // state leaked
+    if (!heap.init(MAX(_heap_size, 0))) {
+        gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: Couldn't allocate a %d byte heap", (int)_heap_size);
+        return;
+    }
+
+    lua_state = lua_newstate(alloc, &heap);
     lua_State *L = lua_state;
     if (L == nullptr) {
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: Couldn't allocate a lua state");
@@ -332,7 +618,16 @@ void lua_scripts::run(void) {
     free(sandbox_data);
 
     // Scan the filesystem in an appropriate manner and autostart scripts
+    const uint32_t load_start_us = AP_HAL::micros();
+    const uint32_t load_start_mem = heap.in_use();
+    heap.reset_peak();
     load_all_scripts_in_dir(L, SCRIPTING_DIRECTORY);
+    gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Loaded in %uus Mem: %u Peak: %u",
+                    (unsigned)(AP_HAL::micros() - load_start_us),
+                    (unsigned)(heap.in_use() - load_start_mem),
+                    (unsigned)(heap.peak() - load_start_mem));
+
+    uint32_t last_statistics_ms = AP_HAL::millis();
 
     while (true) {
 #if defined(AP_SCRIPTING_CHECKS) && AP_SCRIPTING_CHECKS >= 1
@@ -359,16 +654,13 @@ void lua_scripts::run(void) {
                 hal.scheduler->delay(scripts->next_run_ms - now_ms);
             }
 
-            gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Running %s", scripts->name);
-
-            const uint32_t startMem = hal.util->available_memory();
-            const uint32_t loadEnd = AP_HAL::micros();
-
             run_next_script(L);
 
-            const uint32_t runEnd = AP_HAL::micros();
-            const uint32_t endMem = hal.util->available_memory();
-            gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Time: %d Mem: %d", runEnd - loadEnd, startMem - endMem);
+            if ((_debug_options & uint8_t(DebugOption::RUN_STATISTICS)) &&
+                AP_HAL::millis() - last_statistics_ms >= SCRIPTING_STATISTICS_MS) {
+                last_statistics_ms = AP_HAL::millis();
+                send_statistics();
+            }
 
         } else {
             gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: No scripts to run");
@@ -19,11 +19,12 @@
 #include <setjmp.h>
 
 #include "lua_bindings.h"
+#include "lua_heap.h"
 
 class lua_scripts
 {
 public:
-    lua_scripts(const AP_Int32 &vm_steps);
+    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int32 &run_time_us, const AP_Int8 &debug_options);
 
     /* Do not allow copies */
     lua_scripts(const lua_scripts &other) = delete;
@@ -33,12 +34,22 @@ public:
     void run(void);
 
     static bool overtime; // script exceeded it's execution slot, and we are bailing out
+
+    enum class DebugOption : uint8_t {
+        RUN_STATISTICS = 1U << 0,
+        ALLOW_PRECOMPILED = 1U << 1,
+    };
+
 private:
 
     typedef struct script_info {
        int lua_ref;          // reference to the loaded script object
        uint64_t next_run_ms; // time (in milliseconds) the script should next be run at
        char *name;           // filename for the script // FIXME: This information should be available from Lua
+       uint32_t run_count;        // runs since the statistics were last sent
+       uint32_t run_time_us;      // total run time since the statistics were last sent
+       uint32_t run_time_max_us;  // longest run since the statistics were last sent
+       uint32_t instructions_max; // most instructions in a run, counted in steps of the hook interval
        script_info *next;
     } script_info;
 
@@ -46,6 +57,21 @@ private:
 
     void load_all_scripts_in_dir(lua_State *L, const char *dirname);
 
+    // bytecode cache, kept next to each script as <name>.luac. It
+    // starts with the size and CRC of the source it was compiled from
+    // and of the chunk that follows
+    struct bytecode_header {
+        uint32_t magic;
+        uint32_t source_size;
+        uint32_t source_crc;
+        uint32_t chunk_size;
+        uint32_t chunk_crc;
+    };
+    static bool source_signature(const char *filename, uint32_t &size, uint32_t &crc);
+    static char *bytecode_filename(const char *filename);
+    int load_bytecode(lua_State *L, const char *filename, const struct bytecode_header *expected);
+    void save_bytecode(lua_State *L, const char *filename, struct bytecode_header &header);
+
     void run_next_script(lua_State *L);
 
     void remove_script(lua_State *L, script_info *script);
@@ -53,18 +79,35 @@ private:
     // reschedule the script for execution. It is assumed the script is not in the list already
     void reschedule_script(script_info *script);
 
+    // send the run statistics of each script and the heap use to the GCS
+    void send_statistics(void);
+
     script_info *scripts; // linked list of scripts to be run, sorted by next run time (soonest first)
 
-    // hook will be run when CPU time for a script is exceeded
+    // hook is run at intervals to check the script against its budget,
+    // and bails out once either limit is exceeded
     // it must be static to be passed to the C API
     static void hook(lua_State *L, lua_Debug *ar);
 
+    // budget of the running script, checked by the hook
+    static uint32_t run_start_us;
+    static uint32_t run_instructions;
+    static uint32_t run_max_instructions;
+    static uint32_t run_max_us;
+
     // lua panic handler, will jump back to the start of run
     static int atpanic(lua_State *L);
     static jmp_buf panic_jmp;
 
+    // allocator for the lua state, from the fixed size heap
+    static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize);
+    lua_heap heap;
+
     lua_State *lua_state;
 
     const AP_Int32 & _vm_steps;
+    const AP_Int32 & _heap_size;
+    const AP_Int32 & _run_time_us;
+    const AP_Int8 & _debug_options;
 
 };
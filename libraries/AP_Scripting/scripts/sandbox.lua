@@ -31,5 +31,9 @@ function get_sandbox_env ()
           -- ArduPilot specific
           gcs = { send_text = gcs.send_text},
           servo = { set_output_pwm = servo.set_output_pwm},
+          ahrs = { get_state = ahrs.get_state},
+          gps = { get_state = gps.get_state},
+          battery = { get_state = battery.get_state},
+          rc = { get_channels = rc.get_channels},
         }
 end
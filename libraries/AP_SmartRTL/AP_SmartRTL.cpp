@@ -26,8 +26,8 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 
     // @Param: POINTS
     // @DisplayName: SmartRTL maximum number of points on path
-    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3k of memory.
-    // @Range: 0 500
+    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 2k of memory.
+    // @Range: 0 2000
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("POINTS", 1, AP_SmartRTL, _points_max, SMARTRTL_POINTS_DEFAULT),
@@ -38,48 +38,39 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 /*
 *    This library is used for the Safe Return-to-Launch feature. The vehicle's
 *    position (aka "bread crumbs") are stored into an array in memory at
-*    regular intervals.  After a certain number of bread crumbs have been
-*    stored and space within the array is low, clean-up algorithms are run to
-*    reduce the total number of points.  When Safe-RTL is initiated by the
-*    vehicle code, a more thorough cleanup runs and the resulting path is fed
-*    into navigation controller to return the vehicle to home.
+*    regular intervals.  The path is simplified and pruned as each point is
+*    added so that it stays short, and when Safe-RTL is initiated by the
+*    vehicle code the path is fed into navigation controller to return the
+*    vehicle to home.
 *
-*    The cleanup consists of two parts, pruning and simplification:
+*    1. Simplification merges new positions into the last segment of the path
+*    for as long as the segment passes within SMARTRTL_SIMPLIFY_EPSILON of all
+*    of the positions it replaces.  Once a position can not be merged, the end
+*    of the path is fixed and a new segment is started.  At most
+*    SMARTRTL_SIMPLIFY_WINDOW positions are merged into one segment, which
+*    bounds the time taken to add a point.
 *
-*    1. Pruning calculates the closest distance between two line segments formed
-*    by two pairs of sequential points, and then cuts out anything between two
-*    points when their line segments get close. This algorithm will never
-*    compare two consecutive line segments. Obviously the segments (p1,p2) and
-*    (p2,p3) will get very close (they touch), but there would be nothing to
-*    trim between them.
+*    2. Pruning cuts out any loop in the path.  When the last segment passes
+*    close to an earlier segment (but not the one just before it) everything
+*    between them is removed and replaced by the point midway between their
+*    closest points.  Earlier segments are found through a spatial index so
+*    the time taken does not grow with the length of the path.
 *
-*    2. Simplification uses the Ramer-Douglas-Peucker algorithm. See Wikipedia
-*    for a more complete description.
-*
-*    The simplification and pruning algorithms run in the background and do not
-*    alter the path in memory.  Two definitions, SMARTRTL_SIMPLIFY_TIME_US and
-*    SMARTRTL_PRUNING_LOOP_TIME_US are used to limit how long each algorithm will
-*    be run before they save their state and return.
-*
-*    Both algorithms are "anytime algorithms" meaning they can be interrupted
-*    before they complete which is helpful when memory is filling up and we just
-*    need to quickly identify a handful of points which can be deleted.
-*
-*    Once the algorithms have completed the simplify.complete and
-*    prune.complete flags are set to true.  The "thorough cleanup" procedure,
-*    which is run as the vehicle initiates the SmartRTL flight mode, waits for
-*    these flags to become true.  This can force the vehicle to pause for a few
-*    seconds before initiating the return journey.
+*    The spatial index is a hash table of grid cells.  There are
+*    SMARTRTL_INDEX_LEVELS grid sizes, each double the last, and each segment
+*    is held in the cell containing its midpoint on the level of the smallest
+*    cells at least as long as the segment.  All of a segment is then within
+*    half a cell of its own cell, so the segments near a point are found by
+*    looking in the few cells around it on each level which holds segments.
 */
 
 AP_SmartRTL::AP_SmartRTL(bool example_mode) :
     _example_mode(example_mode)
 {
     AP_Param::setup_object_defaults(this, var_info);
-    _simplify.bitmask.setall();
 }
 
-// initialise safe rtl including setting up background processes
+// initialise safe rtl
 void AP_SmartRTL::init()
 {
     // protect against repeated call to init
@@ -95,32 +86,33 @@ void AP_SmartRTL::init()
         return;
     }
 
+    // one hash bucket for each point, rounded up to a power of two
+    uint16_t num_buckets = 1;
+    while (num_buckets < _points_max) {
+        num_buckets <<= 1;
+    }
+
     // allocate arrays
     _path = (Vector3f*)calloc(_points_max, sizeof(Vector3f));
-
-    _prune.loops_max = _points_max * SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT;
-    _prune.loops = (prune_loop_t*)calloc(_prune.loops_max, sizeof(prune_loop_t));
-
-    _simplify.stack_max = _points_max * SMARTRTL_SIMPLIFY_STACK_LEN_MULT;
-    _simplify.stack = (simplify_start_finish_t*)calloc(_simplify.stack_max, sizeof(simplify_start_finish_t));
+    _simplify.window = (Vector3f*)calloc(SMARTRTL_SIMPLIFY_WINDOW, sizeof(Vector3f));
+    _prune.buckets = (uint16_t*)calloc(num_buckets, sizeof(uint16_t));
+    _prune.next = (uint16_t*)calloc(_points_max, sizeof(uint16_t));
 
     // check if memory allocation failed
-    if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr) {
+    if (_path == nullptr || _simplify.window == nullptr || _prune.buckets == nullptr || _prune.next == nullptr) {
         log_action(SRTL_DEACTIVATED_INIT_FAILED);
         gcs().send_text(MAV_SEVERITY_WARNING, "SmartRTL deactivated: init failed");
         free(_path);
-        free(_prune.loops);
-        free(_simplify.stack);
+        free(_simplify.window);
+        free(_prune.buckets);
+        free(_prune.next);
+        _path = nullptr;
         return;
     }
 
     _path_points_max = _points_max;
-
-    // when running the example sketch, we want the cleanup tasks to run when we tell them to, not in the background (so that they can be timed.)
-    if (!_example_mode){
-        // register background cleanup to run in IO thread
-        hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_SmartRTL::run_background_cleanup, void));
-    }
+    _prune.bucket_mask = num_buckets - 1;
+    reset_path();
 }
 
 // returns number of points on the path
@@ -132,30 +124,21 @@ uint16_t AP_SmartRTL::get_num_points() const
 // get next point on the path to home, returns true on success
 bool AP_SmartRTL::pop_point(Vector3f& point)
 {
-    // check we are active
-    if (!_active) {
-        return false;
-    }
-
-    // get semaphore
-    if (!_path_sem.take_nonblocking()) {
-        log_action(SRTL_POP_FAILED_NO_SEMAPHORE);
-        return false;
-    }
-
-    // check we have another point
-    if (_path_points_count == 0) {
-        _path_sem.give();
+    // check we are active and have another point
+    if (!_active || _path_points_count == 0) {
         return false;
     }
 
     // return last point and remove from path
-    point = _path[--_path_points_count];
+    const uint16_t last = _path_points_count - 1;
+    index_remove(last);
+    point = _path[last];
+    _path_points_count = last;
 
-    // record count of last point popped
-    _path_points_completed_limit = _path_points_count;
+    // if points are added again they start a new segment from the end of the path
+    _simplify.anchor = (last > 0) ? last - 1 : 0;
+    _simplify.window_count = 0;
 
-    _path_sem.give();
     return true;
 }
 
@@ -174,12 +157,7 @@ void AP_SmartRTL::set_home(bool position_ok, const Vector3f& current_pos)
     }
 
     // clear path
-    _path_points_count = 0;
-
-    // reset simplification and pruning.  These functions access members that should normally only
-    // be touched by the background thread but it will not be running because active should be false
-    reset_simplification();
-    reset_pruning();
+    reset_path();
 
     // don't continue if no position at take-off
     if (!position_ok) {
@@ -239,40 +217,6 @@ void AP_SmartRTL::update(bool position_ok, const Vector3f& current_pos)
     }
 }
 
-// request thorough cleanup including simplification, pruning and removal of all unnecessary points
-// returns true if the thorough cleanup was completed, false if it has not yet completed
-// this method should be called repeatedly until it returns true before initiating the return journey
-bool AP_SmartRTL::request_thorough_cleanup(ThoroughCleanupType clean_type)
-{
-    // this should never happen but just in case
-    if (!_active) {
-        return false;
-    }
-
-    // request thorough cleanup
-    if (_thorough_clean_request_ms == 0) {
-        _thorough_clean_request_ms = AP_HAL::millis();
-        if (clean_type != THOROUGH_CLEAN_DEFAULT) {
-            _thorough_clean_type = clean_type;
-        }
-        return false;
-    }
-
-    // check if background thread has completed request
-    if (_thorough_clean_complete_ms == _thorough_clean_request_ms) {
-        _thorough_clean_request_ms = 0;
-        return true;
-    }
-
-    return false;
-}
-
-// cancel request for thorough cleanup
-void AP_SmartRTL::cancel_request_for_thorough_cleanup()
-{
-    _thorough_clean_request_ms = 0;
-}
-
 //
 // Private methods
 //
@@ -280,492 +224,253 @@ void AP_SmartRTL::cancel_request_for_thorough_cleanup()
 // add point to end of path (if necessary), returns true on success
 bool AP_SmartRTL::add_point(const Vector3f& point)
 {
-    // get semaphore
-    if (!_path_sem.take_nonblocking()) {
-        log_action(SRTL_ADD_FAILED_NO_SEMAPHORE, point);
-        return false;
-    }
-
     // check if we have traveled far enough
     if (_path_points_count > 0) {
         const Vector3f& last_pos = _path[_path_points_count-1];
         if (last_pos.distance_squared(point) < sq(_accuracy.get())) {
-            _path_sem.give();
             return true;
         }
     }
 
-    // check we have space in the path
-    if (_path_points_count >= _path_points_max) {
-        _path_sem.give();
-        log_action(SRTL_ADD_FAILED_PATH_FULL, point);
-        return false;
+    // the first point starts the path
+    if (_path_points_count == 0) {
+        _path[_path_points_count++] = point;
+        _simplify.anchor = 0;
+        _simplify.window_count = 0;
+        log_action(SRTL_POINT_ADD, point);
+        return true;
     }
 
-    // add point to path
-    _path[_path_points_count++] = point;
-    log_action(SRTL_POINT_ADD, point);
-
-    _path_sem.give();
-    return true;
-}
-
-// run background cleanup - should be run regularly from the IO thread
-void AP_SmartRTL::run_background_cleanup()
-{
-    if (!_active) {
-        return;
+    if (can_extend_last_segment(point)) {
+        // move the end of the path to the new point
+        const uint16_t last = _path_points_count - 1;
+        index_remove(last);
+        log_action(SRTL_POINT_SIMPLIFY, _path[last]);
+        _path[last] = point;
+        _simplify.window[_simplify.window_count++] = point;
+    } else {
+        // check we have space in the path
+        if (_path_points_count >= _path_points_max) {
+            log_action(SRTL_ADD_FAILED_PATH_FULL, point);
+            return false;
+        }
+        // fix the end of the path and start a new segment from it
+        _simplify.anchor = _path_points_count - 1;
+        _path[_path_points_count++] = point;
+        _simplify.window[0] = point;
+        _simplify.window_count = 1;
     }
+    log_action(SRTL_POINT_ADD, point);
 
-    // get semaphore
-    if (!_path_sem.take_nonblocking()) {
-        return;
-    }
-    // local copy of _path_points_count and _path_points_completed_limit
-    const uint16_t path_points_count = _path_points_count;
-    const uint16_t path_points_completed_limit = _path_points_completed_limit;
-    _path_points_completed_limit = SMARTRTL_POINTS_MAX;
-    _path_sem.give();
-
-    // check if thorough cleanup is required
-    if (_thorough_clean_request_ms > 0) {
-        // check if we have already completed the request
-        if (_thorough_clean_complete_ms != _thorough_clean_request_ms) {
-            if (thorough_cleanup(path_points_count, _thorough_clean_type)) {
-                // record completion
-                _thorough_clean_complete_ms = _thorough_clean_request_ms;
+    // cut out any loop closed by the new segment
+    uint16_t segment = _path_points_count - 1;
+    uint16_t loop_start;
+    Vector3f midpoint;
+    if (find_loop(segment, loop_start, midpoint)) {
+        for (uint16_t i = segment - 1; i >= loop_start; i--) {
+            index_remove(i);
+            if (i > loop_start) {
+                log_action(SRTL_POINT_PRUNE, _path[i]);
             }
         }
-        // we do not perform any further detection or cleanup until the requester acknowledges
-        // they have what they need by setting _thorough_clean_request_ms back to zero
-        return;
-    }
-
-    // ensure clean complete time is zero
-    _thorough_clean_complete_ms = 0;
-
-    // perform routine cleanup which removes 10 to 50 points if possible
-    routine_cleanup(path_points_count, path_points_completed_limit);
-}
-
-// routine cleanup is called regularly from run_background_cleanup
-//   simplifies the path after SMARTRTL_CLEANUP_POINT_TRIGGER points (50 points) have been added OR
-//   SMARTRTL_CLEANUP_POINT_MIN (10 points) have been added and the path has less than SMARTRTL_CLEANUP_START_MARGIN spaces (10 spaces) remaining
-//   prunes the path if the path has less than SMARTRTL_CLEANUP_START_MARGIN spaces (10 spaces) remaining
-void AP_SmartRTL::routine_cleanup(uint16_t path_points_count, uint16_t path_points_completed_limit)
-{
-    // if simplify is running, let it run to completion
-    if (!_simplify.complete) {
-        detect_simplifications();
-        return;
-    }
-
-    // remove simplified from path if required
-    if (_simplify.removal_required) {
-        remove_points_by_simplify_bitmask();
-        return;
-    }
+        // midpoint replaces the end point of the earlier segment and the new point follows it
+        _path[loop_start] = midpoint;
+        _path[loop_start + 1] = point;
+        _path_points_count = loop_start + 2;
+        index_add(loop_start);
+        segment = loop_start + 1;
+        _simplify.anchor = loop_start;
+        _simplify.window[0] = point;
+        _simplify.window_count = 1;
+    }
+    index_add(segment);
 
-    // if necessary restart detect_pruning up to last point simplified
-    if (_prune.complete) {
-        restart_pruning_if_new_points();
-    }
-    // if pruning is running, let it run to completion
-    if (!_prune.complete) {
-        detect_loops();
-        return;
-    }
-
-    // detect path shrinkage and reduce simplify and prune path_points_completed count
-    if (_simplify.path_points_completed > path_points_completed_limit) {
-        _simplify.path_points_completed = path_points_completed_limit;
-    }
-    if (_prune.path_points_completed > path_points_completed_limit) {
-        _prune.path_points_completed = path_points_completed_limit;
-    }
-
-    // calculate the number of points we could simplify
-    const uint16_t points_to_simplify = (path_points_count > _simplify.path_points_completed) ? (path_points_count - _simplify.path_points_completed) : 0 ;
-    const bool low_on_space = (_path_points_max - path_points_count) <= SMARTRTL_CLEANUP_START_MARGIN;
-
-    // if 50 points can be simplified or we are low on space and at least 10 points can be simplified
-    if ((points_to_simplify >= SMARTRTL_CLEANUP_POINT_TRIGGER) || (low_on_space && (points_to_simplify >= SMARTRTL_CLEANUP_POINT_MIN))) {
-        restart_simplification(path_points_count);
-        return;
-    }
-
-    // we are low on space, prune
-    if (low_on_space) {
-        // remove at least 10 points
-        remove_points_by_loops(SMARTRTL_CLEANUP_POINT_MIN);
-    }
+    return true;
 }
 
-// thorough cleanup simplifies and prunes all loops.  returns true if the cleanup was completed.
-// path_points_count is _path_points_count but passed in to avoid having to take the semaphore
-bool AP_SmartRTL::thorough_cleanup(uint16_t path_points_count, ThoroughCleanupType clean_type)
+// returns true if the last segment of the path can be extended to point while still
+// passing within SMARTRTL_SIMPLIFY_EPSILON of all the positions it replaces
+bool AP_SmartRTL::can_extend_last_segment(const Vector3f& point) const
 {
-    if (clean_type != THOROUGH_CLEAN_PRUNE_ONLY) {
-        // restart simplify if new points have appeared on path
-        if (_simplify.complete) {
-            restart_simplify_if_new_points(path_points_count);
-        }
-        // if simplification is not complete, run it
-        if (!_simplify.complete) {
-            detect_simplifications();
-            return false;
-        }
-        // remove simplified points from path if required
-        if (_simplify.removal_required) {
-            remove_points_by_simplify_bitmask();
-            return false;
-        }
+    if (_simplify.window_count == 0 || _simplify.window_count >= SMARTRTL_SIMPLIFY_WINDOW) {
+        return false;
     }
-
-    if (clean_type != THOROUGH_CLEAN_SIMPLIFY_ONLY) {
-        // if necessary restart detect_pruning up to last point simplified
-        if (_prune.complete) {
-            restart_pruning_if_new_points();
+    // measure the distance to the segment rather than to the line through it so that positions
+    // where the vehicle doubled back are kept
+    const Vector3f& start = _path[_simplify.anchor];
+    const Vector3f line = point - start;
+    const float line_length_sq = line.length_squared();
+    const float epsilon_sq = sq(SMARTRTL_SIMPLIFY_EPSILON);
+    for (uint8_t i = 0; i < _simplify.window_count; i++) {
+        const Vector3f& pos = _simplify.window[i];
+        float t = 0.0f;
+        if (is_positive(line_length_sq)) {
+            t = constrain_float(((pos - start) * line) / line_length_sq, 0.0f, 1.0f);
         }
-        // if pruning is not complete, run it
-        if (!_prune.complete) {
-            detect_loops();
-            return false;
-        }
-        // remove pruning points
-        if (!remove_points_by_loops(SMARTRTL_POINTS_MAX)) {
+        if ((start + line * t).distance_squared(pos) > epsilon_sq) {
             return false;
         }
     }
-
     return true;
 }
 
-// Simplifies a 3D path, according to the Ramer-Douglas-Peucker algorithm.
-// _simplify.complete is set to true when all simplifications on the path have been identified
-void AP_SmartRTL::detect_simplifications()
+// clear the path and the spatial index
+void AP_SmartRTL::reset_path()
 {
-    // complete immediately if only one segment
-    if (_simplify.path_points_count < 3) {
-        _simplify.complete = true;
-        return;
-    }
-
-    // if not complete but also nothing to do, we must be restarting
-    if (_simplify.stack_count == 0) {
-        // reset to beginning state. add a single element in the array with:
-        //   start = first path point OR the index of the last already-simplified point
-        //   finish = final path point
-        _simplify.stack[0].start = (_simplify.path_points_completed > 0) ? _simplify.path_points_completed - 1 : 0;
-        _simplify.stack[0].finish = _simplify.path_points_count-1;
-        _simplify.stack_count++;
-    }
-
-    const uint32_t start_time_us = AP_HAL::micros();
-    while (_simplify.stack_count > 0) { // while there is something to do
-
-        // if this method has run for long enough, exit
-        if (AP_HAL::micros() - start_time_us > SMARTRTL_SIMPLIFY_TIME_US) {
-            return;
-        }
-
-        // pop last item off the simplify stack
-        const simplify_start_finish_t tmp = _simplify.stack[--_simplify.stack_count];
-        const uint16_t start_index = tmp.start;
-        const uint16_t end_index = tmp.finish;
-
-        // find the point between start and end points that is farthest from the start-end line segment
-        float max_dist = 0.0f;
-        uint16_t farthest_point_index = start_index;
-        for (uint16_t i = start_index + 1; i < end_index; i++) {
-            // only check points that have not already been flagged for simplification
-            if (_simplify.bitmask.get(i)) {
-                const float dist = _path[i].distance_to_segment(_path[start_index], _path[end_index]);
-                if (dist > max_dist) {
-                    farthest_point_index = i;
-                    max_dist = dist;
-                }
-            }
-        }
-
-        // if the farthest point is more than ACCURACY * 0.5 add two new elements to the _simplification_stack
-        // so that on the next iteration we will check between start-to-farthestpoint and farthestpoint-to-end
-        if (max_dist > SMARTRTL_SIMPLIFY_EPSILON) {
-            // if the to-do list is full, give up on simplifying. This should never happen.
-            if (_simplify.stack_count >= _simplify.stack_max) {
-                _simplify.complete = true;
-                return;
-            }
-            _simplify.stack[_simplify.stack_count++] = simplify_start_finish_t {start_index, farthest_point_index};
-            _simplify.stack[_simplify.stack_count++] = simplify_start_finish_t {farthest_point_index, end_index};
-        } else {
-            // if the farthest point was closer than ACCURACY * 0.5 we can simplify all points between start and end
-            for (uint16_t i = start_index + 1; i < end_index; i++) {
-                _simplify.bitmask.clear(i);
-                _simplify.removal_required = true;
-            }
-        }
-    }
-    _simplify.path_points_completed = _simplify.path_points_count;
-    _simplify.complete = true;
+    _path_points_count = 0;
+    _simplify.anchor = 0;
+    _simplify.window_count = 0;
+    memset(_prune.buckets, 0xFF, (_prune.bucket_mask + 1) * sizeof(uint16_t));
+    memset(_prune.level_count, 0, sizeof(_prune.level_count));
+    // the cell size is fixed until the path is next cleared so segments can always be found again
+    _prune.cell_size = SMARTRTL_INDEX_CELL_MULT * _accuracy;
 }
 
-/**
-*   This method runs for the allotted time, and detects loops in a path. Any detected loops are added to _prune.loops,
-*   this function does not alter the path in memory. It works by comparing the line segment between any two sequential points
-*   to the line segment between any other two sequential points. If they get close enough, anything between them could be pruned.
-*
-*   reset_pruning should have been called at least once before this function is called to setup the indexes (_prune.i, etc)
-*/
-void AP_SmartRTL::detect_loops()
+// spatial index hash bucket for a grid cell
+uint16_t AP_SmartRTL::cell_bucket(uint8_t level, int32_t cell_x, int32_t cell_y) const
 {
-    // if there are less than 4 points (3 segments), mark complete
-    if (_prune.path_points_count < 4) {
-        _prune.complete = true;
-        return;
-    }
-
-    // capture start time
-    const uint32_t start_time_us = AP_HAL::micros();
-
-    // run for defined amount of time
-    while (AP_HAL::micros() - start_time_us < SMARTRTL_PRUNING_LOOP_TIME_US) {
-
-        // advance inner loop
-        _prune.j++;
-        if (_prune.j > _prune.i - 2) {
-            // set inner loop back to first point
-            _prune.j = 1;
-            // reduce outer loop
-            _prune.i--;
-            // complete when outer loop has run out of new points to check
-            if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
-                _prune.complete = true;
-                _prune.path_points_completed = _prune.path_points_count;
-                return;
-            }
-        }
-
-        // find the closest distance between two line segments and the mid-point
-        dist_point dp = segment_segment_dist(_path[_prune.i], _path[_prune.i-1], _path[_prune.j-1], _path[_prune.j]);
-        if (dp.distance < SMARTRTL_PRUNING_DELTA) {
-            // if there is a loop here, add to loop array
-            if (!add_loop(_prune.j, _prune.i-1, dp.midpoint)) {
-                // if the buffer is full, stop trying to prune
-                _prune.complete = true;
-            }
-            // set inner loop forward to trigger outer loop move to next segment
-            _prune.j = _prune.i;
-        }
-    }
+    uint32_t hash = ((uint32_t)cell_x * 73856093U) ^ ((uint32_t)cell_y * 19349663U) ^ ((uint32_t)level * 83492791U);
+    hash ^= hash >> 16;
+    return hash & _prune.bucket_mask;
 }
 
-// restart simplify if new points have been added to path
-// path_points_count is _path_points_count but passed in to avoid having to take the semaphore
-void AP_SmartRTL::restart_simplify_if_new_points(uint16_t path_points_count)
+// spatial index bucket and level holding a segment.  These are worked out from the segment's
+// position so it must not change while the segment is in the index
+uint16_t AP_SmartRTL::segment_bucket(uint16_t segment, uint8_t& level) const
 {
-    // any difference in the number of points is because of new points being added to path
-    if (_simplify.path_points_count != path_points_count) {
-        restart_simplification(path_points_count);
-    }
+    const Vector3f& p1 = _path[segment-1];
+    const Vector3f& p2 = _path[segment];
+    const float length = norm(p2.x - p1.x, p2.y - p1.y);
+
+    level = 0;
+    float cell_size = _prune.cell_size;
+    while (level < SMARTRTL_INDEX_LEVELS && cell_size < length) {
+        cell_size *= 2.0f;
+        level++;
+    }
+    if (level == SMARTRTL_INDEX_LEVELS) {
+        // too long for any level, all of these share one bucket
+        return cell_bucket(level, 0, 0);
+    }
+    return cell_bucket(level,
+                       (int32_t)floorf((p1.x + p2.x) * 0.5f / cell_size),
+                       (int32_t)floorf((p1.y + p2.y) * 0.5f / cell_size));
 }
 
-// reset pruning if new points have been simplified
-void AP_SmartRTL::restart_pruning_if_new_points()
+// add a segment to the spatial index
+void AP_SmartRTL::index_add(uint16_t segment)
 {
-    // any difference in the number of points is because of new points being added to path
-    if (_prune.path_points_count != _simplify.path_points_completed) {
-        restart_pruning(_simplify.path_points_completed);
+    if (segment == 0) {
+        return;
     }
+    uint8_t level;
+    const uint16_t bucket = segment_bucket(segment, level);
+    _prune.next[segment] = _prune.buckets[bucket];
+    _prune.buckets[bucket] = segment;
+    _prune.level_count[level]++;
 }
 
-// restart simplification algorithm so that it will check new points in the path
-void AP_SmartRTL::restart_simplification(uint16_t path_points_count)
-{
-    _simplify.complete = false;
-    _simplify.removal_required = false;
-    _simplify.bitmask.setall();
-    _simplify.stack_count = 0;
-    _simplify.path_points_count = path_points_count;
-}
-
-// reset simplification algorithm so that it will re-check all points in the path
-void AP_SmartRTL::reset_simplification()
+// remove a segment from the spatial index
+void AP_SmartRTL::index_remove(uint16_t segment)
 {
-    restart_simplification(0);
-    _simplify.path_points_completed = 0;
-}
-
-// restart pruning algorithm to check new points that have arrived
-void AP_SmartRTL::restart_pruning(uint16_t path_points_count)
-{
-    _prune.complete = false;
-    _prune.i = (path_points_count > 0) ? path_points_count - 1 : 0;
-    _prune.j = 0;
-    _prune.path_points_count = path_points_count;
-}
-
-// reset pruning algorithm so that it will re-check all points in the path
-void AP_SmartRTL::reset_pruning()
-{
-    restart_pruning(0);
-    _prune.loops_count = 0; // clear the loops that we've recorded
-    _prune.path_points_completed = 0;
-}
-
-// remove all simplify-able points from the path
-void AP_SmartRTL::remove_points_by_simplify_bitmask()
-{
-    // get semaphore before modifying path
-    if (!_path_sem.take_nonblocking()) {
+    if (segment == 0) {
         return;
     }
-    uint16_t dest = 1;
-    uint16_t removed = 0;
-    for (uint16_t src = 1; src < _path_points_count; src++) {
-        if (!_simplify.bitmask.get(src)) {
-            log_action(SRTL_POINT_SIMPLIFY, _path[src]);
-            removed++;
-        } else {
-            _path[dest] = _path[src];
-            dest++;
+    uint8_t level;
+    uint16_t* link = &_prune.buckets[segment_bucket(segment, level)];
+    while (*link != SMARTRTL_INDEX_NONE) {
+        if (*link == segment) {
+            *link = _prune.next[segment];
+            _prune.level_count[level]--;
+            return;
         }
+        link = &_prune.next[*link];
     }
-
-    // reduce count of the number of points simplified
-    if (_path_points_count > removed && _simplify.path_points_count > removed) {
-        _path_points_count -= removed;
-        _simplify.path_points_count -= removed;
-        _simplify.path_points_completed = _simplify.path_points_count;
-    } else {
-        // this is an error that should never happen so deactivate
-        deactivate(SRTL_DEACTIVATED_PROGRAM_ERROR, "program error");
-    }
-
-    _path_sem.give();
-
-    // flag point removal is complete
-    _simplify.bitmask.setall();
-    _simplify.removal_required = false;
+    // this is an error that should never happen so deactivate
+    deactivate(SRTL_DEACTIVATED_PROGRAM_ERROR, "program error");
 }
 
-// remove loops until at least num_point_to_delete have been removed from path
-// does not necessarily prune all loops
-// returns false if it failed to remove points (because it could not take semaphore)
-bool AP_SmartRTL::remove_points_by_loops(uint16_t num_points_to_remove)
+// find the earliest segment which passes within SMARTRTL_PRUNING_DELTA of a segment, ignoring
+// the segment just before it which it always touches.  returns true if one was found, in which
+// case loop_start is the earlier segment and midpoint is halfway between their closest points
+bool AP_SmartRTL::find_loop(uint16_t segment, uint16_t& loop_start, Vector3f& midpoint) const
 {
-    // exit immediately if no loops to prune
-    if (_prune.loops_count == 0) {
-        return true;
-    }
-
-    // get semaphore before modifying path
-    if (!_path_sem.take_nonblocking()) {
+    if (segment < 3) {
         return false;
     }
-
-    uint16_t removed_points = 0;
-    uint16_t i = _prune.loops_count;
-    while ((i > 0) && (removed_points < num_points_to_remove)) {
-        i--;
-        prune_loop_t loop = _prune.loops[i];
-
-        // midpoint goes into start_index (this is the end point of the first segment)
-        _path[loop.start_index] = loop.midpoint;
-
-        // shift points after the end of the loop down by the number of points in the loop
-        uint16_t loop_num_points_to_remove = loop.end_index - loop.start_index;
-        for (uint16_t dest = loop.start_index + 1; dest < _path_points_count - loop_num_points_to_remove; dest++) {
-            log_action(SRTL_POINT_PRUNE, _path[dest]);
-            _path[dest] = _path[dest + loop_num_points_to_remove];
+    loop_start = segment;
+
+    const Vector3f& p1 = _path[segment-1];
+    const Vector3f& p2 = _path[segment];
+    const float delta = SMARTRTL_PRUNING_DELTA;
+
+    // all of a segment is within half a cell of its own cell so look in every cell which
+    // could hold a segment within delta of this one.  If that is too many cells at any level
+    // then check every segment instead
+    int32_t x_min[SMARTRTL_INDEX_LEVELS], x_max[SMARTRTL_INDEX_LEVELS];
+    int32_t y_min[SMARTRTL_INDEX_LEVELS], y_max[SMARTRTL_INDEX_LEVELS];
+    float cell_size = _prune.cell_size;
+    for (uint8_t level = 0; level < SMARTRTL_INDEX_LEVELS; level++, cell_size *= 2.0f) {
+        if (_prune.level_count[level] == 0) {
+            continue;
         }
-
-        if (_path_points_count > loop_num_points_to_remove) {
-            _path_points_count -= loop_num_points_to_remove;
-            removed_points += loop_num_points_to_remove;
-        } else {
-            // this is an error that should never happen so deactivate
-            deactivate(SRTL_DEACTIVATED_PROGRAM_ERROR, "program error");
-            _path_sem.give();
-            // we return true so thorough_cleanup does not get stuck
-            return true;
+        const float margin = cell_size * 0.5f + delta;
+        x_min[level] = (int32_t)floorf((MIN(p1.x, p2.x) - margin) / cell_size);
+        x_max[level] = (int32_t)floorf((MAX(p1.x, p2.x) + margin) / cell_size);
+        y_min[level] = (int32_t)floorf((MIN(p1.y, p2.y) - margin) / cell_size);
+        y_max[level] = (int32_t)floorf((MAX(p1.y, p2.y) + margin) / cell_size);
+        if ((x_max[level] - x_min[level] + 1) * (y_max[level] - y_min[level] + 1) > SMARTRTL_INDEX_QUERY_CELLS_MAX) {
+            return find_loop_linear(segment, loop_start, midpoint);
         }
+    }
 
-        // fix the indices of any existing prune loops
-        // we do not check for overlapping loops because add_loops should have caught them
-        for (uint16_t loop_cnt = 0; loop_cnt < i; loop_cnt++) {
-            if (_prune.loops[loop_cnt].start_index >= loop.end_index) {
-                _prune.loops[loop_cnt].start_index -= loop_num_points_to_remove;
-            }
-            if (_prune.loops[loop_cnt].end_index >= loop.end_index) {
-                _prune.loops[loop_cnt].end_index -= loop_num_points_to_remove;
+    for (uint8_t level = 0; level < SMARTRTL_INDEX_LEVELS; level++) {
+        if (_prune.level_count[level] == 0) {
+            continue;
+        }
+        for (int32_t x = x_min[level]; x <= x_max[level]; x++) {
+            for (int32_t y = y_min[level]; y <= y_max[level]; y++) {
+                find_loop_in_bucket(cell_bucket(level, x, y), segment, loop_start, midpoint);
             }
         }
-
-        // remove last prune loop from array
-        _prune.loops_count--;
+    }
+    if (_prune.level_count[SMARTRTL_INDEX_LEVELS] > 0) {
+        find_loop_in_bucket(cell_bucket(SMARTRTL_INDEX_LEVELS, 0, 0), segment, loop_start, midpoint);
     }
 
-    _path_sem.give();
-    return true;
+    return loop_start < segment;
 }
 
-// add loop to loops array
-//  returns true if loop added successfully, false if loop array is full
-//  checks if loop overlaps with an existing loop, keeps only the longer loop
-bool AP_SmartRTL::add_loop(uint16_t start_index, uint16_t end_index, const Vector3f& midpoint)
+// find_loop without the spatial index, checking every earlier segment in order.  Used when the
+// new segment is too long to look up in the index
+bool AP_SmartRTL::find_loop_linear(uint16_t segment, uint16_t& loop_start, Vector3f& midpoint) const
 {
-    // if the buffer is full, return failure
-    if (_prune.loops_count >= _prune.loops_max) {
-        return false;
-    }
-
-    // sanity check indices
-    if (end_index <= start_index) {
-        return false;
-    }
-
-    // create new loop structure and calculate length squared of loop
-    prune_loop_t new_loop = {start_index, end_index, midpoint, 0.0f};
-    new_loop.length_squared = midpoint.distance_squared(_path[start_index]) + midpoint.distance_squared(_path[end_index]);
-    for (uint16_t i = start_index; i < end_index; i++) {
-        new_loop.length_squared += _path[i].distance_squared(_path[i+1]);
-    }
-
-    // look for overlapping loops and find their combined length
-    bool overlapping_loops = false;
-    float overlapping_loop_length = 0.0f;
-    for (uint16_t loop_idx = 0; loop_idx < _prune.loops_count; loop_idx++) {
-        if (loops_overlap(_prune.loops[loop_idx], new_loop)) {
-            overlapping_loops = true;
-            overlapping_loop_length += _prune.loops[loop_idx].length_squared;
+    for (uint16_t i = 1; i + 1 < segment; i++) {
+        const dist_point dp = segment_segment_dist(_path[segment], _path[segment-1], _path[i-1], _path[i]);
+        if (dp.distance < SMARTRTL_PRUNING_DELTA) {
+            loop_start = i;
+            midpoint = dp.midpoint;
+            return true;
         }
     }
+    return false;
+}
 
-    // handle overlapping loops
-    if (overlapping_loops) {
-        // if adding this loop would lengthen the path, discard the new loop but return success
-        if (overlapping_loop_length > new_loop.length_squared) {
-            return true;
+// check the segments in one bucket of the spatial index for find_loop.  Buckets may also hold
+// segments from other cells so every segment is checked
+void AP_SmartRTL::find_loop_in_bucket(uint16_t bucket, uint16_t segment, uint16_t& loop_start, Vector3f& midpoint) const
+{
+    for (uint16_t i = _prune.buckets[bucket]; i != SMARTRTL_INDEX_NONE; i = _prune.next[i]) {
+        // only earlier segments which are not adjacent and would make a longer loop
+        if (i + 1 >= segment || i >= loop_start) {
+            continue;
         }
-        // remove overlapping loops
-        uint16_t dest_idx = 0;
-        uint16_t removed = 0;
-        for (uint16_t src_idx = 0; src_idx < _prune.loops_count; src_idx++) {
-            if (loops_overlap(_prune.loops[src_idx], new_loop)) {
-                removed++;
-            } else {
-                _prune.loops[dest_idx] = _prune.loops[src_idx];
-                dest_idx++;
-            }
+        const dist_point dp = segment_segment_dist(_path[segment], _path[segment-1], _path[i-1], _path[i]);
+        if (dp.distance < SMARTRTL_PRUNING_DELTA) {
+            loop_start = i;
+            midpoint = dp.midpoint;
         }
-        _prune.loops_count -= removed;
     }
-
-    // add new loop to _prune.loops array
-    _prune.loops[_prune.loops_count] = new_loop;
-    _prune.loops_count++;
-    return true;
 }
 
 /**
@@ -828,24 +533,3 @@ void AP_SmartRTL::log_action(SRTL_Actions action, const Vector3f &point)
         DataFlash_Class::instance()->Log_Write_SRTL(_active, _path_points_count, _path_points_max, action, point);
     }
 }
-
-// returns true if the two loops overlap (used within add_loop to determine which loops to keep or throw away)
-bool AP_SmartRTL::loops_overlap(const prune_loop_t &loop1, const prune_loop_t &loop2) const
-{
-    // check if loop1 within loop2
-    if (loop1.start_index >= loop2.start_index && loop1.end_index <= loop2.end_index) {
-        return true;
-    }
-    // check if loop2 within loop1
-    if (loop2.start_index >= loop1.start_index && loop2.end_index <= loop1.end_index) {
-        return true;
-    }
-    // check for partial overlap (loop1's start OR end point is within loop2)
-    const bool loop1_start_in_loop2 = (loop1.start_index >= loop2.start_index) && (loop1.start_index <= loop2.end_index);
-    const bool loop1_end_in_loop2 = (loop1.end_index >= loop2.start_index) && (loop1.end_index <= loop2.end_index);
-    if (loop1_start_in_loop2 != loop1_end_in_loop2) {
-        return true;
-    }
-    // if we got here, no overlap
-    return false;
-}
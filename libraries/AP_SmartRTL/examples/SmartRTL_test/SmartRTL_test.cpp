@@ -36,6 +36,7 @@ void setup();
 void loop();
 void reset();
 void check_path(const std::vector<Vector3f> &correct_path, const char* test_name, uint32_t time_us);
+void benchmark_flight();
 
 void setup()
 {
@@ -53,32 +54,16 @@ void loop()
 
     hal.console->printf("--------------------\n");
 
-    // reset path and upload "test_path_before" to smart_rtl
+    // reset path and upload "test_path_before" to smart_rtl, which
+    // simplifies and prunes it as each point is added
     reference_time = AP_HAL::micros();
     reset();
     run_time = AP_HAL::micros() - reference_time;
-
-    // check path after initial load (no simplification or pruning)
-    check_path(test_path_after_adding, "append", run_time);
-
-    // test simplifications
-    reference_time = AP_HAL::micros();
-    while (!smart_rtl.request_thorough_cleanup(AP_SmartRTL::THOROUGH_CLEAN_SIMPLIFY_ONLY)) {
-        smart_rtl.run_background_cleanup();
-    }
-    run_time = AP_HAL::micros() - reference_time;
-    check_path(test_path_after_simplifying, "simplify", run_time);
-
-    // test both simplification and pruning
-    hal.scheduler->delay(5);    // delay 5 milliseconds because request_through_cleanup uses millisecond timestamps
-    reset();
-    reference_time = AP_HAL::micros();
-    while (!smart_rtl.request_thorough_cleanup(AP_SmartRTL::THOROUGH_CLEAN_ALL)) {
-        smart_rtl.run_background_cleanup();
-    }
-    run_time = AP_HAL::micros() - reference_time;
     check_path(test_path_complete, "simplify and pruning", run_time);
 
+    // time each update over a long flight
+    benchmark_flight();
+
     // delay before next display
     hal.scheduler->delay(5e3); // 5 seconds
 }
@@ -92,6 +77,64 @@ void reset()
     }
 }
 
+// generate the position of a long flight at 3Hz: circuits of a
+// survey pattern with orbits at each end, flown back towards home,
+// so the path is repeatedly simplified and pruned
+static Vector3f flight_position(uint32_t step)
+{
+    const uint32_t circuit_steps = 3000;
+    const float t = (step % circuit_steps) / 3.0f;
+    const float leg = 100.0f;
+    Vector3f pos;
+    if (t < 500.0f) {
+        // lawnmower survey out to 500m, 20m lanes
+        const uint32_t lane = (uint32_t)(t / 20.0f);
+        const float along = fmodf(t, 20.0f) * 5.0f;
+        pos.x = lane * 20.0f;
+        pos.y = (lane % 2) ? leg - along : along;
+    } else if (t < 700.0f) {
+        // orbit at the far end
+        const float angle = (t - 500.0f) * 0.1f;
+        pos.x = 500.0f + 30.0f * sinf(angle);
+        pos.y = 30.0f - 30.0f * cosf(angle);
+    } else {
+        // straight back home
+        const float back = constrain_float((t - 700.0f) * 5.0f, 0.0f, 500.0f);
+        pos.x = 500.0f - back;
+        pos.y = 0.0f;
+    }
+    pos.z = -20.0f - 5.0f * sinf(t * 0.02f);
+    return pos;
+}
+
+// fly ten circuits of flight_position() and display the time taken by
+// each update and the longest the path became
+void benchmark_flight()
+{
+    const uint32_t steps = 30000;
+    uint32_t total_us = 0;
+    uint32_t max_us = 0;
+    uint16_t max_points = 0;
+
+    smart_rtl.set_home(true, Vector3f{0.0f, 0.0f, 0.0f});
+    for (uint32_t i = 0; i < steps; i++) {
+        const Vector3f pos = flight_position(i);
+        const uint32_t reference_time = AP_HAL::micros();
+        smart_rtl.update(true, pos);
+        const uint32_t run_time = AP_HAL::micros() - reference_time;
+        total_us += run_time;
+        max_us = MAX(max_us, run_time);
+        max_points = MAX(max_points, smart_rtl.get_num_points());
+    }
+
+    hal.console->printf("flight: %s updates:%u mean:%4.2f us max:%u us\n",
+                        smart_rtl.is_active() ? "success" : "fail",
+                        (unsigned)steps,
+                        (double)(total_us / (float)steps),
+                        (unsigned)max_us);
+    hal.console->printf("   path peaked at %u points, ended with %u\n", (unsigned)max_points, (unsigned)smart_rtl.get_num_points());
+}
+
 // compare the vector array passed in with the path held in the smart_rtl object
 void check_path(const std::vector<Vector3f>& correct_path, const char* test_name, uint32_t time_us)
 {
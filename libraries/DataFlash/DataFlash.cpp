@@ -1036,3 +1036,37 @@ bool DataFlash_Class::Log_Write_ISBD(const uint16_t isb_seqno,
 
     return backends[0]->WriteBlock(&pkt, sizeof(pkt));
 }
+
+// Write the results of on-board spectral analysis of an IMU batch:
+bool DataFlash_Class::Log_Write_ISBF(const uint16_t isb_seqno,
+                                     const AP_InertialSensor::IMU_SENSOR_TYPE sensor_type,
+                                     const uint8_t sensor_instance,
+                                     const uint16_t points,
+                                     const Vector3f &peak_hz,
+                                     const Vector3f &energy)
+{
+    if (_next_backend == 0) {
+        return false;
+    }
+    struct log_ISBF pkt = {
+        LOG_PACKET_HEADER_INIT(LOG_ISBF_MSG),
+        time_us     : AP_HAL::micros64(),
+        isb_seqno   : isb_seqno,
+        sensor_type : (uint8_t)sensor_type,
+        instance    : sensor_instance,
+        points      : points,
+        peak_x      : peak_hz.x,
+        peak_y      : peak_hz.y,
+        peak_z      : peak_hz.z,
+        energy_x    : energy.x,
+        energy_y    : energy.y,
+        energy_z    : energy.z,
+    };
+
+    // only the first backend need succeed for us to be successful
+    for (uint8_t i=1; i<_next_backend; i++) {
+        backends[i]->WriteBlock(&pkt, sizeof(pkt));
+    }
+
+    return backends[0]->WriteBlock(&pkt, sizeof(pkt));
+}
@@ -108,6 +108,12 @@ public:
                         const int16_t x[32],
                         const int16_t y[32],
                         const int16_t z[32]);
+    bool Log_Write_ISBF(uint16_t isb_seqno,
+                        AP_InertialSensor::IMU_SENSOR_TYPE sensor_type,
+                        uint8_t instance,
+                        uint16_t points,
+                        const Vector3f &peak_hz,
+                        const Vector3f &energy);
     void Log_Write_Vibration();
     void Log_Write_RCIN(void);
     void Log_Write_RCOUT(void);
@@ -369,6 +375,14 @@ private:
     // start page of log data
     uint16_t _log_data_page;
 
+    // requests to retransmit parts of the log already streamed, which
+    // are sent before the stream carries on
+    struct log_gap {
+        uint32_t ofs;
+        uint32_t remaining;
+    } _log_gaps[8];
+    uint8_t _log_num_gaps;
+
     GCS_MAVLINK *_log_sending_link;
 
     bool should_handle_log_message();
@@ -381,6 +395,7 @@ private:
     void handle_log_send_listing(); // handle LISTING state
     void handle_log_sending(); // handle SENDING state
     bool handle_log_send_data(); // send data chunk to client
+    void handle_log_request_gap(uint32_t ofs, uint32_t count); // queue a retransmit
 
     void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc);
 
@@ -49,6 +49,16 @@ extern const AP_HAL::HAL& hal;
 #define MAX_LOG_FILES 500U
 #define DATAFLASH_PAGE_SIZE 1024UL
 
+// log downloads are read ahead on the IO thread in two blocks of this
+// size
+#ifndef DATAFLASH_READ_BLOCK_SIZE
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#define DATAFLASH_READ_BLOCK_SIZE 32768U
+#else
+#define DATAFLASH_READ_BLOCK_SIZE 4096U
+#endif
+#endif
+
 /*
   constructor
  */
@@ -701,6 +711,170 @@ void DataFlash_File::get_log_boundaries(const uint16_t list_entry, uint16_t & st
     end_page = _get_log_size(log_num) / DATAFLASH_PAGE_SIZE;
 }
 
+/*
+  read from the open log file at an offset
+ */
+int32_t DataFlash_File::_read_fd_at(const uint32_t ofs, uint8_t *data, const uint32_t len)
+{
+    /*
+      this rather strange bit of code is here to work around a bug
+      in file offsets in NuttX. Every few hundred blocks of reads
+      (starting at around 350k into a file) NuttX will get the
+      wrong offset for sequential reads. The offset it gets is
+      typically 128k earlier than it should be. It turns out that
+      calling lseek() with 0 offset and SEEK_CUR works around the
+      bug. We can remove this once we find the real bug.
+    */
+    if (ofs / 4096 != (ofs+len) / 4096) {
+        off_t seek_current = ::lseek(_read_fd, 0, SEEK_CUR);
+        if (seek_current == (off_t)-1) {
+            close(_read_fd);
+            _read_fd = -1;
+            return -1;
+        }
+        if (seek_current != (off_t)_read_offset) {
+            if (::lseek(_read_fd, _read_offset, SEEK_SET) == (off_t)-1) {
+                close(_read_fd);
+                _read_fd = -1;
+                return -1;
+            }
+        }
+    }
+
+    if (ofs != _read_offset) {
+        if (::lseek(_read_fd, ofs, SEEK_SET) == (off_t)-1) {
+            close(_read_fd);
+            _read_fd = -1;
+            return -1;
+        }
+        _read_offset = ofs;
+    }
+    int32_t ret = ::read(_read_fd, data, len);
+    if (ret > 0) {
+        _read_offset += ret;
+    }
+    return ret;
+}
+
+/*
+  index of the read-ahead block holding an offset, or -1. A short
+  block ends at the end of the log, so it also holds the offset just
+  past its data
+ */
+int8_t DataFlash_File::_read_block_find(const uint32_t ofs) const
+{
+    for (uint8_t i=0; i<ARRAY_SIZE(_read_block); i++) {
+        const struct read_block &b = _read_block[i];
+        if (!b.valid || ofs < b.ofs) {
+            continue;
+        }
+        if (ofs < b.ofs + b.len ||
+            (ofs == b.ofs + b.len && b.len < DATAFLASH_READ_BLOCK_SIZE)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+  return true if a read at ofs carries on sequentially from the
+  read-ahead blocks, or from a long run of direct reads, rather than
+  going back to fill a gap
+ */
+bool DataFlash_File::_read_block_continues(const uint32_t ofs) const
+{
+    if (ofs == _read_offset && _read_direct_bytes >= DATAFLASH_READ_BLOCK_SIZE/4) {
+        // the download has been restarted from an earlier offset
+        return true;
+    }
+    bool any_valid = false;
+    for (uint8_t i=0; i<ARRAY_SIZE(_read_block); i++) {
+        const struct read_block &b = _read_block[i];
+        if (!b.valid) {
+            continue;
+        }
+        any_valid = true;
+        if (ofs == b.ofs + b.len) {
+            return true;
+        }
+    }
+    return !any_valid;
+}
+
+/*
+  fill the oldest read-ahead block from ofs, returning its index or -1
+  on a read error. Called with _read_sem held
+ */
+int8_t DataFlash_File::_read_block_load(const uint32_t ofs)
+{
+    uint8_t i = 0;
+    if (_read_block[1].valid == false ||
+        (_read_block[0].valid && _read_block[1].ofs < _read_block[0].ofs)) {
+        i = 1;
+    }
+    struct read_block &b = _read_block[i];
+    b.valid = false;
+    const int32_t ret = _read_fd_at(ofs, b.data, DATAFLASH_READ_BLOCK_SIZE);
+    if (ret < 0) {
+        return -1;
+    }
+    b.ofs = ofs;
+    b.len = ret;
+    b.valid = true;
+    _read_direct_bytes = 0;
+    return i;
+}
+
+/*
+  allocate the read-ahead blocks, returning false if there is not
+  enough memory. Called with _read_sem held
+ */
+bool DataFlash_File::_read_blocks_alloc()
+{
+    for (uint8_t i=0; i<ARRAY_SIZE(_read_block); i++) {
+        if (_read_block[i].data == nullptr) {
+            _read_block[i].data = (uint8_t *)malloc(DATAFLASH_READ_BLOCK_SIZE);
+            if (_read_block[i].data == nullptr) {
+                _read_blocks_free();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+  free the read-ahead blocks. Called with _read_sem held
+ */
+void DataFlash_File::_read_blocks_free()
+{
+    for (uint8_t i=0; i<ARRAY_SIZE(_read_block); i++) {
+        free(_read_block[i].data);
+        _read_block[i].data = nullptr;
+        _read_block[i].valid = false;
+    }
+    _read_ahead_ofs = UINT32_MAX;
+}
+
+/*
+  read the next block of the log being downloaded, called from the IO
+  thread so that the main thread rarely waits on the filesystem
+ */
+void DataFlash_File::_io_read_ahead()
+{
+    if (_read_ahead_ofs == UINT32_MAX || !_read_sem.take_nonblocking()) {
+        return;
+    }
+    const uint32_t ofs = _read_ahead_ofs;
+    _read_ahead_ofs = UINT32_MAX;
+    if (_read_fd != -1 && _read_block[0].data != nullptr && _read_block_find(ofs) == -1) {
+        last_io_operation = "read";
+        _read_block_load(ofs);
+        last_io_operation = "";
+    }
+    _read_sem.give();
+}
+
 /*
   retrieve data from a log file
  */
@@ -716,6 +890,8 @@ int16_t DataFlash_File::get_log_data(const uint16_t list_entry, const uint16_t p
         return -1;
     }
 
+    WITH_SEMAPHORE(_read_sem);
+
     if (_read_fd != -1 && log_num != _read_fd_log_num) {
         ::close(_read_fd);
         _read_fd = -1;
@@ -740,45 +916,57 @@ int16_t DataFlash_File::get_log_data(const uint16_t list_entry, const uint16_t p
         free(fname);
         _read_offset = 0;
         _read_fd_log_num = log_num;
+        for (uint8_t i=0; i<ARRAY_SIZE(_read_block); i++) {
+            _read_block[i].valid = false;
+        }
+        _read_ahead_ofs = UINT32_MAX;
     }
     uint32_t ofs = page * (uint32_t)DATAFLASH_PAGE_SIZE + offset;
 
-    /*
-      this rather strange bit of code is here to work around a bug
-      in file offsets in NuttX. Every few hundred blocks of reads
-      (starting at around 350k into a file) NuttX will get the
-      wrong offset for sequential reads. The offset it gets is
-      typically 128k earlier than it should be. It turns out that
-      calling lseek() with 0 offset and SEEK_CUR works around the
-      bug. We can remove this once we find the real bug.
-    */
-    if (ofs / 4096 != (ofs+len) / 4096) {
-        off_t seek_current = ::lseek(_read_fd, 0, SEEK_CUR);
-        if (seek_current == (off_t)-1) {
-            close(_read_fd);
-            _read_fd = -1;
-            return -1;
+    if (!_read_blocks_alloc()) {
+        // no memory to read ahead
+        return _read_fd_at(ofs, data, len);
+    }
+
+    uint16_t ret = 0;
+    while (ret < len) {
+        int8_t i = _read_block_find(ofs);
+        if (i == -1 && _read_block_continues(ofs)) {
+            // the IO thread hasn't kept up with the download
+            i = _read_block_load(ofs);
+            if (i == -1) {
+                return ret > 0 ? ret : -1;
+            }
         }
-        if (seek_current != (off_t)_read_offset) {
-            if (::lseek(_read_fd, _read_offset, SEEK_SET) == (off_t)-1) {
-                close(_read_fd);
-                _read_fd = -1;
-                return -1;
+        if (i == -1) {
+            // a retransmit of an earlier part of the log, which isn't
+            // worth reading a whole block for
+            if (ofs != _read_offset) {
+                _read_direct_bytes = 0;
+            }
+            const int32_t n = _read_fd_at(ofs, &data[ret], len - ret);
+            if (n < 0) {
+                return ret > 0 ? ret : -1;
             }
+            _read_direct_bytes += n;
+            return ret + n;
         }
-    }
-
-    if (ofs != _read_offset) {
-        if (::lseek(_read_fd, ofs, SEEK_SET) == (off_t)-1) {
-            close(_read_fd);
-            _read_fd = -1;
-            return -1;
+        const struct read_block &b = _read_block[i];
+        const uint32_t n = MIN((uint32_t)(len - ret), b.ofs + b.len - ofs);
+        if (n == 0) {
+            // end of the log
+            break;
+        }
+        memcpy(&data[ret], &b.data[ofs - b.ofs], n);
+        ret += n;
+        ofs += n;
+
+        // have the IO thread read the block after this one before it
+        // is needed
+        const uint32_t next = b.ofs + b.len;
+        if (b.len == DATAFLASH_READ_BLOCK_SIZE && _read_block_find(next) == -1) {
+            _read_ahead_ofs = next;
         }
-        _read_offset = ofs;
-    }
-    int16_t ret = (int16_t)::read(_read_fd, data, len);
-    if (ret > 0) {
-        _read_offset += ret;
     }
     return ret;
 }
@@ -869,9 +1057,13 @@ uint16_t DataFlash_File::start_new_log(void)
         return 0xFFFF;
     }
 
-    if (_read_fd != -1) {
-        ::close(_read_fd);
-        _read_fd = -1;
+    if (_read_fd != -1 || _read_block[0].data != nullptr) {
+        WITH_SEMAPHORE(_read_sem);
+        if (_read_fd != -1) {
+            ::close(_read_fd);
+            _read_fd = -1;
+        }
+        _read_blocks_free();
     }
 
     if (disk_space_avail() < _free_space_min_avail) {
@@ -990,6 +1182,7 @@ void DataFlash_File::_io_timer(void)
 {
     uint32_t tnow = AP_HAL::millis();
     _io_timer_heartbeat = tnow;
+    _io_read_ahead();
     if (_write_fd == -1 || !_initialised || _open_error) {
         return;
     }
@@ -71,6 +71,28 @@ private:
     int _read_fd;
     uint16_t _read_fd_log_num;
     uint32_t _read_offset;
+    int32_t _read_fd_at(uint32_t ofs, uint8_t *data, uint32_t len);
+
+    // log download read-ahead. While one block is sent from, the IO
+    // thread reads the next into the other
+    struct read_block {
+        uint8_t *data;
+        uint32_t ofs;
+        uint32_t len;
+        bool valid;
+    } _read_block[2];
+    // offset for the IO thread to read the next block from
+    uint32_t _read_ahead_ofs = UINT32_MAX;
+    // bytes read sequentially without using the blocks
+    uint32_t _read_direct_bytes;
+    // _read_sem mediates access to _read_fd and the read-ahead blocks
+    HAL_Semaphore _read_sem;
+    int8_t _read_block_find(uint32_t ofs) const;
+    bool _read_block_continues(uint32_t ofs) const;
+    int8_t _read_block_load(uint32_t ofs);
+    bool _read_blocks_alloc();
+    void _read_blocks_free();
+    void _io_read_ahead();
     uint32_t _write_offset;
     volatile bool _open_error;
     const char *_log_directory;
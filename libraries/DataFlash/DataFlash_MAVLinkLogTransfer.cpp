@@ -24,6 +24,9 @@
 
 extern const AP_HAL::HAL& hal;
 
+// longest time to spend streaming log data to a link in one call
+#define LOG_SEND_MAX_US 1000U
+
 // We avoid doing log messages when timing is critical:
 bool DataFlash_Class::should_handle_log_message()
 {
@@ -102,20 +105,22 @@ void DataFlash_Class::handle_log_request_list(GCS_MAVLINK &link, mavlink_message
  */
 void DataFlash_Class::handle_log_request_data(GCS_MAVLINK &link, mavlink_message_t *msg)
 {
+    mavlink_log_request_data_t packet;
+    mavlink_msg_log_request_data_decode(msg, &packet);
+
     if (_log_sending_link != nullptr) {
         // some GCS (e.g. MAVProxy) attempt to stream request_data
         // messages when they're filling gaps in the downloaded logs.
-        // This channel check avoids complaining to them, at the cost
-        // of silently dropping any repeated attempts to start logging
+        // Those are queued as retransmits, and requests from other
+        // channels are refused
         if (_log_sending_link->get_chan() != link.get_chan()) {
             link.send_text(MAV_SEVERITY_INFO, "Log download in progress");
+        } else if (transfer_activity == SENDING && packet.id == _log_num_data) {
+            handle_log_request_gap(packet.ofs, packet.count);
         }
         return;
     }
 
-    mavlink_log_request_data_t packet;
-    mavlink_msg_log_request_data_decode(msg, &packet);
-
     // consider opening or switching logs:
     if (transfer_activity != SENDING || _log_num_data != packet.id) {
 
@@ -144,6 +149,7 @@ void DataFlash_Class::handle_log_request_data(GCS_MAVLINK &link, mavlink_message
     if (_log_data_remaining > packet.count) {
         _log_data_remaining = packet.count;
     }
+    _log_num_gaps = 0;
 
     transfer_activity = SENDING;
     _log_sending_link = &link;
@@ -151,6 +157,39 @@ void DataFlash_Class::handle_log_request_data(GCS_MAVLINK &link, mavlink_message
     handle_log_send();
 }
 
+/**
+   handle a request for data while a log is being streamed. Parts of
+   the log already sent are queued to be sent again, and the rest will
+   be sent by the stream anyway
+ */
+void DataFlash_Class::handle_log_request_gap(uint32_t ofs, uint32_t count)
+{
+    if (ofs >= _log_data_offset) {
+        if (_log_data_remaining == 0) {
+            // the stream has finished, so restart it from here
+            _log_data_offset = ofs;
+            _log_data_remaining = MIN(count, _log_data_size > ofs ? _log_data_size - ofs : 0);
+        }
+        return;
+    }
+    count = MIN(count, _log_data_offset - ofs);
+
+    for (uint8_t i=0; i<_log_num_gaps; i++) {
+        const struct log_gap &gap = _log_gaps[i];
+        if (ofs >= gap.ofs && ofs + count <= gap.ofs + gap.remaining) {
+            // already queued
+            return;
+        }
+    }
+    if (_log_num_gaps >= ARRAY_SIZE(_log_gaps)) {
+        // the GCS will ask again
+        return;
+    }
+    _log_gaps[_log_num_gaps].ofs = ofs;
+    _log_gaps[_log_num_gaps].remaining = count;
+    _log_num_gaps++;
+}
+
 /**
    handle request to erase log data
  */
@@ -172,6 +211,7 @@ void DataFlash_Class::handle_log_request_end(GCS_MAVLINK &link, mavlink_message_
 
     transfer_activity = IDLE;
     _log_sending_link = nullptr;
+    _log_num_gaps = 0;
 }
 
 /**
@@ -202,26 +242,24 @@ void DataFlash_Class::handle_log_sending()
 {
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
     // assume USB speeds in SITL for the purposes of log download
-    const uint8_t num_sends = 40;
+    const bool stream = true;
 #else
-    uint8_t num_sends = 1;
-    if (_log_sending_link->is_high_bandwidth() && hal.gpio->usb_connected()) {
-        // when on USB we can send a lot more data
-        num_sends = 250;
-    } else if (_log_sending_link->have_flow_control()) {
-    #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
-        num_sends = 80;
-    #else
-        num_sends = 10;
-    #endif
-    }
+    // USB and links with flow control only take data as fast as
+    // they can send it
+    const bool stream = (_log_sending_link->is_high_bandwidth() && hal.gpio->usb_connected()) ||
+        _log_sending_link->have_flow_control();
 #endif
 
-    for (uint8_t i=0; i<num_sends; i++) {
-        if (transfer_activity != SENDING) {
-            // may have completed sending data
-            break;
-        }
+    if (!stream) {
+        handle_log_send_data();
+        return;
+    }
+
+    // fill the link's transmit buffer, bounded in time so the main
+    // loop isn't held up by a fast link
+    const uint32_t start_us = AP_HAL::micros();
+    while (transfer_activity == SENDING &&
+           AP_HAL::micros() - start_us < LOG_SEND_MAX_US) {
         if (!handle_log_send_data()) {
             break;
         }
@@ -277,14 +315,18 @@ bool DataFlash_Class::handle_log_send_data()
         return false;
     }
 
+    // retransmits go ahead of the stream
+    struct log_gap *gap = _log_num_gaps > 0 ? &_log_gaps[0] : nullptr;
+    const uint32_t ofs = gap != nullptr ? gap->ofs : _log_data_offset;
+
     int16_t ret = 0;
-    uint32_t len = _log_data_remaining;
+    uint32_t len = gap != nullptr ? gap->remaining : _log_data_remaining;
 	mavlink_log_data_t packet;
 
     if (len > MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) {
         len = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
     }
-    ret = get_log_data(_log_num_data, _log_data_page, _log_data_offset, len, packet.data);
+    ret = get_log_data(_log_num_data, _log_data_page, ofs, len, packet.data);
     if (ret < 0) {
         // report as EOF on error
         ret = 0;
@@ -293,7 +335,7 @@ bool DataFlash_Class::handle_log_send_data()
         memset(&packet.data[ret], 0, MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN-ret);
     }
 
-    packet.ofs = _log_data_offset;
+    packet.ofs = ofs;
     packet.id = _log_num_data;
     packet.count = ret;
     _mav_finalize_message_chan_send(_log_sending_link->get_chan(),
@@ -303,9 +345,22 @@ bool DataFlash_Class::handle_log_send_data()
                                     MAVLINK_MSG_ID_LOG_DATA_LEN,
                                     MAVLINK_MSG_ID_LOG_DATA_CRC);
 
-    _log_data_offset += len;
-    _log_data_remaining -= len;
-    if (ret < MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN || _log_data_remaining == 0) {
+    if (gap != nullptr) {
+        gap->ofs += len;
+        gap->remaining -= len;
+        if (ret < (int16_t)len || gap->remaining == 0) {
+            _log_num_gaps--;
+            memmove(&_log_gaps[0], &_log_gaps[1], _log_num_gaps * sizeof(_log_gaps[0]));
+        }
+    } else {
+        _log_data_offset += len;
+        _log_data_remaining -= len;
+        if (ret < MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) {
+            // end of the log
+            _log_data_remaining = 0;
+        }
+    }
+    if (_log_data_remaining == 0 && _log_num_gaps == 0) {
         transfer_activity = IDLE;
         _log_sending_link = nullptr;
     }
@@ -236,6 +236,21 @@ struct PACKED log_ISBD {
 };
 static_assert(sizeof(log_ISBD) < 256, "log_ISBD is over-size");
 
+struct PACKED log_ISBF {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint16_t isb_seqno;
+    uint8_t sensor_type; // e.g. GYRO or ACCEL
+    uint8_t instance;
+    uint16_t points; // FFT length
+    float peak_x;
+    float peak_y;
+    float peak_z;
+    float energy_x;
+    float energy_y;
+    float energy_z;
+};
+
 struct PACKED log_Vibe {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -1044,6 +1059,18 @@ struct PACKED log_Performance {
     uint16_t load;
 };
 
+struct PACKED log_Latency {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t stage;
+    uint32_t count;
+    float mean;
+    uint32_t max;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+};
+
 struct PACKED log_SRTL {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -1127,6 +1154,11 @@ struct PACKED log_DSTL {
 #define ISBD_UNITS  "s--ooo"
 #define ISBD_MULTS  "F--???"
 
+#define ISBF_LABELS "TimeUS,N,type,instance,pts,PkX,PkY,PkZ,EnX,EnY,EnZ"
+#define ISBF_FMT    "QHBBHffffff"
+#define ISBF_UNITS  "s----zzz???"
+#define ISBF_MULTS  "F----000???"
+
 #define IMU_LABELS "TimeUS,GyrX,GyrY,GyrZ,AccX,AccY,AccZ,EG,EA,T,GH,AH,GHz,AHz"
 #define IMU_FMT   "QffffffIIfBBHH"
 #define IMU_UNITS "sEEEooo--O--zz"
@@ -1286,6 +1318,8 @@ Format characters in the format string for binary log messages
       "PRX", "QBfffffffffff", "TimeUS,Health,D0,D45,D90,D135,D180,D225,D270,D315,DUp,CAn,CDis", "s-mmmmmmmmmhm", "F-BBBBBBBBB00" }, \
     { LOG_PERFORMANCE_MSG, sizeof(log_Performance),                     \
       "PM",  "QHHIIH", "TimeUS,NLon,NLoop,MaxT,Mem,Load", "s---b%", "F---0A" }, \
+    { LOG_LATENCY_MSG, sizeof(log_Latency),                         \
+      "LAT", "QBIfIIII", "TimeUS,Stage,N,Mean,Max,P50,P90,P99", "s--sssss", "F--FFFFF" }, \
     { LOG_SRTL_MSG, sizeof(log_SRTL), \
       "SRTL", "QBHHBfff", "TimeUS,Active,NumPts,MaxPts,Action,N,E,D", "s----mmm", "F----000" }
 
@@ -1429,6 +1463,8 @@ Format characters in the format string for binary log messages
       "ISBH",ISBH_FMT,ISBH_LABELS,ISBH_UNITS,ISBH_MULTS },  \
     { LOG_ISBD_MSG, sizeof(log_ISBD), \
       "ISBD",ISBD_FMT,ISBD_LABELS, ISBD_UNITS, ISBD_MULTS }, \
+    { LOG_ISBF_MSG, sizeof(log_ISBF), \
+      "ISBF",ISBF_FMT,ISBF_LABELS, ISBF_UNITS, ISBF_MULTS }, \
     { LOG_ORGN_MSG, sizeof(log_ORGN), \
       "ORGN","QBLLe","TimeUS,Type,Lat,Lng,Alt", "s-DUm", "F-GGB" },   \
     { LOG_DF_FILE_STATS, sizeof(log_DSF), \
@@ -1615,6 +1651,8 @@ enum LogMessages : uint8_t {
     LOG_ASP2_MSG,
     LOG_PERFORMANCE_MSG,
     LOG_OPTFLOW_MSG,
+    LOG_LATENCY_MSG,
+    LOG_ISBF_MSG,
     _LOG_LAST_MSG_
 };
 
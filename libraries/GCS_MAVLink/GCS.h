@@ -26,6 +26,17 @@
 
 #define GCS_DEBUG_SEND_MESSAGE_TIMINGS 0
 
+// number of mission items requested ahead of the next one to be stored during a mission
+// upload.  At most 16
+#ifndef GCS_MAVLINK_MISSION_UPLOAD_WINDOW
+#define GCS_MAVLINK_MISSION_UPLOAD_WINDOW 8
+#endif
+
+// MAVLink FTP server, on boards with a filesystem
+#ifndef HAL_MAVLINK_FTP_ENABLED
+#define HAL_MAVLINK_FTP_ENABLED (HAL_OS_POSIX_IO || HAL_OS_FATFS_IO)
+#endif
+
 // check if a message will fit in the payload space available
 #define PAYLOAD_SIZE(chan, id) (GCS_MAVLINK::packet_overhead_chan(chan)+MAVLINK_MSG_ID_ ## id ## _LEN)
 #define HAVE_PAYLOAD_SPACE(chan, id) (comm_get_txspace(chan) >= PAYLOAD_SIZE(chan, id))
@@ -364,6 +375,10 @@ protected:
     void handle_device_op_read(mavlink_message_t *msg);
     void handle_device_op_write(mavlink_message_t *msg);
 
+#if HAL_MAVLINK_FTP_ENABLED
+    void handle_file_transfer_protocol(mavlink_message_t *msg);
+#endif
+
     void send_timesync();
     // returns the time a timesync message was most likely received:
     uint64_t timesync_receive_timestamp_ns() const;
@@ -472,6 +487,19 @@ private:
     uint32_t        waypoint_timelast_receive; // milliseconds
     uint32_t        waypoint_timelast_request; // milliseconds
     const uint16_t  waypoint_receive_timeout = 8000; // milliseconds
+    uint16_t        waypoint_request_next; // next index to request, up to GCS_MAVLINK_MISSION_UPLOAD_WINDOW ahead of waypoint_request_i
+    bool            waypoint_request_int;  // GCS is sending MISSION_ITEM_INT so request items with MISSION_REQUEST_INT
+
+    // mission items received ahead of waypoint_request_i, held until the items before them arrive
+    AP_Mission::Mission_Command waypoint_buffer[GCS_MAVLINK_MISSION_UPLOAD_WINDOW];
+    uint16_t        waypoint_buffer_valid; // bitmask of waypoint_buffer entries holding an item
+
+    // start receiving mission items from the GCS which sent msg
+    void start_mission_upload(const mavlink_message_t *msg, uint16_t first, uint16_t last);
+    // true if the mission item with index seq has been received and is waiting to be stored
+    bool waypoint_buffered(uint16_t seq) const;
+    // store a received mission item in the mission
+    MAV_MISSION_RESULT store_mission_item(AP_Mission &mission, uint16_t seq, AP_Mission::Mission_Command &cmd);
 
     // number of extra 20ms intervals to add to slow things down for the radio
     uint8_t         stream_slowdown;
@@ -608,6 +636,98 @@ private:
     // send an async parameter reply
     void send_parameter_reply(void);
 
+#if HAL_MAVLINK_FTP_ENABLED
+    // MAVLink FTP, see GCS_FTP.cpp
+    enum class FTP_OP : uint8_t {
+        None = 0,
+        TerminateSession = 1,
+        ResetSessions = 2,
+        ListDirectory = 3,
+        OpenFileRO = 4,
+        ReadFile = 5,
+        CreateFile = 6,
+        WriteFile = 7,
+        RemoveFile = 8,
+        CreateDirectory = 9,
+        RemoveDirectory = 10,
+        OpenFileWO = 11,
+        TruncateFile = 12,
+        Rename = 13,
+        CalcFileCRC32 = 14,
+        BurstReadFile = 15,
+        Ack = 128,
+        Nack = 129,
+    };
+
+    enum class FTP_ERROR : uint8_t {
+        None = 0,
+        Fail = 1,
+        FailErrno = 2,
+        InvalidDataSize = 3,
+        InvalidSession = 4,
+        NoSessionsAvailable = 5,
+        EndOfFile = 6,
+        UnknownCommand = 7,
+        FileExists = 8,
+        FileProtected = 9,
+        FileNotFound = 10,
+    };
+
+    // a request or reply, unpacked from the FILE_TRANSFER_PROTOCOL
+    // payload
+    struct pending_ftp {
+        uint32_t offset;
+        mavlink_channel_t chan;
+        uint16_t seq_number;
+        FTP_OP opcode;
+        FTP_OP req_opcode;
+        bool burst_complete;
+        uint8_t size;
+        uint8_t session;
+        uint8_t sysid;
+        uint8_t compid;
+        uint8_t data[239];
+    };
+
+    // there is one session, shared by all links and only used from
+    // the IO thread
+    struct ftp_state {
+        ObjectBuffer<pending_ftp> *requests;
+        ObjectBuffer<pending_ftp> *replies;
+
+        int fd = -1;
+        uint8_t session;
+        uint32_t last_request_ms;
+
+        // file data is read a block at a time
+        uint8_t *block;
+        uint32_t block_ofs;
+        uint32_t block_len;
+
+        // burst read in progress
+        struct pending_ftp burst;
+        uint16_t burst_remaining;
+
+        // file CRC in progress, sent once the whole file is read
+        struct pending_ftp crc_reply;
+        uint32_t crc;
+        uint32_t crc_offset;
+        bool crc_active;
+    };
+    static struct ftp_state ftp;
+
+    bool ftp_init(void);
+    void ftp_io_timer(void);
+    void ftp_process_request(const pending_ftp &request, pending_ftp &reply);
+    void ftp_burst_continue(void);
+    void ftp_crc_continue(void);
+    void ftp_close(void);
+    int32_t ftp_read(uint32_t offset, uint8_t *data, uint32_t len);
+    void ftp_error(pending_ftp &reply, FTP_ERROR error);
+    void ftp_list_dir(const char *path, const pending_ftp &request, pending_ftp &reply);
+    void send_ftp_replies(void);
+#endif
+
     void send_distance_sensor(const AP_RangeFinder_Backend *sensor, const uint8_t instance) const;
 
     virtual bool handle_guided_request(AP_Mission::Mission_Command &cmd) = 0;
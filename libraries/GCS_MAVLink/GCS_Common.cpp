@@ -166,22 +166,59 @@ GCS_MAVLINK::setup_uart(const AP_SerialManager& serial_manager, AP_SerialManager
 
 
 /**
- * @brief Send the next pending waypoint, called from deferred message
+ * @brief Send the next pending waypoint requests, called from deferred message
  * handling code
  */
 void
 GCS_MAVLINK::queued_waypoint_send()
 {
-    if (initialised &&
-        waypoint_receiving &&
-        waypoint_request_i <= waypoint_request_last) {
-        mavlink_msg_mission_request_send(
-            chan,
-            waypoint_dest_sysid,
-            waypoint_dest_compid,
-            waypoint_request_i,
-            MAV_MISSION_TYPE_MISSION);
+    if (!initialised || !waypoint_receiving) {
+        return;
+    }
+
+    // request up to GCS_MAVLINK_MISSION_UPLOAD_WINDOW items so the GCS can send them without
+    // waiting for each one to be stored.  The next item needed is always requested
+    const uint16_t window_end = MAX(MIN((uint32_t)waypoint_request_last, (uint32_t)waypoint_request_i + GCS_MAVLINK_MISSION_UPLOAD_WINDOW),
+                                    (uint32_t)waypoint_request_i + 1);
+    if (waypoint_request_next < waypoint_request_i || waypoint_request_next > window_end) {
+        waypoint_request_next = waypoint_request_i;
     }
+
+    while (waypoint_request_next < window_end) {
+        if (!waypoint_buffered(waypoint_request_next)) {
+            if (waypoint_request_int) {
+                if (!HAVE_PAYLOAD_SPACE(chan, MISSION_REQUEST_INT)) {
+                    return;
+                }
+                mavlink_msg_mission_request_int_send(
+                    chan,
+                    waypoint_dest_sysid,
+                    waypoint_dest_compid,
+                    waypoint_request_next,
+                    MAV_MISSION_TYPE_MISSION);
+            } else {
+                if (!HAVE_PAYLOAD_SPACE(chan, MISSION_REQUEST)) {
+                    return;
+                }
+                mavlink_msg_mission_request_send(
+                    chan,
+                    waypoint_dest_sysid,
+                    waypoint_dest_compid,
+                    waypoint_request_next,
+                    MAV_MISSION_TYPE_MISSION);
+            }
+        }
+        waypoint_request_next++;
+    }
+}
+
+/*
+  true if the mission item with index seq has been received and is waiting to be stored
+ */
+bool GCS_MAVLINK::waypoint_buffered(uint16_t seq) const
+{
+    const uint8_t slot = seq % GCS_MAVLINK_MISSION_UPLOAD_WINDOW;
+    return (waypoint_buffer_valid & (1U<<slot)) && waypoint_buffer[slot].index == seq;
 }
 
 void GCS_MAVLINK::send_meminfo(void)
@@ -562,12 +599,24 @@ void GCS_MAVLINK::handle_mission_count(AP_Mission &mission, mavlink_message_t *m
     // new mission arriving, truncate mission to be the same length
     mission.truncate(packet.count);
 
+    // expect commands zero to count-1
+    start_mission_upload(msg, 0, packet.count);
+}
+
+/*
+  start receiving mission items first to last from the GCS which sent msg
+ */
+void GCS_MAVLINK::start_mission_upload(const mavlink_message_t *msg, uint16_t first, uint16_t last)
+{
     // set variables to help handle the expected receiving of commands from the GCS
     waypoint_timelast_receive = AP_HAL::millis();    // set time we last received commands to now
     waypoint_receiving = true;              // record that we expect to receive commands
-    waypoint_request_i = 0;                 // reset the next expected command number to zero
-    waypoint_request_last = packet.count;   // record how many commands we expect to receive
+    waypoint_request_i = first;             // record the next expected command number
+    waypoint_request_next = first;          // start requesting from the next expected command
+    waypoint_request_last = last;           // record how many commands we expect to receive
     waypoint_timelast_request = 0;          // set time we last requested commands to zero
+    waypoint_request_int = false;           // ask for MISSION_ITEM until the GCS sends MISSION_ITEM_INT
+    waypoint_buffer_valid = 0;              // no commands received yet
 
     waypoint_dest_sysid = msg->sysid;       // record system id of GCS who wants to upload the mission
     waypoint_dest_compid = msg->compid;     // record component id of GCS who wants to upload the mission
@@ -611,14 +660,7 @@ void GCS_MAVLINK::handle_mission_write_partial_list(AP_Mission &mission, mavlink
         return;
     }
 
-    waypoint_timelast_receive = AP_HAL::millis();
-    waypoint_timelast_request = 0;
-    waypoint_receiving   = true;
-    waypoint_request_i   = packet.start_index;
-    waypoint_request_last= packet.end_index;
-
-    waypoint_dest_sysid = msg->sysid;       // record system id of GCS who wants to partially update the mission
-    waypoint_dest_compid = msg->compid;     // record component id of GCS who wants to partially update the mission
+    start_mission_upload(msg, packet.start_index, packet.end_index);
 }
 
 
@@ -700,6 +742,32 @@ void GCS_MAVLINK::handle_radio_status(mavlink_message_t *msg, DataFlash_Class &d
     }
 }
 
+/*
+  store a received mission item in the mission, replacing an existing
+  command or adding it to the end
+ */
+MAV_MISSION_RESULT GCS_MAVLINK::store_mission_item(AP_Mission &mission, uint16_t seq, AP_Mission::Mission_Command &cmd)
+{
+    // if command index is within the existing list, replace the command
+    if (seq < mission.num_commands()) {
+        if (mission.replace_cmd(seq,cmd)) {
+            return MAV_MISSION_ACCEPTED;
+        }
+        return MAV_MISSION_ERROR;
+    }
+
+    // if command is at the end of command list, add the command
+    if (seq == mission.num_commands()) {
+        if (mission.add_cmd(cmd)) {
+            return MAV_MISSION_ACCEPTED;
+        }
+        return MAV_MISSION_ERROR;
+    }
+
+    // if beyond the end of the command list, return an error
+    return MAV_MISSION_ERROR;
+}
+
 /*
   handle an incoming mission item
   return true if this is the last mission item, otherwise false
@@ -711,6 +779,7 @@ bool GCS_MAVLINK::handle_mission_item(mavlink_message_t *msg, AP_Mission &missio
     bool mission_is_complete = false;
     uint16_t seq=0;
     uint16_t current = 0;
+    bool int_packet = true;
     
     if (msg->msgid == MAVLINK_MSG_ID_MISSION_ITEM) {      
         mavlink_mission_item_t packet;    
@@ -724,6 +793,7 @@ bool GCS_MAVLINK::handle_mission_item(mavlink_message_t *msg, AP_Mission &missio
         
         seq = packet.seq;
         current = packet.current;
+        int_packet = false;
     } else {
         mavlink_mission_item_int_t packet;
         mavlink_msg_mission_item_int_decode(msg, &packet);
@@ -764,8 +834,14 @@ bool GCS_MAVLINK::handle_mission_item(mavlink_message_t *msg, AP_Mission &missio
         goto mission_ack;
     }
 
-    // check if this is the requested waypoint
-    if (seq != waypoint_request_i) {
+    // requests may be repeated so items which have already been stored can arrive again
+    if (seq < waypoint_request_i) {
+        return false;
+    }
+
+    // check if this is one of the requested waypoints
+    if (seq >= (uint32_t)waypoint_request_i + GCS_MAVLINK_MISSION_UPLOAD_WINDOW ||
+        (seq >= waypoint_request_last && seq != waypoint_request_i)) {
         result = MAV_MISSION_INVALID_SEQUENCE;
         goto mission_ack;
     }
@@ -777,33 +853,38 @@ bool GCS_MAVLINK::handle_mission_item(mavlink_message_t *msg, AP_Mission &missio
             goto mission_ack;
         }
     }
-    
-    // if command index is within the existing list, replace the command
-    if (seq < mission.num_commands()) {
-        if (mission.replace_cmd(seq,cmd)) {
-            result = MAV_MISSION_ACCEPTED;
-        }else{
-            result = MAV_MISSION_ERROR;
+
+    // ask for MISSION_ITEM_INT from now on if that is what the GCS sends
+    waypoint_request_int = int_packet;
+    waypoint_timelast_receive = AP_HAL::millis();
+
+    // hold items which arrive ahead of the next one needed
+    if (seq != waypoint_request_i) {
+        const uint8_t slot = seq % GCS_MAVLINK_MISSION_UPLOAD_WINDOW;
+        cmd.index = seq;
+        waypoint_buffer[slot] = cmd;
+        waypoint_buffer_valid |= (1U<<slot);
+        return false;
+    }
+
+    // store this item followed by any held items which now follow on from it
+    while (true) {
+        result = store_mission_item(mission, waypoint_request_i, cmd);
+        if (result != MAV_MISSION_ACCEPTED) {
             goto mission_ack;
         }
-        // if command is at the end of command list, add the command
-    } else if (seq == mission.num_commands()) {
-        if (mission.add_cmd(cmd)) {
-            result = MAV_MISSION_ACCEPTED;
-        }else{
-            result = MAV_MISSION_ERROR;
-            goto mission_ack;
+
+        // update waypoint receiving state machine
+        waypoint_request_i++;
+
+        if (waypoint_request_i >= waypoint_request_last || !waypoint_buffered(waypoint_request_i)) {
+            break;
         }
-        // if beyond the end of the command list, return an error
-    } else {
-        result = MAV_MISSION_ERROR;
-        goto mission_ack;
+        const uint8_t slot = waypoint_request_i % GCS_MAVLINK_MISSION_UPLOAD_WINDOW;
+        waypoint_buffer_valid &= ~(1U<<slot);
+        cmd = waypoint_buffer[slot];
     }
     
-    // update waypoint receiving state machine
-    waypoint_timelast_receive = AP_HAL::millis();
-    waypoint_request_i++;
-    
     if (waypoint_request_i >= waypoint_request_last) {
         mavlink_msg_mission_ack_send_buf(
             msg,
@@ -1139,6 +1220,10 @@ void GCS_MAVLINK::update_send()
         DataFlash_Class::instance()->handle_log_send();
     }
 
+#if HAL_MAVLINK_FTP_ENABLED
+    send_ftp_replies();
+#endif
+
     if (!deferred_messages_initialised) {
         initialise_message_intervals_from_streamrates();
         deferred_messages_initialised = true;
@@ -1545,7 +1630,9 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
             waypoint_receiving = false;
             gcs().send_text(MAV_SEVERITY_WARNING, "Mission upload timeout");
         } else if (tnow - waypoint_timelast_request > wp_recv_time) {
+            // ask again for any requested items which have not arrived
             waypoint_timelast_request = tnow;
+            waypoint_request_next = waypoint_request_i;
             send_message(MSG_NEXT_WAYPOINT);
         }
     }
@@ -2867,6 +2954,11 @@ void GCS_MAVLINK::handle_common_message(mavlink_message_t *msg)
     case MAVLINK_MSG_ID_DEVICE_OP_WRITE:
         handle_device_op_write(msg);
         break;
+#if HAL_MAVLINK_FTP_ENABLED
+    case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+        handle_file_transfer_protocol(msg);
+        break;
+#endif
     case MAVLINK_MSG_ID_TIMESYNC:
         handle_timesync(msg);
         break;
@@ -0,0 +1,585 @@
+/*
+   MAVLink FTP server
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  Requests are queued by the main thread and handled on the IO
+  thread, which queues replies for the main thread to send. A burst
+  read streams up to FTP_BURST_PACKETS replies from one request, at
+  the rate the link takes them. A file CRC is calculated a block per
+  call of the IO timer and answered when it is done.
+ */
+#include <AP_HAL/AP_HAL.h>
+
+#include "GCS.h"
+
+#if HAL_MAVLINK_FTP_ENABLED
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
+
+#include <stdio.h>
+#if HAL_OS_POSIX_IO
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+extern const AP_HAL::HAL& hal;
+
+// file data is read in blocks of this size
+#ifndef FTP_BLOCK_SIZE
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#define FTP_BLOCK_SIZE 16384U
+#else
+#define FTP_BLOCK_SIZE 2048U
+#endif
+#endif
+
+// replies sent for one BurstReadFile request
+#define FTP_BURST_PACKETS 500U
+
+// close a session after this long with no requests
+#define FTP_SESSION_TIMEOUT_MS 10000U
+
+// header size of the FILE_TRANSFER_PROTOCOL payload
+#define FTP_HEADER_LEN 12U
+
+struct GCS_MAVLINK::ftp_state GCS_MAVLINK::ftp;
+
+/*
+  allocate the request and reply queues and start the IO callback
+ */
+bool GCS_MAVLINK::ftp_init(void)
+{
+    if (ftp.requests != nullptr) {
+        return true;
+    }
+    ObjectBuffer<pending_ftp> *requests = new ObjectBuffer<pending_ftp>(5);
+    ObjectBuffer<pending_ftp> *replies = new ObjectBuffer<pending_ftp>(20);
+    if (requests == nullptr || replies == nullptr ||
+        requests->space() == 0 || replies->space() == 0) {
+        delete requests;
+        delete replies;
+        return false;
+    }
+    ftp.replies = replies;
+    ftp.requests = requests;
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&GCS_MAVLINK::ftp_io_timer, void));
+    return true;
+}
+
+/*
+  handle FILE_TRANSFER_PROTOCOL message
+ */
+void GCS_MAVLINK::handle_file_transfer_protocol(mavlink_message_t *msg)
+{
+    mavlink_file_transfer_protocol_t packet;
+    mavlink_msg_file_transfer_protocol_decode(msg, &packet);
+
+    if (packet.target_system != mavlink_system.sysid ||
+        (packet.target_component != 0 && packet.target_component != mavlink_system.compid)) {
+        return;
+    }
+    if (!ftp_init() || ftp.requests->space() == 0) {
+        // the GCS will retry
+        return;
+    }
+
+    const uint8_t *p = packet.payload;
+    struct pending_ftp request;
+    request.chan = chan;
+    request.sysid = msg->sysid;
+    request.compid = msg->compid;
+    request.seq_number = p[0] | (p[1] << 8);
+    request.session = p[2];
+    request.opcode = (FTP_OP)p[3];
+    request.size = MIN(p[4], (uint8_t)sizeof(request.data));
+    request.req_opcode = (FTP_OP)p[5];
+    request.burst_complete = p[6];
+    request.offset = p[8] | (p[9] << 8) | (p[10] << 16) | ((uint32_t)p[11] << 24);
+    memcpy(request.data, &p[FTP_HEADER_LEN], sizeof(request.data));
+
+    ftp.last_request_ms = AP_HAL::millis();
+    ftp.requests->push(request);
+}
+
+/*
+  send queued replies for this link while there is room for them
+ */
+void GCS_MAVLINK::send_ftp_replies(void)
+{
+    if (ftp.replies == nullptr) {
+        return;
+    }
+    struct pending_ftp reply;
+    while (ftp.replies->peek(reply) && reply.chan == chan &&
+           HAVE_PAYLOAD_SPACE(chan, FILE_TRANSFER_PROTOCOL)) {
+        uint8_t payload[MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN] {};
+        payload[0] = reply.seq_number & 0xFF;
+        payload[1] = reply.seq_number >> 8;
+        payload[2] = reply.session;
+        payload[3] = (uint8_t)reply.opcode;
+        payload[4] = reply.size;
+        payload[5] = (uint8_t)reply.req_opcode;
+        payload[6] = reply.burst_complete;
+        payload[8] = reply.offset & 0xFF;
+        payload[9] = (reply.offset >> 8) & 0xFF;
+        payload[10] = (reply.offset >> 16) & 0xFF;
+        payload[11] = reply.offset >> 24;
+        memcpy(&payload[FTP_HEADER_LEN], reply.data, reply.size);
+        mavlink_msg_file_transfer_protocol_send(chan, 0, reply.sysid, reply.compid, payload);
+        ftp.replies->pop();
+    }
+}
+
+/*
+  fill in a NAK
+ */
+void GCS_MAVLINK::ftp_error(pending_ftp &reply, FTP_ERROR error)
+{
+    reply.opcode = FTP_OP::Nack;
+    reply.data[0] = (uint8_t)error;
+    reply.size = 1;
+    if (error == FTP_ERROR::FailErrno) {
+        reply.data[1] = (uint8_t)errno;
+        reply.size = 2;
+    }
+}
+
+/*
+  close the session's file
+ */
+void GCS_MAVLINK::ftp_close(void)
+{
+    if (ftp.fd != -1) {
+        ::close(ftp.fd);
+        ftp.fd = -1;
+    }
+    ftp.block_len = 0;
+    ftp.burst_remaining = 0;
+    ftp.crc_active = false;
+}
+
+/*
+  read from the session's file, a block at a time
+ */
+int32_t GCS_MAVLINK::ftp_read(uint32_t offset, uint8_t *data, uint32_t len)
+{
+    if (ftp.block == nullptr) {
+        ftp.block = (uint8_t *)malloc(FTP_BLOCK_SIZE);
+    }
+    if (ftp.block == nullptr) {
+        // no memory for a block, read directly
+        if (::lseek(ftp.fd, offset, SEEK_SET) == (off_t)-1) {
+            return -1;
+        }
+        return ::read(ftp.fd, data, len);
+    }
+    if (offset < ftp.block_ofs || offset >= ftp.block_ofs + ftp.block_len) {
+        if (::lseek(ftp.fd, offset, SEEK_SET) == (off_t)-1) {
+            return -1;
+        }
+        const int32_t ret = ::read(ftp.fd, ftp.block, FTP_BLOCK_SIZE);
+        if (ret < 0) {
+            ftp.block_len = 0;
+            return -1;
+        }
+        ftp.block_ofs = offset;
+        ftp.block_len = ret;
+    }
+    const uint32_t n = MIN(len, ftp.block_ofs + ftp.block_len - offset);
+    memcpy(data, &ftp.block[offset - ftp.block_ofs], n);
+    return n;
+}
+
+/*
+  map a path from the GCS to the filesystem
+ */
+static const char *ftp_path(const char *path)
+{
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    // keep SITL in its working directory
+    while (*path == '/') {
+        path++;
+    }
+    if (*path == 0) {
+        return ".";
+    }
+#else
+    if (*path == 0) {
+        return "/";
+    }
+#endif
+    return path;
+}
+
+/*
+  list a directory, starting at the entry in the request's offset.
+  Entries are "F<name>\t<size>\0" for files and "D<name>\0" for
+  directories
+ */
+void GCS_MAVLINK::ftp_list_dir(const char *path, const pending_ftp &request, pending_ftp &reply)
+{
+    DIR *dir = opendir(path);
+    if (dir == nullptr) {
+        ftp_error(reply, FTP_ERROR::FailErrno);
+        return;
+    }
+    uint32_t index = 0;
+    reply.size = 0;
+    struct dirent *de;
+    while ((de = readdir(dir)) != nullptr) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) {
+            continue;
+        }
+        if (index++ < request.offset) {
+            continue;
+        }
+        char full_path[128];
+        struct stat st;
+        hal.util->snprintf(full_path, sizeof(full_path), "%s/%s", path, de->d_name);
+        char entry[sizeof(reply.data)];
+        int len;
+        if (stat(full_path, &st) != 0) {
+            len = hal.util->snprintf(entry, sizeof(entry), "S");
+        } else if ((st.st_mode & S_IFMT) == S_IFDIR) {
+            len = hal.util->snprintf(entry, sizeof(entry), "D%s", de->d_name);
+        } else {
+            len = hal.util->snprintf(entry, sizeof(entry), "F%s\t%u", de->d_name, (unsigned)st.st_size);
+        }
+        if (len < 0) {
+            continue;
+        }
+        // include the null
+        len++;
+        if (reply.size + (uint32_t)len > sizeof(reply.data)) {
+            break;
+        }
+        memcpy(&reply.data[reply.size], entry, len);
+        reply.size += len;
+    }
+    closedir(dir);
+    if (reply.size == 0) {
+        ftp_error(reply, FTP_ERROR::EndOfFile);
+    }
+}
+
+/*
+  handle one request, filling in its reply
+ */
+void GCS_MAVLINK::ftp_process_request(const pending_ftp &request, pending_ftp &reply)
+{
+    // paths are sent without a null when they fill the data
+    char path[sizeof(request.data)+1];
+    memcpy(path, request.data, request.size);
+    path[request.size] = 0;
+    const char *fname = ftp_path(path);
+
+    reply.opcode = FTP_OP::Ack;
+
+    // requests which use an open file must be for its session
+    switch (request.opcode) {
+    case FTP_OP::ReadFile:
+    case FTP_OP::BurstReadFile:
+    case FTP_OP::WriteFile:
+    case FTP_OP::TerminateSession:
+        if (ftp.fd == -1 || request.session != ftp.session) {
+            ftp_error(reply, FTP_ERROR::InvalidSession);
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    switch (request.opcode) {
+    case FTP_OP::None:
+        break;
+
+    case FTP_OP::TerminateSession:
+    case FTP_OP::ResetSessions:
+        ftp_close();
+        break;
+
+    case FTP_OP::ListDirectory:
+        ftp_list_dir(fname, request, reply);
+        break;
+
+    case FTP_OP::OpenFileRO: {
+        if (ftp.fd != -1) {
+            ftp_error(reply, FTP_ERROR::NoSessionsAvailable);
+            break;
+        }
+        struct stat st;
+        if (stat(fname, &st) != 0) {
+            ftp_error(reply, errno == ENOENT ? FTP_ERROR::FileNotFound : FTP_ERROR::FailErrno);
+            break;
+        }
+        ftp.fd = ::open(fname, O_RDONLY|O_CLOEXEC);
+        if (ftp.fd == -1) {
+            ftp_error(reply, FTP_ERROR::FailErrno);
+            break;
+        }
+        ftp.session++;
+        ftp.block_len = 0;
+        reply.session = ftp.session;
+        const uint32_t size = st.st_size;
+        memcpy(reply.data, &size, sizeof(size));
+        reply.size = sizeof(size);
+        break;
+    }
+
+    case FTP_OP::CreateFile:
+    case FTP_OP::OpenFileWO: {
+        if (ftp.fd != -1) {
+            ftp_error(reply, FTP_ERROR::NoSessionsAvailable);
+            break;
+        }
+        int flags = O_WRONLY|O_CREAT|O_CLOEXEC;
+        if (request.opcode == FTP_OP::CreateFile) {
+            flags |= O_TRUNC;
+        }
+#if HAL_OS_POSIX_IO
+        ftp.fd = ::open(fname, flags, 0644);
+#else
+        ftp.fd = ::open(fname, flags);
+#endif
+        if (ftp.fd == -1) {
+            ftp_error(reply, FTP_ERROR::FailErrno);
+            break;
+        }
+        ftp.session++;
+        ftp.block_len = 0;
+        reply.session = ftp.session;
+        break;
+    }
+
+    case FTP_OP::ReadFile: {
+        const int32_t n = ftp_read(request.offset, reply.data, request.size != 0 ? request.size : sizeof(reply.data));
+        if (n < 0) {
+            ftp_error(reply, FTP_ERROR::FailErrno);
+        } else if (n == 0) {
+            ftp_error(reply, FTP_ERROR::EndOfFile);
+        } else {
+            reply.size = n;
+        }
+        break;
+    }
+
+    case FTP_OP::BurstReadFile:
+        // send the rest from the IO timer as the link takes them
+        ftp.burst = request;
+        ftp.burst_remaining = FTP_BURST_PACKETS;
+        reply.opcode = FTP_OP::None;
+        break;
+
+    case FTP_OP::WriteFile: {
+        ftp.block_len = 0;
+        if (::lseek(ftp.fd, request.offset, SEEK_SET) == (off_t)-1 ||
+            ::write(ftp.fd, request.data, request.size) != (ssize_t)request.size) {
+            ftp_error(reply, FTP_ERROR::FailErrno);
+        }
+        break;
+    }
+
+    case FTP_OP::RemoveFile:
+        if (unlink(fname) != 0) {
+            ftp_error(reply, errno == ENOENT ? FTP_ERROR::FileNotFound : FTP_ERROR::FailErrno);
+        }
+        break;
+
+    case FTP_OP::CreateDirectory:
+        if (mkdir(fname, 0755) != 0) {
+            ftp_error(reply, errno == EEXIST ? FTP_ERROR::FileExists : FTP_ERROR::FailErrno);
+        }
+        break;
+
+    case FTP_OP::RemoveDirectory:
+        if (rmdir(fname) != 0) {
+            ftp_error(reply, errno == ENOENT ? FTP_ERROR::FileNotFound : FTP_ERROR::FailErrno);
+        }
+        break;
+
+    case FTP_OP::TruncateFile:
+        if (truncate(fname, request.offset) != 0) {
+            ftp_error(reply, errno == ENOENT ? FTP_ERROR::FileNotFound : FTP_ERROR::FailErrno);
+        }
+        break;
+
+    case FTP_OP::Rename: {
+        // the data holds the old and new names, each null terminated
+        const size_t len = strnlen(path, request.size);
+        if (len + 1 >= request.size) {
+            ftp_error(reply, FTP_ERROR::InvalidDataSize);
+            break;
+        }
+        char new_path[sizeof(path)];
+        strncpy(new_path, &path[len+1], sizeof(new_path));
+        new_path[sizeof(new_path)-1] = 0;
+        if (rename(fname, ftp_path(new_path)) != 0) {
+            ftp_error(reply, errno == ENOENT ? FTP_ERROR::FileNotFound : FTP_ERROR::FailErrno);
+        }
+        break;
+    }
+
+    case FTP_OP::CalcFileCRC32:
+        if (ftp.fd != -1) {
+            ftp_error(reply, FTP_ERROR::NoSessionsAvailable);
+            break;
+        }
+        ftp.fd = ::open(fname, O_RDONLY|O_CLOEXEC);
+        if (ftp.fd == -1) {
+            ftp_error(reply, errno == ENOENT ? FTP_ERROR::FileNotFound : FTP_ERROR::FailErrno);
+            break;
+        }
+        // calculate it a block at a time from the IO timer, so a
+        // large file doesn't hold up the IO thread
+        ftp.block_len = 0;
+        ftp.crc_reply = reply;
+        ftp.crc = 0;
+        ftp.crc_offset = 0;
+        ftp.crc_active = true;
+        reply.opcode = FTP_OP::None;
+        break;
+
+    default:
+        ftp_error(reply, FTP_ERROR::UnknownCommand);
+        break;
+    }
+}
+
+/*
+  send more of a burst read while there is room to queue it
+ */
+void GCS_MAVLINK::ftp_burst_continue(void)
+{
+    const pending_ftp &request = ftp.burst;
+    const uint8_t chunk = request.size != 0 ? request.size : sizeof(request.data);
+
+    while (ftp.burst_remaining > 0 && ftp.replies->space() > 0) {
+        struct pending_ftp reply;
+        reply.chan = request.chan;
+        reply.sysid = request.sysid;
+        reply.compid = request.compid;
+        reply.session = ftp.session;
+        reply.req_opcode = FTP_OP::BurstReadFile;
+        reply.seq_number = ++ftp.burst.seq_number;
+        reply.offset = ftp.burst.offset;
+        reply.opcode = FTP_OP::Ack;
+
+        const int32_t n = ftp_read(ftp.burst.offset, reply.data, chunk);
+        if (n <= 0) {
+            ftp_error(reply, n == 0 ? FTP_ERROR::EndOfFile : FTP_ERROR::FailErrno);
+            ftp.burst_remaining = 0;
+        } else {
+            reply.size = n;
+            ftp.burst.offset += n;
+            ftp.burst_remaining--;
+        }
+        reply.burst_complete = (ftp.burst_remaining == 0);
+        ftp.replies->push(reply);
+    }
+}
+
+/*
+  add the next block of a file to its CRC, queueing the reply once
+  the whole file has been read
+ */
+void GCS_MAVLINK::ftp_crc_continue(void)
+{
+    pending_ftp &reply = ftp.crc_reply;
+    const uint32_t end = ftp.crc_offset + FTP_BLOCK_SIZE;
+    int32_t n;
+    do {
+        n = ftp_read(ftp.crc_offset, reply.data, sizeof(reply.data));
+        if (n > 0) {
+            ftp.crc = crc_crc32(ftp.crc, reply.data, n);
+            ftp.crc_offset += n;
+        }
+    } while (n > 0 && ftp.crc_offset < end);
+    if (n > 0) {
+        // more to read on the next call
+        return;
+    }
+    if (n < 0) {
+        // fill in the error before closing the file changes errno
+        ftp_error(reply, FTP_ERROR::FailErrno);
+    } else {
+        memcpy(reply.data, &ftp.crc, sizeof(ftp.crc));
+        reply.size = sizeof(ftp.crc);
+    }
+    ftp_close();
+    ftp.replies->push(reply);
+}
+
+/*
+  IO timer callback, handling requests, bursts and CRCs
+ */
+void GCS_MAVLINK::ftp_io_timer(void)
+{
+    if (ftp.replies->space() == 0) {
+        return;
+    }
+
+    struct pending_ftp request;
+    if (ftp.requests->pop(request)) {
+        if (ftp.crc_active) {
+            if (request.opcode == FTP_OP::CalcFileCRC32 &&
+                (uint16_t)(request.seq_number + 1) == ftp.crc_reply.seq_number) {
+                // a retry of the CRC in progress, which will be
+                // answered when it is done
+                ftp_crc_continue();
+                return;
+            }
+            // any other request ends the CRC
+            ftp_close();
+        }
+
+        // a new request ends any burst
+        ftp.burst_remaining = 0;
+
+        struct pending_ftp reply;
+        reply.chan = request.chan;
+        reply.sysid = request.sysid;
+        reply.compid = request.compid;
+        reply.seq_number = request.seq_number + 1;
+        reply.session = request.session;
+        reply.req_opcode = request.opcode;
+        reply.offset = request.offset;
+        reply.burst_complete = false;
+        reply.size = 0;
+
+        ftp_process_request(request, reply);
+        if (reply.opcode != FTP_OP::None) {
+            ftp.replies->push(reply);
+        }
+    } else if (ftp.fd != -1 && ftp.burst_remaining == 0 && !ftp.crc_active &&
+               AP_HAL::millis() - ftp.last_request_ms > FTP_SESSION_TIMEOUT_MS) {
+        // the GCS has gone away
+        ftp_close();
+    }
+
+    if (ftp.burst_remaining > 0) {
+        ftp_burst_continue();
+    } else if (ftp.crc_active && ftp.replies->space() > 0) {
+        ftp_crc_continue();
+    }
+}
+
+#endif // HAL_MAVLINK_FTP_ENABLED
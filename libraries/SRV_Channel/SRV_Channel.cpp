@@ -124,7 +124,11 @@ void SRV_Channel::calc_pwm(int16_t output_scaled)
 void SRV_Channel::set_output_pwm(uint16_t pwm)
 {
     output_pwm = pwm;
-    have_pwm_mask |= (1U<<ch_num);
+    // only write the mask when the bit changes, so the motors written
+    // from a rate controller thread never race the main loop over it
+    if (!(have_pwm_mask & (1U<<ch_num))) {
+        have_pwm_mask |= (1U<<ch_num);
+    }
 }
 
 // set angular range of scaled output
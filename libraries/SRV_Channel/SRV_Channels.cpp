@@ -20,6 +20,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Vehicle/AP_Vehicle.h>
+#include <AP_Scheduler/LatencyInfo.h>
 #include "SRV_Channel.h"
 
 #if HAL_WITH_UAVCAN
@@ -222,6 +223,8 @@ void SRV_Channels::push()
 {
     hal.rcout->push();
 
+    AP::latency().record(AP::LatencyInfo::STAGE_OUTPUT);
+
     // give volz library a chance to update
     volz_ptr->update();
 